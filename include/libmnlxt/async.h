@@ -0,0 +1,77 @@
+/*
+ * libmnlxt/async.h		Libmnlxt Asynchronous Requests
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef LIBMNLXT_ASYNC_H_
+#define LIBMNLXT_ASYNC_H_
+
+#include <libmnlxt/core.h>
+#include <libmnlxt/data.h>
+
+/**
+ * Function called on completion of an asynchronous request
+ * @param handle pointer to mnlxt handle the request was sent with
+ * @param seq sequence number of the request
+ * @param error 0 on success, else negative error number
+ * @param data pointer to mnlxt data with the parsed replies, it is cleaned after the callback returns,
+ * mnlxt messages to keep have to be removed from it
+ * @param arg user argument given by sending of the request
+ */
+typedef void (*mnlxt_async_cb_t)(mnlxt_handle_t *handle, uint32_t seq, int error, mnlxt_data_t *data, void *arg);
+
+/**
+ * Enables asynchronous mode on a connected mnlxt handle.
+ * The netlink socket is switched to non blocking mode, synchronous requests should not be used on it anymore.
+ * @param handle pointer to connected mnlxt handle
+ * @param window maximal number of requests in flight
+ * @return 0 on success, else -1
+ */
+int mnlxt_async_init(mnlxt_handle_t *handle, uint32_t window);
+/**
+ * Disables asynchronous mode, pending requests are completed with -ECANCELED
+ * @param handle pointer to mnlxt handle
+ */
+void mnlxt_async_clean(mnlxt_handle_t *handle);
+/**
+ * Sends a netlink request without waiting for its reply.
+ * NLM_F_REQUEST and NLM_F_ACK are added to the request flags, the sequence number is assigned by the handle.
+ * The kernel runs only one dump per socket at a time, further dumps are rejected until the first one is done.
+ * @param handle pointer to mnlxt handle in asynchronous mode
+ * @param nlh netlink message header with embedded message to send
+ * @param cb function to call on completion
+ * @param arg user argument to pass to the function
+ * @return 0 on success, else -1 (errno EBUSY if the window of requests in flight is full)
+ */
+int mnlxt_async_send(mnlxt_handle_t *handle, struct nlmsghdr *nlh, mnlxt_async_cb_t cb, void *arg);
+/**
+ * Creates a request from a mnlxt message and sends it without waiting for its reply
+ * @param handle pointer to mnlxt handle in asynchronous mode
+ * @param message pointer to mnlxt message
+ * @param cb function to call on completion
+ * @param arg user argument to pass to the function
+ * @return 0 on success, else -1 (errno EBUSY if the window of requests in flight is full)
+ */
+int mnlxt_async_message_send(mnlxt_handle_t *handle, const mnlxt_message_t *message, mnlxt_async_cb_t cb, void *arg);
+/**
+ * Receives all pending replies and calls the completion functions of finished requests.
+ * To be called if the file descriptor of the handle (see mnlxt_handel_get_fd) becomes readable.
+ * Messages not belonging to a request in flight are ignored. The completion functions are called after all messages
+ * of a read are parsed, they may send new requests, leave asynchronous mode or disconnect the handle.
+ * @param handle pointer to mnlxt handle in asynchronous mode
+ * @return number of completed requests, or -1 on error
+ */
+int mnlxt_async_process(mnlxt_handle_t *handle);
+/**
+ * Gets number of requests in flight
+ * @param handle pointer to mnlxt handle
+ * @return number of requests waiting for completion
+ */
+uint32_t mnlxt_async_pending(const mnlxt_handle_t *handle);
+
+#endif /* LIBMNLXT_ASYNC_H_ */
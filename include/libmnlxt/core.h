@@ -57,14 +57,61 @@ typedef struct {
 	int seq;
 	const mnlxt_data_cb_t *data_handlers;
 	size_t data_nhandlers;
+	/** buf is not owned by the buffer (zero-copy receive) and is not freed by mnlxt_buffer_clean */
+	int borrowed;
 } mnlxt_buffer_t;
 
+typedef enum {
+	/** socket is non blocking (SOCK_NONBLOCK), synchronous requests wait for their answers by poll */
+	MNLXT_CONNECT_NONBLOCK = 0,
+	/** socket is closed on exec (SOCK_CLOEXEC) */
+	MNLXT_CONNECT_CLOEXEC,
+	/** no ENOBUFS on receive queue overrun, events are dropped silently (NETLINK_NO_ENOBUFS) */
+	MNLXT_CONNECT_NO_ENOBUFS,
+	/** acknowledges do not echo the request (NETLINK_CAP_ACK) */
+	MNLXT_CONNECT_CAP_ACK,
+	/** errors carry an extended message of the kernel (NETLINK_EXT_ACK) */
+	MNLXT_CONNECT_EXT_ACK,
+	/** buffer sizes may exceed the system limits (SO_RCVBUFFORCE, SO_SNDBUFFORCE), needs CAP_NET_ADMIN,
+	 * without it the sizes are capped by the limits */
+	MNLXT_CONNECT_BUF_FORCE,
+	/** dump requests are checked strictly and their headers and attributes filter the dumped objects in the kernel
+	 * (NETLINK_GET_STRICT_CHK), plain dumps still work as they send complete headers */
+	MNLXT_CONNECT_STRICT_CHK
+#define MNLXT_CONNECT_MAX MNLXT_CONNECT_STRICT_CHK + 1
+} mnlxt_connect_flag_t;
+
+typedef struct {
+	/** options flags, use macro MNLXT_FLAG to create it from mnlxt_connect_flag_t */
+	uint32_t flags;
+	/** size of the socket receive buffer (SO_RCVBUF), 0 to keep the default */
+	int rcvbuf;
+	/** size of the socket send buffer (SO_SNDBUF), 0 to keep the default */
+	int sndbuf;
+} mnlxt_connect_opts_t;
+
+struct mnlxt_async_s;
+struct mnlxt_rx_s;
+
 typedef struct {
 	struct mnl_socket *nl;
 	uint32_t seq;
 	const char *error_str;
 	const mnlxt_data_cb_t *data_handlers;
 	size_t data_nhandlers;
+	/** requests in flight of asynchronous mode (see libmnlxt/async.h) */
+	struct mnlxt_async_s *async;
+	/** reusable receive buffer of zero-copy receive */
+	char *rx_buf;
+	size_t rx_size;
+	/** size of a single read, 0 for the size of the receive buffer (see mnlxt_handle_set_read_size) */
+	size_t read_size;
+	/** datagrams received by one batched read (see mnlxt_handle_set_read_batch) */
+	struct mnlxt_rx_s *rx;
+	/** subscribed multicast groups */
+	int groups;
+	/** number of receive queue overruns (ENOBUFS), each one lost an unknown number of events */
+	unsigned long overruns;
 } mnlxt_handle_t;
 
 /**
@@ -76,7 +123,17 @@ typedef struct {
  */
 int mnlxt_connect(mnlxt_handle_t *handle, int bus, int groups);
 /**
- * Disconnects netlink socket and cleans mnlxt handle
+ * Connects to netlink socket with socket options and initializes mnlxt handle.
+ * The options are set before binding, so no event is received with the default options.
+ * @param handle pointer to mnlxt handle
+ * @param bus netlink bus type (NETLINK_* see linux/netlink.h)
+ * @param groups netlink multicast groups to subscribe
+ * @param opts pointer to connect options, or NULL for defaults
+ * @return 0 on success, else -1
+ */
+int mnlxt_connect_opts(mnlxt_handle_t *handle, int bus, int groups, const mnlxt_connect_opts_t *opts);
+/**
+ * Disconnects netlink socket and cleans mnlxt handle, pending asynchronous requests are cancelled
  * @param handle pointer to mnlxt handle
  */
 void mnlxt_disconnect(mnlxt_handle_t *handle);
@@ -94,6 +151,60 @@ int mnlxt_send(mnlxt_handle_t *handle, struct nlmsghdr *nlh);
  * @return 0 on success, else -1
  */
 int mnlxt_receive(mnlxt_handle_t *handle, mnlxt_buffer_t *buffer);
+/**
+ * Receives netlink message into the reusable receive buffer of the handle without copying.
+ * Without a configured read size a single read of the receive buffer is done, which has at least
+ * MNL_SOCKET_BUFFER_SIZE bytes. The kernel fills datagrams up to the size of the last read, only a single message
+ * larger than it is truncated. The read fails with EMSGSIZE then and the buffer is grown to fit the next ones.
+ * @param handle pointer to mnlxt handle
+ * @param buffer pointer to buffer referring the received netlink message(s),
+ * which stay valid until the next receive on the handle
+ * @return length of received data, 0 if no data is available on a non blocking socket, else -1
+ */
+int mnlxt_receive_inplace(mnlxt_handle_t *handle, mnlxt_buffer_t *buffer);
+/**
+ * Receives netlink message into a caller provided buffer without copying
+ * @param handle pointer to mnlxt handle
+ * @param buffer pointer to buffer referring the received netlink message(s)
+ * @param buf memory to receive into
+ * @param size size of memory to receive into
+ * @return length of received data, 0 if no data is available on a non blocking socket, else -1
+ * (errno EMSGSIZE if the datagram does not fit, it is left in the socket and its size is stored in buffer->len)
+ */
+int mnlxt_receive_buf(mnlxt_handle_t *handle, mnlxt_buffer_t *buffer, char *buf, size_t size);
+/**
+ * Sets size of a single read of a connected mnlxt handle.
+ * Every datagram has to fit into it, longer ones fail with EMSGSIZE. The kernel fills dump datagrams
+ * up to the read size of the reader, but not beyond 32 KiB, which is a good value for large dumps.
+ * @param handle pointer to mnlxt handle
+ * @param size read size in bytes, or 0 for reads of the receive buffer (default, see mnlxt_receive_inplace)
+ * @return 0 on success, else -1
+ */
+int mnlxt_handle_set_read_size(mnlxt_handle_t *handle, size_t size);
+/**
+ * Sets number of datagrams read by one system call (recvmmsg) of a connected mnlxt handle.
+ * Each datagram gets a buffer of the read size (see mnlxt_handle_set_read_size).
+ * @param handle pointer to mnlxt handle
+ * @param count maximal number of datagrams per read, 0 or 1 to read single datagrams (default)
+ * @return 0 on success, else -1 (errno ENOTSUP if recvmmsg is not available)
+ */
+int mnlxt_handle_set_read_batch(mnlxt_handle_t *handle, unsigned int count);
+/**
+ * Subscribes a connected mnlxt handle to a netlink multicast group.
+ * The groups of connect are a bit mask of the groups 1 - 32, higher groups have to be added this way
+ * and e.g. RTNLGRP_NEXTHOP (32) needs the sign bit of the mask otherwise.
+ * @param handle pointer to mnlxt handle
+ * @param group number of the multicast group (RTNLGRP_* see linux/rtnetlink.h), not a bit mask
+ * @return 0 on success, else -1
+ */
+int mnlxt_handle_add_group(mnlxt_handle_t *handle, unsigned int group);
+/**
+ * Gets number of receive queue overruns of a mnlxt handle. A receive fails with ENOBUFS after an overrun,
+ * the events dropped by the kernel have to be recovered by dumping the objects again.
+ * @param handle pointer to mnlxt handle
+ * @return number of overruns since connect
+ */
+unsigned long mnlxt_handle_get_overruns(const mnlxt_handle_t *handle);
 /**
  * Gets netlink file descriptor
  * @param handle pointer to mnlxt handle
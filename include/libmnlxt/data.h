@@ -13,23 +13,46 @@
 
 #include <libmnlxt/core.h>
 
+struct mnlxt_arena_s;
+
 typedef struct mnlxt_message_s {
-	struct mnlxt_message_s *next;
+	struct mnlxt_message_s *next, *prev;
 	/** NETLINK-Message type, which it was part of */
 	uint16_t nlmsg_type;
 	/** Optional NETLINK-Request flags (NLM_F_* see linux/netlink.h) */
 	uint16_t flags;
+	/** Result of the last batch request: 0 on success, else negative error number */
+	int error;
+	/** Message and payload are allocated from the arena of a mnlxt data (see mnlxt_data_use_arena) */
+	int arena;
 	/** Message body */
 	void *payload;
 	/** Message data handler */
 	const mnlxt_data_cb_t *handler;
 } mnlxt_message_t;
 
+/**
+ * Function called for each parsed mnlxt message of a streaming mnlxt data
+ * @param message pointer to mnlxt message, it is freed after the function returns
+ * @param arg user argument given by mnlxt_data_set_stream
+ * @return 0 to continue, else to stop
+ */
+typedef int (*mnlxt_data_stream_cb_t)(mnlxt_message_t *message, void *arg);
+
 typedef struct {
 	mnlxt_message_t *first, *last;
+	/** number of stored mnlxt messages */
+	size_t count;
 	const char *error_str;
 	const mnlxt_data_cb_t *handlers;
 	size_t nhandlers;
+	/** function to pass parsed messages to instead of storing them (see mnlxt_data_set_stream) */
+	mnlxt_data_stream_cb_t stream;
+	void *stream_arg;
+	/** streaming was stopped by the function */
+	int stream_stopped;
+	/** slabs to allocate parsed messages from (see mnlxt_data_use_arena) */
+	struct mnlxt_arena_s *arena;
 	char error_buf[512];
 } mnlxt_data_t;
 
@@ -39,7 +62,7 @@ typedef struct {
  */
 mnlxt_message_t *mnlxt_message_new();
 /**
- * Frees memory allocated by mnlxt message
+ * Frees memory allocated by mnlxt message, messages allocated from an arena are left to it
  * @param message pointer to mnlxt_message_t to free
  */
 void mnlxt_message_free(mnlxt_message_t *message);
@@ -56,6 +79,25 @@ const char *mnlxt_message_type(const mnlxt_message_t *message);
  * @return 0 on success, else -1
  */
 int mnlxt_message_request(const mnlxt_message_t *message, int bus);
+/**
+ * Creates a request from a mnlxt message and sends it via an already connected mnlxt handle.
+ * The handle can be reused for any number of requests, it should not be subscribed to multicast groups.
+ * @param handle pointer to connected mnlxt handle
+ * @param message pointer to mnlxt message
+ * @return 0 on success, else -1
+ */
+int mnlxt_handle_request(mnlxt_handle_t *handle, const mnlxt_message_t *message);
+/**
+ * Sends all mnlxt messages stored in mnlxt data as batched requests via an already connected mnlxt handle.
+ * The messages are serialised back-to-back into buffers of MNL_SOCKET_BUFFER_SIZE, each buffer is sent with one
+ * system call and the acknowledges are collected by sequence number before the next buffer is sent.
+ * The result of each request is stored in the error field of its mnlxt message; messages which were not
+ * acknowledged keep -ECANCELED.
+ * @param handle pointer to connected mnlxt handle
+ * @param data pointer to mnlxt data with mnlxt messages to send
+ * @return 0 if all requests succeeded, number of failed requests (errno is set to the first error), or -1 on error
+ */
+int mnlxt_handle_batch_request(mnlxt_handle_t *handle, mnlxt_data_t *data);
 /**
  * Iterates over mnlxt data
  * @param data pointer to mnlxt data to iterate
@@ -64,18 +106,47 @@ int mnlxt_message_request(const mnlxt_message_t *message, int bus);
  */
 mnlxt_message_t *mnlxt_data_iterate(mnlxt_data_t *data, mnlxt_message_t *message);
 /**
- * Removes mnlxt message from mnlxt data
+ * Removes mnlxt message from mnlxt data in constant time
  * @param data pointer to mnlxt data to remove from
- * @param message pointer to the mnlxt message to remove NULL for the first one
+ * @param message pointer to the mnlxt message of this mnlxt data to remove, NULL for the first one
  * @return pointer to removed message or NULL for empty mnlxt data
  */
 mnlxt_message_t *mnlxt_data_remove(mnlxt_data_t *data, mnlxt_message_t *message);
+/**
+ * Gets number of mnlxt messages stored in mnlxt data
+ * @param data pointer to mnlxt data
+ * @return number of mnlxt messages
+ */
+size_t mnlxt_data_count(const mnlxt_data_t *data);
 /**
  * Adds mnlxt message to mnlxt data
  * @param data pointer to mnlxt data to add a mnlxt message to
  * @param message pointer to the mnlxt message to add
  */
 void mnlxt_data_add(mnlxt_data_t *data, mnlxt_message_t *message);
+/**
+ * Turns mnlxt data into streaming mode: each mnlxt message added to it, e.g. by parsing a dump,
+ * is passed to the given function and freed afterwards instead of being stored.
+ * If the function stops the stream, a dump via a temporary connection is aborted, while a dump via
+ * a connected mnlxt handle is read to its end without being parsed, so the handle can be reused.
+ * @param data pointer to empty mnlxt data
+ * @param cb function to call for each mnlxt message
+ * @param arg user argument to pass to the function
+ * @return 0 on success, else -1
+ */
+int mnlxt_data_set_stream(mnlxt_data_t *data, mnlxt_data_stream_cb_t cb, void *arg);
+/**
+ * Lets mnlxt data allocate all messages parsed into it, including their payloads, strings and arrays,
+ * from large slabs, which are released at once by mnlxt_data_clean.
+ * Such messages stay valid until mnlxt data is cleaned, even if removed from it, mnlxt_message_free ignores them.
+ * Their payloads must not be freed or changed by setters replacing strings or arrays, clone them to do so.
+ * Messages not parsed into it must not be added, they would not be freed.
+ * In streaming mode the slabs are reused for each message.
+ * @param data pointer to empty mnlxt data
+ * @param slab_size size of a slab, or 0 for the default of 64 KiB
+ * @return 0 on success, else -1
+ */
+int mnlxt_data_use_arena(mnlxt_data_t *data, size_t slab_size);
 /**
  * Creates netlink message header for given mnlxt message
  * @param message pointer to mnlxt message to create netlink message header for
@@ -112,5 +183,13 @@ void mnlxt_data_clean(mnlxt_data_t *data);
  * @return 0 on success, else -1
  */
 int mnlxt_data_dump(mnlxt_data_t *data, int bus, struct nlmsghdr *nlh);
+/**
+ * Dumps netlink data for given netlink message via an already connected mnlxt handle
+ * @param handle pointer to connected mnlxt handle
+ * @param data pointer to mnlxt data to store the result into
+ * @param nlh pointer to netlink message
+ * @return 0 on success, else -1
+ */
+int mnlxt_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, struct nlmsghdr *nlh);
 
 #endif /* LIBMNLXT_DATA_H_ */
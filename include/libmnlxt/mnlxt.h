@@ -28,6 +28,7 @@
 
 #include <libmnlxt/core.h>
 #include <libmnlxt/data.h>
+#include <libmnlxt/async.h>
 
 #ifdef LIBMNLXT_WITH_RTM
 #include <libmnlxt/rt.h>
@@ -16,12 +16,18 @@
 #include <libmnlxt/core.h>
 #include <libmnlxt/data.h>
 #include <libmnlxt/rt_addr.h>
+#include <libmnlxt/rt_cache.h>
 #include <libmnlxt/rt_link.h>
 #include <libmnlxt/rt_link_tun.h>
 #include <libmnlxt/rt_link_vlan.h>
 #include <libmnlxt/rt_link_xfrm.h>
+#include <libmnlxt/rt_neigh.h>
+#include <libmnlxt/rt_nexthop.h>
 #include <libmnlxt/rt_route.h>
+#include <libmnlxt/rt_route_index.h>
+#include <libmnlxt/rt_route_lpm.h>
 #include <libmnlxt/rt_rule.h>
+#include <libmnlxt/rt_stats.h>
 
 /**
  * Connects to rtnetlink socket and initializes mnlxt handle
@@ -30,6 +36,14 @@
  * @return 0 on success, else -1
  */
 int mnlxt_rt_connect(mnlxt_handle_t *handle, int groups);
+/**
+ * Connects to rtnetlink socket with socket options and initializes mnlxt handle
+ * @param handle pointer to mnlxt handle
+ * @param groups rtnetlink multicast groups to subscribe (RTMGRP_* see linux/rtnetlink.h)
+ * @param opts pointer to connect options, or NULL for defaults
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_connect_opts(mnlxt_handle_t *handle, int groups, const mnlxt_connect_opts_t *opts);
 /**
  * Dumps netlink data for given rtnetlink message type
  * @param data pointer to mnlxt data to store mnlxt messages into
@@ -44,6 +58,22 @@ int mnlxt_rt_data_dump(mnlxt_data_t *data, int type, unsigned char family);
  * @return 0 on success, else -1
  */
 int mnlxt_rt_message_request(mnlxt_message_t *message);
+/**
+ * Dumps netlink data for given rtnetlink message type via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store mnlxt messages into
+ * @param type rtnetlink message type (RTM_GET* see linux/rtnetlink.h)
+ * @param family address family (AF_* see bits/socket.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_handle_data_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, int type, unsigned char family);
+/**
+ * Creates a request from a mnlxt message and sends it via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param message pointer to mnlxt message
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_handle_message_request(mnlxt_handle_t *handle, mnlxt_message_t *message);
 
 /**
  * Create a mnlxt routing message
@@ -33,6 +33,11 @@ typedef enum {
 #define MNLXT_RT_ADDR_MAX MNLXT_RT_ADDR_CACHEINFO + 1
 } mnlxt_rt_addr_data_t;
 
+/**
+ * Address properties, which filter a dump in the kernel (see mnlxt_rt_addr_dump_filter)
+ */
+#define MNLXT_RT_ADDR_DUMP_FILTER (MNLXT_FLAG(MNLXT_RT_ADDR_FAMILY) | MNLXT_FLAG(MNLXT_RT_ADDR_IFINDEX))
+
 typedef union {
 	struct in6_addr in6;
 	struct in_addr in;
@@ -356,6 +361,15 @@ mnlxt_message_t *mnlxt_rt_addr_message(mnlxt_rt_addr_t **addr, uint16_t type, ui
  * @return 0 on success, else -1
  */
 int mnlxt_rt_addr_request(mnlxt_rt_addr_t *rt_addr, uint16_t type, uint16_t flags);
+/**
+ * Sends a netlink request with the given address information via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param rt_addr pointer to an address information structure mnlxt_rt_addr_t
+ * @param type request type (RTM_NEWADDR or RTM_DELADDR)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set to 0 for default.
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_addr_handle_request(mnlxt_handle_t *handle, mnlxt_rt_addr_t *rt_addr, uint16_t type, uint16_t flags);
 /**
  * Gets information of all addresses configured on system
  * @param data pointer to mnlxt data to store information into
@@ -363,5 +377,44 @@ int mnlxt_rt_addr_request(mnlxt_rt_addr_t *rt_addr, uint16_t type, uint16_t flag
  * @return 0 on success, else -1
  */
 int mnlxt_rt_addr_dump(mnlxt_data_t *data, unsigned char family);
+/**
+ * Gets information of all addresses configured on system via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store information into
+ * @param family address family to get the information for
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_addr_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, unsigned char family);
+/**
+ * Gets information of the addresses configured on system, which match a filter.
+ * The kernel skips the other addresses, if the dump request is checked strictly (see MNLXT_CONNECT_STRICT_CHK),
+ * older kernels ignore the filter and the dumped addresses have to be matched by mnlxt_rt_addr_match.
+ * @param data pointer to mnlxt data to store information into
+ * @param filter pointer to address with the properties to match, only MNLXT_RT_ADDR_DUMP_FILTER are supported
+ * @return 0 on success, else -1 (errno EINVAL for other properties)
+ */
+int mnlxt_rt_addr_dump_filter(mnlxt_data_t *data, const mnlxt_rt_addr_t *filter);
+/**
+ * Gets information of the addresses configured on system, which match a filter, via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect_opts with MNLXT_CONNECT_STRICT_CHK
+ * or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store information into
+ * @param filter pointer to address with the properties to match, only MNLXT_RT_ADDR_DUMP_FILTER are supported
+ * @return 0 on success, else -1 (errno EINVAL for other properties)
+ */
+int mnlxt_rt_addr_handle_dump_filter(mnlxt_handle_t *handle, mnlxt_data_t *data, const mnlxt_rt_addr_t *filter);
+/**
+ * Computes the changes turning the current addresses into the desired ones.
+ * Only the properties set in the desired addresses are compared, unchanged addresses produce no change.
+ * An address is identified by family, interface index, prefix length and local address.
+ * Addresses of the same identity but other properties are replaced by RTM_NEWADDR with NLM_F_REPLACE.
+ * New addresses are added first in the order of the desired addresses, stale addresses are deleted last.
+ * @param desired pointer to mnlxt data with the desired addresses
+ * @param current pointer to mnlxt data with the current addresses, e.g. filled by a dump
+ * @param changes pointer to mnlxt data without arena or stream to add the messages to,
+ * which are ready for @mnlxt_handle_batch_request; on failure it may hold a part of the messages
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_addr_reconcile(mnlxt_data_t *desired, mnlxt_data_t *current, mnlxt_data_t *changes);
 
 #endif /* LIBMNLXT_RT_ADDR_H_ */
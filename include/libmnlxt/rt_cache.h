@@ -0,0 +1,167 @@
+/*
+ * libmnlxt/rt_cache.h		Libmnlxt Routing Object Cache
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef LIBMNLXT_RT_CACHE_H_
+#define LIBMNLXT_RT_CACHE_H_
+
+#include <libmnlxt/rt_addr.h>
+#include <libmnlxt/rt_link.h>
+#include <libmnlxt/rt_route.h>
+#include <libmnlxt/rt_rule.h>
+
+typedef enum {
+	MNLXT_RT_CACHE_LINK = 0,
+	MNLXT_RT_CACHE_ADDR,
+	MNLXT_RT_CACHE_ROUTE,
+	MNLXT_RT_CACHE_RULE
+#define MNLXT_RT_CACHE_MAX MNLXT_RT_CACHE_RULE + 1
+} mnlxt_rt_cache_object_t;
+
+/**
+ * Cache of links, addresses, routes and rules kept in sync with the kernel by rtnetlink events.
+ * The events are subscribed before the objects are dumped. Events arriving during the dump are queued by the event
+ * socket and applied after it in order, so the last event of an object wins over the dumped state.
+ * Lookups and iterations are served from memory; the objects are dumped again only if the event socket overruns.
+ */
+typedef struct mnlxt_rt_cache_s mnlxt_rt_cache_t;
+
+/**
+ * Function to get notified about changes of the cache
+ * @param type rtnetlink message type of the change, RTM_NEW* or RTM_DEL* of the object
+ * @param object kind of the changed object
+ * @param payload pointer to the new object, or to the removed object which is freed after the call
+ * @param arg user argument
+ */
+typedef void (*mnlxt_rt_cache_change_cb_t)(uint16_t type, mnlxt_rt_cache_object_t object, const void *payload,
+																					 void *arg);
+
+/**
+ * Creates a cache, subscribes to the events of the cached objects and dumps them
+ * @param objects objects to cache, use macro MNLXT_FLAG to create it from mnlxt_rt_cache_object_t
+ * @return pointer to new dynamically allocated cache, or NULL
+ */
+mnlxt_rt_cache_t *mnlxt_rt_cache_new(uint64_t objects);
+/**
+ * Frees cache with all its objects and closes its sockets
+ * @param cache pointer to cache
+ */
+void mnlxt_rt_cache_free(mnlxt_rt_cache_t *cache);
+/**
+ * Gets file descriptor of the non blocking event socket to poll for @mnlxt_rt_cache_process
+ * @param cache pointer to cache
+ * @return file descriptor on success, or -1
+ */
+int mnlxt_rt_cache_get_fd(const mnlxt_rt_cache_t *cache);
+/**
+ * Sets function to get notified about changes, applied events and the differences found by a resync
+ * @param cache pointer to cache
+ * @param cb function to call, or NULL
+ * @param arg user argument passed to the function
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_cache_set_change_cb(mnlxt_rt_cache_t *cache, mnlxt_rt_cache_change_cb_t cb, void *arg);
+/**
+ * Enables or disables the automatic resync of @mnlxt_rt_cache_process after an overrun (enabled by default)
+ * @param cache pointer to cache
+ * @param enable 0 to let @mnlxt_rt_cache_process fail with ENOBUFS instead
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_cache_set_auto_resync(mnlxt_rt_cache_t *cache, int enable);
+/**
+ * Applies all queued events to the cache without blocking; the objects are dumped again on overrun (ENOBUFS)
+ * @param cache pointer to cache
+ * @return number of applied events, else -1
+ */
+int mnlxt_rt_cache_process(mnlxt_rt_cache_t *cache);
+/**
+ * Replaces the cached objects by a new dump and applies the events queued meanwhile.
+ * Only the objects of the subscribed groups are dumped. Objects which are new or changed by the dump are passed
+ * as RTM_NEW*, vanished objects as RTM_DEL* to the change function.
+ * @param cache pointer to cache
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_cache_resync(mnlxt_rt_cache_t *cache);
+/**
+ * Gets number of overruns of the event socket
+ * @param cache pointer to cache
+ * @return number of overruns
+ */
+unsigned long mnlxt_rt_cache_overruns(const mnlxt_rt_cache_t *cache);
+/**
+ * Gets error string of the last failed operation
+ * @param cache pointer to cache
+ * @return error string, or NULL
+ */
+const char *mnlxt_rt_cache_error(const mnlxt_rt_cache_t *cache);
+/**
+ * Gets number of cached objects
+ * @param cache pointer to cache
+ * @param object kind of objects
+ * @return number of objects
+ */
+size_t mnlxt_rt_cache_count(const mnlxt_rt_cache_t *cache, mnlxt_rt_cache_object_t object);
+/**
+ * Looks up link by interface index
+ * @param cache pointer to cache
+ * @param index interface index
+ * @return pointer to cached link information, or NULL if not found
+ */
+mnlxt_rt_link_t *mnlxt_rt_cache_link_lookup(const mnlxt_rt_cache_t *cache, uint32_t index);
+/**
+ * Iterates over cached links
+ * @param cache pointer to cache
+ * @param iterator pointer to iterator, which should be NULL for the first call
+ * @return pointer to next link information, or NULL at the end
+ */
+mnlxt_rt_link_t *mnlxt_rt_cache_link_iterate(const mnlxt_rt_cache_t *cache, void **iterator);
+/**
+ * Looks up address by family, interface index, prefix length, address and local address
+ * @param cache pointer to cache
+ * @param key pointer to address information with the properties to look for
+ * @return pointer to cached address information, or NULL if not found
+ */
+mnlxt_rt_addr_t *mnlxt_rt_cache_addr_lookup(const mnlxt_rt_cache_t *cache, const mnlxt_rt_addr_t *key);
+/**
+ * Iterates over cached addresses
+ * @param cache pointer to cache
+ * @param iterator pointer to iterator, which should be NULL for the first call
+ * @return pointer to next address information, or NULL at the end
+ */
+mnlxt_rt_addr_t *mnlxt_rt_cache_addr_iterate(const mnlxt_rt_cache_t *cache, void **iterator);
+/**
+ * Looks up route with the same identity, see @mnlxt_rt_route_index_lookup
+ * @param cache pointer to cache
+ * @param key pointer to route information with the identity properties to look for
+ * @return pointer to cached route information, or NULL if not found
+ */
+mnlxt_rt_route_t *mnlxt_rt_cache_route_lookup(const mnlxt_rt_cache_t *cache, const mnlxt_rt_route_t *key);
+/**
+ * Iterates over cached routes
+ * @param cache pointer to cache
+ * @param iterator pointer to iterator, which should be NULL for the first call
+ * @return pointer to next route information, or NULL at the end
+ */
+mnlxt_rt_route_t *mnlxt_rt_cache_route_iterate(const mnlxt_rt_cache_t *cache, void **iterator);
+/**
+ * Looks up rule with equal properties
+ * @param cache pointer to cache
+ * @param key pointer to rule information
+ * @return pointer to cached rule information, or NULL if not found
+ */
+mnlxt_rt_rule_t *mnlxt_rt_cache_rule_lookup(const mnlxt_rt_cache_t *cache, const mnlxt_rt_rule_t *key);
+/**
+ * Iterates over cached rules
+ * @param cache pointer to cache
+ * @param iterator pointer to iterator, which should be NULL for the first call
+ * @return pointer to next rule information, or NULL at the end
+ */
+mnlxt_rt_rule_t *mnlxt_rt_cache_rule_iterate(const mnlxt_rt_cache_t *cache, void **iterator);
+
+#endif /* LIBMNLXT_RT_CACHE_H_ */
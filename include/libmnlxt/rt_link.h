@@ -34,6 +34,11 @@ typedef enum {
 #define MNLXT_RT_LINK_MAX MNLXT_RT_LINK_INFO + 1
 } mnlxt_rt_link_data_t;
 
+/**
+ * Link properties, which filter a dump in the kernel (see mnlxt_rt_link_dump_filter)
+ */
+#define MNLXT_RT_LINK_DUMP_FILTER (MNLXT_FLAG(MNLXT_RT_LINK_MASTER) | MNLXT_FLAG(MNLXT_RT_LINK_INFO))
+
 /** Hardware address type definition */
 typedef uint8_t mnlxt_eth_addr_t[ETH_ALEN];
 /** Hardware address type backwards compatibility */
@@ -490,11 +495,44 @@ mnlxt_message_t *mnlxt_rt_link_message(mnlxt_rt_link_t **link, uint16_t type, ui
  * @return 0 on success, else -1
  */
 int mnlxt_rt_link_request(mnlxt_rt_link_t *rt_link, uint16_t type, uint16_t flags);
+/**
+ * Sends a netlink request with information from the given link instance via an already connected mnlxt handle.
+ * In case of successful execution of RTM_NEWLINK-request, index of the new interface will be set on link instance.
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param rt_link pointer to a link instance mnlxt_rt_link_t
+ * @param type request type (RTM_NEWLINK, RTM_DELLINK or RTM_SETLINK)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set to 0 for default.
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_link_handle_request(mnlxt_handle_t *handle, mnlxt_rt_link_t *rt_link, uint16_t type, uint16_t flags);
 /**
  * Gets information of all links configured on system
  * @param data pointer to mnlxt data to store information into
  * @return 0 on success, else -1
  */
 int mnlxt_rt_link_dump(mnlxt_data_t *data);
+/**
+ * Gets information of all links configured on system via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store information into
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_link_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data);
+/**
+ * Gets information of the links configured on system, which match a filter of master and information kind.
+ * Older kernels ignore the filter and the dumped links have to be matched by mnlxt_rt_link_match.
+ * @param data pointer to mnlxt data to store information into
+ * @param filter pointer to link with the properties to match, only MNLXT_RT_LINK_DUMP_FILTER are supported
+ * @return 0 on success, else -1 (errno EINVAL for other properties)
+ */
+int mnlxt_rt_link_dump_filter(mnlxt_data_t *data, const mnlxt_rt_link_t *filter);
+/**
+ * Gets information of the links configured on system, which match a filter, via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store information into
+ * @param filter pointer to link with the properties to match, only MNLXT_RT_LINK_DUMP_FILTER are supported
+ * @return 0 on success, else -1 (errno EINVAL for other properties)
+ */
+int mnlxt_rt_link_handle_dump_filter(mnlxt_handle_t *handle, mnlxt_data_t *data, const mnlxt_rt_link_t *filter);
 
 #endif /* LIBMNLXT_RT_LINK_H_ */
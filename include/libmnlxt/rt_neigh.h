@@ -0,0 +1,330 @@
+/*
+ * libmnlxt/rt_neigh.h		Libmnlxt Routing Neighbours
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef LIBMNLXT_RT_NEIGH_H_
+#define LIBMNLXT_RT_NEIGH_H_
+
+#include <linux/neighbour.h>
+
+#include <libmnlxt/rt_addr.h>
+#include <libmnlxt/rt_link.h>
+
+typedef enum {
+	MNLXT_RT_NEIGH_FAMILY = 0,
+	MNLXT_RT_NEIGH_IFINDEX,
+	MNLXT_RT_NEIGH_STATE,
+	MNLXT_RT_NEIGH_FLAGS,
+	MNLXT_RT_NEIGH_TYPE,
+	MNLXT_RT_NEIGH_DST,
+	MNLXT_RT_NEIGH_LLADDR,
+	MNLXT_RT_NEIGH_VLAN
+#define MNLXT_RT_NEIGH_MAX MNLXT_RT_NEIGH_VLAN + 1
+} mnlxt_rt_neigh_data_t;
+
+typedef struct {
+	/** Properties flags */
+	uint16_t prop_flags;
+	/** Address family: AF_INET (ARP), AF_INET6 (ND) or AF_BRIDGE (forwarding database) */
+	uint8_t family;
+	/** Neighbour flags, NTF_* see linux/neighbour.h */
+	uint8_t flags;
+	/** Neighbour state, NUD_* see linux/neighbour.h
+	 * NUD_PERMANENT    static entry, never expires
+	 * NUD_NOARP        valid entry without resolution
+	 * NUD_REACHABLE    valid entry until the reachable time expires
+	 */
+	uint16_t state;
+	/** Routing type of the neighbour, usually RTN_UNICAST; @see mnlxt_rt_route_t */
+	uint8_t type;
+	/** Interface index */
+	uint32_t if_index;
+	/** Network address of the neighbour */
+	mnlxt_inet_addr_t dst;
+	/** Link layer address of the neighbour */
+	mnlxt_eth_addr_t lladdr;
+	/** VLAN ID of a forwarding database entry */
+	uint16_t vlan;
+} mnlxt_rt_neigh_t;
+
+/**
+ * Creates a new neighbour information
+ * @return pointer to new dynamically allocated neighbour information structure
+ */
+mnlxt_rt_neigh_t *mnlxt_rt_neigh_new();
+/**
+ * Makes a copy of a neighbour information structure
+ * @param neigh source neighbour to copy from
+ * @param filter data filter. In case of 0, the function is equal to @mnlxt_rt_neigh_new().
+ * Use macro MNLXT_FLAG to create filter from @mnlxt_rt_neigh_data_t.
+ * @return pointer to copy on success, else NULL
+ */
+mnlxt_rt_neigh_t *mnlxt_rt_neigh_clone(const mnlxt_rt_neigh_t *neigh, uint64_t filter);
+/**
+ * Frees memory allocated by a neighbour information structure
+ * @param neigh pointer to neighbour information structure to free
+ */
+void mnlxt_rt_neigh_free(mnlxt_rt_neigh_t *neigh);
+/**
+ * Callback wrapper for mnlxt_rt_neigh_free
+ * @param neigh neighbour information structure to free given by void pointer
+ */
+static inline void mnlxt_rt_neigh_FREE(void *neigh) {
+	mnlxt_rt_neigh_free((mnlxt_rt_neigh_t *)neigh);
+}
+/**
+ * Sets address family on neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param family address family (AF_INET, AF_INET6 or AF_BRIDGE)
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_set_family(mnlxt_rt_neigh_t *neigh, uint8_t family);
+/**
+ * Gets address family from neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param family pointer to buffer to save address family
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_neigh_get_family(const mnlxt_rt_neigh_t *neigh, uint8_t *family);
+/**
+ * Sets interface index on neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param if_index interface index
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_set_ifindex(mnlxt_rt_neigh_t *neigh, uint32_t if_index);
+/**
+ * Gets interface index from neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param if_index pointer to buffer to save interface index
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_neigh_get_ifindex(const mnlxt_rt_neigh_t *neigh, uint32_t *if_index);
+/**
+ * Sets state on neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param state neighbour state (NUD_* see linux/neighbour.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_set_state(mnlxt_rt_neigh_t *neigh, uint16_t state);
+/**
+ * Gets state from neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param state pointer to buffer to save neighbour state
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_neigh_get_state(const mnlxt_rt_neigh_t *neigh, uint16_t *state);
+/**
+ * Sets flags on neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param flags neighbour flags (NTF_* see linux/neighbour.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_set_flags(mnlxt_rt_neigh_t *neigh, uint8_t flags);
+/**
+ * Gets flags from neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param flags pointer to buffer to save neighbour flags
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_neigh_get_flags(const mnlxt_rt_neigh_t *neigh, uint8_t *flags);
+/**
+ * Sets routing type on neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param type routing type (RTN_* see linux/rtnetlink.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_set_type(mnlxt_rt_neigh_t *neigh, uint8_t type);
+/**
+ * Gets routing type from neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param type pointer to buffer to save routing type
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_neigh_get_type(const mnlxt_rt_neigh_t *neigh, uint8_t *type);
+/**
+ * Sets network address on neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param family address family (AF_INET or AF_INET6)
+ * @param buf pointer to buffer with network address
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_set_dst(mnlxt_rt_neigh_t *neigh, uint8_t family, const mnlxt_inet_addr_t *buf);
+/**
+ * Gets network address from neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param family pointer to buffer to save address family
+ * @param buf pointer to buffer to save pointer to network address
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_neigh_get_dst(const mnlxt_rt_neigh_t *neigh, uint8_t *family, const mnlxt_inet_addr_t **buf);
+/**
+ * Sets link layer address on neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param lladdr link layer address
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_set_lladdr(mnlxt_rt_neigh_t *neigh, mnlxt_eth_addr_t lladdr);
+/**
+ * Gets link layer address from neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param lladdr pointer to buffer to save link layer address
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_neigh_get_lladdr(const mnlxt_rt_neigh_t *neigh, mnlxt_eth_addr_t *lladdr);
+/**
+ * Sets VLAN ID on neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param vlan VLAN ID of a forwarding database entry
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_set_vlan(mnlxt_rt_neigh_t *neigh, uint16_t vlan);
+/**
+ * Gets VLAN ID from neighbour information
+ * @param neigh pointer to neighbour information structure
+ * @param vlan pointer to buffer to save VLAN ID
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_neigh_get_vlan(const mnlxt_rt_neigh_t *neigh, uint16_t *vlan);
+
+/**
+ * Checks if a neighbour information matches another one
+ * @param neigh pointer to neighbour information to check
+ * @param match pointer to neighbour information to match
+ * @return 0 for matching, else MNLXT_RT_NEIGH_* + 1 for property which does not match
+ */
+int mnlxt_rt_neigh_match(const mnlxt_rt_neigh_t *neigh, const mnlxt_rt_neigh_t *match);
+/**
+ * Compares two neighbour structures
+ * @param neigh1 pointer to first neighbour information
+ * @param neigh2 pointer to second neighbour information
+ * @param filter data filter for selecting neighbour properties to compare. Use macro MNLXT_FLAG to create filter from
+ * @mnlxt_rt_neigh_data_t.
+ * @return 0 for equal, else MNLXT_RT_NEIGH_* + 1 for property which does not match
+ */
+int mnlxt_rt_neigh_compare(const mnlxt_rt_neigh_t *neigh1, const mnlxt_rt_neigh_t *neigh2, uint64_t filter);
+
+/**
+ * Initializes netlink message from neighbour information
+ * @param nlh pointer to netlink message header to initialize
+ * @param neigh pointer to neighbour information structure
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_put(struct nlmsghdr *nlh, const mnlxt_rt_neigh_t *neigh);
+/**
+ * Callback wrapper at mnlxt_rt_neigh_put
+ * @param nlh nlh pointer to netlink message header to initialize
+ * @param neigh neighbour information structure given by void pointer
+ * @param nlmsg_type message type (will be ignored)
+ * @return 0 on success, else -1
+ */
+static inline int mnlxt_rt_neigh_PUT(struct nlmsghdr *nlh, const void *neigh, uint16_t nlmsg_type) {
+	(void)nlmsg_type;
+	return mnlxt_rt_neigh_put(nlh, (mnlxt_rt_neigh_t *)neigh);
+}
+
+/**
+ * Parses netlink message into neighbour information and stores it into mnlxt data
+ * @param nlh pointer to netlink message
+ * @param data pointer to mnlxt data
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+int mnlxt_rt_neigh_data(const struct nlmsghdr *nlh, mnlxt_data_t *data);
+/**
+ * Callback wrapper for mnlxt_rt_neigh_data
+ * @param nlh pointer to netlink message
+ * @param data mnlxt data given by void pointer
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+static inline int mnlxt_rt_neigh_DATA(const struct nlmsghdr *nlh, void *data) {
+	return mnlxt_rt_neigh_data(nlh, (mnlxt_data_t *)data);
+}
+
+/**
+ * Iterates over neighbour informations stored in mnlxt data
+ * @param data pointer to mnlxt data
+ * @param iterator data iterator; this pointer have to be initialized with NULL before iteration
+ * @return pointer to the next neighbour information or NULL for the end of iteration
+ */
+mnlxt_rt_neigh_t *mnlxt_rt_neigh_iterate(mnlxt_data_t *data, mnlxt_message_t **iterator);
+/**
+ * Gets neighbour information from mnlxt message.
+ * In case, if you will handle the neighbour information independently from the mnlxt message use
+ * @mnlxt_rt_neigh_remove instead. Or clone it with @mnlxt_rt_neigh_clone before calling @mnlxt_message_free.
+ * @param message pointer to mnlxt message
+ * @return pointer to neighbour information structure on success, else NULL
+ */
+mnlxt_rt_neigh_t *mnlxt_rt_neigh_get(const mnlxt_message_t *message);
+/**
+ * Removes neighbour information from mnlxt message.
+ * Unlike @mnlxt_rt_neigh_get it will detach neighbour information from the message.
+ * @param message pointer to mnlxt message
+ * @return pointer to neighbour information structure on success, else NULL
+ */
+mnlxt_rt_neigh_t *mnlxt_rt_neigh_remove(mnlxt_message_t *message);
+/**
+ * Creates a mnlxt message and stores the given neighbour information into it.
+ * Many entries are programmed at once by adding their messages to mnlxt data and sending them by
+ * @mnlxt_handle_batch_request.
+ * @param neigh double pointer to a neighbour information structure mnlxt_rt_neigh_t
+ * @param type message type (RTM_NEWNEIGH or RTM_DELNEIGH)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set to 0 for default.
+ * @return pointer to mnlxt message on success (pointer to the given neighbour will be reset) else NULL
+ */
+mnlxt_message_t *mnlxt_rt_neigh_message(mnlxt_rt_neigh_t **neigh, uint16_t type, uint16_t flags);
+
+/**
+ * Sends a netlink request with the given neighbour information.
+ * Events of neighbours are received after subscribing RTMGRP_NEIGH.
+ * @param neigh pointer to a neighbour information structure mnlxt_rt_neigh_t
+ * @param type request type (RTM_NEWNEIGH or RTM_DELNEIGH)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set to 0 for default.
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_request(mnlxt_rt_neigh_t *neigh, uint16_t type, uint16_t flags);
+/**
+ * Sends a netlink request with the given neighbour information via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param neigh pointer to a neighbour information structure mnlxt_rt_neigh_t
+ * @param type request type (RTM_NEWNEIGH or RTM_DELNEIGH)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set to 0 for default.
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_handle_request(mnlxt_handle_t *handle, mnlxt_rt_neigh_t *neigh, uint16_t type, uint16_t flags);
+/**
+ * Gets information of all neighbours configured on system
+ * @param data pointer to mnlxt data to store information into
+ * @param family neighbour family to get the information for (AF_UNSPEC for all)
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_dump(mnlxt_data_t *data, unsigned char family);
+/**
+ * Gets information of all neighbours configured on system via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store information into
+ * @param family neighbour family to get the information for (AF_UNSPEC for all)
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, unsigned char family);
+/**
+ * Computes the changes turning the current neighbours into the desired ones.
+ * Only the properties set in the desired neighbours are compared, unchanged neighbours produce no change.
+ * A neighbour is identified by family, interface index and destination, a bridge forwarding entry
+ * by interface index, link layer address and VLAN.
+ * Neighbours of the same identity but other properties are replaced by RTM_NEWNEIGH with NLM_F_REPLACE.
+ * New neighbours are added first in the order of the desired neighbours, stale neighbours are deleted last.
+ * @param desired pointer to mnlxt data with the desired neighbours
+ * @param current pointer to mnlxt data with the current neighbours, e.g. filled by a dump
+ * @param changes pointer to mnlxt data without arena or stream to add the messages to,
+ * which are ready for @mnlxt_handle_batch_request; on failure it may hold a part of the messages
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_neigh_reconcile(mnlxt_data_t *desired, mnlxt_data_t *current, mnlxt_data_t *changes);
+
+#endif /* LIBMNLXT_RT_NEIGH_H_ */
@@ -0,0 +1,338 @@
+/*
+ * libmnlxt/rt_nexthop.h		Libmnlxt Routing Nexthops
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef LIBMNLXT_RT_NEXTHOP_H_
+#define LIBMNLXT_RT_NEXTHOP_H_
+
+#include <linux/nexthop.h>
+
+#include <libmnlxt/rt_addr.h>
+
+typedef enum {
+	MNLXT_RT_NEXTHOP_FAMILY = 0,
+	MNLXT_RT_NEXTHOP_PROTOCOL,
+	MNLXT_RT_NEXTHOP_FLAGS,
+	MNLXT_RT_NEXTHOP_ID,
+	MNLXT_RT_NEXTHOP_OIFINDEX,
+	MNLXT_RT_NEXTHOP_GATEWAY,
+	MNLXT_RT_NEXTHOP_BLACKHOLE,
+	MNLXT_RT_NEXTHOP_GROUP,
+	MNLXT_RT_NEXTHOP_GROUP_TYPE
+#define MNLXT_RT_NEXTHOP_MAX MNLXT_RT_NEXTHOP_GROUP_TYPE + 1
+} mnlxt_rt_nexthop_data_t;
+
+typedef struct {
+	/** ID of the member nexthop */
+	uint32_t id;
+	/** Weight of the member nexthop, 1 - 256 */
+	uint16_t weight;
+} mnlxt_rt_nexthop_grp_t;
+
+typedef struct {
+	/** Properties flags */
+	uint16_t prop_flags;
+	/** Address family of the nexthop, AF_UNSPEC for groups and blackholes */
+	uint8_t family;
+	/** Routing protocol, which installed the nexthop; @see mnlxt_rt_route_t */
+	uint8_t protocol;
+	/** Nexthop flags, RTNH_F_* see linux/rtnetlink.h */
+	uint32_t flags;
+	/** Nexthop object ID, which is referred by routes and groups */
+	uint32_t id;
+	/** Output interface index */
+	uint32_t oif_index;
+	/** Nexthop gateway address */
+	mnlxt_inet_addr_t gateway;
+	/** Group type; linux/nexthop.h
+	 * NEXTHOP_GRP_TYPE_MPATH   hash-threshold multipath
+	 */
+	uint16_t group_type;
+	/** Number of group members */
+	uint16_t group_size;
+	/** Group members, a group is a nexthop of other nexthops */
+	mnlxt_rt_nexthop_grp_t *group;
+} mnlxt_rt_nexthop_t;
+
+/**
+ * Creates a new nexthop information
+ * @return pointer to new dynamically allocated nexthop information structure
+ */
+mnlxt_rt_nexthop_t *mnlxt_rt_nexthop_new();
+/**
+ * Makes a copy of a nexthop information structure
+ * @param nexthop source nexthop to copy from
+ * @param filter data filter. In case of 0, the function is equal to @mnlxt_rt_nexthop_new().
+ * Use macro MNLXT_FLAG to create filter from @mnlxt_rt_nexthop_data_t.
+ * @return pointer to copy on success, else NULL
+ */
+mnlxt_rt_nexthop_t *mnlxt_rt_nexthop_clone(const mnlxt_rt_nexthop_t *nexthop, uint64_t filter);
+/**
+ * Frees memory allocated by a nexthop information structure
+ * @param nexthop pointer to nexthop information structure to free
+ */
+void mnlxt_rt_nexthop_free(mnlxt_rt_nexthop_t *nexthop);
+/**
+ * Callback wrapper for mnlxt_rt_nexthop_free
+ * @param nexthop nexthop information structure to free given by void pointer
+ */
+static inline void mnlxt_rt_nexthop_FREE(void *nexthop) {
+	mnlxt_rt_nexthop_free((mnlxt_rt_nexthop_t *)nexthop);
+}
+/**
+ * Sets address family on nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param family address family
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_set_family(mnlxt_rt_nexthop_t *nexthop, uint8_t family);
+/**
+ * Gets address family from nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param family pointer to buffer to save address family
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_nexthop_get_family(const mnlxt_rt_nexthop_t *nexthop, uint8_t *family);
+/**
+ * Sets routing protocol on nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param protocol routing protocol
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_set_protocol(mnlxt_rt_nexthop_t *nexthop, uint8_t protocol);
+/**
+ * Gets routing protocol from nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param protocol pointer to buffer to save routing protocol
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_nexthop_get_protocol(const mnlxt_rt_nexthop_t *nexthop, uint8_t *protocol);
+/**
+ * Sets nexthop flags on nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param flags nexthop flags (RTNH_F_* see linux/rtnetlink.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_set_flags(mnlxt_rt_nexthop_t *nexthop, uint32_t flags);
+/**
+ * Gets nexthop flags from nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param flags pointer to buffer to save nexthop flags
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_nexthop_get_flags(const mnlxt_rt_nexthop_t *nexthop, uint32_t *flags);
+/**
+ * Sets nexthop object ID on nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param id nexthop object ID, 0 lets the kernel choose one on creation
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_set_id(mnlxt_rt_nexthop_t *nexthop, uint32_t id);
+/**
+ * Gets nexthop object ID from nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param id pointer to buffer to save nexthop object ID
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_nexthop_get_id(const mnlxt_rt_nexthop_t *nexthop, uint32_t *id);
+/**
+ * Sets output interface on nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param if_index output interface index
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_set_oifindex(mnlxt_rt_nexthop_t *nexthop, uint32_t if_index);
+/**
+ * Gets output interface from nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param if_index pointer to buffer to save output interface index
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_nexthop_get_oifindex(const mnlxt_rt_nexthop_t *nexthop, uint32_t *if_index);
+/**
+ * Sets gateway address on nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param family address family
+ * @param buf pointer to buffer with gateway address
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_set_gateway(mnlxt_rt_nexthop_t *nexthop, uint8_t family, const mnlxt_inet_addr_t *buf);
+/**
+ * Gets gateway address from nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param family pointer to buffer to save address family
+ * @param buf pointer to buffer to save pointer to gateway address
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_nexthop_get_gateway(const mnlxt_rt_nexthop_t *nexthop, uint8_t *family, const mnlxt_inet_addr_t **buf);
+/**
+ * Sets nexthop information as blackhole, which drops the packets
+ * @param nexthop pointer to nexthop information structure
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_set_blackhole(mnlxt_rt_nexthop_t *nexthop);
+/**
+ * Checks if nexthop information is a blackhole
+ * @param nexthop pointer to nexthop information structure
+ * @return 0 for a blackhole, 1 on not set, else -1
+ */
+int mnlxt_rt_nexthop_get_blackhole(const mnlxt_rt_nexthop_t *nexthop);
+/**
+ * Sets group members on nexthop information, which makes it a nexthop group
+ * @param nexthop pointer to nexthop information structure
+ * @param group pointer to array of group members to copy
+ * @param size number of group members
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_set_group(mnlxt_rt_nexthop_t *nexthop, const mnlxt_rt_nexthop_grp_t *group, uint16_t size);
+/**
+ * Gets group members from nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param group pointer to buffer to save pointer to array of group members
+ * @param size pointer to buffer to save number of group members
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_nexthop_get_group(const mnlxt_rt_nexthop_t *nexthop, const mnlxt_rt_nexthop_grp_t **group,
+															 uint16_t *size);
+/**
+ * Sets group type on nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param group_type group type (NEXTHOP_GRP_TYPE_* see linux/nexthop.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_set_group_type(mnlxt_rt_nexthop_t *nexthop, uint16_t group_type);
+/**
+ * Gets group type from nexthop information
+ * @param nexthop pointer to nexthop information structure
+ * @param group_type pointer to buffer to save group type
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_nexthop_get_group_type(const mnlxt_rt_nexthop_t *nexthop, uint16_t *group_type);
+
+/**
+ * Checks if a nexthop information matches another one
+ * @param nexthop pointer to nexthop information to check
+ * @param match pointer to nexthop information to match
+ * @return 0 for matching, else MNLXT_RT_NEXTHOP_* + 1 for property which does not match
+ */
+int mnlxt_rt_nexthop_match(const mnlxt_rt_nexthop_t *nexthop, const mnlxt_rt_nexthop_t *match);
+/**
+ * Compares two nexthop structures
+ * @param nexthop1 pointer to first nexthop information
+ * @param nexthop2 pointer to second nexthop information
+ * @param filter data filter for selecting nexthop properties to compare. Use macro MNLXT_FLAG to create filter from
+ * @mnlxt_rt_nexthop_data_t.
+ * @return 0 for equal, else MNLXT_RT_NEXTHOP_* + 1 for property which does not match
+ */
+int mnlxt_rt_nexthop_compare(const mnlxt_rt_nexthop_t *nexthop1, const mnlxt_rt_nexthop_t *nexthop2, uint64_t filter);
+
+/**
+ * Initializes netlink message from nexthop information
+ * @param nlh pointer to netlink message header to initialize
+ * @param nexthop pointer to nexthop information structure
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_put(struct nlmsghdr *nlh, const mnlxt_rt_nexthop_t *nexthop);
+/**
+ * Callback wrapper at mnlxt_rt_nexthop_put
+ * @param nlh nlh pointer to netlink message header to initialize
+ * @param nexthop nexthop information structure given by void pointer
+ * @param nlmsg_type message type (will be ignored)
+ * @return 0 on success, else -1
+ */
+static inline int mnlxt_rt_nexthop_PUT(struct nlmsghdr *nlh, const void *nexthop, uint16_t nlmsg_type) {
+	(void)nlmsg_type;
+	return mnlxt_rt_nexthop_put(nlh, (mnlxt_rt_nexthop_t *)nexthop);
+}
+
+/**
+ * Parses netlink message into nexthop information and stores it into mnlxt data
+ * @param nlh pointer to netlink message
+ * @param data pointer to mnlxt data
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+int mnlxt_rt_nexthop_data(const struct nlmsghdr *nlh, mnlxt_data_t *data);
+/**
+ * Callback wrapper for mnlxt_rt_nexthop_data
+ * @param nlh pointer to netlink message
+ * @param data mnlxt data given by void pointer
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+static inline int mnlxt_rt_nexthop_DATA(const struct nlmsghdr *nlh, void *data) {
+	return mnlxt_rt_nexthop_data(nlh, (mnlxt_data_t *)data);
+}
+
+/**
+ * Iterates over nexthop informations stored in mnlxt data
+ * @param data pointer to mnlxt data
+ * @param iterator data iterator; this pointer have to be initialized with NULL before iteration
+ * @return pointer to the next nexthop information or NULL for the end of iteration
+ */
+mnlxt_rt_nexthop_t *mnlxt_rt_nexthop_iterate(mnlxt_data_t *data, mnlxt_message_t **iterator);
+/**
+ * Gets nexthop information from mnlxt message.
+ * In case, if you will handle the nexthop information independently from the mnlxt message use
+ * @mnlxt_rt_nexthop_remove instead. Or clone it with @mnlxt_rt_nexthop_clone before calling @mnlxt_message_free.
+ * @param message pointer to mnlxt message
+ * @return pointer to nexthop information structure on success, else NULL
+ */
+mnlxt_rt_nexthop_t *mnlxt_rt_nexthop_get(const mnlxt_message_t *message);
+/**
+ * Removes nexthop information from mnlxt message.
+ * Unlike @mnlxt_rt_nexthop_get it will detach nexthop information from the message.
+ * @param message pointer to mnlxt message
+ * @return pointer to nexthop information structure on success, else NULL
+ */
+mnlxt_rt_nexthop_t *mnlxt_rt_nexthop_remove(mnlxt_message_t *message);
+/**
+ * Creates a mnlxt message and stores the given nexthop information into it
+ * @param nexthop double pointer to a nexthop information structure mnlxt_rt_nexthop_t
+ * @param type message type (RTM_NEWNEXTHOP or RTM_DELNEXTHOP)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set to 0 for default.
+ * @return pointer to mnlxt message on success (pointer to the given nexthop will be reset) else NULL
+ */
+mnlxt_message_t *mnlxt_rt_nexthop_message(mnlxt_rt_nexthop_t **nexthop, uint16_t type, uint16_t flags);
+
+/**
+ * Sends a netlink request with the given nexthop information.
+ * Events of nexthops are received after subscribing RTNLGRP_NEXTHOP by mnlxt_handle_add_group.
+ * Replacing a nexthop or the members of a group (NLM_F_REPLACE) moves all routes using it at once.
+ * @param nexthop pointer to a nexthop information structure mnlxt_rt_nexthop_t
+ * @param type request type (RTM_NEWNEXTHOP or RTM_DELNEXTHOP)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set to 0 for default.
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_request(mnlxt_rt_nexthop_t *nexthop, uint16_t type, uint16_t flags);
+/**
+ * Sends a netlink request with the given nexthop information via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param nexthop pointer to a nexthop information structure mnlxt_rt_nexthop_t
+ * @param type request type (RTM_NEWNEXTHOP or RTM_DELNEXTHOP)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set to 0 for default.
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_handle_request(mnlxt_handle_t *handle, mnlxt_rt_nexthop_t *nexthop, uint16_t type,
+																		uint16_t flags);
+/**
+ * Gets information of all nexthops and nexthop groups configured on system
+ * @param data pointer to mnlxt data to store information into
+ * @param family nexthop family to get the information for
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_dump(mnlxt_data_t *data, unsigned char family);
+/**
+ * Gets information of all nexthops and nexthop groups configured on system via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store information into
+ * @param family nexthop family to get the information for
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_nexthop_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, unsigned char family);
+
+#endif /* LIBMNLXT_RT_NEXTHOP_H_ */
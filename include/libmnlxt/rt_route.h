@@ -26,22 +26,43 @@ typedef enum {
 	MNLXT_RT_ROUTE_DST_PREFIX,
 	MNLXT_RT_ROUTE_SRC,
 	MNLXT_RT_ROUTE_DST,
-	MNLXT_RT_ROUTE_GATEWAY
-#define MNLXT_RT_ROUTE_MAX MNLXT_RT_ROUTE_GATEWAY + 1
+	MNLXT_RT_ROUTE_GATEWAY,
+	MNLXT_RT_ROUTE_NH_ID,
+	MNLXT_RT_ROUTE_MULTIPATH
+#define MNLXT_RT_ROUTE_MAX MNLXT_RT_ROUTE_MULTIPATH + 1
 } mnlxt_rt_route_data_t;
 
+typedef struct {
+	/** Output interface index of the path */
+	uint32_t oif_index;
+	/** Weight of the path, 1 - 256 */
+	uint16_t weight;
+	/** Nexthop flags of the path, RTNH_F_* see linux/rtnetlink.h */
+	uint8_t flags;
+	/** The path has a gateway */
+	uint8_t has_gateway;
+	/**
+	 * Address family of the gateway, AF_UNSPEC for the family of the route.
+	 * A gateway of another family, e.g. an IPv6 gateway of an IPv4 route, is sent as RTA_VIA.
+	 */
+	uint8_t gateway_family;
+	uint8_t padding[3];
+	/** Gateway address of the path */
+	mnlxt_inet_addr_t gateway;
+} mnlxt_rt_route_path_t;
+
+/**
+ * Route properties, which filter a dump in the kernel (see mnlxt_rt_route_dump_filter)
+ */
+#define MNLXT_RT_ROUTE_DUMP_FILTER                                                                                    \
+	(MNLXT_FLAG(MNLXT_RT_ROUTE_FAMILY) | MNLXT_FLAG(MNLXT_RT_ROUTE_TYPE) | MNLXT_FLAG(MNLXT_RT_ROUTE_TABLE)              \
+	 | MNLXT_FLAG(MNLXT_RT_ROUTE_PROTOCOL) | MNLXT_FLAG(MNLXT_RT_ROUTE_OIFINDEX))
+
 typedef struct {
 	/** Properties flags */
 	uint32_t prop_flags;
 	/** Address family of route */
 	uint8_t family;
-	/** Routing table ID, @see rtnetlink(7);
-	 * RT_TABLE_UNSPEC    an unspecified routing table
-	 * RT_TABLE_DEFAULT   the default table
-	 * RT_TABLE_MAIN      the main table
-	 * RT_TABLE_LOCAL     the local table
-	 * */
-	uint8_t table;
 	/**
 	 * Type of route, @see rtnetlink(7) or linux/rtnetlink.h:
 	 * RTN_UNSPEC
@@ -88,7 +109,14 @@ typedef struct {
 	uint8_t scope;
 	uint8_t src_prefix;
 	uint8_t dst_prefix;
-	uint8_t padding;
+	uint8_t padding[2];
+	/** Routing table ID, @see rtnetlink(7), tables above 255 (e.g. of VRFs) are sent as RTA_TABLE;
+	 * RT_TABLE_UNSPEC    an unspecified routing table
+	 * RT_TABLE_DEFAULT   the default table
+	 * RT_TABLE_MAIN      the main table
+	 * RT_TABLE_LOCAL     the local table
+	 * */
+	uint32_t table;
 	/** Priority of route */
 	uint32_t priority;
 	/** Input interface index. */
@@ -101,6 +129,12 @@ typedef struct {
 	mnlxt_inet_addr_t dst;
 	/** Route gateway address */
 	mnlxt_inet_addr_t gateway;
+	/** Nexthop object ID, the route is forwarded by the nexthop or nexthop group (see libmnlxt/rt_nexthop.h) */
+	uint32_t nh_id;
+	/** Number of paths of a multipath route */
+	uint16_t multipath_size;
+	/** Paths of a multipath route (ECMP), instead of a single gateway and output interface */
+	mnlxt_rt_route_path_t *multipath;
 } mnlxt_rt_route_t;
 
 /**
@@ -162,14 +196,14 @@ int mnlxt_rt_route_get_protocol(const mnlxt_rt_route_t *route, uint8_t *protocol
  * @param table route table number
  * @return 0 on success, else -1
  */
-int mnlxt_rt_route_set_table(mnlxt_rt_route_t *route, uint8_t table);
+int mnlxt_rt_route_set_table(mnlxt_rt_route_t *route, uint32_t table);
 /**
  * Gets route table from route information
  * @param route pointer to route information structure
  * @param table pointer to buffer to save route table number
  * @return 0 on success, 1 on not set, else -1
  */
-int mnlxt_rt_route_get_table(const mnlxt_rt_route_t *route, uint8_t *table);
+int mnlxt_rt_route_get_table(const mnlxt_rt_route_t *route, uint32_t *table);
 /**
  * Sets route scope on route information
  * @param route pointer to route information structure
@@ -259,7 +293,7 @@ int mnlxt_rt_route_set_dst(mnlxt_rt_route_t *route, uint8_t family, const mnlxt_
  */
 int mnlxt_rt_route_get_dst(const mnlxt_rt_route_t *route, uint8_t *family, const mnlxt_inet_addr_t **buf);
 /**
- * Sets route gateway address on route information
+ * Sets route gateway address on route information, the nexthop object ID is unset
  * @param route pointer to route information structure
  * @param family address family
  * @param buf pointer to route buffer with gateway address
@@ -274,6 +308,52 @@ int mnlxt_rt_route_set_gateway(mnlxt_rt_route_t *route, uint8_t family, const mn
  * @return 0 on success, 1 on not set, else -1
  */
 int mnlxt_rt_route_get_gateway(const mnlxt_rt_route_t *route, uint8_t *family, const mnlxt_inet_addr_t **buf);
+/**
+ * Sets nexthop object ID on route information, which replaces gateway, output interface and multipath,
+ * so they are unset. Setting one of them unsets the nexthop object ID. Routes dumped in nexthop compat mode
+ * carry the nexthop object ID only.
+ * Many routes share a nexthop, they are all moved by a single update of the nexthop.
+ * @param route pointer to route information structure
+ * @param nh_id nexthop object ID
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_route_set_nh_id(mnlxt_rt_route_t *route, uint32_t nh_id);
+/**
+ * Gets nexthop object ID from route information
+ * @param route pointer to route information structure
+ * @param nh_id pointer to buffer to save nexthop object ID
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_route_get_nh_id(const mnlxt_rt_route_t *route, uint32_t *nh_id);
+/**
+ * Sets paths of a multipath route on route information, which replaces gateway, output interface and
+ * nexthop object ID, so they are unset.
+ * All paths are installed or replaced at once by a single request.
+ * @param route pointer to route information structure
+ * @param family address family of the gateways
+ * @param paths pointer to array of paths to copy
+ * @param size number of paths
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_route_set_multipath(mnlxt_rt_route_t *route, uint8_t family, const mnlxt_rt_route_path_t *paths,
+																 uint16_t size);
+/**
+ * Adds a path of a multipath route on route information, gateway, output interface and nexthop object ID are
+ * unset like by @mnlxt_rt_route_set_multipath
+ * @param route pointer to route information structure
+ * @param family address family of the gateway
+ * @param path pointer to path to copy
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_route_add_path(mnlxt_rt_route_t *route, uint8_t family, const mnlxt_rt_route_path_t *path);
+/**
+ * Gets paths of a multipath route from route information
+ * @param route pointer to route information structure
+ * @param paths pointer to buffer to save pointer to array of paths
+ * @param size pointer to buffer to save number of paths
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_rt_route_get_multipath(const mnlxt_rt_route_t *route, const mnlxt_rt_route_path_t **paths, uint16_t *size);
 /**
  * Sets route priority prefix on route information
  * @param route pointer to route information structure
@@ -289,7 +369,7 @@ int mnlxt_rt_route_set_priority(mnlxt_rt_route_t *route, uint32_t priority);
  */
 int mnlxt_rt_route_get_priority(const mnlxt_rt_route_t *route, uint32_t *priority);
 /**
- * Sets route output interface on route information
+ * Sets route output interface on route information, the nexthop object ID is unset
  * @param route pointer to route information structure
  * @param oif_index output interface index
  * @return 0 on success, else -1
@@ -410,6 +490,15 @@ mnlxt_message_t *mnlxt_rt_route_message(mnlxt_rt_route_t **route, uint16_t type,
  * @return 0 on success, else -1
  */
 int mnlxt_rt_route_request(mnlxt_rt_route_t *rt_route, uint16_t type, uint16_t flags);
+/**
+ * Sends a netlink request with the given route information via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param rt_route pointer to a route information structure mnlxt_rt_route_t
+ * @param type request type (RTM_NEWROUTE or RTM_DELROUTE)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set to 0 for default.
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_route_handle_request(mnlxt_handle_t *handle, mnlxt_rt_route_t *rt_route, uint16_t type, uint16_t flags);
 /**
  * Gets information of all routes configured on system
  * @param data pointer to mnlxt data to store information into
@@ -417,5 +506,45 @@ int mnlxt_rt_route_request(mnlxt_rt_route_t *rt_route, uint16_t type, uint16_t f
  * @return 0 on success, else -1
  */
 int mnlxt_rt_route_dump(mnlxt_data_t *data, unsigned char family);
+/**
+ * Gets information of all routes configured on system via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store information into
+ * @param family route family get the information for
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_route_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, unsigned char family);
+/**
+ * Gets information of the routes configured on system, which match a filter.
+ * The kernel skips the other routes, if the dump request is checked strictly (see MNLXT_CONNECT_STRICT_CHK),
+ * older kernels ignore the filter and the dumped routes have to be matched by mnlxt_rt_route_match.
+ * @param data pointer to mnlxt data to store information into
+ * @param filter pointer to route with the properties to match, only MNLXT_RT_ROUTE_DUMP_FILTER are supported
+ * @return 0 on success, else -1 (errno EINVAL for other properties)
+ */
+int mnlxt_rt_route_dump_filter(mnlxt_data_t *data, const mnlxt_rt_route_t *filter);
+/**
+ * Gets information of the routes configured on system, which match a filter, via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect_opts with MNLXT_CONNECT_STRICT_CHK
+ * or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store information into
+ * @param filter pointer to route with the properties to match, only MNLXT_RT_ROUTE_DUMP_FILTER are supported
+ * @return 0 on success, else -1 (errno EINVAL for other properties)
+ */
+int mnlxt_rt_route_handle_dump_filter(mnlxt_handle_t *handle, mnlxt_data_t *data, const mnlxt_rt_route_t *filter);
+/**
+ * Computes the changes turning the current routes into the desired ones.
+ * Only the properties set in the desired routes are compared, unchanged routes produce no change.
+ * A route is identified by family, table, priority and the prefixes of destination and source,
+ * which have to be set in the desired routes as reported by the kernel (e.g. table RT_TABLE_MAIN).
+ * Routes of the same identity but other properties are replaced by RTM_NEWROUTE with NLM_F_REPLACE.
+ * New routes are added first in the order of the desired routes, stale routes are deleted last.
+ * @param desired pointer to mnlxt data with the desired routes
+ * @param current pointer to mnlxt data with the current routes, e.g. filled by a dump
+ * @param changes pointer to mnlxt data without arena or stream to add the messages to,
+ * which are ready for @mnlxt_handle_batch_request; on failure it may hold a part of the messages
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_route_reconcile(mnlxt_data_t *desired, mnlxt_data_t *current, mnlxt_data_t *changes);
 
 #endif /* LIBMNLXT_RT_ROUTE_H_ */
@@ -0,0 +1,83 @@
+/*
+ * libmnlxt/rt_route_index.h		Libmnlxt Routing Route Index
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef LIBMNLXT_RT_ROUTE_INDEX_H_
+#define LIBMNLXT_RT_ROUTE_INDEX_H_
+
+#include <libmnlxt/rt_route.h>
+
+/**
+ * Route store hashed on the identity of routes in the kernel: table, family, destination with prefix length,
+ * source with prefix length and priority. Routes are kept in insertion order.
+ */
+typedef struct mnlxt_rt_route_index_s mnlxt_rt_route_index_t;
+
+/**
+ * Creates an empty route index
+ * @param size expected number of routes, or 0
+ * @return pointer to new dynamically allocated route index, or NULL
+ */
+mnlxt_rt_route_index_t *mnlxt_rt_route_index_new(size_t size);
+/**
+ * Frees route index with all its routes
+ * @param index pointer to route index
+ */
+void mnlxt_rt_route_index_free(mnlxt_rt_route_index_t *index);
+/**
+ * Gets number of routes in route index
+ * @param index pointer to route index
+ * @return number of routes
+ */
+size_t mnlxt_rt_route_index_count(const mnlxt_rt_route_index_t *index);
+/**
+ * Adds route to route index, a stored route with the same identity is replaced and freed
+ * @param index pointer to route index
+ * @param route pointer to dynamically allocated route information, owned by route index on success
+ * @return 0 if added, 1 if replaced, else -1
+ */
+int mnlxt_rt_route_index_add(mnlxt_rt_route_index_t *index, mnlxt_rt_route_t *route);
+/**
+ * Looks up route with the same identity
+ * @param index pointer to route index
+ * @param key pointer to route information with the identity properties to look for
+ * @return pointer to stored route information, or NULL if not found
+ */
+mnlxt_rt_route_t *mnlxt_rt_route_index_lookup(const mnlxt_rt_route_index_t *index, const mnlxt_rt_route_t *key);
+/**
+ * Removes route with the same identity from route index
+ * @param index pointer to route index
+ * @param key pointer to route information with the identity properties to look for
+ * @return pointer to removed route information to be freed by the caller, or NULL if not found
+ */
+mnlxt_rt_route_t *mnlxt_rt_route_index_remove(mnlxt_rt_route_index_t *index, const mnlxt_rt_route_t *key);
+/**
+ * Applies a route message: RTM_NEWROUTE and RTM_GETROUTE add a copy of its route, RTM_DELROUTE removes and frees it
+ * @param index pointer to route index
+ * @param message pointer to mnlxt message
+ * @return 0 on success, 1 if a route to delete was not found, else -1
+ */
+int mnlxt_rt_route_index_update(mnlxt_rt_route_index_t *index, const mnlxt_message_t *message);
+/**
+ * Moves all routes of mnlxt data, e.g. of @mnlxt_rt_route_dump, into route index.
+ * The route messages are removed from mnlxt data and freed.
+ * @param index pointer to route index
+ * @param data pointer to mnlxt data
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_route_index_load(mnlxt_rt_route_index_t *index, mnlxt_data_t *data);
+/**
+ * Iterates over route index in insertion order; the current route may be removed while iterating
+ * @param index pointer to route index
+ * @param iterator pointer to iterator, which should be NULL for the first call
+ * @return pointer to next route information, or NULL at the end
+ */
+mnlxt_rt_route_t *mnlxt_rt_route_index_iterate(const mnlxt_rt_route_index_t *index, void **iterator);
+
+#endif /* LIBMNLXT_RT_ROUTE_INDEX_H_ */
@@ -0,0 +1,91 @@
+/*
+ * libmnlxt/rt_route_lpm.h		Libmnlxt Routing Longest Prefix Match
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef LIBMNLXT_RT_ROUTE_LPM_H_
+#define LIBMNLXT_RT_ROUTE_LPM_H_
+
+#include <libmnlxt/rt_route.h>
+
+/**
+ * Longest prefix match over routes, with a path compressed binary trie per routing table and address family.
+ * Routes of the same destination prefix are ordered by priority, the lowest priority wins.
+ * Only the destination is matched; the source prefix of IPv6 source routing is not considered.
+ */
+typedef struct mnlxt_rt_route_lpm_s mnlxt_rt_route_lpm_t;
+
+/**
+ * Creates an empty longest prefix match structure
+ * @return pointer to new dynamically allocated structure, or NULL
+ */
+mnlxt_rt_route_lpm_t *mnlxt_rt_route_lpm_new();
+/**
+ * Frees longest prefix match structure with all its routes
+ * @param lpm pointer to longest prefix match structure
+ */
+void mnlxt_rt_route_lpm_free(mnlxt_rt_route_lpm_t *lpm);
+/**
+ * Gets number of routes in longest prefix match structure
+ * @param lpm pointer to longest prefix match structure
+ * @return number of routes
+ */
+size_t mnlxt_rt_route_lpm_count(const mnlxt_rt_route_lpm_t *lpm);
+/**
+ * Adds route, a stored route with the same table, family, destination prefix and priority is replaced and freed
+ * @param lpm pointer to longest prefix match structure
+ * @param route pointer to dynamically allocated route information with AF_INET or AF_INET6 family,
+ * owned by the structure on success
+ * @return 0 if added, 1 if replaced, else -1
+ */
+int mnlxt_rt_route_lpm_add(mnlxt_rt_route_lpm_t *lpm, mnlxt_rt_route_t *route);
+/**
+ * Removes route with the same table, family, destination prefix and priority
+ * @param lpm pointer to longest prefix match structure
+ * @param key pointer to route information with the properties to look for
+ * @return pointer to removed route information to be freed by the caller, or NULL if not found
+ */
+mnlxt_rt_route_t *mnlxt_rt_route_lpm_remove(mnlxt_rt_route_lpm_t *lpm, const mnlxt_rt_route_t *key);
+/**
+ * Applies a route message: RTM_NEWROUTE and RTM_GETROUTE add a copy of its route, RTM_DELROUTE removes and frees it
+ * @param lpm pointer to longest prefix match structure
+ * @param message pointer to mnlxt message
+ * @return 0 on success, 1 if a route to delete was not found, else -1
+ */
+int mnlxt_rt_route_lpm_update(mnlxt_rt_route_lpm_t *lpm, const mnlxt_message_t *message);
+/**
+ * Adds copies of all AF_INET and AF_INET6 routes of mnlxt data, e.g. of @mnlxt_rt_route_dump
+ * @param lpm pointer to longest prefix match structure
+ * @param data pointer to mnlxt data, which is not modified
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_route_lpm_load(mnlxt_rt_route_lpm_t *lpm, const mnlxt_data_t *data);
+/**
+ * Looks up the route with the longest destination prefix covering an address
+ * @param lpm pointer to longest prefix match structure
+ * @param table routing table ID
+ * @param family address family, AF_INET or AF_INET6
+ * @param addr pointer to address
+ * @return pointer to stored route information, or NULL if no route matches
+ */
+const mnlxt_rt_route_t *mnlxt_rt_route_lpm_lookup(const mnlxt_rt_route_lpm_t *lpm, uint32_t table, uint8_t family,
+																									const mnlxt_inet_addr_t *addr);
+/**
+ * Looks up routes for a batch of addresses of the same table and family
+ * @param lpm pointer to longest prefix match structure
+ * @param table routing table ID
+ * @param family address family, AF_INET or AF_INET6
+ * @param addrs array of addresses
+ * @param routes array receiving the pointers to stored route information, or NULL if no route matches
+ * @param count number of addresses
+ * @return number of matched addresses, or -1 on error
+ */
+int mnlxt_rt_route_lpm_lookup_batch(const mnlxt_rt_route_lpm_t *lpm, uint32_t table, uint8_t family,
+																		const mnlxt_inet_addr_t *addrs, const mnlxt_rt_route_t **routes, size_t count);
+
+#endif /* LIBMNLXT_RT_ROUTE_LPM_H_ */
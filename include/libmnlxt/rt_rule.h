@@ -378,6 +378,15 @@ mnlxt_message_t *mnlxt_rt_rule_message(mnlxt_rt_rule_t **rule, uint16_t type, ui
  * @return 0 on success, else -1
  */
 int mnlxt_rt_rule_request(mnlxt_rt_rule_t *rt_rule, uint16_t type, uint16_t flags);
+/**
+ * Sends a netlink request with the given rule information via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param rt_rule pointer to a rule information structure mnlxt_rt_rule_t
+ * @param type request type (RTM_NEWRULE or RTM_DELRULE)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set to 0 for default.
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_rule_handle_request(mnlxt_handle_t *handle, mnlxt_rt_rule_t *rt_rule, uint16_t type, uint16_t flags);
 /**
  * Gets information of all network rules configured on system
  * @param data pointer to mnlxt data to store information into
@@ -385,5 +394,26 @@ int mnlxt_rt_rule_request(mnlxt_rt_rule_t *rt_rule, uint16_t type, uint16_t flag
  * @return 0 on success, else -1
  */
 int mnlxt_rt_rule_dump(mnlxt_data_t *data, unsigned char family);
+/**
+ * Gets information of all network rules configured on system via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store information into
+ * @param family rule family get the information for
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_rule_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, unsigned char family);
+/**
+ * Computes the changes turning the current rules into the desired ones.
+ * Only the properties set in the desired rules are compared, unchanged rules produce no change.
+ * A rule is identified by all its properties, family, table and priority have to be set in the desired rules.
+ * Rules are never replaced, a changed rule is created and the old one deleted.
+ * New rules are added first in the order of the desired rules, stale rules are deleted last.
+ * @param desired pointer to mnlxt data with the desired rules
+ * @param current pointer to mnlxt data with the current rules, e.g. filled by a dump
+ * @param changes pointer to mnlxt data without arena or stream to add the messages to,
+ * which are ready for @mnlxt_handle_batch_request; on failure it may hold a part of the messages
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_rule_reconcile(mnlxt_data_t *desired, mnlxt_data_t *current, mnlxt_data_t *changes);
 
 #endif /* LIBMNLXT_RT_RULE_H_ */
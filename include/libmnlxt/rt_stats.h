@@ -0,0 +1,122 @@
+/*
+ * libmnlxt/rt_stats.h		Libmnlxt Routing Interface Statistics
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef LIBMNLXT_RT_STATS_H_
+#define LIBMNLXT_RT_STATS_H_
+
+#include <linux/if_link.h>
+
+#include <libmnlxt/core.h>
+#include <libmnlxt/data.h>
+
+typedef struct {
+	/** Interface index */
+	uint32_t if_index;
+	/** 64 bit counters of the interface, counters unknown to the kernel stay 0 */
+	struct rtnl_link_stats64 stats;
+} mnlxt_rt_stats_t;
+
+/**
+ * Counters of all interfaces in a single array, which is reused by each update.
+ * Initialize it with zeros, release it by @mnlxt_rt_stats_table_clean.
+ */
+typedef struct {
+	/** Counters of the interfaces, sorted by interface index */
+	mnlxt_rt_stats_t *entries;
+	/** Number of valid entries */
+	size_t size;
+	/** Number of allocated entries */
+	size_t capacity;
+} mnlxt_rt_stats_table_t;
+
+/**
+ * Frees memory allocated by an interface statistics structure
+ * @param stats pointer to interface statistics structure to free
+ */
+void mnlxt_rt_stats_free(mnlxt_rt_stats_t *stats);
+/**
+ * Callback wrapper for mnlxt_rt_stats_free
+ * @param stats interface statistics structure to free given by void pointer
+ */
+static inline void mnlxt_rt_stats_FREE(void *stats) {
+	mnlxt_rt_stats_free((mnlxt_rt_stats_t *)stats);
+}
+
+/**
+ * Parses netlink message into interface statistics and stores it into mnlxt data
+ * @param nlh pointer to netlink message
+ * @param data pointer to mnlxt data
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+int mnlxt_rt_stats_data(const struct nlmsghdr *nlh, mnlxt_data_t *data);
+/**
+ * Callback wrapper for mnlxt_rt_stats_data
+ * @param nlh pointer to netlink message
+ * @param data mnlxt data given by void pointer
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+static inline int mnlxt_rt_stats_DATA(const struct nlmsghdr *nlh, void *data) {
+	return mnlxt_rt_stats_data(nlh, (mnlxt_data_t *)data);
+}
+
+/**
+ * Iterates over interface statistics stored in mnlxt data
+ * @param data pointer to mnlxt data
+ * @param iterator data iterator; this pointer have to be initialized with NULL before iteration
+ * @return pointer to the next interface statistics or NULL for the end of iteration
+ */
+mnlxt_rt_stats_t *mnlxt_rt_stats_iterate(mnlxt_data_t *data, mnlxt_message_t **iterator);
+/**
+ * Gets interface statistics from mnlxt message
+ * @param message pointer to mnlxt message
+ * @return pointer to interface statistics structure on success, else NULL
+ */
+mnlxt_rt_stats_t *mnlxt_rt_stats_get(const mnlxt_message_t *message);
+
+/**
+ * Gets the 64 bit counters of interfaces (RTM_GETSTATS limited to IFLA_STATS_LINK_64)
+ * @param data pointer to mnlxt data to store information into
+ * @param if_index interface to get the counters for, or 0 for all interfaces
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_stats_dump(mnlxt_data_t *data, uint32_t if_index);
+/**
+ * Gets the 64 bit counters of interfaces via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store information into
+ * @param if_index interface to get the counters for, or 0 for all interfaces
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_stats_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, uint32_t if_index);
+
+/**
+ * Replaces the content of a statistics table by the current counters of interfaces.
+ * The counters are streamed into the array of the table, which only grows when more interfaces appear.
+ * For rate computation keep two tables and swap them between updates.
+ * @param handle pointer to mnlxt handle connected by @mnlxt_rt_connect or NULL for a temporary connection
+ * @param table pointer to statistics table
+ * @param if_index interface to get the counters for, or 0 for all interfaces
+ * @return 0 on success, else -1
+ */
+int mnlxt_rt_stats_table_update(mnlxt_handle_t *handle, mnlxt_rt_stats_table_t *table, uint32_t if_index);
+/**
+ * Finds the counters of an interface in a statistics table
+ * @param table pointer to statistics table
+ * @param if_index interface index
+ * @return pointer to counters of the interface, or NULL if not found
+ */
+const mnlxt_rt_stats_t *mnlxt_rt_stats_table_find(const mnlxt_rt_stats_table_t *table, uint32_t if_index);
+/**
+ * Frees memory allocated by a statistics table
+ * @param table pointer to statistics table
+ */
+void mnlxt_rt_stats_table_clean(mnlxt_rt_stats_table_t *table);
+
+#endif /* LIBMNLXT_RT_STATS_H_ */
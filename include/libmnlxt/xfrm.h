@@ -15,7 +15,11 @@
 
 #include <libmnlxt/core.h>
 #include <libmnlxt/data.h>
+#include <libmnlxt/xfrm_event.h>
 #include <libmnlxt/xfrm_policy.h>
+#include <libmnlxt/xfrm_spd.h>
+#include <libmnlxt/xfrm_spdinfo.h>
+#include <libmnlxt/xfrm_state.h>
 
 /**
  * Connects to xfrm netlink socket and initializes mnlxt handle
@@ -24,6 +28,14 @@
  * @return 0 on success, else -1
  */
 int mnlxt_xfrm_connect(mnlxt_handle_t *handle, int group);
+/**
+ * Connects to xfrm netlink socket with socket options and initializes mnlxt handle
+ * @param handle pointer to mnlxt handle
+ * @param groups xfrm netlink multicast groups to subscribe (XFRMNLGRP_* see linux/xfrm.h)
+ * @param opts pointer to connect options, or NULL for defaults
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_connect_opts(mnlxt_handle_t *handle, int group, const mnlxt_connect_opts_t *opts);
 /**
  * Dumps netlink data for given xfrm message type
  * @param data pointer to mnlxt data to store mnlxt messages into
@@ -37,6 +49,21 @@ int mnlxt_xfrm_data_dump(mnlxt_data_t *data, int type);
  * @return 0 on success, else -1
  */
 int mnlxt_xfrm_message_request(mnlxt_message_t *message);
+/**
+ * Dumps netlink data for given xfrm message type via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_xfrm_connect or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store mnlxt messages into
+ * @param type netlink message type (XFRM_MSG_GET* see linux/xfrm.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_handle_data_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, int type);
+/**
+ * Creates a request from a mnlxt message and sends it via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_xfrm_connect or NULL for a temporary connection
+ * @param message pointer to mnlxt message
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_handle_message_request(mnlxt_handle_t *handle, mnlxt_message_t *message);
 
 /**
  * Create a mnlxt xfrm message
@@ -0,0 +1,238 @@
+/*
+ * libmnlxt/xfrm_event.h		Libmnlxt Xfrm/IPsec Events
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef LIBMNLXT_XFRM_EVENT_H_
+#define LIBMNLXT_XFRM_EVENT_H_
+
+#include <linux/xfrm.h>
+
+#include <libmnlxt/core.h>
+#include <libmnlxt/data.h>
+#include <libmnlxt/xfrm_policy.h>
+#include <libmnlxt/xfrm_state.h>
+
+/** Request of the kernel to negotiate a missing state (XFRM_MSG_ACQUIRE of XFRMNLGRP_ACQUIRE) */
+typedef struct {
+	/** sequence number, which the negotiated state is installed with */
+	uint32_t seq;
+	/** family, protocol and peers of the missing state, its mode and reqid are given by the templates of the policy */
+	mnlxt_xfrm_tmpl_t id;
+	/** selector of the packet which triggered the acquire */
+	mnlxt_xfrm_policy_t sel;
+	/** policy requiring the state, with its templates, mark and xfrm interface id */
+	mnlxt_xfrm_policy_t policy;
+} mnlxt_xfrm_acquire_t;
+
+/** Lifetime of a state expired (XFRM_MSG_EXPIRE of XFRMNLGRP_EXPIRE) */
+typedef struct {
+	/** 1 if the hard lifetime expired and the state is deleted, 0 for the soft lifetime to rekey */
+	uint8_t hard;
+	/** the expired state, without keys */
+	mnlxt_xfrm_state_t state;
+} mnlxt_xfrm_expire_t;
+
+/** Lifetime of a policy expired (XFRM_MSG_POLEXPIRE of XFRMNLGRP_EXPIRE) */
+typedef struct {
+	/** 1 if the hard lifetime expired and the policy is deleted, 0 for the soft lifetime */
+	uint8_t hard;
+	/** the expired policy */
+	mnlxt_xfrm_policy_t policy;
+} mnlxt_xfrm_polexpire_t;
+
+/** NAT mapping of a UDP encapsulated state changed (XFRM_MSG_MAPPING of XFRMNLGRP_MAPPING) */
+typedef struct {
+	/** AF_INET6 or AF_INET */
+	uint8_t family;
+	/** IPPROTO_ESP */
+	uint8_t proto;
+	uint16_t padding;
+	/** SPI in host byte order */
+	uint32_t spi;
+	uint32_t reqid;
+	/** destination peer of the state */
+	mnlxt_inet_addr_t dst;
+	/** source peer before the mapping changed */
+	mnlxt_inet_addr_t old_src;
+	/** source peer after the mapping changed */
+	mnlxt_inet_addr_t new_src;
+	/** source port before the mapping changed in host byte order */
+	uint16_t old_sport;
+	/** source port after the mapping changed in host byte order */
+	uint16_t new_sport;
+} mnlxt_xfrm_mapping_t;
+
+/**
+ * Functions called for the events of a mnlxt handle, functions not set skip their events.
+ * The events are valid during the call only.
+ */
+typedef struct {
+	void (*acquire)(const mnlxt_xfrm_acquire_t *acquire, void *arg);
+	void (*expire)(const mnlxt_xfrm_expire_t *expire, void *arg);
+	void (*polexpire)(const mnlxt_xfrm_polexpire_t *polexpire, void *arg);
+	void (*mapping)(const mnlxt_xfrm_mapping_t *mapping, void *arg);
+	/** all other parsed messages, e.g. XFRM_MSG_NEWSA of XFRMNLGRP_SA or XFRM_MSG_DELPOLICY of XFRMNLGRP_POLICY */
+	void (*other)(const mnlxt_message_t *message, void *arg);
+} mnlxt_xfrm_event_cbs_t;
+
+/**
+ * Frees memory allocated by an acquire event
+ * @param acquire pointer to acquire event to free
+ */
+void mnlxt_xfrm_acquire_free(mnlxt_xfrm_acquire_t *acquire);
+/**
+ * Callback wrapper for mnlxt_xfrm_acquire_free
+ * @param acquire acquire event to free given by void pointer
+ */
+static inline void mnlxt_xfrm_acquire_FREE(void *acquire) {
+	mnlxt_xfrm_acquire_free((mnlxt_xfrm_acquire_t *)acquire);
+}
+/**
+ * Parses netlink message into acquire event and stores it into mnlxt data
+ * @param nlh pointer to netlink message
+ * @param data pointer to mnlxt data
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+int mnlxt_xfrm_acquire_data(const struct nlmsghdr *nlh, mnlxt_data_t *data);
+/**
+ * Callback wrapper for mnlxt_xfrm_acquire_data
+ * @param nlh pointer to netlink message
+ * @param data mnlxt data given by void pointer
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+static inline int mnlxt_xfrm_acquire_DATA(const struct nlmsghdr *nlh, void *data) {
+	return mnlxt_xfrm_acquire_data(nlh, (mnlxt_data_t *)data);
+}
+/**
+ * Gets acquire event from mnlxt message
+ * @param message pointer to mnlxt message
+ * @return pointer to acquire event on success, else NULL
+ */
+mnlxt_xfrm_acquire_t *mnlxt_xfrm_acquire_get(const mnlxt_message_t *message);
+
+/**
+ * Frees memory allocated by a state expire event
+ * @param expire pointer to state expire event to free
+ */
+void mnlxt_xfrm_expire_free(mnlxt_xfrm_expire_t *expire);
+/**
+ * Callback wrapper for mnlxt_xfrm_expire_free
+ * @param expire state expire event to free given by void pointer
+ */
+static inline void mnlxt_xfrm_expire_FREE(void *expire) {
+	mnlxt_xfrm_expire_free((mnlxt_xfrm_expire_t *)expire);
+}
+/**
+ * Parses netlink message into state expire event and stores it into mnlxt data
+ * @param nlh pointer to netlink message
+ * @param data pointer to mnlxt data
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+int mnlxt_xfrm_expire_data(const struct nlmsghdr *nlh, mnlxt_data_t *data);
+/**
+ * Callback wrapper for mnlxt_xfrm_expire_data
+ * @param nlh pointer to netlink message
+ * @param data mnlxt data given by void pointer
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+static inline int mnlxt_xfrm_expire_DATA(const struct nlmsghdr *nlh, void *data) {
+	return mnlxt_xfrm_expire_data(nlh, (mnlxt_data_t *)data);
+}
+/**
+ * Gets state expire event from mnlxt message
+ * @param message pointer to mnlxt message
+ * @return pointer to state expire event on success, else NULL
+ */
+mnlxt_xfrm_expire_t *mnlxt_xfrm_expire_get(const mnlxt_message_t *message);
+
+/**
+ * Frees memory allocated by a policy expire event
+ * @param polexpire pointer to policy expire event to free
+ */
+void mnlxt_xfrm_polexpire_free(mnlxt_xfrm_polexpire_t *polexpire);
+/**
+ * Callback wrapper for mnlxt_xfrm_polexpire_free
+ * @param polexpire policy expire event to free given by void pointer
+ */
+static inline void mnlxt_xfrm_polexpire_FREE(void *polexpire) {
+	mnlxt_xfrm_polexpire_free((mnlxt_xfrm_polexpire_t *)polexpire);
+}
+/**
+ * Parses netlink message into policy expire event and stores it into mnlxt data
+ * @param nlh pointer to netlink message
+ * @param data pointer to mnlxt data
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+int mnlxt_xfrm_polexpire_data(const struct nlmsghdr *nlh, mnlxt_data_t *data);
+/**
+ * Callback wrapper for mnlxt_xfrm_polexpire_data
+ * @param nlh pointer to netlink message
+ * @param data mnlxt data given by void pointer
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+static inline int mnlxt_xfrm_polexpire_DATA(const struct nlmsghdr *nlh, void *data) {
+	return mnlxt_xfrm_polexpire_data(nlh, (mnlxt_data_t *)data);
+}
+/**
+ * Gets policy expire event from mnlxt message
+ * @param message pointer to mnlxt message
+ * @return pointer to policy expire event on success, else NULL
+ */
+mnlxt_xfrm_polexpire_t *mnlxt_xfrm_polexpire_get(const mnlxt_message_t *message);
+
+/**
+ * Frees memory allocated by a mapping event
+ * @param mapping pointer to mapping event to free
+ */
+void mnlxt_xfrm_mapping_free(mnlxt_xfrm_mapping_t *mapping);
+/**
+ * Callback wrapper for mnlxt_xfrm_mapping_free
+ * @param mapping mapping event to free given by void pointer
+ */
+static inline void mnlxt_xfrm_mapping_FREE(void *mapping) {
+	mnlxt_xfrm_mapping_free((mnlxt_xfrm_mapping_t *)mapping);
+}
+/**
+ * Parses netlink message into mapping event and stores it into mnlxt data
+ * @param nlh pointer to netlink message
+ * @param data pointer to mnlxt data
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+int mnlxt_xfrm_mapping_data(const struct nlmsghdr *nlh, mnlxt_data_t *data);
+/**
+ * Callback wrapper for mnlxt_xfrm_mapping_data
+ * @param nlh pointer to netlink message
+ * @param data mnlxt data given by void pointer
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+static inline int mnlxt_xfrm_mapping_DATA(const struct nlmsghdr *nlh, void *data) {
+	return mnlxt_xfrm_mapping_data(nlh, (mnlxt_data_t *)data);
+}
+/**
+ * Gets mapping event from mnlxt message
+ * @param message pointer to mnlxt message
+ * @return pointer to mapping event on success, else NULL
+ */
+mnlxt_xfrm_mapping_t *mnlxt_xfrm_mapping_get(const mnlxt_message_t *message);
+
+/**
+ * Receives all queued events of a mnlxt handle without blocking and passes them to the functions of their type.
+ * To be called if the file descriptor of the handle (see mnlxt_handel_get_fd) becomes readable.
+ * The handle is connected by @mnlxt_xfrm_connect_opts with MNLXT_CONNECT_NONBLOCK, the groups of the events
+ * are added by @mnlxt_handle_add_group (XFRMNLGRP_ACQUIRE, XFRMNLGRP_EXPIRE or XFRMNLGRP_MAPPING).
+ * The events are parsed into a reused arena, so no memory is allocated per event.
+ * @param handle pointer to mnlxt handle
+ * @param cbs pointer to functions to call
+ * @param arg user argument to pass to the functions
+ * @return number of dispatched events, or -1 on error (errno ENOBUFS if events were lost by an overrun,
+ * the states and policies have to be dumped again)
+ */
+int mnlxt_xfrm_event_process(mnlxt_handle_t *handle, const mnlxt_xfrm_event_cbs_t *cbs, void *arg);
+
+#endif /* LIBMNLXT_XFRM_EVENT_H_ */
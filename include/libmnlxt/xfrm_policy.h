@@ -15,6 +15,9 @@
 
 #include <libmnlxt/rt_addr.h>
 
+/** maximum number of templates of a policy (XFRM_MAX_DEPTH of the kernel) */
+#define MNLXT_XFRM_POLICY_TMPL_MAX 6
+
 typedef enum {
 	MNLXT_XFRM_POLICY_FAMILY = 0,
 	MNLXT_XFRM_POLICY_PROTO,
@@ -34,8 +37,9 @@ typedef enum {
 	MNLXT_XFRM_POLICY_ACTION,
 	MNLXT_XFRM_POLICY_DIR,
 	MNLXT_XFRM_POLICY_MARK,
-	MNLXT_XFRM_POLICY_TMPLS
-#define MNLXT_XFRM_POLICY_MAX MNLXT_XFRM_POLICY_TMPLS + 1
+	MNLXT_XFRM_POLICY_TMPLS,
+	MNLXT_XFRM_POLICY_IF_ID
+#define MNLXT_XFRM_POLICY_MAX MNLXT_XFRM_POLICY_IF_ID + 1
 } mnlxt_xfrm_policy_data_t;
 
 typedef struct {
@@ -47,7 +51,11 @@ typedef struct {
 	uint8_t mode;
 	/** XFRM_SHARE_* linux/xfrm.h */
 	uint8_t share;
+	/** 1 if traffic without a matching state is accepted as well (level use) */
+	uint8_t optional;
+	uint8_t padding[3];
 	uint32_t reqid;
+	/** SPI in network byte order, 0 for any */
 	uint32_t spi;
 	/** source peer */
 	mnlxt_inet_addr_t src;
@@ -86,6 +94,8 @@ typedef struct {
 	/** input interface index */
 	uint32_t if_index;
 	uint32_t priority;
+	/** xfrm interface id */
+	uint32_t if_id;
 	mnlxt_xfrm_site_t src;
 	mnlxt_xfrm_site_t dst;
 	mnlxt_xfrm_mark_t mark;
@@ -319,6 +329,36 @@ int mnlxt_xfrm_policy_set_index(mnlxt_xfrm_policy_t *policy, uint32_t index);
  * @return 0 on success, 1 on not set, else -1
  */
 int mnlxt_xfrm_policy_get_index(const mnlxt_xfrm_policy_t *policy, uint32_t *index);
+/**
+ * Sets xfrm interface id on xfrm policy
+ * @param policy pointer to xfrm policy structure
+ * @param if_id xfrm interface id
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_policy_set_if_id(mnlxt_xfrm_policy_t *policy, uint32_t if_id);
+/**
+ * Gets xfrm interface id from xfrm policy
+ * @param policy pointer to xfrm policy structure
+ * @param if_id pointer to buffer to store xfrm interface id
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_policy_get_if_id(const mnlxt_xfrm_policy_t *policy, uint32_t *if_id);
+/**
+ * Sets the templates of the states required by an xfrm policy, the templates are copied
+ * @param policy pointer to xfrm policy structure
+ * @param tmpls pointer to array of templates, outer transformation first
+ * @param num number of templates, at most MNLXT_XFRM_POLICY_TMPL_MAX
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_policy_set_tmpls(mnlxt_xfrm_policy_t *policy, const mnlxt_xfrm_tmpl_t *tmpls, uint16_t num);
+/**
+ * Gets the templates from xfrm policy
+ * @param policy pointer to xfrm policy structure
+ * @param tmpls pointer to store the pointer to the array of templates into
+ * @param num pointer to buffer to store the number of templates
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_policy_get_tmpls(const mnlxt_xfrm_policy_t *policy, const mnlxt_xfrm_tmpl_t **tmpls, uint16_t *num);
 
 /**
  * Checks if an xfrm policy matches another one
@@ -414,11 +454,60 @@ mnlxt_message_t *mnlxt_xfrm_policy_message(mnlxt_xfrm_policy_t **policy, uint16_
  * @return
  */
 int mnlxt_xfrm_policy_request(mnlxt_xfrm_policy_t *xfrm_policy, uint16_t type, uint16_t flags);
+/**
+ * Sends a netlink request with the given xfrm policy via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_xfrm_connect or NULL for a temporary connection
+ * @param xfrm_policy pointer to xfrm policy
+ * @param type request type (XFRM_MSG_NEWPOLICY, XFRM_MSG_UPDPOLICY or XFRM_MSG_DELPOLICY)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set 0 for default.
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_policy_handle_request(mnlxt_handle_t *handle, mnlxt_xfrm_policy_t *xfrm_policy, uint16_t type,
+																		 uint16_t flags);
 /**
  * Gets information of all policies configured on system
  * @param data pointer to mnlxt data to store information into
  * @return 0 on success, else -1
  */
 int mnlxt_xfrm_policy_dump(mnlxt_data_t *data);
+/**
+ * Gets information of all policies configured on system via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_xfrm_connect or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store information into
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_policy_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data);
+/**
+ * Computes the changes turning the current policies into the desired ones.
+ * Only the properties set in the desired policies are compared, unchanged policies produce no change.
+ * A policy is identified by direction, selector, interface index, mark and xfrm interface id.
+ * Policies of the same identity but other properties are replaced by XFRM_MSG_UPDPOLICY.
+ * New policies are added first in the order of the desired policies, stale policies are deleted last.
+ * @param desired pointer to mnlxt data with the desired policies
+ * @param current pointer to mnlxt data with the current policies, e.g. filled by a dump
+ * @param changes pointer to mnlxt data without arena or stream to add the messages to,
+ * which are ready for @mnlxt_handle_batch_request; on failure it may hold a part of the messages
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_policy_reconcile(mnlxt_data_t *desired, mnlxt_data_t *current, mnlxt_data_t *changes);
+
+/**
+ * Deletes all policies of a policy type by a single request (XFRM_MSG_FLUSHPOLICY)
+ * @param handle pointer to mnlxt handle connected by @mnlxt_xfrm_connect or NULL for a temporary connection
+ * @param type policy type (XFRM_POLICY_TYPE_MAIN or XFRM_POLICY_TYPE_SUB see linux/xfrm.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_policy_flush(mnlxt_handle_t *handle, uint8_t type);
+/**
+ * Deletes all policies matching the given policy.
+ * The policies are dumped and the XFRM_MSG_DELPOLICY requests of the matching ones are sent in batches.
+ * The properties set on match are compared like by @mnlxt_xfrm_policy_match, except the source and
+ * destination addresses: with an address and its prefix length set, every policy whose selector prefix lies
+ * within the prefix of match is selected.
+ * @param handle pointer to mnlxt handle connected by @mnlxt_xfrm_connect or NULL for a temporary connection
+ * @param match pointer to policy to match, e.g. with only the mark or the xfrm interface id set
+ * @return number of deleted policies, or -1 on error
+ */
+int mnlxt_xfrm_policy_flush_match(mnlxt_handle_t *handle, const mnlxt_xfrm_policy_t *match);
 
 #endif /* LIBMNLXT_XFRM_POLICY_H_ */
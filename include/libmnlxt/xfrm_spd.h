@@ -0,0 +1,116 @@
+/*
+ * libmnlxt/xfrm_spd.h		Libmnlxt Xfrm/IPsec Security Policy Database Classifier
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef LIBMNLXT_XFRM_SPD_H_
+#define LIBMNLXT_XFRM_SPD_H_
+
+#include <libmnlxt/xfrm_policy.h>
+
+/**
+ * Classifier of flows over policies, e.g. to check which policy the kernel would apply to a flow.
+ * The policies are indexed by a hierarchical trie per direction and address family: a path compressed binary trie
+ * of the destination prefixes whose nodes hold tries of the source prefixes. The policies of one source and
+ * destination prefix are ordered by priority, the remaining selector properties (protocol, ports, input interface
+ * and mark) are compared for them only. Of all matching policies the one with the lowest priority wins,
+ * for equal priorities the one with the lower index.
+ */
+typedef struct mnlxt_xfrm_spd_s mnlxt_xfrm_spd_t;
+
+/** Flow to classify, its direction and address family are given by the lookup */
+typedef struct {
+	/** IPPROTO_* see netinet/in.h */
+	uint8_t proto;
+	uint8_t padding;
+	/** source port in host byte order, 0 for protocols without ports */
+	uint16_t src_port;
+	/** destination port in host byte order, 0 for protocols without ports */
+	uint16_t dst_port;
+	uint16_t padding2;
+	/** input interface index, 0 for none */
+	uint32_t if_index;
+	/** firewall mark of the packets */
+	uint32_t mark;
+	mnlxt_inet_addr_t src;
+	mnlxt_inet_addr_t dst;
+} mnlxt_xfrm_flow_t;
+
+/**
+ * Creates an empty classifier
+ * @return pointer to new dynamically allocated classifier, or NULL
+ */
+mnlxt_xfrm_spd_t *mnlxt_xfrm_spd_new();
+/**
+ * Frees classifier with all its policies
+ * @param spd pointer to classifier
+ */
+void mnlxt_xfrm_spd_free(mnlxt_xfrm_spd_t *spd);
+/**
+ * Gets number of policies in classifier
+ * @param spd pointer to classifier
+ * @return number of policies
+ */
+size_t mnlxt_xfrm_spd_count(const mnlxt_xfrm_spd_t *spd);
+/**
+ * Adds policy, a stored policy with the same direction, family, source and destination prefix and index
+ * is replaced and freed. A policy without index, e.g. one not yet installed, replaces the stored policy without
+ * index of the same selector, mark, input interface and xfrm interface id.
+ * @param spd pointer to classifier
+ * @param policy pointer to dynamically allocated xfrm policy with family and direction (XFRM_POLICY_IN,
+ * XFRM_POLICY_OUT or XFRM_POLICY_FWD), owned by the classifier on success
+ * @return 0 if added, 1 if replaced, else -1
+ */
+int mnlxt_xfrm_spd_add(mnlxt_xfrm_spd_t *spd, mnlxt_xfrm_policy_t *policy);
+/**
+ * Removes policy with the same direction, family, source and destination prefix and index,
+ * or without index the policy without index of the same selector, mark, input interface and xfrm interface id
+ * @param spd pointer to classifier
+ * @param key pointer to xfrm policy with the properties to look for
+ * @return pointer to removed xfrm policy to be freed by the caller, or NULL if not found
+ */
+mnlxt_xfrm_policy_t *mnlxt_xfrm_spd_remove(mnlxt_xfrm_spd_t *spd, const mnlxt_xfrm_policy_t *key);
+/**
+ * Applies a policy message: XFRM_MSG_NEWPOLICY, XFRM_MSG_UPDPOLICY and XFRM_MSG_GETPOLICY add a copy of its policy,
+ * XFRM_MSG_DELPOLICY and the hard XFRM_MSG_POLEXPIRE remove and free it, the soft XFRM_MSG_POLEXPIRE is ignored
+ * @param spd pointer to classifier
+ * @param message pointer to mnlxt message, e.g. of a handle subscribed to XFRMNLGRP_POLICY and XFRMNLGRP_EXPIRE
+ * @return 0 on success, 1 if a policy to delete was not found, else -1
+ */
+int mnlxt_xfrm_spd_update(mnlxt_xfrm_spd_t *spd, const mnlxt_message_t *message);
+/**
+ * Adds copies of all policies of mnlxt data, e.g. of @mnlxt_xfrm_policy_dump
+ * @param spd pointer to classifier
+ * @param data pointer to mnlxt data, which is not modified
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_spd_load(mnlxt_xfrm_spd_t *spd, const mnlxt_data_t *data);
+/**
+ * Looks up the policy applied to a flow
+ * @param spd pointer to classifier
+ * @param dir traffic direction: XFRM_POLICY_IN, XFRM_POLICY_OUT or XFRM_POLICY_FWD
+ * @param family address family, AF_INET or AF_INET6
+ * @param flow pointer to flow
+ * @return pointer to stored xfrm policy, or NULL if no policy matches
+ */
+const mnlxt_xfrm_policy_t *mnlxt_xfrm_spd_lookup(const mnlxt_xfrm_spd_t *spd, uint8_t dir, uint8_t family,
+																								 const mnlxt_xfrm_flow_t *flow);
+/**
+ * Looks up the policies applied to a batch of flows of the same direction and family
+ * @param spd pointer to classifier
+ * @param dir traffic direction: XFRM_POLICY_IN, XFRM_POLICY_OUT or XFRM_POLICY_FWD
+ * @param family address family, AF_INET or AF_INET6
+ * @param flows array of flows
+ * @param policies array receiving the pointers to stored xfrm policies, or NULL if no policy matches
+ * @param count number of flows
+ * @return number of matched flows, or -1 on error
+ */
+int mnlxt_xfrm_spd_lookup_batch(const mnlxt_xfrm_spd_t *spd, uint8_t dir, uint8_t family,
+																const mnlxt_xfrm_flow_t *flows, const mnlxt_xfrm_policy_t **policies, size_t count);
+
+#endif /* LIBMNLXT_XFRM_SPD_H_ */
@@ -0,0 +1,182 @@
+/*
+ * libmnlxt/xfrm_spdinfo.h		Libmnlxt Xfrm/IPsec Security Policy Database Information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef LIBMNLXT_XFRM_SPDINFO_H_
+#define LIBMNLXT_XFRM_SPDINFO_H_
+
+#include <linux/xfrm.h>
+
+#include <libmnlxt/core.h>
+#include <libmnlxt/data.h>
+
+typedef enum {
+	/** policy counts, reported by the kernel only */
+	MNLXT_XFRM_SPDINFO_COUNTS = 0,
+	/** hash table sizes, reported by the kernel only */
+	MNLXT_XFRM_SPDINFO_HASH,
+	MNLXT_XFRM_SPDINFO_IPV4_HTHRESH,
+	MNLXT_XFRM_SPDINFO_IPV6_HTHRESH
+#define MNLXT_XFRM_SPDINFO_MAX MNLXT_XFRM_SPDINFO_IPV6_HTHRESH + 1
+} mnlxt_xfrm_spdinfo_data_t;
+
+typedef struct {
+	/** Properties flags */
+	uint16_t prop_flags;
+	/** number of policies per direction, inxxx are the policies bound to sockets */
+	struct xfrmu_spdinfo counts;
+	/** number of hash buckets and maximum number of buckets */
+	struct xfrmu_spdhinfo hash;
+	/**
+	 * Minimal prefix lengths of local (lbits) and remote (rbits) selector addresses for hashing an IPv4 policy,
+	 * policies with shorter prefixes are kept in the linear inexact list.
+	 */
+	struct xfrmu_spdhthresh ipv4_hthresh;
+	/** Minimal prefix lengths for hashing an IPv6 policy */
+	struct xfrmu_spdhthresh ipv6_hthresh;
+} mnlxt_xfrm_spdinfo_t;
+
+/**
+ * Creates a new SPD information instance
+ * @return pointer to new dynamically allocated SPD information structure
+ */
+mnlxt_xfrm_spdinfo_t *mnlxt_xfrm_spdinfo_new();
+/**
+ * Frees memory allocated by a SPD information structure
+ * @param info pointer to SPD information structure to free
+ */
+void mnlxt_xfrm_spdinfo_free(mnlxt_xfrm_spdinfo_t *info);
+/**
+ * Callback wrapper for mnlxt_xfrm_spdinfo_free
+ * @param info SPD information structure to free given by void pointer
+ */
+static inline void mnlxt_xfrm_spdinfo_FREE(void *info) {
+	mnlxt_xfrm_spdinfo_free((mnlxt_xfrm_spdinfo_t *)info);
+}
+
+/**
+ * Sets the hash thresholds of an address family
+ * @param info pointer to SPD information structure
+ * @param family AF_INET or AF_INET6
+ * @param lbits minimal prefix length of the local address, at most 32 for AF_INET and 128 for AF_INET6
+ * @param rbits minimal prefix length of the remote address, at most 32 for AF_INET and 128 for AF_INET6
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_spdinfo_set_hthresh(mnlxt_xfrm_spdinfo_t *info, uint8_t family, uint8_t lbits, uint8_t rbits);
+/**
+ * Gets the hash thresholds of an address family
+ * @param info pointer to SPD information structure
+ * @param family AF_INET or AF_INET6
+ * @param lbits pointer to store the minimal prefix length of the local address into
+ * @param rbits pointer to store the minimal prefix length of the remote address into
+ * @return 0 on success, 1 if not set, else -1
+ */
+int mnlxt_xfrm_spdinfo_get_hthresh(const mnlxt_xfrm_spdinfo_t *info, uint8_t family, uint8_t *lbits, uint8_t *rbits);
+/**
+ * Gets the policy counts
+ * @param info pointer to SPD information structure
+ * @param counts pointer to store the pointer to the policy counts into
+ * @return 0 on success, 1 if not set, else -1
+ */
+int mnlxt_xfrm_spdinfo_get_counts(const mnlxt_xfrm_spdinfo_t *info, const struct xfrmu_spdinfo **counts);
+/**
+ * Gets the hash table sizes
+ * @param info pointer to SPD information structure
+ * @param hash pointer to store the pointer to the hash table sizes into
+ * @return 0 on success, 1 if not set, else -1
+ */
+int mnlxt_xfrm_spdinfo_get_hash(const mnlxt_xfrm_spdinfo_t *info, const struct xfrmu_spdhinfo **hash);
+
+/**
+ * Initializes netlink message from SPD information, only the hash thresholds are sent
+ * @param nlh pointer to netlink message
+ * @param info pointer to SPD information structure
+ * @param nlmsg_type netlink message type (XFRM_MSG_NEWSPDINFO or XFRM_MSG_GETSPDINFO see linux/xfrm.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_spdinfo_put(struct nlmsghdr *nlh, const mnlxt_xfrm_spdinfo_t *info, uint16_t nlmsg_type);
+/**
+ * Callback wrapper for mnlxt_xfrm_spdinfo_put
+ * @param nlh pointer to netlink message
+ * @param info pointer to SPD information structure
+ * @param nlmsg_type netlink message type
+ * @return 0 on success, else -1
+ */
+static inline int mnlxt_xfrm_spdinfo_PUT(struct nlmsghdr *nlh, const void *info, uint16_t nlmsg_type) {
+	return mnlxt_xfrm_spdinfo_put(nlh, (const mnlxt_xfrm_spdinfo_t *)info, nlmsg_type);
+}
+
+/**
+ * Parses netlink message into SPD information and stores it into mnlxt data
+ * @param nlh pointer to netlink message
+ * @param data pointer to mnlxt data
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+int mnlxt_xfrm_spdinfo_data(const struct nlmsghdr *nlh, mnlxt_data_t *data);
+/**
+ * Callback wrapper for mnlxt_xfrm_spdinfo_data
+ * @param nlh pointer to netlink message
+ * @param data mnlxt data given by void pointer
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+static inline int mnlxt_xfrm_spdinfo_DATA(const struct nlmsghdr *nlh, void *data) {
+	return mnlxt_xfrm_spdinfo_data(nlh, (mnlxt_data_t *)data);
+}
+
+/**
+ * Iterates over SPD information stored in mnlxt data
+ * @param data pointer to mnlxt data
+ * @param iterator data iterator; this pointer have to be initialized with NULL before iteration
+ * @return pointer to the next SPD information or NULL for the end of iteration
+ */
+mnlxt_xfrm_spdinfo_t *mnlxt_xfrm_spdinfo_iterate(mnlxt_data_t *data, mnlxt_message_t **iterator);
+/**
+ * Gets SPD information from mnlxt message
+ * @param message pointer to mnlxt message
+ * @return pointer to SPD information structure on success, else NULL
+ */
+mnlxt_xfrm_spdinfo_t *mnlxt_xfrm_spdinfo_get(const mnlxt_message_t *message);
+/**
+ * Removes SPD information from mnlxt message
+ * @param message pointer to mnlxt message
+ * @return pointer to SPD information structure on success, else NULL
+ */
+mnlxt_xfrm_spdinfo_t *mnlxt_xfrm_spdinfo_remove(mnlxt_message_t *message);
+
+/**
+ * Gets policy counts, hash table sizes and hash thresholds of the SPD (XFRM_MSG_GETSPDINFO)
+ * @param data pointer to mnlxt data to store information into
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_spdinfo_dump(mnlxt_data_t *data);
+/**
+ * Gets policy counts, hash table sizes and hash thresholds of the SPD via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_xfrm_connect or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store information into
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_spdinfo_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data);
+
+/**
+ * Sets the hash thresholds of the SPD (XFRM_MSG_NEWSPDINFO), the kernel rebuilds the policy hash tables.
+ * Raising the thresholds of a family whose policies use long prefixes moves them from the inexact list into the
+ * hash tables, so that lookups do not scan all of them.
+ * @param info pointer to SPD information with the thresholds to set
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_spdinfo_request(const mnlxt_xfrm_spdinfo_t *info);
+/**
+ * Sets the hash thresholds of the SPD via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_xfrm_connect or NULL for a temporary connection
+ * @param info pointer to SPD information with the thresholds to set
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_spdinfo_handle_request(mnlxt_handle_t *handle, const mnlxt_xfrm_spdinfo_t *info);
+
+#endif /* LIBMNLXT_XFRM_SPDINFO_H_ */
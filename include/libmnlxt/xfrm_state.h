@@ -0,0 +1,485 @@
+/*
+ * libmnlxt/xfrm_state.h		Libmnlxt Xfrm/IPsec Security Association
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef LIBMNLXT_XFRM_STATE_H_
+#define LIBMNLXT_XFRM_STATE_H_
+
+#include <linux/xfrm.h>
+
+#include <libmnlxt/core.h>
+#include <libmnlxt/data.h>
+#include <libmnlxt/xfrm_policy.h>
+
+/** maximum key length of an algorithm in bytes */
+#define MNLXT_XFRM_ALG_KEY_MAX 64
+
+typedef enum {
+	MNLXT_XFRM_STATE_FAMILY = 0,
+	MNLXT_XFRM_STATE_PROTO,
+	MNLXT_XFRM_STATE_SPI,
+	MNLXT_XFRM_STATE_SRC_ADDR,
+	MNLXT_XFRM_STATE_DST_ADDR,
+	MNLXT_XFRM_STATE_MODE,
+	MNLXT_XFRM_STATE_REQID,
+	MNLXT_XFRM_STATE_REPLAY_WINDOW,
+	MNLXT_XFRM_STATE_FLAGS,
+	MNLXT_XFRM_STATE_MARK,
+	MNLXT_XFRM_STATE_IF_ID,
+	MNLXT_XFRM_STATE_ENCAP,
+	MNLXT_XFRM_STATE_LIFETIME,
+	MNLXT_XFRM_STATE_AUTH,
+	MNLXT_XFRM_STATE_CRYPT,
+	MNLXT_XFRM_STATE_AEAD
+#define MNLXT_XFRM_STATE_MAX MNLXT_XFRM_STATE_AEAD + 1
+} mnlxt_xfrm_state_data_t;
+
+typedef struct {
+	/** algorithm name known by the kernel crypto API, e.g. "hmac(sha256)", "cbc(aes)" or "rfc4106(gcm(aes))" */
+	char name[64];
+	/** key length in bits */
+	uint16_t key_len;
+	/** truncation length of authentication or ICV length of AEAD algorithms in bits */
+	uint16_t icv_len;
+	uint8_t key[MNLXT_XFRM_ALG_KEY_MAX];
+} mnlxt_xfrm_alg_t;
+
+typedef struct {
+	/** UDP_ENCAP_ESPINUDP or UDP_ENCAP_ESPINUDP_NON_IKE see linux/udp.h */
+	uint16_t type;
+	/** source port in host byte order */
+	uint16_t sport;
+	/** destination port in host byte order */
+	uint16_t dport;
+	uint16_t padding;
+	/** original address for NAT-T transport mode */
+	mnlxt_inet_addr_t oa;
+} mnlxt_xfrm_encap_t;
+
+typedef struct {
+	/** Properties flags */
+	uint16_t prop_flags;
+	/** AF_INET6 or AF_INET */
+	uint8_t family;
+	/** IPPROTO_ESP, IPPROTO_AH or IPPROTO_COMP */
+	uint8_t proto;
+	/** XFRM_MODE_* see linux/xfrm.h */
+	uint8_t mode;
+	/** XFRM_STATE_* flags see linux/xfrm.h */
+	uint8_t flags;
+	uint8_t replay_window;
+	uint8_t padding;
+	/** SPI in host byte order */
+	uint32_t spi;
+	uint32_t reqid;
+	/** xfrm interface id */
+	uint32_t if_id;
+	mnlxt_xfrm_mark_t mark;
+	/** source peer */
+	mnlxt_inet_addr_t src;
+	/** destination peer */
+	mnlxt_inet_addr_t dst;
+	mnlxt_xfrm_encap_t encap;
+	struct xfrm_lifetime_cfg lifetime;
+	mnlxt_xfrm_alg_t auth;
+	mnlxt_xfrm_alg_t crypt;
+	mnlxt_xfrm_alg_t aead;
+} mnlxt_xfrm_state_t;
+
+/**
+ * Creates a new xfrm state instance
+ * @return pointer to new dynamically allocated xfrm state structure
+ */
+mnlxt_xfrm_state_t *mnlxt_xfrm_state_new();
+/**
+ * Makes a copy of an xfrm state structure
+ * @param state source state to copy from
+ * @param filter data filter. In case of 0, the function is equal to @mnlxt_xfrm_state_new().
+ * Use macro MNLXT_FLAG to create filter from @mnlxt_xfrm_state_data_t.
+ * @return pointer to copy on success, else NULL
+ */
+mnlxt_xfrm_state_t *mnlxt_xfrm_state_clone(const mnlxt_xfrm_state_t *state, uint64_t filter);
+/**
+ * Frees memory allocated by dynamic allocated an xfrm state structure, the keys are cleared before
+ * @param state pointer to xfrm state structure to free
+ */
+void mnlxt_xfrm_state_free(mnlxt_xfrm_state_t *state);
+/**
+ * Callback wrapper for mnlxt_xfrm_state_free
+ * @param state void pointer to xfrm state structure to free
+ */
+static inline void mnlxt_xfrm_state_FREE(void *state) {
+	mnlxt_xfrm_state_free((mnlxt_xfrm_state_t *)state);
+}
+/**
+ * Sets IP address family on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param family IP address family (AF_INET or AF_INET6 see sys/socket.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_family(mnlxt_xfrm_state_t *state, uint8_t family);
+/**
+ * Gets IP address family from xfrm state structure
+ * @param state pointer to xfrm state structure
+ * @param family pointer to buffer to store IP address family
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_family(const mnlxt_xfrm_state_t *state, uint8_t *family);
+/**
+ * Sets IPsec protocol on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param proto IPsec protocol (IPPROTO_ESP, IPPROTO_AH or IPPROTO_COMP see netinet/in.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_proto(mnlxt_xfrm_state_t *state, uint8_t proto);
+/**
+ * Gets IPsec protocol from xfrm state structure
+ * @param state pointer to xfrm state structure
+ * @param proto pointer to buffer to store IPsec protocol
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_proto(const mnlxt_xfrm_state_t *state, uint8_t *proto);
+/**
+ * Sets SPI on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param spi security parameter index in host byte order
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_spi(mnlxt_xfrm_state_t *state, uint32_t spi);
+/**
+ * Gets SPI from xfrm state structure
+ * @param state pointer to xfrm state structure
+ * @param spi pointer to buffer to store security parameter index in host byte order
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_spi(const mnlxt_xfrm_state_t *state, uint32_t *spi);
+/**
+ * Sets source peer address on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param family IP address family (AF_INET or AF_INET6 see sys/socket.h)
+ * @param buf pointer to IP address buffer
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_src_addr(mnlxt_xfrm_state_t *state, uint8_t family, const mnlxt_inet_addr_t *buf);
+/**
+ * Gets source peer address from xfrm state
+ * @param state pointer to xfrm state structure
+ * @param family pointer to buffer to store IP address family or NULL
+ * @param buf pointer to buffer to store IP address
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_src_addr(const mnlxt_xfrm_state_t *state, uint8_t *family, const mnlxt_inet_addr_t **buf);
+/**
+ * Sets destination peer address on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param family IP address family (AF_INET or AF_INET6 see sys/socket.h)
+ * @param buf pointer to IP address buffer
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_dst_addr(mnlxt_xfrm_state_t *state, uint8_t family, const mnlxt_inet_addr_t *buf);
+/**
+ * Gets destination peer address from xfrm state
+ * @param state pointer to xfrm state structure
+ * @param family pointer to buffer to store IP address family or NULL
+ * @param buf pointer to buffer to store IP address
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_dst_addr(const mnlxt_xfrm_state_t *state, uint8_t *family, const mnlxt_inet_addr_t **buf);
+/**
+ * Sets mode on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param mode mode (XFRM_MODE_* see linux/xfrm.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_mode(mnlxt_xfrm_state_t *state, uint8_t mode);
+/**
+ * Gets mode from xfrm state
+ * @param state pointer to xfrm state structure
+ * @param mode pointer to buffer to store mode
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_mode(const mnlxt_xfrm_state_t *state, uint8_t *mode);
+/**
+ * Sets request id on xfrm state, which binds the state to policy templates
+ * @param state pointer to xfrm state structure
+ * @param reqid request id
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_reqid(mnlxt_xfrm_state_t *state, uint32_t reqid);
+/**
+ * Gets request id from xfrm state
+ * @param state pointer to xfrm state structure
+ * @param reqid pointer to buffer to store request id
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_reqid(const mnlxt_xfrm_state_t *state, uint32_t *reqid);
+/**
+ * Sets replay window size on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param replay_window replay window size in packets
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_replay_window(mnlxt_xfrm_state_t *state, uint8_t replay_window);
+/**
+ * Gets replay window size from xfrm state
+ * @param state pointer to xfrm state structure
+ * @param replay_window pointer to buffer to store replay window size
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_replay_window(const mnlxt_xfrm_state_t *state, uint8_t *replay_window);
+/**
+ * Sets flags on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param flags flags (XFRM_STATE_* see linux/xfrm.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_flags(mnlxt_xfrm_state_t *state, uint8_t flags);
+/**
+ * Gets flags from xfrm state
+ * @param state pointer to xfrm state structure
+ * @param flags pointer to buffer to store flags
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_flags(const mnlxt_xfrm_state_t *state, uint8_t *flags);
+/**
+ * Sets mark on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param mark mark
+ * @param mask mark's mask
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_mark(mnlxt_xfrm_state_t *state, uint32_t mark, uint32_t mask);
+/**
+ * Gets mark from xfrm state
+ * @param state pointer to xfrm state structure
+ * @param mark pointer to buffer to store mark or NULL
+ * @param mask pointer to buffer to store mark's mask or NULL
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_mark(const mnlxt_xfrm_state_t *state, uint32_t *mark, uint32_t *mask);
+/**
+ * Sets xfrm interface id on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param if_id xfrm interface id
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_if_id(mnlxt_xfrm_state_t *state, uint32_t if_id);
+/**
+ * Gets xfrm interface id from xfrm state
+ * @param state pointer to xfrm state structure
+ * @param if_id pointer to buffer to store xfrm interface id
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_if_id(const mnlxt_xfrm_state_t *state, uint32_t *if_id);
+/**
+ * Sets UDP encapsulation on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param encap pointer to encapsulation
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_encap(mnlxt_xfrm_state_t *state, const mnlxt_xfrm_encap_t *encap);
+/**
+ * Gets UDP encapsulation from xfrm state
+ * @param state pointer to xfrm state structure
+ * @param encap pointer to store the pointer to encapsulation
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_encap(const mnlxt_xfrm_state_t *state, const mnlxt_xfrm_encap_t **encap);
+/**
+ * Sets lifetime limits on xfrm state. Without them the state never expires.
+ * @param state pointer to xfrm state structure
+ * @param lifetime pointer to lifetime limits, XFRM_INF for no limit
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_lifetime(mnlxt_xfrm_state_t *state, const struct xfrm_lifetime_cfg *lifetime);
+/**
+ * Gets lifetime limits from xfrm state
+ * @param state pointer to xfrm state structure
+ * @param lifetime pointer to store the pointer to lifetime limits
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_lifetime(const mnlxt_xfrm_state_t *state, const struct xfrm_lifetime_cfg **lifetime);
+/**
+ * Sets authentication algorithm on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param name algorithm name, e.g. "hmac(sha256)"
+ * @param key pointer to key
+ * @param key_len key length in bits, at most 8 * MNLXT_XFRM_ALG_KEY_MAX
+ * @param trunc_len truncation length of the ICV in bits
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_auth(mnlxt_xfrm_state_t *state, const char *name, const uint8_t *key, uint16_t key_len,
+															uint16_t trunc_len);
+/**
+ * Gets authentication algorithm from xfrm state
+ * @param state pointer to xfrm state structure
+ * @param alg pointer to store the pointer to algorithm
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_auth(const mnlxt_xfrm_state_t *state, const mnlxt_xfrm_alg_t **alg);
+/**
+ * Sets encryption algorithm on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param name algorithm name, e.g. "cbc(aes)"
+ * @param key pointer to key
+ * @param key_len key length in bits, at most 8 * MNLXT_XFRM_ALG_KEY_MAX
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_crypt(mnlxt_xfrm_state_t *state, const char *name, const uint8_t *key, uint16_t key_len);
+/**
+ * Gets encryption algorithm from xfrm state
+ * @param state pointer to xfrm state structure
+ * @param alg pointer to store the pointer to algorithm
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_crypt(const mnlxt_xfrm_state_t *state, const mnlxt_xfrm_alg_t **alg);
+/**
+ * Sets AEAD algorithm on xfrm state
+ * @param state pointer to xfrm state structure
+ * @param name algorithm name, e.g. "rfc4106(gcm(aes))"
+ * @param key pointer to key including the salt
+ * @param key_len key length in bits, at most 8 * MNLXT_XFRM_ALG_KEY_MAX
+ * @param icv_len ICV length in bits
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_set_aead(mnlxt_xfrm_state_t *state, const char *name, const uint8_t *key, uint16_t key_len,
+															uint16_t icv_len);
+/**
+ * Gets AEAD algorithm from xfrm state
+ * @param state pointer to xfrm state structure
+ * @param alg pointer to store the pointer to algorithm
+ * @return 0 on success, 1 on not set, else -1
+ */
+int mnlxt_xfrm_state_get_aead(const mnlxt_xfrm_state_t *state, const mnlxt_xfrm_alg_t **alg);
+
+/**
+ * Checks if an xfrm state matches another one
+ * @param state pointer to xfrm state structure
+ * @param match pointer to state to match
+ * @return 0 for matching, else MNLXT_XFRM_STATE_* + 1 for property which does not match
+ */
+int mnlxt_xfrm_state_match(const mnlxt_xfrm_state_t *state, const mnlxt_xfrm_state_t *match);
+/**
+ * Compares two xfrm states
+ * @param state1 pointer to first xfrm state structure
+ * @param state2 pointer to second xfrm state structure
+ * @param filter data filter for selecting state properties to compare. Use macro MNLXT_FLAG to create filter from
+ * @mnlxt_xfrm_state_data_t.
+ * @return 0 for equal, else MNLXT_XFRM_STATE_* + 1 for property which does not match
+ */
+int mnlxt_xfrm_state_compare(const mnlxt_xfrm_state_t *state1, const mnlxt_xfrm_state_t *state2, uint64_t filter);
+
+/**
+ * Initializes netlink message from xfrm state
+ * @param nlh pointer to netlink message
+ * @param state pointer to xfrm state structure
+ * @param nlmsg_type netlink message type (XFRM_MSG_NEWSA, XFRM_MSG_UPDSA, XFRM_MSG_DELSA or XFRM_MSG_GETSA
+ * see linux/xfrm.h)
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_put(struct nlmsghdr *nlh, const mnlxt_xfrm_state_t *state, uint16_t nlmsg_type);
+/**
+ * Callback wrapper for mnlxt_xfrm_state_put
+ * @param nlh pointer to netlink message
+ * @param state pointer to xfrm state structure
+ * @param nlmsg_type netlink message type
+ * @return 0 on success, else -1
+ */
+static inline int mnlxt_xfrm_state_PUT(struct nlmsghdr *nlh, const void *state, uint16_t nlmsg_type) {
+	return mnlxt_xfrm_state_put(nlh, (const mnlxt_xfrm_state_t *)state, nlmsg_type);
+}
+
+/**
+ * Parses netlink message into xfrm state structure and stores it into mnlxt data
+ * @param nlh pointer to netlink message
+ * @param data pointer to mnlxt data
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+int mnlxt_xfrm_state_data(const struct nlmsghdr *nlh, mnlxt_data_t *data);
+/**
+ * Callback wrapper for mnlxt_xfrm_state_data
+ * @param nlh pointer to netlink message
+ * @param data pointer to mnlxt data
+ * @return MNL_CB_OK on success, else MNL_CB_ERROR
+ */
+static inline int mnlxt_xfrm_state_DATA(const struct nlmsghdr *nlh, void *data) {
+	return mnlxt_xfrm_state_data(nlh, (mnlxt_data_t *)data);
+}
+
+/**
+ * Iterates over xfrm states stored in mnlxt data
+ * @param data pointer to mnlxt data
+ * @param iterator pointer to mnlxt message pointer; this pointer have to be initialized with NULL before iteration
+ * @return pointer to the next xfrm state or NULL for the end of iteration
+ */
+mnlxt_xfrm_state_t *mnlxt_xfrm_state_iterate(mnlxt_data_t *data, mnlxt_message_t **iterator);
+/**
+ * Gets xfrm state from mnlxt message
+ * @param message pointer to mnlxt message
+ * @return pointer to xfrm state structure on success, else NULL
+ */
+mnlxt_xfrm_state_t *mnlxt_xfrm_state_get(const mnlxt_message_t *message);
+/**
+ * Removes xfrm state from mnlxt message
+ * @param message pointer to mnlxt message
+ * @return pointer to xfrm state structure on success, else NULL
+ */
+mnlxt_xfrm_state_t *mnlxt_xfrm_state_remove(mnlxt_message_t *message);
+/**
+ * Creates a mnlxt message and stores the given xfrm state into it.
+ * Many states are installed at once by adding their messages to a mnlxt data and sending it by
+ * @mnlxt_handle_batch_request.
+ * @param state double pointer to xfrm state
+ * @param type message type (XFRM_MSG_NEWSA, XFRM_MSG_UPDSA or XFRM_MSG_DELSA see linux/xfrm.h)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set 0 for default.
+ * @return pointer to mnlxt message on success (pointer to the given xfrm state will be reset) else NULL
+ */
+mnlxt_message_t *mnlxt_xfrm_state_message(mnlxt_xfrm_state_t **state, uint16_t type, uint16_t flags);
+
+/**
+ * Sends a netlink request with the given xfrm state
+ * @param state pointer to xfrm state
+ * @param type request type (XFRM_MSG_NEWSA, XFRM_MSG_UPDSA or XFRM_MSG_DELSA)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set 0 for default.
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_request(mnlxt_xfrm_state_t *state, uint16_t type, uint16_t flags);
+/**
+ * Sends a netlink request with the given xfrm state via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_xfrm_connect or NULL for a temporary connection
+ * @param state pointer to xfrm state
+ * @param type request type (XFRM_MSG_NEWSA, XFRM_MSG_UPDSA or XFRM_MSG_DELSA)
+ * @param flags request flags (NLM_F_* see linux/netlink.h). Set 0 for default.
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_handle_request(mnlxt_handle_t *handle, mnlxt_xfrm_state_t *state, uint16_t type,
+																		uint16_t flags);
+/**
+ * Gets information of all xfrm states configured on system
+ * @param data pointer to mnlxt data to store information into
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_dump(mnlxt_data_t *data);
+/**
+ * Gets information of all xfrm states configured on system via an already connected mnlxt handle
+ * @param handle pointer to mnlxt handle connected by @mnlxt_xfrm_connect or NULL for a temporary connection
+ * @param data pointer to mnlxt data to store information into
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data);
+
+/**
+ * Deletes all states of a protocol by a single request (XFRM_MSG_FLUSHSA)
+ * @param handle pointer to mnlxt handle connected by @mnlxt_xfrm_connect or NULL for a temporary connection
+ * @param proto IPPROTO_ESP, IPPROTO_AH, IPPROTO_COMP, IPSEC_PROTO_ANY for these three, or 0 for all states
+ * @return 0 on success, else -1
+ */
+int mnlxt_xfrm_state_flush(mnlxt_handle_t *handle, uint8_t proto);
+
+#endif /* LIBMNLXT_XFRM_STATE_H_ */
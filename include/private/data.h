@@ -0,0 +1,40 @@
+/*
+ * data.h		Libmnlxt Internal Data, allocation of parsed messages
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef MNLXT_PRIVATE_DATA_H_
+#define MNLXT_PRIVATE_DATA_H_
+
+#include <libmnlxt/data.h>
+
+struct mnlxt_arena_s *mnlxt_arena_new(size_t slab_size);
+void *mnlxt_arena_alloc(struct mnlxt_arena_s *arena, size_t size);
+void mnlxt_arena_reset(struct mnlxt_arena_s *arena);
+void mnlxt_arena_free(struct mnlxt_arena_s *arena);
+
+/* allocations for parsing into mnlxt data: from its arena if any, else from the heap */
+void *mnlxt_data_alloc(mnlxt_data_t *data, size_t size);
+char *mnlxt_data_strndup(mnlxt_data_t *data, const char *str, size_t n);
+mnlxt_message_t *mnlxt_data_message_new(mnlxt_data_t *data);
+/* frees a payload not added to mnlxt data yet, arena memory is released with the arena only */
+void mnlxt_data_release(mnlxt_data_t *data, void *payload, mnlxt_data_free_cb_t free_cb);
+
+/* dumps via a temporary connection with socket options */
+int mnlxt_data_dump_opts(mnlxt_data_t *data, int bus, struct nlmsghdr *nlh, const mnlxt_connect_opts_t *opts);
+/* gets a single object via a connected handle or a temporary connection, the acknowledge ends the answer */
+int mnlxt_data_get(mnlxt_handle_t *handle, mnlxt_data_t *data, int bus, struct nlmsghdr *nlh);
+/* dumps with a complete request header, the filter of a strict dump request is applied by the kernel */
+int mnlxt_rt_dump_request(mnlxt_handle_t *handle, mnlxt_data_t *data, struct nlmsghdr *nlh, int strict);
+int mnlxt_rt_get_request(mnlxt_handle_t *handle, mnlxt_data_t *data, struct nlmsghdr *nlh);
+int mnlxt_xfrm_get_request(mnlxt_handle_t *handle, mnlxt_data_t *data, struct nlmsghdr *nlh);
+
+mnlxt_message_t *mnlxt_rt_data_message_new(mnlxt_data_t *data, uint16_t type, void *payload);
+mnlxt_message_t *mnlxt_xfrm_data_message_new(mnlxt_data_t *data, uint16_t type, void *payload);
+
+#endif /* MNLXT_PRIVATE_DATA_H_ */
@@ -0,0 +1,46 @@
+/*
+ * hash.h		Libmnlxt Internal Hash Table
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef MNLXT_PRIVATE_HASH_H_
+#define MNLXT_PRIVATE_HASH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** entry to embed into hashed structures */
+typedef struct mnlxt_hash_entry_s {
+	/** next entry of the same bucket */
+	struct mnlxt_hash_entry_s *chain;
+	/** neighbours in insertion order */
+	struct mnlxt_hash_entry_s *next, *prev;
+	uint32_t hash;
+} mnlxt_hash_entry_t;
+
+typedef struct {
+	mnlxt_hash_entry_t **buckets;
+	/** number of buckets, power of two */
+	size_t size;
+	size_t count;
+	mnlxt_hash_entry_t *first, *last;
+} mnlxt_hash_t;
+
+/** checks whether entry matches key, returns 0 on match */
+typedef int (*mnlxt_hash_cmp_cb_t)(const mnlxt_hash_entry_t *entry, const void *key);
+
+uint32_t mnlxt_hash_fnv(const void *buf, size_t len);
+
+int mnlxt_hash_init(mnlxt_hash_t *hash, size_t size);
+/* frees the buckets only, the entries belong to the caller */
+void mnlxt_hash_clean(mnlxt_hash_t *hash);
+int mnlxt_hash_insert(mnlxt_hash_t *hash, mnlxt_hash_entry_t *entry, uint32_t hashval);
+mnlxt_hash_entry_t *mnlxt_hash_find(const mnlxt_hash_t *hash, uint32_t hashval, mnlxt_hash_cmp_cb_t cmp, const void *key);
+void mnlxt_hash_remove(mnlxt_hash_t *hash, mnlxt_hash_entry_t *entry);
+
+#endif /* MNLXT_PRIVATE_HASH_H_ */
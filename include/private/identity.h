@@ -0,0 +1,35 @@
+/*
+ * identity.h		Libmnlxt Internal Identity of Routing Objects
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef MNLXT_PRIVATE_IDENTITY_H_
+#define MNLXT_PRIVATE_IDENTITY_H_
+
+#include <stdint.h>
+
+/*
+ * The kernel knows only one object of an identity at a time.
+ * The hash functions return equal values for objects of the same identity,
+ * the cmp functions return 0 for objects of the same identity.
+ */
+
+uint32_t mnlxt_rt_route_identity_hash(const void *route);
+int mnlxt_rt_route_identity_cmp(const void *route1, const void *route2);
+
+uint32_t mnlxt_rt_addr_identity_hash(const void *addr);
+int mnlxt_rt_addr_identity_cmp(const void *addr1, const void *addr2);
+
+/* rules have no identity besides all their properties, the hash covers some of them */
+uint32_t mnlxt_rt_rule_identity_hash(const void *rule);
+int mnlxt_rt_rule_identity_cmp(const void *rule1, const void *rule2);
+
+uint32_t mnlxt_rt_neigh_identity_hash(const void *neigh);
+int mnlxt_rt_neigh_identity_cmp(const void *neigh1, const void *neigh2);
+
+#endif /* MNLXT_PRIVATE_IDENTITY_H_ */
@@ -0,0 +1,42 @@
+/*
+ * reconcile.h		Libmnlxt Internal Reconciliation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef MNLXT_PRIVATE_RECONCILE_H_
+#define MNLXT_PRIVATE_RECONCILE_H_
+
+#include <libmnlxt/data.h>
+
+/* functions and message types of a kind of objects to reconcile */
+typedef struct {
+	/* hash of the identity, equal for objects of the same identity */
+	uint32_t (*hash)(const void *object);
+	/* returns 0 if the current object has the identity of the desired one */
+	int (*identity)(const void *current, const void *desired);
+	/* returns 0 if the current object has all properties of the desired one */
+	int (*match)(const void *current, const void *desired);
+	void *(*get)(const mnlxt_message_t *message);
+	/* returns a dynamically allocated copy with all properties */
+	void *(*clone)(const void *object);
+	mnlxt_data_free_cb_t free;
+	/* creates a message owning the object on success */
+	mnlxt_message_t *(*message)(void *object, uint16_t type, uint16_t flags);
+	uint16_t new_type;
+	uint16_t new_flags;
+	/* 0 to delete the current object and create the desired one instead */
+	uint16_t replace_type;
+	uint16_t replace_flags;
+	uint16_t del_type;
+} mnlxt_reconcile_ops_t;
+
+/* adds the messages turning the current objects into the desired ones to the changes */
+int mnlxt_data_reconcile(const mnlxt_reconcile_ops_t *ops, mnlxt_data_t *desired, mnlxt_data_t *current,
+												 mnlxt_data_t *changes);
+
+#endif /* MNLXT_PRIVATE_RECONCILE_H_ */
@@ -0,0 +1,53 @@
+/*
+ * trie.h		Libmnlxt Internal Path Compressed Binary Trie
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef MNLXT_PRIVATE_TRIE_H_
+#define MNLXT_PRIVATE_TRIE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** maximal key length in bytes */
+#define MNLXT_TRIE_KEY_SIZE 16
+
+typedef struct mnlxt_trie_node_s {
+	struct mnlxt_trie_node_s *child[2];
+	/** value of the prefix, NULL for nodes only joining two branches */
+	void *value;
+	/** prefix length in bits */
+	uint8_t len;
+	/** prefix, bits behind the prefix length are 0 */
+	uint8_t key[MNLXT_TRIE_KEY_SIZE];
+} mnlxt_trie_node_t;
+
+typedef struct {
+	mnlxt_trie_node_t *root;
+} mnlxt_trie_t;
+
+/** function to free values */
+typedef void (*mnlxt_trie_free_cb_t)(void *value);
+/** function to visit values */
+typedef void (*mnlxt_trie_walk_cb_t)(const uint8_t *key, uint8_t len, void *value, void *arg);
+
+/* gets the value slot of the prefix, which is created if needed; a new slot is NULL */
+void **mnlxt_trie_insert(mnlxt_trie_t *trie, const uint8_t *key, uint8_t len);
+/* gets the value slot of the prefix, or NULL */
+void **mnlxt_trie_find(const mnlxt_trie_t *trie, const uint8_t *key, uint8_t len);
+/* gets the value of the longest prefix with value covering the first bits of key */
+void *mnlxt_trie_lookup(const mnlxt_trie_t *trie, const uint8_t *key, uint8_t bits);
+/* gets the values of all prefixes covering the first bits of key, shorter prefixes first; returns their number */
+size_t mnlxt_trie_prefixes(const mnlxt_trie_t *trie, const uint8_t *key, uint8_t bits, void **values, size_t max);
+/* removes the prefix and returns its value */
+void *mnlxt_trie_remove(mnlxt_trie_t *trie, const uint8_t *key, uint8_t len);
+/* visits all values, shorter prefixes first */
+void mnlxt_trie_walk(const mnlxt_trie_t *trie, mnlxt_trie_walk_cb_t cb, void *arg);
+void mnlxt_trie_clean(mnlxt_trie_t *trie, mnlxt_trie_free_cb_t free_cb);
+
+#endif /* MNLXT_PRIVATE_TRIE_H_ */
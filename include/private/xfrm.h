@@ -0,0 +1,38 @@
+/*
+ * xfrm.h		Libmnlxt Internal Parsing of Xfrm Messages
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#ifndef MNLXT_PRIVATE_XFRM_H_
+#define MNLXT_PRIVATE_XFRM_H_
+
+#include "libmnlxt/xfrm.h"
+
+/*
+ * Policies and states are embedded in several xfrm messages, e.g. in the events.
+ * The attrs functions parse the attributes behind the header of the given size,
+ * on failure they return -1 and set the error string of mnlxt data.
+ */
+
+/** the kernel knows only one policy of a direction, selector, mark and xfrm interface id */
+#define MNLXT_XFRM_POLICY_IDENTITY_FILTER                                                                       \
+	(MNLXT_FLAG(MNLXT_XFRM_POLICY_FAMILY) | MNLXT_FLAG(MNLXT_XFRM_POLICY_PROTO)                                   \
+	 | MNLXT_FLAG(MNLXT_XFRM_POLICY_SRC_PREFIXLEN) | MNLXT_FLAG(MNLXT_XFRM_POLICY_DST_PREFIXLEN)                  \
+	 | MNLXT_FLAG(MNLXT_XFRM_POLICY_SRC_ADDR) | MNLXT_FLAG(MNLXT_XFRM_POLICY_DST_ADDR)                            \
+	 | MNLXT_FLAG(MNLXT_XFRM_POLICY_SRC_PORT) | MNLXT_FLAG(MNLXT_XFRM_POLICY_DST_PORT)                            \
+	 | MNLXT_FLAG(MNLXT_XFRM_POLICY_IFINDEX) | MNLXT_FLAG(MNLXT_XFRM_POLICY_DIR) | MNLXT_FLAG(MNLXT_XFRM_POLICY_MARK) \
+	 | MNLXT_FLAG(MNLXT_XFRM_POLICY_IF_ID))
+
+void mnlxt_xfrm_policy_selector_set(mnlxt_xfrm_policy_t *policy, const struct xfrm_selector *sel);
+void mnlxt_xfrm_policy_info_set(mnlxt_xfrm_policy_t *policy, const struct xfrm_userpolicy_info *xpinfo);
+int mnlxt_xfrm_policy_attrs(mnlxt_data_t *data, mnlxt_xfrm_policy_t *policy, const struct nlmsghdr *nlh, size_t offset);
+
+void mnlxt_xfrm_state_info_set(mnlxt_xfrm_state_t *state, const struct xfrm_usersa_info *xsinfo);
+int mnlxt_xfrm_state_attrs(mnlxt_data_t *data, mnlxt_xfrm_state_t *state, const struct nlmsghdr *nlh, size_t offset);
+
+#endif /* MNLXT_PRIVATE_XFRM_H_ */
@@ -8,32 +8,134 @@
  *
  */
 
+#define _GNU_SOURCE
+
+#include "config.h"
+
 #include <errno.h>
+#include <fcntl.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
 #include <time.h>
 
-#include "libmnlxt/core.h"
+#include "libmnlxt/async.h"
 
-int mnlxt_connect(mnlxt_handle_t *handle, int bus, int groups) {
+/* socket options of kernel headers older than the running kernel, it rejects them if unknown */
+#ifndef NETLINK_CAP_ACK
+#define NETLINK_CAP_ACK 10
+#endif
+#ifndef NETLINK_EXT_ACK
+#define NETLINK_EXT_ACK 11
+#endif
+#ifndef NETLINK_GET_STRICT_CHK
+#define NETLINK_GET_STRICT_CHK 12
+#endif
+
+/** datagrams received by one batched read */
+struct mnlxt_rx_s {
+	/** maximal number of datagrams per read */
+	unsigned int size;
+	/** number of datagrams received by the last read */
+	unsigned int count;
+	/** next datagram to pass */
+	unsigned int next;
+	char *buf;
+	struct mmsghdr *msgs;
+	struct iovec *iov;
+	struct sockaddr_nl *addr;
+};
+
+static struct mnl_socket *mnlxt_socket_open(int bus, uint32_t flags) {
+	struct mnl_socket *nl;
+#ifdef HAVE_MNL_SOCKET_OPEN2
+	int type = 0;
+	if (flags & MNLXT_FLAG(MNLXT_CONNECT_NONBLOCK)) {
+		type |= SOCK_NONBLOCK;
+	}
+	if (flags & MNLXT_FLAG(MNLXT_CONNECT_CLOEXEC)) {
+		type |= SOCK_CLOEXEC;
+	}
+	nl = mnl_socket_open2(bus, type);
+#else
+	nl = mnl_socket_open(bus);
+	if (nl && (flags & (MNLXT_FLAG(MNLXT_CONNECT_NONBLOCK) | MNLXT_FLAG(MNLXT_CONNECT_CLOEXEC)))) {
+		int fd = mnl_socket_get_fd(nl), fl;
+		if ((flags & MNLXT_FLAG(MNLXT_CONNECT_NONBLOCK))
+				&& (0 > (fl = fcntl(fd, F_GETFL)) || 0 > fcntl(fd, F_SETFL, fl | O_NONBLOCK))) {
+			goto failed;
+		}
+		if ((flags & MNLXT_FLAG(MNLXT_CONNECT_CLOEXEC))
+				&& (0 > (fl = fcntl(fd, F_GETFD)) || 0 > fcntl(fd, F_SETFD, fl | FD_CLOEXEC))) {
+			goto failed;
+		}
+	}
+	return nl;
+failed:
+	mnl_socket_close(nl);
+	nl = NULL;
+#endif
+	return nl;
+}
+
+static int mnlxt_socket_set_buf(struct mnl_socket *nl, int name, int force_name, int size, int force) {
+	int fd = mnl_socket_get_fd(nl);
+	if (force && 0 == setsockopt(fd, SOL_SOCKET, force_name, &size, sizeof(size))) {
+		return 0;
+	}
+	/* without CAP_NET_ADMIN the size is capped by rmem_max or wmem_max */
+	return setsockopt(fd, SOL_SOCKET, name, &size, sizeof(size));
+}
+
+static int mnlxt_socket_set_flag(struct mnl_socket *nl, int name) {
+	int on = 1;
+	return mnl_socket_setsockopt(nl, name, &on, sizeof(on));
+}
+
+static int mnlxt_socket_set_opts(mnlxt_handle_t *handle, struct mnl_socket *nl, const mnlxt_connect_opts_t *opts) {
+	int rc = -1, force = (opts->flags & MNLXT_FLAG(MNLXT_CONNECT_BUF_FORCE));
+
+	if (opts->rcvbuf && 0 != mnlxt_socket_set_buf(nl, SO_RCVBUF, SO_RCVBUFFORCE, opts->rcvbuf, force)) {
+		handle->error_str = "setting receive buffer size failed";
+	} else if (opts->sndbuf && 0 != mnlxt_socket_set_buf(nl, SO_SNDBUF, SO_SNDBUFFORCE, opts->sndbuf, force)) {
+		handle->error_str = "setting send buffer size failed";
+	} else if ((opts->flags & MNLXT_FLAG(MNLXT_CONNECT_NO_ENOBUFS))
+						 && 0 != mnlxt_socket_set_flag(nl, NETLINK_NO_ENOBUFS)) {
+		handle->error_str = "setting NETLINK_NO_ENOBUFS failed";
+	} else if ((opts->flags & MNLXT_FLAG(MNLXT_CONNECT_CAP_ACK)) && 0 != mnlxt_socket_set_flag(nl, NETLINK_CAP_ACK)) {
+		handle->error_str = "setting NETLINK_CAP_ACK failed";
+	} else if ((opts->flags & MNLXT_FLAG(MNLXT_CONNECT_EXT_ACK)) && 0 != mnlxt_socket_set_flag(nl, NETLINK_EXT_ACK)) {
+		handle->error_str = "setting NETLINK_EXT_ACK failed";
+	} else if ((opts->flags & MNLXT_FLAG(MNLXT_CONNECT_STRICT_CHK))
+						 && 0 != mnlxt_socket_set_flag(nl, NETLINK_GET_STRICT_CHK)) {
+		handle->error_str = "setting NETLINK_GET_STRICT_CHK failed";
+	} else {
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_connect_opts(mnlxt_handle_t *handle, int bus, int groups, const mnlxt_connect_opts_t *opts) {
 	int rc = -1;
 	struct mnl_socket *nl = NULL;
 
 	do {
-		if (!handle) {
+		if (!handle || (opts && opts->flags >= MNLXT_FLAG((MNLXT_CONNECT_MAX)))) {
 			errno = EINVAL;
 			break;
-		} else {
-			handle->error_str = NULL;
 		}
 
 		memset(handle, 0, sizeof(mnlxt_handle_t));
-		nl = mnl_socket_open(bus);
+		nl = mnlxt_socket_open(bus, (opts ? opts->flags : 0));
 		if (nl == NULL) {
 			handle->error_str = "open socket failed";
 			break;
 		}
 
+		if (opts && 0 != mnlxt_socket_set_opts(handle, nl, opts)) {
+			break;
+		}
+
 		if (mnl_socket_bind(nl, groups, MNL_SOCKET_AUTOPID) < 0) {
 			handle->error_str = "bind socket failed";
 			break;
@@ -49,16 +151,32 @@ int mnlxt_connect(mnlxt_handle_t *handle, int bus, int groups) {
 	} else {
 		handle->nl = nl;
 		handle->seq = time(NULL);
+		handle->groups = groups;
 	}
 	return rc;
 }
 
+int mnlxt_connect(mnlxt_handle_t *handle, int bus, int groups) {
+	return mnlxt_connect_opts(handle, bus, groups, NULL);
+}
+
 void mnlxt_disconnect(mnlxt_handle_t *handle) {
 	if (handle) {
+		mnlxt_async_clean(handle);
 		if (handle->nl) {
 			mnl_socket_close(handle->nl);
 			handle->nl = NULL;
 		}
+		if (handle->rx_buf) {
+			free(handle->rx_buf);
+			handle->rx_buf = NULL;
+			handle->rx_size = 0;
+		}
+		if (handle->rx) {
+			/* drop unprocessed datagrams */
+			handle->rx->next = handle->rx->count;
+			mnlxt_handle_set_read_batch(handle, 0);
+		}
 	}
 }
 
@@ -72,48 +190,310 @@ int mnlxt_send(mnlxt_handle_t *handle, struct nlmsghdr *nlh) {
 	return rc;
 }
 
-int mnlxt_receive(mnlxt_handle_t *handle, mnlxt_buffer_t *buffer) {
-	int rc = -1;
-	char buf[MNL_SOCKET_BUFFER_SIZE];
-	if (!handle || !handle->nl || !buffer) {
-		errno = EINVAL;
-		goto end;
+static size_t mnlxt_read_size(const mnlxt_handle_t *handle) {
+	return (handle->read_size ? handle->read_size : MNL_SOCKET_BUFFER_SIZE);
+}
+
+static void mnlxt_receive_failed(mnlxt_handle_t *handle) {
+	if (ENOBUFS == errno) {
+		/* the kernel dropped messages for this socket */
+		++handle->overruns;
+		handle->error_str = "receive queue overrun";
+	} else {
+		handle->error_str = "receive failed";
 	}
-	int len = 0;
-	while (0 > (len = mnl_socket_recvfrom(handle->nl, buf, sizeof(buf)))) {
+}
+
+static ssize_t mnlxt_recvmsg(mnlxt_handle_t *handle, char *buf, size_t size, int flags) {
+	ssize_t len;
+	struct sockaddr_nl addr;
+	struct iovec iov = {.iov_base = buf, .iov_len = size};
+	struct msghdr msg = {.msg_name = &addr, .msg_namelen = sizeof(addr), .msg_iov = &iov, .msg_iovlen = 1};
+
+	while (0 > (len = recvmsg(mnl_socket_get_fd(handle->nl), &msg, flags))) {
 		if (EWOULDBLOCK == errno) {
 			/* would block on non blocking socket */
-			rc = 0;
-			goto end;
+			len = 0;
+			break;
 		}
-		if (EINTR != errno && EAGAIN != errno) {
+		if (EINTR != errno) {
 			/* an error by receiving message */
-			handle->error_str = "receive failed";
-			goto end;
+			mnlxt_receive_failed(handle);
+			break;
 		}
 	}
+	if (0 < len && sizeof(addr) != msg.msg_namelen) {
+		handle->error_str = "invalid sender address";
+		errno = EINVAL;
+		len = -1;
+	} else if (0 < len && !((MSG_PEEK | MSG_TRUNC) & flags) && (MSG_TRUNC & msg.msg_flags)) {
+		handle->error_str = "message truncated";
+		errno = EMSGSIZE;
+		len = -1;
+	}
+	return len;
+}
 
+static void mnlxt_buffer_set(mnlxt_handle_t *handle, mnlxt_buffer_t *buffer, char *buf, size_t len) {
+	buffer->buf = buf;
+	buffer->len = len;
+	buffer->borrowed = 1;
+	buffer->portid = mnl_socket_get_portid(handle->nl);
+	buffer->seq = handle->seq;
+	if (NULL != handle->data_handlers) {
+		buffer->data_handlers = handle->data_handlers;
+		buffer->data_nhandlers = handle->data_nhandlers;
+	}
+}
+
+static int mnlxt_receive_into(mnlxt_handle_t *handle, mnlxt_buffer_t *buffer, char *buf, size_t size) {
+	ssize_t len = mnlxt_recvmsg(handle, buf, size, 0);
 	if (0 < len) {
-		buffer->buf = malloc(len);
-		if (!buffer->buf) {
-			handle->error_str = "malloc failed";
+		mnlxt_buffer_set(handle, buffer, buf, len);
+	}
+	return len;
+}
+
+static int mnlxt_receive_queued(mnlxt_handle_t *handle, mnlxt_buffer_t *buffer) {
+	int rc = -1;
+	struct mnlxt_rx_s *rx = handle->rx;
+	struct mmsghdr *msg;
+
+	if (rx->next >= rx->count) {
+#ifdef HAVE_RECVMMSG
+		int n;
+		unsigned int i;
+		rx->count = rx->next = 0;
+		for (i = 0; i < rx->size; ++i) {
+			rx->msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_nl);
+			rx->msgs[i].msg_hdr.msg_flags = 0;
+		}
+		/* block for the first datagram only and take whatever else is already queued */
+		while (0 > (n = recvmmsg(mnl_socket_get_fd(handle->nl), rx->msgs, rx->size, MSG_WAITFORONE, NULL))) {
+			if (EWOULDBLOCK == errno) {
+				/* would block on non blocking socket */
+				rc = 0;
+				goto end;
+			}
+			if (EINTR != errno) {
+				/* an error by receiving message */
+				mnlxt_receive_failed(handle);
+				goto end;
+			}
+		}
+		rx->count = n;
+		if (0 == n) {
+			rc = 0;
 			goto end;
 		}
+#else
+		errno = ENOTSUP;
+		goto end;
+#endif
+	}
+
+	msg = &rx->msgs[rx->next++];
+	if (sizeof(struct sockaddr_nl) != msg->msg_hdr.msg_namelen) {
+		handle->error_str = "invalid sender address";
+		errno = EINVAL;
+	} else if (MSG_TRUNC & msg->msg_hdr.msg_flags) {
+		handle->error_str = "message truncated";
+		errno = EMSGSIZE;
+	} else {
+		mnlxt_buffer_set(handle, buffer, msg->msg_hdr.msg_iov->iov_base, msg->msg_len);
+		rc = msg->msg_len;
+	}
+end:
+	return rc;
+}
+
+static int mnlxt_rx_setup(mnlxt_handle_t *handle, unsigned int count) {
+	int rc = -1;
+	struct mnlxt_rx_s *rx = NULL;
+	size_t size = mnlxt_read_size(handle);
+	unsigned int i;
 
-		memcpy(buffer->buf, buf, len);
-		buffer->len = len;
-		buffer->portid = mnl_socket_get_portid(handle->nl);
-		buffer->seq = handle->seq;
-		if (NULL != handle->data_handlers) {
-			buffer->data_handlers = handle->data_handlers;
-			buffer->data_nhandlers = handle->data_nhandlers;
+	if (NULL != handle->rx && handle->rx->next < handle->rx->count) {
+		/* datagrams of the last read are not processed yet */
+		errno = EBUSY;
+		goto end;
+	}
+	if (1 < count) {
+		if (NULL == (rx = calloc(1, sizeof(*rx))) || NULL == (rx->buf = malloc(count * size))
+				|| NULL == (rx->msgs = calloc(count, sizeof(*rx->msgs)))
+				|| NULL == (rx->iov = calloc(count, sizeof(*rx->iov)))
+				|| NULL == (rx->addr = calloc(count, sizeof(*rx->addr)))) {
+			handle->error_str = "malloc failed";
+			goto end;
+		}
+		rx->size = count;
+		for (i = 0; i < count; ++i) {
+			rx->iov[i].iov_base = rx->buf + i * size;
+			rx->iov[i].iov_len = size;
+			rx->msgs[i].msg_hdr.msg_name = &rx->addr[i];
+			rx->msgs[i].msg_hdr.msg_iov = &rx->iov[i];
+			rx->msgs[i].msg_hdr.msg_iovlen = 1;
 		}
 	}
-	rc = len;
+	rc = 0;
 end:
+	if (0 == rc) {
+		/* swap the queue */
+		struct mnlxt_rx_s *old = handle->rx;
+		handle->rx = rx;
+		rx = old;
+	}
+	if (NULL != rx) {
+		free(rx->buf);
+		free(rx->msgs);
+		free(rx->iov);
+		free(rx->addr);
+		free(rx);
+	}
+	return rc;
+}
+
+int mnlxt_handle_set_read_size(mnlxt_handle_t *handle, size_t size) {
+	int rc = -1;
+	size_t old_size;
+	if (!handle) {
+		errno = EINVAL;
+	} else {
+		old_size = handle->read_size;
+		handle->read_size = size;
+		if (NULL != handle->rx && 0 != (rc = mnlxt_rx_setup(handle, handle->rx->size))) {
+			handle->read_size = old_size;
+		} else {
+			rc = 0;
+		}
+	}
+	return rc;
+}
+
+int mnlxt_handle_set_read_batch(mnlxt_handle_t *handle, unsigned int count) {
+	int rc = -1;
+	if (!handle) {
+		errno = EINVAL;
+	} else if (1 < count) {
+#ifdef HAVE_RECVMMSG
+		rc = mnlxt_rx_setup(handle, count);
+#else
+		errno = ENOTSUP;
+#endif
+	} else if (NULL != handle->rx) {
+		rc = mnlxt_rx_setup(handle, 0);
+	} else {
+		rc = 0;
+	}
 	return rc;
 }
 
+int mnlxt_receive_buf(mnlxt_handle_t *handle, mnlxt_buffer_t *buffer, char *buf, size_t size) {
+	int rc = -1;
+	ssize_t len;
+	if (!handle || !handle->nl || !buffer || !buf) {
+		errno = EINVAL;
+	} else if (0 < (len = mnlxt_recvmsg(handle, NULL, 0, MSG_PEEK | MSG_TRUNC))) {
+		if ((size_t)len > size) {
+			buffer->len = len;
+			handle->error_str = "receive buffer too small";
+			errno = EMSGSIZE;
+		} else {
+			rc = mnlxt_receive_into(handle, buffer, buf, size);
+		}
+	} else {
+		rc = len;
+	}
+	return rc;
+}
+
+/* grows the receive buffer of the handle to at least size bytes */
+static int mnlxt_rx_reserve(mnlxt_handle_t *handle, size_t size) {
+	int rc = 0;
+	if (handle->rx_size < size) {
+		char *buf = realloc(handle->rx_buf, size);
+		if (!buf) {
+			handle->error_str = "malloc failed";
+			rc = -1;
+		} else {
+			handle->rx_buf = buf;
+			handle->rx_size = size;
+		}
+	}
+	return rc;
+}
+
+int mnlxt_receive_inplace(mnlxt_handle_t *handle, mnlxt_buffer_t *buffer) {
+	int rc = -1;
+	ssize_t len;
+	if (!handle || !handle->nl || !buffer) {
+		errno = EINVAL;
+	} else if (NULL != handle->rx) {
+		rc = mnlxt_receive_queued(handle, buffer);
+	} else if (0 != handle->read_size) {
+		/* the configured read size must fit every datagram */
+		if (0 == mnlxt_rx_reserve(handle, handle->read_size)) {
+			rc = mnlxt_receive_into(handle, buffer, handle->rx_buf, handle->read_size);
+		}
+	} else if (0 == mnlxt_rx_reserve(handle, MNL_SOCKET_BUFFER_SIZE)) {
+		/* the kernel does not fill datagrams beyond the size of the last read, with MSG_TRUNC the length of a
+		 * truncated one is returned */
+		len = mnlxt_recvmsg(handle, handle->rx_buf, handle->rx_size, MSG_TRUNC);
+		if (0 < len && (size_t)len > handle->rx_size) {
+			/* the datagram is lost, the buffer is grown for the next ones of an oversized message */
+			mnlxt_rx_reserve(handle, len);
+			handle->error_str = "message truncated";
+			errno = EMSGSIZE;
+		} else {
+			if (0 < len) {
+				mnlxt_buffer_set(handle, buffer, handle->rx_buf, len);
+			}
+			rc = len;
+		}
+	}
+	return rc;
+}
+
+int mnlxt_receive(mnlxt_handle_t *handle, mnlxt_buffer_t *buffer) {
+	mnlxt_buffer_t received = {};
+	int rc = mnlxt_receive_inplace(handle, &received);
+	if (0 < rc) {
+		*buffer = received;
+		buffer->borrowed = 0;
+		buffer->buf = malloc(received.len);
+		if (!buffer->buf) {
+			handle->error_str = "malloc failed";
+			memset(buffer, 0, sizeof(mnlxt_buffer_t));
+			rc = -1;
+		} else {
+			memcpy(buffer->buf, received.buf, received.len);
+		}
+	}
+	return rc;
+}
+
+int mnlxt_handle_add_group(mnlxt_handle_t *handle, unsigned int group) {
+	int rc = -1;
+	if (NULL == handle || NULL == handle->nl || 0 == group) {
+		errno = EINVAL;
+	} else if (0 != mnl_socket_setsockopt(handle->nl, NETLINK_ADD_MEMBERSHIP, &group, sizeof(group))) {
+		handle->error_str = "setting NETLINK_ADD_MEMBERSHIP failed";
+	} else {
+		rc = 0;
+	}
+	return rc;
+}
+
+unsigned long mnlxt_handle_get_overruns(const mnlxt_handle_t *handle) {
+	unsigned long overruns = 0;
+	if (handle) {
+		overruns = handle->overruns;
+	} else {
+		errno = EINVAL;
+	}
+	return overruns;
+}
+
 int mnlxt_handel_get_fd(const mnlxt_handle_t *handle) {
 	int rc = -1;
 	if (handle && handle->nl) {
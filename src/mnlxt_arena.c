@@ -0,0 +1,136 @@
+/*
+ * mnlxt_arena.c		Libmnlxt Arena, slab allocation of parsed messages
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "private/data.h"
+
+/** default slab size */
+#define MNLXT_ARENA_SLAB_SIZE 65536
+/** alignment of allocations */
+#define MNLXT_ARENA_ALIGN (2 * sizeof(void *))
+#define MNLXT_ARENA_ALIGN_UP(size) (((size) + MNLXT_ARENA_ALIGN - 1) & ~(MNLXT_ARENA_ALIGN - 1))
+
+typedef struct mnlxt_slab_s {
+	struct mnlxt_slab_s *next;
+	size_t size;
+	size_t used;
+} mnlxt_slab_t;
+
+#define MNLXT_SLAB_HDRLEN MNLXT_ARENA_ALIGN_UP(sizeof(mnlxt_slab_t))
+
+struct mnlxt_arena_s {
+	size_t slab_size;
+	/** all slabs, the ones behind the current slab are free */
+	mnlxt_slab_t *first, *current;
+};
+
+struct mnlxt_arena_s *mnlxt_arena_new(size_t slab_size) {
+	struct mnlxt_arena_s *arena = calloc(1, sizeof(struct mnlxt_arena_s));
+	if (arena) {
+		arena->slab_size = (slab_size ? slab_size : MNLXT_ARENA_SLAB_SIZE);
+	}
+	return arena;
+}
+
+void *mnlxt_arena_alloc(struct mnlxt_arena_s *arena, size_t size) {
+	void *ptr = NULL;
+	mnlxt_slab_t *slab = arena->current;
+	size = MNLXT_ARENA_ALIGN_UP(size ? size : 1);
+
+	if (NULL == slab || slab->size - slab->used < size) {
+		/* continue with the next free slab or insert a new one */
+		slab = (arena->current ? arena->current->next : NULL);
+		if (NULL == slab || slab->size < size) {
+			size_t slab_size = (arena->slab_size > size ? arena->slab_size : size);
+			if (NULL == (slab = malloc(MNLXT_SLAB_HDRLEN + slab_size))) {
+				goto end;
+			}
+			slab->size = slab_size;
+			slab->used = 0;
+			if (arena->current) {
+				slab->next = arena->current->next;
+				arena->current->next = slab;
+			} else {
+				slab->next = NULL;
+				arena->first = slab;
+			}
+		}
+		arena->current = slab;
+	}
+	ptr = (char *)slab + MNLXT_SLAB_HDRLEN + slab->used;
+	slab->used += size;
+	memset(ptr, 0, size);
+end:
+	return ptr;
+}
+
+void mnlxt_arena_reset(struct mnlxt_arena_s *arena) {
+	mnlxt_slab_t *slab;
+	for (slab = arena->first; slab; slab = slab->next) {
+		slab->used = 0;
+	}
+	arena->current = arena->first;
+}
+
+void mnlxt_arena_free(struct mnlxt_arena_s *arena) {
+	if (arena) {
+		mnlxt_slab_t *slab = arena->first;
+		while (slab) {
+			mnlxt_slab_t *next = slab->next;
+			free(slab);
+			slab = next;
+		}
+		free(arena);
+	}
+}
+
+void *mnlxt_data_alloc(mnlxt_data_t *data, size_t size) {
+	void *ptr;
+	if (data && data->arena) {
+		ptr = mnlxt_arena_alloc(data->arena, size);
+	} else {
+		ptr = calloc(1, size);
+	}
+	return ptr;
+}
+
+char *mnlxt_data_strndup(mnlxt_data_t *data, const char *str, size_t n) {
+	char *copy;
+	if (data && data->arena) {
+		size_t len = strnlen(str, n);
+		if (NULL != (copy = mnlxt_arena_alloc(data->arena, len + 1))) {
+			memcpy(copy, str, len);
+		}
+	} else {
+		copy = strndup(str, n);
+	}
+	return copy;
+}
+
+mnlxt_message_t *mnlxt_data_message_new(mnlxt_data_t *data) {
+	mnlxt_message_t *message;
+	if (data && data->arena) {
+		if (NULL != (message = mnlxt_arena_alloc(data->arena, sizeof(mnlxt_message_t)))) {
+			message->arena = 1;
+		}
+	} else {
+		message = mnlxt_message_new();
+	}
+	return message;
+}
+
+void mnlxt_data_release(mnlxt_data_t *data, void *payload, mnlxt_data_free_cb_t free_cb) {
+	if (payload && !(data && data->arena)) {
+		free_cb(payload);
+	}
+}
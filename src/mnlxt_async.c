@@ -0,0 +1,230 @@
+/*
+ * mnlxt_async.c		Libmnlxt Asynchronous Requests
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libmnlxt/async.h"
+
+typedef struct {
+	uint32_t seq;
+	int busy;
+	/** the request is finished, its completion is deferred until the received buffer is walked */
+	int done;
+	int error;
+	mnlxt_async_cb_t cb;
+	void *arg;
+	/** replies received so far */
+	mnlxt_data_t data;
+} mnlxt_async_entry_t;
+
+struct mnlxt_async_s {
+	uint32_t window;
+	uint32_t pending;
+	/** requests in flight in any free entry */
+	mnlxt_async_entry_t entries[];
+};
+
+static void mnlxt_async_complete(mnlxt_handle_t *handle, mnlxt_async_entry_t *entry, int error) {
+	/* the callback is free to send new requests, which may reuse the entry */
+	mnlxt_async_entry_t done = *entry;
+	if (entry->data.error_str == entry->data.error_buf) {
+		done.data.error_str = done.data.error_buf;
+	}
+	entry->busy = 0;
+	entry->done = 0;
+	memset(&entry->data, 0, sizeof(entry->data));
+	--handle->async->pending;
+	if (done.cb) {
+		done.cb(handle, done.seq, error, &done.data, done.arg);
+	}
+	mnlxt_data_clean(&done.data);
+}
+
+int mnlxt_async_init(mnlxt_handle_t *handle, uint32_t window) {
+	int rc = -1;
+	int fd, flags;
+	if (NULL == handle || NULL == handle->nl || 0 == window) {
+		errno = EINVAL;
+	} else if (NULL != handle->async) {
+		errno = EALREADY;
+	} else if (0 > (fd = mnl_socket_get_fd(handle->nl)) || 0 > (flags = fcntl(fd, F_GETFL))
+						 || 0 > fcntl(fd, F_SETFL, flags | O_NONBLOCK)) {
+		handle->error_str = "fcntl failed";
+	} else if (NULL == (handle->async = calloc(1, sizeof(struct mnlxt_async_s) + window * sizeof(mnlxt_async_entry_t)))) {
+		handle->error_str = "malloc failed";
+	} else {
+		handle->async->window = window;
+		rc = 0;
+	}
+	return rc;
+}
+
+void mnlxt_async_clean(mnlxt_handle_t *handle) {
+	if (NULL != handle && NULL != handle->async) {
+		uint32_t i;
+		for (i = 0; i < handle->async->window && 0 != handle->async->pending; ++i) {
+			mnlxt_async_entry_t *entry = &handle->async->entries[i];
+			if (entry->busy) {
+				mnlxt_async_complete(handle, entry, (entry->done ? entry->error : -ECANCELED));
+			}
+		}
+		free(handle->async);
+		handle->async = NULL;
+	}
+}
+
+/* gets the request in flight of a sequence number, or NULL */
+static mnlxt_async_entry_t *mnlxt_async_find(struct mnlxt_async_s *async, uint32_t seq) {
+	uint32_t i;
+	for (i = 0; i < async->window; ++i) {
+		if (async->entries[i].busy && !async->entries[i].done && async->entries[i].seq == seq) {
+			return &async->entries[i];
+		}
+	}
+	return NULL;
+}
+
+int mnlxt_async_send(mnlxt_handle_t *handle, struct nlmsghdr *nlh, mnlxt_async_cb_t cb, void *arg) {
+	int rc = -1;
+	mnlxt_async_entry_t *entry;
+	if (NULL == handle || NULL == handle->async || NULL == nlh) {
+		errno = EINVAL;
+		goto end;
+	}
+
+	if (handle->async->pending >= handle->async->window) {
+		handle->error_str = "request window full";
+		errno = EBUSY;
+		goto end;
+	}
+	/* a free entry exists while the window is not full */
+	entry = handle->async->entries;
+	while (entry->busy) {
+		++entry;
+	}
+
+	nlh->nlmsg_flags |= NLM_F_REQUEST | NLM_F_ACK;
+	if (0 > mnlxt_send(handle, nlh)) {
+		goto end;
+	}
+	memset(entry, 0, sizeof(*entry));
+	entry->seq = nlh->nlmsg_seq;
+	entry->busy = 1;
+	entry->cb = cb;
+	entry->arg = arg;
+	++handle->async->pending;
+	rc = 0;
+end:
+	return rc;
+}
+
+int mnlxt_async_message_send(mnlxt_handle_t *handle, const mnlxt_message_t *message, mnlxt_async_cb_t cb, void *arg) {
+	int rc = -1;
+	struct nlmsghdr *nlh;
+	if (NULL == message) {
+		errno = EINVAL;
+	} else if (NULL != (nlh = mnlxt_msghdr_create(message))) {
+		if (message->flags) {
+			nlh->nlmsg_flags = message->flags;
+		} else if (message->handler) {
+			nlh->nlmsg_flags = message->handler->flags;
+		}
+		rc = mnlxt_async_send(handle, nlh, cb, arg);
+		mnlxt_msghdr_free(nlh);
+	}
+	return rc;
+}
+
+static int mnlxt_async_dispatch(mnlxt_handle_t *handle, mnlxt_buffer_t *buffer) {
+	int rc = 0;
+	const struct nlmsghdr *nlh = (const struct nlmsghdr *)buffer->buf;
+	int len = buffer->len;
+
+	mnlxt_async_entry_t *entry;
+	uint32_t i;
+
+	while (mnl_nlmsg_ok(nlh, len)) {
+		if (NULL != (entry = mnlxt_async_find(handle->async, nlh->nlmsg_seq))) {
+			/* parse each message on its own into the data of its request */
+			mnlxt_buffer_t msg_buf = {.portid = buffer->portid,
+																.buf = (char *)nlh,
+																.len = nlh->nlmsg_len,
+																.seq = nlh->nlmsg_seq,
+																.data_handlers = buffer->data_handlers,
+																.data_nhandlers = buffer->data_nhandlers};
+			int ret;
+			errno = 0;
+			ret = mnlxt_data_parse(&entry->data, &msg_buf);
+			if (1 == ret) {
+				entry->done = 1;
+				entry->error = 0;
+			} else if (0 > ret) {
+				const struct nlmsgerr *err = mnl_nlmsg_get_payload(nlh);
+				entry->done = 1;
+				if (NLMSG_ERROR == nlh->nlmsg_type && mnl_nlmsg_size(sizeof(struct nlmsgerr)) <= nlh->nlmsg_len) {
+					entry->error = err->error;
+				} else {
+					entry->error = (errno ? -errno : -EBADMSG);
+				}
+			}
+		}
+		nlh = mnl_nlmsg_next(nlh, &len);
+	}
+	/* the callbacks may disconnect the handle, which releases the buffer and the requests in flight */
+	for (i = 0; NULL != handle->async && i < handle->async->window; ++i) {
+		entry = &handle->async->entries[i];
+		if (entry->busy && entry->done) {
+			mnlxt_async_complete(handle, entry, entry->error);
+			++rc;
+		}
+	}
+	return rc;
+}
+
+int mnlxt_async_process(mnlxt_handle_t *handle) {
+	int rc = -1;
+	int completed = 0;
+	mnlxt_buffer_t mnlxt_buf = {};
+	if (NULL == handle || NULL == handle->async) {
+		errno = EINVAL;
+		goto end;
+	}
+
+	while (1) {
+		int ret = mnlxt_receive_inplace(handle, &mnlxt_buf);
+		if (0 > ret) {
+			goto end;
+		} else if (0 == ret) {
+			/* nothing more to read */
+			break;
+		}
+		completed += mnlxt_async_dispatch(handle, &mnlxt_buf);
+		mnlxt_buffer_clean(&mnlxt_buf);
+		if (NULL == handle->async) {
+			/* asynchronous mode was left by a callback */
+			break;
+		}
+	}
+	rc = completed;
+end:
+	mnlxt_buffer_clean(&mnlxt_buf);
+	return rc;
+}
+
+uint32_t mnlxt_async_pending(const mnlxt_handle_t *handle) {
+	uint32_t pending = 0;
+	if (NULL != handle && NULL != handle->async) {
+		pending = handle->async->pending;
+	}
+	return pending;
+}
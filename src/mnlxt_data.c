@@ -9,10 +9,18 @@
  */
 
 #include <errno.h>
+#include <poll.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "libmnlxt/data.h"
+#include "private/data.h"
+
+/** read size of temporary dump connections, the kernel does not fill dump datagrams beyond 32 KiB */
+#define MNLXT_DUMP_READ_SIZE 32768
+/** datagrams per read of temporary dump connections */
+#define MNLXT_DUMP_READ_BATCH 8
 
 const char *mnlxt_message_type(const mnlxt_message_t *msg) {
 	const char *type = NULL;
@@ -27,7 +35,7 @@ mnlxt_message_t *mnlxt_message_new() {
 }
 
 void mnlxt_message_free(mnlxt_message_t *message) {
-	if (message) {
+	if (message && !message->arena) {
 		if (message->payload) {
 			mnlxt_data_free_cb_t free_foo = NULL;
 			if (message->handler) {
@@ -43,72 +51,277 @@ void mnlxt_message_free(mnlxt_message_t *message) {
 	}
 }
 
-static int mnlxt_request(struct nlmsghdr *nlh, int bus, mnlxt_data_t *data) {
+static int mnlxt_handle_exchange(mnlxt_handle_t *handle, struct nlmsghdr *nlh, mnlxt_data_t *data, int drain) {
+	int rc = -1;
+	mnlxt_buffer_t mnlxt_buf = {};
+	if (0 < mnlxt_send(handle, nlh)) {
+		while (1) {
+			/* get data or acknowledge */
+			int ret = mnlxt_receive_inplace(handle, &mnlxt_buf);
+			if (0 < ret) {
+				if (sizeof(struct nlmsghdr) <= mnlxt_buf.len
+						&& nlh->nlmsg_seq != ((struct nlmsghdr *)mnlxt_buf.buf)->nlmsg_seq) {
+					/* skip leftovers of previous requests and events on a reused handle */
+					mnlxt_buffer_clean(&mnlxt_buf);
+					continue;
+				}
+				/* parse answer */
+				ret = mnlxt_data_parse(data, &mnlxt_buf);
+				mnlxt_buffer_clean(&mnlxt_buf);
+				if (0 != ret) {
+					/* parsing stop or parsing error */
+					if (1 == ret) {
+						rc = 0;
+					}
+					break;
+				}
+				if (!drain && NULL != data && data->stream_stopped) {
+					/* the rest of the stream is dropped with the connection */
+					rc = 0;
+					break;
+				}
+			} else if (0 > ret) {
+				/* an error by receiving message */
+				if (NULL != data) {
+					data->error_str = handle->error_str;
+				}
+				break;
+			} else {
+				/* would block on a non blocking socket, wait for the answer */
+				struct pollfd pfd = {.fd = mnl_socket_get_fd(handle->nl), .events = POLLIN};
+				if (0 > poll(&pfd, 1, -1) && EINTR != errno) {
+					handle->error_str = "poll failed";
+					if (NULL != data) {
+						data->error_str = handle->error_str;
+					}
+					break;
+				}
+			}
+		}
+	} else if (NULL != handle->error_str && NULL != data) {
+		data->error_str = handle->error_str;
+	}
+	return rc;
+}
+
+static int mnlxt_request(struct nlmsghdr *nlh, int bus, const mnlxt_connect_opts_t *opts, mnlxt_data_t *data) {
 	int rc = -1;
 	if (NULL == nlh) {
 		errno = EINVAL;
 	} else {
 		mnlxt_handle_t handle = {};
-		mnlxt_buffer_t mnlxt_buf = {};
-		if (0 == mnlxt_connect(&handle, bus, 0)) {
-			if (0 < mnlxt_send(&handle, nlh)) {
-				while (1) {
-					/* get data or acknowledge */
-					int ret = mnlxt_receive(&handle, &mnlxt_buf);
-					if (0 < ret) {
-						/* parse answer */
-						ret = mnlxt_data_parse(data, &mnlxt_buf);
-						if (0 != ret) {
-							/* parsing stop or parsing error */
-							if (1 == ret) {
-								rc = 0;
-							}
-							mnlxt_buffer_clean(&mnlxt_buf);
-							break;
-						}
-						mnlxt_buffer_clean(&mnlxt_buf);
-					} else if (0 > ret) {
-						/* an error by receiving message */
-						if (NULL != data) {
-							data->error_str = handle.error_str;
-						}
-						break;
-					} else {
-						/* no data */
-						rc = 0;
-						break;
-					}
+		if (0 == mnlxt_connect_opts(&handle, bus, 0, opts)) {
+			if (NLM_F_DUMP == (NLM_F_DUMP & nlh->nlmsg_flags)) {
+				/* large reads of several datagrams cut down the system calls of big dumps */
+				if (0 == mnlxt_handle_set_read_size(&handle, MNLXT_DUMP_READ_SIZE)) {
+					mnlxt_handle_set_read_batch(&handle, MNLXT_DUMP_READ_BATCH);
 				}
-			} else if (NULL != handle.error_str && NULL != data) {
-				data->error_str = handle.error_str;
 			}
+			rc = mnlxt_handle_exchange(&handle, nlh, data, 0);
 			mnlxt_disconnect(&handle);
-			if (NULL != mnlxt_buf.buf) {
-				free(mnlxt_buf.buf);
-			}
+		} else if (NULL != data) {
+			data->error_str = handle.error_str;
 		}
 	}
 	return rc;
 }
 
+static struct nlmsghdr *mnlxt_message_msghdr(const mnlxt_message_t *message) {
+	struct nlmsghdr *nlh = NULL;
+	if (!message) {
+		errno = EINVAL;
+	} else if (NULL != (nlh = mnlxt_msghdr_create(message))) {
+		nlh->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+		if (message->flags) {
+			nlh->nlmsg_flags |= message->flags;
+		} else if (message->handler) {
+			nlh->nlmsg_flags |= message->handler->flags;
+		}
+	}
+	return nlh;
+}
+
 int mnlxt_message_request(const mnlxt_message_t *message, int bus) {
 	int rc = -1;
-	if (!message) {
+	struct nlmsghdr *nlh = mnlxt_message_msghdr(message);
+	if (nlh) {
+		rc = mnlxt_request(nlh, bus, NULL, NULL);
+		mnlxt_msghdr_free(nlh);
+	}
+	return rc;
+}
+
+int mnlxt_handle_request(mnlxt_handle_t *handle, const mnlxt_message_t *message) {
+	int rc = -1;
+	struct nlmsghdr *nlh;
+	if (NULL == handle || NULL == handle->nl) {
 		errno = EINVAL;
-	} else {
-		struct nlmsghdr *nlh = mnlxt_msghdr_create(message);
-		if (nlh) {
-			nlh->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
-			if (message->flags) {
-				nlh->nlmsg_flags |= message->flags;
-			} else if (message->handler) {
-				nlh->nlmsg_flags |= message->handler->flags;
+	} else if (NULL != (nlh = mnlxt_message_msghdr(message))) {
+		rc = mnlxt_handle_exchange(handle, nlh, NULL, 1);
+		mnlxt_msghdr_free(nlh);
+	}
+	return rc;
+}
+
+typedef struct {
+	/** messages sent with the current buffer, indexed by sequence number */
+	mnlxt_message_t **messages;
+	/** sequence number of the first message of the current buffer */
+	uint32_t seq;
+	size_t count;
+	size_t acked;
+	int failed;
+	int error;
+} mnlxt_batch_t;
+
+static int mnlxt_batch_ack_cb(const struct nlmsghdr *nlh, void *data) {
+	mnlxt_batch_t *batch = (mnlxt_batch_t *)data;
+	struct nlmsgerr *err = mnl_nlmsg_get_payload(nlh);
+	uint32_t index = nlh->nlmsg_seq - batch->seq;
+	mnlxt_message_t *msg;
+
+	if (mnl_nlmsg_size(sizeof(struct nlmsgerr)) > nlh->nlmsg_len) {
+		errno = EBADMSG;
+		return MNL_CB_ERROR;
+	}
+	if (batch->count > index && NULL != (msg = batch->messages[index])) {
+		msg->error = err->error;
+		batch->messages[index] = NULL;
+		++batch->acked;
+		if (0 != err->error) {
+			if (0 == batch->failed++) {
+				batch->error = -err->error;
+			}
+		}
+	}
+	return MNL_CB_OK;
+}
+
+static int mnlxt_batch_flush(mnlxt_handle_t *handle, struct mnl_nlmsg_batch *b, mnlxt_batch_t *batch) {
+	static const mnl_cb_t ctl_cb[NLMSG_MIN_TYPE] = {[NLMSG_ERROR] = mnlxt_batch_ack_cb};
+	mnlxt_buffer_t mnlxt_buf = {};
+	int rc = -1;
+
+	if (0 > mnl_socket_sendto(handle->nl, mnl_nlmsg_batch_head(b), mnl_nlmsg_batch_size(b))) {
+		handle->error_str = "send failed";
+		goto end;
+	}
+	while (batch->acked < batch->count) {
+		int ret = mnlxt_receive_inplace(handle, &mnlxt_buf);
+		if (0 > ret) {
+			goto end;
+		} else if (0 == ret) {
+			/* would block, wait for outstanding acknowledges */
+			struct pollfd pfd = {.fd = mnl_socket_get_fd(handle->nl), .events = POLLIN};
+			poll(&pfd, 1, -1);
+			continue;
+		}
+		ret = mnl_cb_run2(mnlxt_buf.buf, mnlxt_buf.len, 0, mnlxt_buf.portid, NULL, batch, ctl_cb,
+											MNL_ARRAY_SIZE(ctl_cb));
+		mnlxt_buffer_clean(&mnlxt_buf);
+		if (MNL_CB_ERROR == ret) {
+			handle->error_str = "invalid acknowledge";
+			goto end;
+		}
+	}
+	rc = 0;
+end:
+	mnlxt_buffer_clean(&mnlxt_buf);
+	return rc;
+}
+
+int mnlxt_handle_batch_request(mnlxt_handle_t *handle, mnlxt_data_t *data) {
+	const size_t buf_size = MNL_SOCKET_BUFFER_SIZE;
+	mnlxt_batch_t batch = {};
+	struct mnl_nlmsg_batch *b = NULL;
+	mnlxt_message_t *msg;
+	char *buf = NULL;
+	int rc = -1;
+
+	if (NULL == handle || NULL == handle->nl || NULL == data) {
+		errno = EINVAL;
+		goto end;
+	}
+
+	/* the second half of the buffer takes the message which overflows the current batch */
+	buf = malloc(2 * buf_size);
+	batch.messages = calloc(buf_size / NLMSG_HDRLEN + 1, sizeof(mnlxt_message_t *));
+	if (NULL == buf || NULL == batch.messages) {
+		handle->error_str = "malloc failed";
+		goto end;
+	}
+
+	for (msg = data->first; NULL != msg; msg = msg->next) {
+		msg->error = -ECANCELED;
+	}
+
+	b = mnl_nlmsg_batch_start(buf, buf_size);
+	batch.seq = handle->seq + 1;
+	for (msg = data->first; NULL != msg; msg = msg->next) {
+		struct nlmsghdr *nlh = mnl_nlmsg_put_header(mnl_nlmsg_batch_current(b));
+		nlh->nlmsg_type = msg->nlmsg_type;
+		if (NULL == msg->handler || NULL == msg->handler->put) {
+			msg->error = -EBADMSG;
+		} else if (errno = 0, 0 != msg->handler->put(nlh, msg->payload, msg->nlmsg_type)) {
+			msg->error = -(errno ? errno : EINVAL);
+		}
+		if (-ECANCELED != msg->error) {
+			if (0 == batch.failed++) {
+				batch.error = -msg->error;
+			}
+			continue;
+		}
+		nlh->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+		if (msg->flags) {
+			nlh->nlmsg_flags |= msg->flags;
+		} else {
+			nlh->nlmsg_flags |= msg->handler->flags;
+		}
+		nlh->nlmsg_seq = ++handle->seq;
+		batch.messages[batch.count++] = msg;
+
+		if (!mnl_nlmsg_batch_next(b)) {
+			/* send all messages except the current one, which does not fit anymore */
+			--batch.count;
+			if (0 == batch.count) {
+				msg->error = -EMSGSIZE;
+				batch.seq = handle->seq + 1;
+				if (0 == batch.failed++) {
+					batch.error = EMSGSIZE;
+				}
+				/* the first reset moves the message to the head, the second one drops it */
+				mnl_nlmsg_batch_reset(b);
+				mnl_nlmsg_batch_reset(b);
+				continue;
 			}
-			rc = mnlxt_request(nlh, bus, NULL);
-			mnlxt_msghdr_free(nlh);
+			if (0 != mnlxt_batch_flush(handle, b, &batch)) {
+				goto end;
+			}
+			mnl_nlmsg_batch_reset(b);
+			batch.messages[0] = msg;
+			batch.seq = handle->seq;
+			batch.count = 1;
+			batch.acked = 0;
 		}
 	}
+	if (!mnl_nlmsg_batch_is_empty(b) && 0 != mnlxt_batch_flush(handle, b, &batch)) {
+		goto end;
+	}
 
+	rc = batch.failed;
+	if (rc) {
+		errno = batch.error;
+	}
+end:
+	if (NULL != b) {
+		mnl_nlmsg_batch_stop(b);
+	}
+	if (NULL != buf) {
+		free(buf);
+	}
+	if (NULL != batch.messages) {
+		free(batch.messages);
+	}
 	return rc;
 }
 
@@ -143,6 +356,31 @@ void mnlxt_msghdr_free(struct nlmsghdr *msghdr) {
 	}
 }
 
+/* gets the message text of an extended acknowledge (see MNLXT_CONNECT_EXT_ACK), or NULL */
+static const char *mnlxt_ext_ack_msg(const struct nlmsghdr *nlh) {
+	const char *msg = NULL;
+#ifdef NLM_F_ACK_TLVS
+	const struct nlmsgerr *err = mnl_nlmsg_get_payload(nlh);
+	const struct nlattr *attr;
+	size_t offset = sizeof(struct nlmsgerr);
+	if (NLM_F_ACK_TLVS & nlh->nlmsg_flags) {
+		if (!(NLM_F_CAPPED & nlh->nlmsg_flags)) {
+			/* the attributes follow the echoed request */
+			offset += err->msg.nlmsg_len - sizeof(struct nlmsghdr);
+		}
+		if (mnl_nlmsg_size(offset) <= nlh->nlmsg_len) {
+			mnl_attr_for_each(attr, nlh, offset) {
+				if (NLMSGERR_ATTR_MSG == mnl_attr_get_type(attr) && 0 <= mnl_attr_validate(attr, MNL_TYPE_NUL_STRING)) {
+					msg = mnl_attr_get_str(attr);
+					break;
+				}
+			}
+		}
+	}
+#endif
+	return msg;
+}
+
 static int mnlxt_data_cb(const struct nlmsghdr *nlh, void *data) {
 	int rc = MNL_CB_ERROR;
 	mnlxt_data_t *mnlxt_data = (mnlxt_data_t *)data;
@@ -154,7 +392,12 @@ static int mnlxt_data_cb(const struct nlmsghdr *nlh, void *data) {
 		errno = EINTR;
 	} else if (mnlxt_data->nhandlers > nlh->nlmsg_type
 						 && NULL != (cb_foo = mnlxt_data->handlers[nlh->nlmsg_type].parse)) {
-		rc = cb_foo(nlh, data);
+		if (mnlxt_data->stream_stopped) {
+			/* skip the rest of a stopped stream */
+			rc = MNL_CB_OK;
+		} else {
+			rc = cb_foo(nlh, data);
+		}
 	} else if (NLMSG_ERROR == nlh->nlmsg_type) {
 		struct nlmsgerr *err = mnl_nlmsg_get_payload(nlh);
 		if (mnl_nlmsg_size(sizeof(struct nlmsgerr)) > nlh->nlmsg_len) {
@@ -162,7 +405,12 @@ static int mnlxt_data_cb(const struct nlmsghdr *nlh, void *data) {
 			errno = EBADMSG;
 		} else {
 			if (0 != err->error) {
+				const char *ext_msg = mnlxt_ext_ack_msg(nlh);
 				strerror_r(-err->error, mnlxt_data->error_buf, sizeof(mnlxt_data->error_buf));
+				if (ext_msg) {
+					size_t len = strlen(mnlxt_data->error_buf);
+					snprintf(mnlxt_data->error_buf + len, sizeof(mnlxt_data->error_buf) - len, ": %s", ext_msg);
+				}
 				mnlxt_data->error_str = mnlxt_data->error_buf;
 				errno = -err->error;
 			} else {
@@ -212,7 +460,7 @@ int mnlxt_data_parse(mnlxt_data_t *data, mnlxt_buffer_t *buffer) {
 
 void mnlxt_buffer_clean(mnlxt_buffer_t *buffer) {
 	if (buffer) {
-		if (buffer->buf) {
+		if (buffer->buf && !buffer->borrowed) {
 			free(buffer->buf);
 		}
 		memset(buffer, 0, sizeof(mnlxt_buffer_t));
@@ -221,21 +469,56 @@ void mnlxt_buffer_clean(mnlxt_buffer_t *buffer) {
 
 void mnlxt_data_clean(mnlxt_data_t *data) {
 	if (NULL != data) {
-		mnlxt_message_t *msg;
-		while (NULL != (msg = mnlxt_data_remove(data, NULL))) {
-			mnlxt_message_free(msg);
+		if (NULL != data->arena) {
+			/* messages of the arena are released with its slabs */
+			mnlxt_arena_free(data->arena);
+		} else {
+			mnlxt_message_t *msg;
+			while (NULL != (msg = mnlxt_data_remove(data, NULL))) {
+				mnlxt_message_free(msg);
+			}
 		}
 		memset(data, 0, sizeof(*data));
 	}
 }
 
 int mnlxt_data_dump(mnlxt_data_t *data, int bus, struct nlmsghdr *nlh) {
+	return mnlxt_data_dump_opts(data, bus, nlh, NULL);
+}
+
+int mnlxt_data_dump_opts(mnlxt_data_t *data, int bus, struct nlmsghdr *nlh, const mnlxt_connect_opts_t *opts) {
 	int rc = -1;
 	if (NULL == nlh || NULL == data) {
 		errno = EINVAL;
 	} else {
 		nlh->nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
-		rc = mnlxt_request(nlh, bus, data);
+		rc = mnlxt_request(nlh, bus, opts, data);
+	}
+	return rc;
+}
+
+int mnlxt_data_get(mnlxt_handle_t *handle, mnlxt_data_t *data, int bus, struct nlmsghdr *nlh) {
+	int rc = -1;
+	if (NULL == nlh || NULL == data || (NULL != handle && NULL == handle->nl)) {
+		errno = EINVAL;
+	} else {
+		nlh->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+		if (NULL == handle) {
+			rc = mnlxt_request(nlh, bus, NULL, data);
+		} else {
+			rc = mnlxt_handle_exchange(handle, nlh, data, 1);
+		}
+	}
+	return rc;
+}
+
+int mnlxt_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, struct nlmsghdr *nlh) {
+	int rc = -1;
+	if (NULL == handle || NULL == handle->nl || NULL == nlh || NULL == data) {
+		errno = EINVAL;
+	} else {
+		nlh->nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+		rc = mnlxt_handle_exchange(handle, nlh, data, 1);
 	}
 	return rc;
 }
@@ -257,42 +540,89 @@ mnlxt_message_t *mnlxt_data_iterate(mnlxt_data_t *data, mnlxt_message_t *message
 mnlxt_message_t *mnlxt_data_remove(mnlxt_data_t *data, mnlxt_message_t *message) {
 	mnlxt_message_t *msg = NULL;
 	if (data) {
-		msg = data->first;
-		if (message && message != msg) {
-			while (msg && msg->next != message) {
-				msg = msg->next;
-			}
-			if (msg) {
-				if (data->last == message) {
-					data->last = msg;
-				}
-				msg->next = message->next;
-				msg = message;
+		msg = (message ? message : data->first);
+		if (msg && (msg->prev || data->first == msg)) {
+			if (msg->prev) {
+				msg->prev->next = msg->next;
+			} else {
+				data->first = msg->next;
 			}
-		} else if (msg) {
-			if (data->last == msg) {
-				data->last = NULL;
+			if (msg->next) {
+				msg->next->prev = msg->prev;
+			} else {
+				data->last = msg->prev;
 			}
-			data->first = msg->next;
+			--data->count;
+		} else {
+			/* not part of mnlxt data */
+			msg = NULL;
 		}
 	} else {
 		errno = EINVAL;
 	}
 	if (msg) {
-		msg->next = NULL;
+		msg->next = msg->prev = NULL;
 	}
 	return msg;
 }
 
+size_t mnlxt_data_count(const mnlxt_data_t *data) {
+	size_t count = 0;
+	if (data) {
+		count = data->count;
+	} else {
+		errno = EINVAL;
+	}
+	return count;
+}
+
+int mnlxt_data_set_stream(mnlxt_data_t *data, mnlxt_data_stream_cb_t cb, void *arg) {
+	int rc = -1;
+	if (NULL == data || NULL == cb) {
+		errno = EINVAL;
+	} else {
+		data->stream = cb;
+		data->stream_arg = arg;
+		data->stream_stopped = 0;
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_data_use_arena(mnlxt_data_t *data, size_t slab_size) {
+	int rc = -1;
+	if (NULL == data) {
+		errno = EINVAL;
+	} else if (NULL != data->first || NULL != data->arena) {
+		errno = EBUSY;
+	} else if (NULL != (data->arena = mnlxt_arena_new(slab_size))) {
+		rc = 0;
+	}
+	return rc;
+}
+
 void mnlxt_data_add(mnlxt_data_t *data, mnlxt_message_t *message) {
 	if (data && message) {
-		if (data->last) {
-			data->last->next = message;
+		if (data->stream) {
+			if (!data->stream_stopped && 0 != data->stream(message, data->stream_arg)) {
+				data->stream_stopped = 1;
+			}
+			mnlxt_message_free(message);
+			if (data->arena) {
+				/* nothing else lives in the arena of a stream */
+				mnlxt_arena_reset(data->arena);
+			}
 		} else {
-			data->first = message;
+			if (data->last) {
+				data->last->next = message;
+			} else {
+				data->first = message;
+			}
+			message->prev = data->last;
+			message->next = NULL;
+			data->last = message;
+			++data->count;
 		}
-		data->last = message;
-		message->next = NULL;
 	} else {
 		errno = EINVAL;
 	}
@@ -0,0 +1,131 @@
+/*
+ * mnlxt_hash.c		Libmnlxt Hash Table
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+
+#include "private/hash.h"
+
+#define MNLXT_HASH_MIN_SIZE 64
+
+uint32_t mnlxt_hash_fnv(const void *buf, size_t len) {
+	const uint8_t *byte = buf;
+	uint32_t hashval = 2166136261u;
+	while (len--) {
+		hashval ^= *byte++;
+		hashval *= 16777619u;
+	}
+	return hashval;
+}
+
+int mnlxt_hash_init(mnlxt_hash_t *hash, size_t size) {
+	int rc = -1;
+	size_t buckets = MNLXT_HASH_MIN_SIZE;
+	while (buckets < size) {
+		buckets <<= 1;
+	}
+	if (NULL == hash) {
+		errno = EINVAL;
+	} else if (NULL != (hash->buckets = calloc(buckets, sizeof(mnlxt_hash_entry_t *)))) {
+		hash->size = buckets;
+		hash->count = 0;
+		hash->first = hash->last = NULL;
+		rc = 0;
+	}
+	return rc;
+}
+
+void mnlxt_hash_clean(mnlxt_hash_t *hash) {
+	if (NULL != hash) {
+		free(hash->buckets);
+		hash->buckets = NULL;
+		hash->size = hash->count = 0;
+		hash->first = hash->last = NULL;
+	}
+}
+
+static void mnlxt_hash_grow(mnlxt_hash_t *hash) {
+	size_t size = hash->size << 1;
+	mnlxt_hash_entry_t **buckets = calloc(size, sizeof(mnlxt_hash_entry_t *));
+	mnlxt_hash_entry_t *entry;
+	if (NULL == buckets) {
+		/* keep the longer chains */
+		return;
+	}
+	for (entry = hash->first; entry; entry = entry->next) {
+		mnlxt_hash_entry_t **bucket = &buckets[entry->hash & (size - 1)];
+		entry->chain = *bucket;
+		*bucket = entry;
+	}
+	free(hash->buckets);
+	hash->buckets = buckets;
+	hash->size = size;
+}
+
+int mnlxt_hash_insert(mnlxt_hash_t *hash, mnlxt_hash_entry_t *entry, uint32_t hashval) {
+	int rc = -1;
+	if (NULL == hash || NULL == hash->buckets || NULL == entry) {
+		errno = EINVAL;
+	} else {
+		mnlxt_hash_entry_t **bucket = &hash->buckets[hashval & (hash->size - 1)];
+		entry->hash = hashval;
+		entry->chain = *bucket;
+		*bucket = entry;
+		entry->next = NULL;
+		entry->prev = hash->last;
+		if (hash->last) {
+			hash->last->next = entry;
+		} else {
+			hash->first = entry;
+		}
+		hash->last = entry;
+		if (++hash->count > hash->size) {
+			mnlxt_hash_grow(hash);
+		}
+		rc = 0;
+	}
+	return rc;
+}
+
+mnlxt_hash_entry_t *mnlxt_hash_find(const mnlxt_hash_t *hash, uint32_t hashval, mnlxt_hash_cmp_cb_t cmp, const void *key) {
+	mnlxt_hash_entry_t *entry = NULL;
+	if (NULL != hash && NULL != hash->buckets) {
+		for (entry = hash->buckets[hashval & (hash->size - 1)]; entry; entry = entry->chain) {
+			if (entry->hash == hashval && 0 == cmp(entry, key)) {
+				break;
+			}
+		}
+	}
+	return entry;
+}
+
+void mnlxt_hash_remove(mnlxt_hash_t *hash, mnlxt_hash_entry_t *entry) {
+	if (NULL != hash && NULL != hash->buckets && NULL != entry) {
+		mnlxt_hash_entry_t **bucket = &hash->buckets[entry->hash & (hash->size - 1)];
+		while (*bucket && *bucket != entry) {
+			bucket = &(*bucket)->chain;
+		}
+		if (*bucket) {
+			*bucket = entry->chain;
+			if (entry->prev) {
+				entry->prev->next = entry->next;
+			} else {
+				hash->first = entry->next;
+			}
+			if (entry->next) {
+				entry->next->prev = entry->prev;
+			} else {
+				hash->last = entry->prev;
+			}
+			--hash->count;
+		}
+		entry->chain = entry->next = entry->prev = NULL;
+	}
+}
@@ -0,0 +1,123 @@
+/*
+ * mnlxt_reconcile.c		Libmnlxt Reconciliation of desired and current objects
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+
+#include "private/hash.h"
+#include "private/reconcile.h"
+
+typedef struct {
+	/** has to be the first member */
+	mnlxt_hash_entry_t entry;
+	const void *object;
+	/** a desired object has the identity of the current object */
+	int matched;
+} mnlxt_reconcile_entry_t;
+
+typedef struct {
+	const mnlxt_reconcile_ops_t *ops;
+	const void *desired;
+} mnlxt_reconcile_key_t;
+
+static int mnlxt_reconcile_key_cmp(const mnlxt_hash_entry_t *entry, const void *key) {
+	const mnlxt_reconcile_key_t *reconcile_key = key;
+	return reconcile_key->ops->identity(((const mnlxt_reconcile_entry_t *)entry)->object, reconcile_key->desired);
+}
+
+static int mnlxt_reconcile_add(const mnlxt_reconcile_ops_t *ops, mnlxt_data_t *changes, const void *object,
+															 uint16_t type, uint16_t flags) {
+	int rc = -1;
+	mnlxt_message_t *message;
+	void *copy = ops->clone(object);
+	if (NULL != copy) {
+		if (NULL == (message = ops->message(copy, type, flags))) {
+			ops->free(copy);
+		} else {
+			mnlxt_data_add(changes, message);
+			rc = 0;
+		}
+	}
+	return rc;
+}
+
+int mnlxt_data_reconcile(const mnlxt_reconcile_ops_t *ops, mnlxt_data_t *desired, mnlxt_data_t *current,
+												 mnlxt_data_t *changes) {
+	int rc = -1;
+	mnlxt_hash_t hash = {};
+	mnlxt_reconcile_entry_t *entries = NULL, *entry;
+	mnlxt_reconcile_key_t key = {ops, NULL};
+	mnlxt_message_t *it;
+	const void *object;
+	size_t count = 0, i;
+
+	if (NULL == ops || NULL == desired || NULL == current || NULL == changes || NULL != changes->arena
+			|| NULL != changes->stream) {
+		errno = EINVAL;
+		return rc;
+	}
+
+	/* hash the current objects by identity */
+	for (it = NULL; NULL != (it = mnlxt_data_iterate(current, it));) {
+		if (NULL != ops->get(it)) {
+			++count;
+		}
+	}
+	if (0 != mnlxt_hash_init(&hash, count)) {
+		goto end;
+	}
+	if (0 < count && NULL == (entries = calloc(count, sizeof(*entries)))) {
+		goto end;
+	}
+	for (it = NULL, i = 0; NULL != (it = mnlxt_data_iterate(current, it));) {
+		if (NULL != (object = ops->get(it))) {
+			entries[i].object = object;
+			mnlxt_hash_insert(&hash, &entries[i].entry, ops->hash(object));
+			++i;
+		}
+	}
+
+	/* creations and replacements in the order of the desired objects */
+	for (it = NULL; NULL != (it = mnlxt_data_iterate(desired, it));) {
+		if (NULL == (key.desired = ops->get(it))) {
+			continue;
+		}
+		entry = (mnlxt_reconcile_entry_t *)mnlxt_hash_find(&hash, ops->hash(key.desired), mnlxt_reconcile_key_cmp, &key);
+		if (NULL == entry) {
+			if (0 != mnlxt_reconcile_add(ops, changes, key.desired, ops->new_type, ops->new_flags)) {
+				goto end;
+			}
+		} else {
+			entry->matched = 1;
+			if (0 == ops->match(entry->object, key.desired)) {
+				/* unchanged */
+			} else if (ops->replace_type) {
+				if (0 != mnlxt_reconcile_add(ops, changes, key.desired, ops->replace_type, ops->replace_flags)) {
+					goto end;
+				}
+			} else if (0 != mnlxt_reconcile_add(ops, changes, entry->object, ops->del_type, 0)
+								 || 0 != mnlxt_reconcile_add(ops, changes, key.desired, ops->new_type, ops->new_flags)) {
+				goto end;
+			}
+		}
+	}
+
+	/* deletions of the stale objects last, so the desired state is complete before anything goes away */
+	for (i = 0; i < count; ++i) {
+		if (!entries[i].matched && 0 != mnlxt_reconcile_add(ops, changes, entries[i].object, ops->del_type, 0)) {
+			goto end;
+		}
+	}
+	rc = 0;
+end:
+	free(entries);
+	mnlxt_hash_clean(&hash);
+	return rc;
+}
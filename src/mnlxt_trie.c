@@ -0,0 +1,202 @@
+/*
+ * mnlxt_trie.c		Libmnlxt Path Compressed Binary Trie
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "private/trie.h"
+
+#define MNLXT_TRIE_BIT(key, i) (((key)[(i) >> 3] >> (7 - ((i)&7))) & 1)
+
+/* number of equal leading bits of both keys, but not more than len */
+static unsigned mnlxt_trie_common(const uint8_t *key1, const uint8_t *key2, unsigned len) {
+	unsigned i = 0;
+	while (i < len && key1[i >> 3] == key2[i >> 3]) {
+		i += 8;
+	}
+	if (i < len) {
+		uint8_t diff = key1[i >> 3] ^ key2[i >> 3];
+		while (!(diff & 0x80)) {
+			diff <<= 1;
+			++i;
+		}
+	}
+	return (i < len ? i : len);
+}
+
+static mnlxt_trie_node_t *mnlxt_trie_node_new(const uint8_t *key, uint8_t len) {
+	mnlxt_trie_node_t *node = calloc(1, sizeof(mnlxt_trie_node_t));
+	if (node) {
+		unsigned bytes = len >> 3;
+		node->len = len;
+		memcpy(node->key, key, bytes);
+		if (len & 7) {
+			node->key[bytes] = key[bytes] & (uint8_t)(0xff << (8 - (len & 7)));
+		}
+	}
+	return node;
+}
+
+void **mnlxt_trie_insert(mnlxt_trie_t *trie, const uint8_t *key, uint8_t len) {
+	mnlxt_trie_node_t **link = &trie->root, *node, *glue;
+	unsigned common;
+
+	if (MNLXT_TRIE_KEY_SIZE * 8 < len) {
+		errno = EINVAL;
+		return NULL;
+	}
+	while (NULL != (node = *link)) {
+		common = mnlxt_trie_common(node->key, key, (node->len < len ? node->len : len));
+		if (common == node->len) {
+			if (node->len == len) {
+				return &node->value;
+			}
+			/* the node is a prefix of the key */
+			link = &node->child[MNLXT_TRIE_BIT(key, node->len)];
+			continue;
+		}
+		if (common == len) {
+			/* the key is a prefix of the node */
+			if (NULL == (glue = mnlxt_trie_node_new(key, len))) {
+				return NULL;
+			}
+			glue->child[MNLXT_TRIE_BIT(node->key, len)] = node;
+			*link = glue;
+			return &glue->value;
+		}
+		/* both diverge behind the common bits */
+		if (NULL == (glue = mnlxt_trie_node_new(key, common))) {
+			return NULL;
+		}
+		if (NULL == (glue->child[MNLXT_TRIE_BIT(key, common)] = mnlxt_trie_node_new(key, len))) {
+			free(glue);
+			return NULL;
+		}
+		glue->child[MNLXT_TRIE_BIT(node->key, common)] = node;
+		*link = glue;
+		return &glue->child[MNLXT_TRIE_BIT(key, common)]->value;
+	}
+	if (NULL == (*link = mnlxt_trie_node_new(key, len))) {
+		return NULL;
+	}
+	return &(*link)->value;
+}
+
+static mnlxt_trie_node_t **mnlxt_trie_link(mnlxt_trie_node_t *const *link, const uint8_t *key, uint8_t len,
+																					 mnlxt_trie_node_t *const **parent) {
+	mnlxt_trie_node_t *node;
+	if (parent) {
+		*parent = NULL;
+	}
+	while (NULL != (node = *link) && node->len <= len && mnlxt_trie_common(node->key, key, node->len) == node->len) {
+		if (node->len == len) {
+			return (mnlxt_trie_node_t **)link;
+		}
+		if (parent) {
+			*parent = link;
+		}
+		link = &node->child[MNLXT_TRIE_BIT(key, node->len)];
+	}
+	return NULL;
+}
+
+void **mnlxt_trie_find(const mnlxt_trie_t *trie, const uint8_t *key, uint8_t len) {
+	mnlxt_trie_node_t **link = mnlxt_trie_link(&trie->root, key, len, NULL);
+	return (link && (*link)->value ? &(*link)->value : NULL);
+}
+
+void *mnlxt_trie_lookup(const mnlxt_trie_t *trie, const uint8_t *key, uint8_t bits) {
+	void *value = NULL;
+	const mnlxt_trie_node_t *node = trie->root;
+	while (node && node->len <= bits && mnlxt_trie_common(node->key, key, node->len) == node->len) {
+		if (node->value) {
+			value = node->value;
+		}
+		if (node->len == bits) {
+			break;
+		}
+		node = node->child[MNLXT_TRIE_BIT(key, node->len)];
+	}
+	return value;
+}
+
+size_t mnlxt_trie_prefixes(const mnlxt_trie_t *trie, const uint8_t *key, uint8_t bits, void **values, size_t max) {
+	size_t count = 0;
+	const mnlxt_trie_node_t *node = trie->root;
+	while (node && count < max && node->len <= bits && mnlxt_trie_common(node->key, key, node->len) == node->len) {
+		if (node->value) {
+			values[count++] = node->value;
+		}
+		if (node->len == bits) {
+			break;
+		}
+		node = node->child[MNLXT_TRIE_BIT(key, node->len)];
+	}
+	return count;
+}
+
+/* replaces a node without value and with less than two children by its child */
+static void mnlxt_trie_prune(mnlxt_trie_node_t **link) {
+	mnlxt_trie_node_t *node = *link;
+	if (node && NULL == node->value && (NULL == node->child[0] || NULL == node->child[1])) {
+		*link = (node->child[0] ? node->child[0] : node->child[1]);
+		free(node);
+	}
+}
+
+void *mnlxt_trie_remove(mnlxt_trie_t *trie, const uint8_t *key, uint8_t len) {
+	void *value = NULL;
+	mnlxt_trie_node_t *const *parent;
+	mnlxt_trie_node_t **link = mnlxt_trie_link(&trie->root, key, len, &parent);
+	if (link) {
+		/* a prefix without value left by a failed insert is pruned as well */
+		value = (*link)->value;
+		(*link)->value = NULL;
+		mnlxt_trie_prune(link);
+		if (parent) {
+			mnlxt_trie_prune((mnlxt_trie_node_t **)parent);
+		}
+	}
+	return value;
+}
+
+static void mnlxt_trie_walk_node(const mnlxt_trie_node_t *node, mnlxt_trie_walk_cb_t cb, void *arg) {
+	while (node) {
+		if (node->value) {
+			cb(node->key, node->len, node->value, arg);
+		}
+		mnlxt_trie_walk_node(node->child[0], cb, arg);
+		node = node->child[1];
+	}
+}
+
+void mnlxt_trie_walk(const mnlxt_trie_t *trie, mnlxt_trie_walk_cb_t cb, void *arg) {
+	mnlxt_trie_walk_node(trie->root, cb, arg);
+}
+
+static void mnlxt_trie_free_node(mnlxt_trie_node_t *node, mnlxt_trie_free_cb_t free_cb) {
+	while (node) {
+		mnlxt_trie_node_t *next = node->child[1];
+		mnlxt_trie_free_node(node->child[0], free_cb);
+		if (node->value && free_cb) {
+			free_cb(node->value);
+		}
+		free(node);
+		node = next;
+	}
+}
+
+void mnlxt_trie_clean(mnlxt_trie_t *trie, mnlxt_trie_free_cb_t free_cb) {
+	if (trie) {
+		mnlxt_trie_free_node(trie->root, free_cb);
+		trie->root = NULL;
+	}
+}
@@ -13,7 +13,11 @@
 
 #include "config.h"
 #include "libmnlxt/rt.h"
+#include "private/data.h"
+#include "private/hash.h"
+#include "private/identity.h"
 #include "private/internal.h"
+#include "private/reconcile.h"
 
 static int mnlxt_rt_addr_cmp(const mnlxt_rt_addr_t *rt_addr1, const mnlxt_rt_addr_t *rt_addr2,
 														 mnlxt_rt_addr_data_t data) {
@@ -217,11 +221,14 @@ int mnlxt_rt_addr_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 		goto end;
 	}
 
-	rt_addr = mnlxt_rt_addr_new();
+	rt_addr = mnlxt_data_alloc(data, sizeof(mnlxt_rt_addr_t));
 	if (NULL == rt_addr) {
-		data->error_str = "mnlxt_rt_addr_new failed";
+		data->error_str = "mnlxt_data_alloc failed";
 		goto end;
 	}
+	/* defaults of mnlxt_rt_addr_new */
+	rt_addr->cacheinfo.ifa_prefered = MNLXT_RT_ADDR_LIFE_TIME_INFINITY;
+	rt_addr->cacheinfo.ifa_valid = MNLXT_RT_ADDR_LIFE_TIME_INFINITY;
 
 	mnlxt_rt_addr_set_prefixlen(rt_addr, ifam->ifa_prefixlen);
 	mnlxt_rt_addr_set_flags(rt_addr, ifam->ifa_flags);
@@ -263,10 +270,12 @@ int mnlxt_rt_addr_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 				data->error_str = "IFA_LABEL validation failed";
 				goto end;
 			}
-			if (-1 == mnlxt_rt_addr_set_label(rt_addr, mnl_attr_get_str(attr))) {
-				data->error_str = "mnlxt_rt_addr_set_label failed";
+			if (NULL == rt_addr->label
+					&& NULL == (rt_addr->label = mnlxt_data_strndup(data, mnl_attr_get_str(attr), sizeof(mnlxt_if_name_t) - 1))) {
+				data->error_str = "mnlxt_data_strndup failed";
 				goto end;
 			}
+			MNLXT_SET_PROP_FLAG(rt_addr, MNLXT_RT_ADDR_LABEL);
 			break;
 		case IFA_BROADCAST:
 			break;
@@ -299,9 +308,9 @@ int mnlxt_rt_addr_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 		}
 	}
 
-	msg = mnlxt_rt_message_new(nlh->nlmsg_type, 0, rt_addr);
+	msg = mnlxt_rt_data_message_new(data, nlh->nlmsg_type, rt_addr);
 	if (NULL == msg) {
-		data->error_str = "mnlxt_rt_message_new failed";
+		data->error_str = "mnlxt_rt_data_message_new failed";
 		goto end;
 	}
 
@@ -310,7 +319,7 @@ int mnlxt_rt_addr_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 	msg = NULL;
 	rc = MNL_CB_OK;
 end:
-	mnlxt_rt_addr_free(rt_addr);
+	mnlxt_data_release(data, rt_addr, mnlxt_rt_addr_FREE);
 	mnlxt_message_free(msg);
 	return rc;
 }
@@ -328,20 +337,50 @@ mnlxt_rt_addr_t *mnlxt_rt_addr_iterate(mnlxt_data_t *data, mnlxt_message_t **ite
 }
 
 int mnlxt_rt_addr_dump(mnlxt_data_t *data, unsigned char family) {
+	return mnlxt_rt_addr_handle_dump(NULL, data, family);
+}
+
+int mnlxt_rt_addr_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, unsigned char family) {
 	int rc = -1;
 	if (AF_INET != family && AF_INET6 != family && AF_UNSPEC != family) {
 		errno = EAFNOSUPPORT;
 	} else {
-		rc = mnlxt_rt_data_dump(data, RTM_GETADDR, family);
+		rc = mnlxt_rt_handle_data_dump(handle, data, RTM_GETADDR, family);
+	}
+	return rc;
+}
+
+int mnlxt_rt_addr_dump_filter(mnlxt_data_t *data, const mnlxt_rt_addr_t *filter) {
+	return mnlxt_rt_addr_handle_dump_filter(NULL, data, filter);
+}
+
+int mnlxt_rt_addr_handle_dump_filter(mnlxt_handle_t *handle, mnlxt_data_t *data, const mnlxt_rt_addr_t *filter) {
+	int rc = -1;
+	if (NULL == filter || (filter->prop_flags & ~MNLXT_RT_ADDR_DUMP_FILTER)) {
+		errno = EINVAL;
+	} else if (MNLXT_GET_PROP_FLAG(filter, MNLXT_RT_ADDR_FAMILY) && AF_INET != filter->family
+						 && AF_INET6 != filter->family && AF_UNSPEC != filter->family) {
+		errno = EAFNOSUPPORT;
+	} else {
+		char buf[MNL_NLMSG_HDRLEN + MNL_ALIGN(sizeof(struct ifaddrmsg))];
+		struct nlmsghdr *nlh = mnl_nlmsg_put_header(buf);
+		nlh->nlmsg_type = RTM_GETADDR;
+		if (0 == mnlxt_rt_addr_put(nlh, filter)) {
+			rc = mnlxt_rt_dump_request(handle, data, nlh, 1);
+		}
 	}
 	return rc;
 }
 
 int mnlxt_rt_addr_request(mnlxt_rt_addr_t *rt_addr, uint16_t type, uint16_t flags) {
+	return mnlxt_rt_addr_handle_request(NULL, rt_addr, type, flags);
+}
+
+int mnlxt_rt_addr_handle_request(mnlxt_handle_t *handle, mnlxt_rt_addr_t *rt_addr, uint16_t type, uint16_t flags) {
 	int rc = -1;
 	mnlxt_message_t *message = mnlxt_rt_addr_message(&rt_addr, type, flags);
 	if (NULL != message) {
-		rc = mnlxt_rt_message_request(message);
+		rc = mnlxt_rt_handle_message_request(handle, message);
 		mnlxt_rt_addr_remove(message);
 		mnlxt_message_free(message);
 	}
@@ -357,3 +396,74 @@ mnlxt_message_t *mnlxt_rt_addr_message(mnlxt_rt_addr_t **rt_addr, uint16_t type,
 	}
 	return message;
 }
+
+#define MNLXT_RT_ADDR_IDENTITY_FILTER                                                                          \
+	(MNLXT_FLAG(MNLXT_RT_ADDR_FAMILY) | MNLXT_FLAG(MNLXT_RT_ADDR_PREFIXLEN) | MNLXT_FLAG(MNLXT_RT_ADDR_IFINDEX) \
+	 | MNLXT_FLAG(MNLXT_RT_ADDR_ADDR) | MNLXT_FLAG(MNLXT_RT_ADDR_LOCAL))
+
+uint32_t mnlxt_rt_addr_identity_hash(const void *object) {
+	const mnlxt_rt_addr_t *addr = object;
+	struct {
+		uint32_t if_index;
+		uint8_t family;
+		uint8_t prefixlen;
+		mnlxt_inet_addr_t addr;
+	} key;
+	memset(&key, 0, sizeof(key));
+	if (MNLXT_GET_PROP_FLAG(addr, MNLXT_RT_ADDR_IFINDEX)) {
+		key.if_index = addr->if_index;
+	}
+	if (MNLXT_GET_PROP_FLAG(addr, MNLXT_RT_ADDR_FAMILY)) {
+		key.family = addr->family;
+	}
+	if (MNLXT_GET_PROP_FLAG(addr, MNLXT_RT_ADDR_PREFIXLEN)) {
+		key.prefixlen = addr->prefixlen;
+	}
+	if (MNLXT_GET_PROP_FLAG(addr, MNLXT_RT_ADDR_LOCAL)) {
+		key.addr = addr->addr_local;
+	} else if (MNLXT_GET_PROP_FLAG(addr, MNLXT_RT_ADDR_ADDR)) {
+		key.addr = addr->addr;
+	}
+	return mnlxt_hash_fnv(&key, sizeof(key));
+}
+
+int mnlxt_rt_addr_identity_cmp(const void *object1, const void *object2) {
+	return mnlxt_rt_addr_compare(object1, object2, MNLXT_RT_ADDR_IDENTITY_FILTER);
+}
+
+static int mnlxt_rt_addr_reconcile_match(const void *current, const void *desired) {
+	return mnlxt_rt_addr_match(current, desired);
+}
+
+static void *mnlxt_rt_addr_reconcile_get(const mnlxt_message_t *message) {
+	return mnlxt_rt_addr_get(message);
+}
+
+static void *mnlxt_rt_addr_reconcile_clone(const void *object) {
+	const mnlxt_rt_addr_t *addr = object;
+	return mnlxt_rt_addr_clone(addr, addr->prop_flags);
+}
+
+static mnlxt_message_t *mnlxt_rt_addr_reconcile_message(void *object, uint16_t type, uint16_t flags) {
+	mnlxt_rt_addr_t *addr = object;
+	return mnlxt_rt_addr_message(&addr, type, flags);
+}
+
+static const mnlxt_reconcile_ops_t addr_reconcile_ops = {
+	.hash = mnlxt_rt_addr_identity_hash,
+	.identity = mnlxt_rt_addr_identity_cmp,
+	.match = mnlxt_rt_addr_reconcile_match,
+	.get = mnlxt_rt_addr_reconcile_get,
+	.clone = mnlxt_rt_addr_reconcile_clone,
+	.free = mnlxt_rt_addr_FREE,
+	.message = mnlxt_rt_addr_reconcile_message,
+	.new_type = RTM_NEWADDR,
+	.new_flags = NLM_F_CREATE | NLM_F_EXCL,
+	.replace_type = RTM_NEWADDR,
+	.replace_flags = NLM_F_REPLACE,
+	.del_type = RTM_DELADDR,
+};
+
+int mnlxt_rt_addr_reconcile(mnlxt_data_t *desired, mnlxt_data_t *current, mnlxt_data_t *changes) {
+	return mnlxt_data_reconcile(&addr_reconcile_ops, desired, current, changes);
+}
@@ -0,0 +1,681 @@
+/*
+ * cache.c		Libmnlxt Routing Object Cache
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libmnlxt/rt.h"
+#include "private/hash.h"
+#include "private/identity.h"
+#include "private/internal.h"
+
+/** receive buffer of the event socket, large enough for bursts of route changes */
+#define MNLXT_RT_CACHE_RCVBUF (4 << 20)
+
+/** rtnetlink group of IPv6 rules, there is no RTMGRP_* macro for it */
+#define MNLXT_RTMGRP_IPV6_RULE (1 << (RTNLGRP_IPV6_RULE - 1))
+
+typedef struct {
+	/** has to be the first member */
+	mnlxt_hash_entry_t entry;
+	void *object;
+} mnlxt_rt_cache_entry_t;
+
+/* functions of a kind of objects kept in a hash table */
+typedef struct {
+	uint32_t (*hash)(const void *object);
+	/* returns 0 for the same identity */
+	int (*cmp)(const void *object1, const void *object2);
+	void *(*clone)(const void *object);
+	void *(*get)(const mnlxt_message_t *message);
+	void *(*remove)(mnlxt_message_t *message);
+	mnlxt_data_free_cb_t free;
+	/* returns 0 if the properties of objects of the same identity are equal */
+	int (*differ)(const void *object1, const void *object2);
+} mnlxt_rt_cache_ops_t;
+
+typedef struct {
+	/** links, addresses and rules, the slot of routes is unused */
+	mnlxt_hash_t tables[MNLXT_RT_CACHE_MAX];
+	mnlxt_rt_route_index_t *routes;
+} mnlxt_rt_cache_state_t;
+
+struct mnlxt_rt_cache_s {
+	uint64_t objects;
+	/** subscribed to the events of the cached objects */
+	mnlxt_handle_t events;
+	/** dumps the cached objects */
+	mnlxt_handle_t request;
+	mnlxt_rt_cache_state_t state;
+	const char *error_str;
+	mnlxt_rt_cache_change_cb_t change_cb;
+	void *change_arg;
+	/** dump again on overrun within mnlxt_rt_cache_process */
+	int auto_resync;
+};
+
+static uint32_t mnlxt_rt_cache_link_hash(const void *object) {
+	const mnlxt_rt_link_t *link = object;
+	return mnlxt_hash_fnv(&link->index, sizeof(link->index));
+}
+
+static int mnlxt_rt_cache_link_cmp(const void *object1, const void *object2) {
+	return (((const mnlxt_rt_link_t *)object1)->index != ((const mnlxt_rt_link_t *)object2)->index);
+}
+
+static void *mnlxt_rt_cache_link_clone(const void *object) {
+	const mnlxt_rt_link_t *link = object;
+	return mnlxt_rt_link_clone(link, link->prop_flags);
+}
+
+static void *mnlxt_rt_cache_link_get(const mnlxt_message_t *message) {
+	return mnlxt_rt_link_get(message);
+}
+
+static void *mnlxt_rt_cache_link_remove(mnlxt_message_t *message) {
+	return mnlxt_rt_link_remove(message);
+}
+
+static int mnlxt_rt_cache_link_differ(const void *object1, const void *object2) {
+	return (0 != mnlxt_rt_link_compare(object1, object2, (uint64_t)-1)
+					|| 0 != mnlxt_rt_link_info_compare(object1, object2, (uint16_t)-1));
+}
+
+static void *mnlxt_rt_cache_addr_clone(const void *object) {
+	const mnlxt_rt_addr_t *addr = object;
+	return mnlxt_rt_addr_clone(addr, addr->prop_flags);
+}
+
+static void *mnlxt_rt_cache_addr_get(const mnlxt_message_t *message) {
+	return mnlxt_rt_addr_get(message);
+}
+
+static void *mnlxt_rt_cache_addr_remove(mnlxt_message_t *message) {
+	return mnlxt_rt_addr_remove(message);
+}
+
+static int mnlxt_rt_cache_addr_differ(const void *object1, const void *object2) {
+	/* the lifetimes of the cache information change all the time */
+	return mnlxt_rt_addr_compare(object1, object2, ~MNLXT_FLAG(MNLXT_RT_ADDR_CACHEINFO));
+}
+
+static void *mnlxt_rt_cache_rule_clone(const void *object) {
+	const mnlxt_rt_rule_t *rule = object;
+	return mnlxt_rt_rule_clone(rule, rule->prop_flags);
+}
+
+static void *mnlxt_rt_cache_rule_get(const mnlxt_message_t *message) {
+	return mnlxt_rt_rule_get(message);
+}
+
+static void *mnlxt_rt_cache_rule_remove(mnlxt_message_t *message) {
+	return mnlxt_rt_rule_remove(message);
+}
+
+static int mnlxt_rt_cache_rule_differ(const void *object1, const void *object2) {
+	/* all properties are the identity */
+	return 0;
+}
+
+static const mnlxt_rt_cache_ops_t cache_ops[MNLXT_RT_CACHE_MAX] = {
+	[MNLXT_RT_CACHE_LINK] = {mnlxt_rt_cache_link_hash, mnlxt_rt_cache_link_cmp, mnlxt_rt_cache_link_clone,
+													 mnlxt_rt_cache_link_get, mnlxt_rt_cache_link_remove, mnlxt_rt_link_FREE,
+													 mnlxt_rt_cache_link_differ},
+	[MNLXT_RT_CACHE_ADDR] = {mnlxt_rt_addr_identity_hash, mnlxt_rt_addr_identity_cmp, mnlxt_rt_cache_addr_clone,
+													 mnlxt_rt_cache_addr_get, mnlxt_rt_cache_addr_remove, mnlxt_rt_addr_FREE,
+													 mnlxt_rt_cache_addr_differ},
+	[MNLXT_RT_CACHE_RULE] = {mnlxt_rt_rule_identity_hash, mnlxt_rt_rule_identity_cmp, mnlxt_rt_cache_rule_clone,
+													 mnlxt_rt_cache_rule_get, mnlxt_rt_cache_rule_remove, mnlxt_rt_rule_FREE,
+													 mnlxt_rt_cache_rule_differ},
+};
+
+/* message types and event groups of IPv4 and IPv6 of the objects */
+static const struct {
+	uint16_t get_type;
+	uint16_t new_type;
+	uint16_t del_type;
+	int groups4;
+	int groups6;
+} cache_objects[MNLXT_RT_CACHE_MAX] = {
+	[MNLXT_RT_CACHE_LINK] = {RTM_GETLINK, RTM_NEWLINK, RTM_DELLINK, RTMGRP_LINK, RTMGRP_LINK},
+	[MNLXT_RT_CACHE_ADDR] = {RTM_GETADDR, RTM_NEWADDR, RTM_DELADDR, RTMGRP_IPV4_IFADDR, RTMGRP_IPV6_IFADDR},
+	[MNLXT_RT_CACHE_ROUTE] = {RTM_GETROUTE, RTM_NEWROUTE, RTM_DELROUTE, RTMGRP_IPV4_ROUTE, RTMGRP_IPV6_ROUTE},
+	[MNLXT_RT_CACHE_RULE] = {RTM_GETRULE, RTM_NEWRULE, RTM_DELRULE, RTMGRP_IPV4_RULE, MNLXT_RTMGRP_IPV6_RULE},
+};
+
+static int mnlxt_rt_cache_message_object(const mnlxt_message_t *message) {
+	int object = -1;
+	switch (message->nlmsg_type) {
+	case RTM_NEWLINK:
+	case RTM_DELLINK:
+		object = MNLXT_RT_CACHE_LINK;
+		break;
+	case RTM_NEWADDR:
+	case RTM_DELADDR:
+		object = MNLXT_RT_CACHE_ADDR;
+		break;
+	case RTM_NEWROUTE:
+	case RTM_DELROUTE:
+		object = MNLXT_RT_CACHE_ROUTE;
+		break;
+	case RTM_NEWRULE:
+	case RTM_DELRULE:
+		object = MNLXT_RT_CACHE_RULE;
+		break;
+	}
+	return object;
+}
+
+typedef struct {
+	const mnlxt_rt_cache_ops_t *ops;
+	const void *object;
+} mnlxt_rt_cache_key_t;
+
+static int mnlxt_rt_cache_key_cmp(const mnlxt_hash_entry_t *entry, const void *key) {
+	const mnlxt_rt_cache_key_t *cache_key = key;
+	return cache_key->ops->cmp(((const mnlxt_rt_cache_entry_t *)entry)->object, cache_key->object);
+}
+
+static mnlxt_rt_cache_entry_t *mnlxt_rt_cache_find(const mnlxt_rt_cache_state_t *state, int object,
+																									 const void *key) {
+	mnlxt_rt_cache_key_t cache_key = {&cache_ops[object], key};
+	return (mnlxt_rt_cache_entry_t *)mnlxt_hash_find(&state->tables[object], cache_ops[object].hash(key),
+																									 mnlxt_rt_cache_key_cmp, &cache_key);
+}
+
+static int mnlxt_rt_cache_state_init(mnlxt_rt_cache_state_t *state) {
+	int rc = -1, object;
+	memset(state, 0, sizeof(*state));
+	for (object = 0; object < MNLXT_RT_CACHE_MAX; ++object) {
+		if (MNLXT_RT_CACHE_ROUTE != object && 0 != mnlxt_hash_init(&state->tables[object], 0)) {
+			goto end;
+		}
+	}
+	if (NULL != (state->routes = mnlxt_rt_route_index_new(0))) {
+		rc = 0;
+	}
+end:
+	return rc;
+}
+
+static void mnlxt_rt_cache_state_clean(mnlxt_rt_cache_state_t *state) {
+	int object;
+	for (object = 0; object < MNLXT_RT_CACHE_MAX; ++object) {
+		mnlxt_hash_entry_t *entry = state->tables[object].first;
+		while (entry) {
+			mnlxt_rt_cache_entry_t *cache_entry = (mnlxt_rt_cache_entry_t *)entry;
+			entry = entry->next;
+			cache_ops[object].free(cache_entry->object);
+			free(cache_entry);
+		}
+		mnlxt_hash_clean(&state->tables[object]);
+	}
+	mnlxt_rt_route_index_free(state->routes);
+	state->routes = NULL;
+}
+
+/* takes the payload of a message over, the payload of an arena message is copied */
+static void *mnlxt_rt_cache_take(mnlxt_message_t *message, void *payload, void *(*remove)(mnlxt_message_t *),
+																 void *(*clone)(const void *)) {
+	return (message->arena ? clone(payload) : remove(message));
+}
+
+static void mnlxt_rt_cache_notify(mnlxt_rt_cache_t *cache, int object, uint16_t type, const void *payload) {
+	if (cache && cache->change_cb) {
+		cache->change_cb(type, object, payload, cache->change_arg);
+	}
+}
+
+static int mnlxt_rt_cache_apply_route(mnlxt_rt_cache_state_t *state, mnlxt_message_t *message,
+																			mnlxt_rt_cache_t *notify) {
+	int rc = -1;
+	mnlxt_rt_route_t *route = mnlxt_rt_route_get(message);
+	if (RTM_DELROUTE == message->nlmsg_type) {
+		if (NULL != (route = mnlxt_rt_route_index_remove(state->routes, route))) {
+			mnlxt_rt_cache_notify(notify, MNLXT_RT_CACHE_ROUTE, RTM_DELROUTE, route);
+			mnlxt_rt_route_free(route);
+		}
+		rc = 0;
+	} else if (NULL != (route = (message->arena ? mnlxt_rt_route_clone(route, route->prop_flags)
+																							: mnlxt_rt_route_remove(message)))) {
+		if (0 <= mnlxt_rt_route_index_add(state->routes, route)) {
+			mnlxt_rt_cache_notify(notify, MNLXT_RT_CACHE_ROUTE, RTM_NEWROUTE, route);
+			rc = 0;
+		} else {
+			mnlxt_rt_route_free(route);
+		}
+	}
+	return rc;
+}
+
+/* applies an event or a dumped object, deletion of unknown objects is ignored; changes are passed to notify */
+static int mnlxt_rt_cache_apply(mnlxt_rt_cache_state_t *state, mnlxt_message_t *message, mnlxt_rt_cache_t *notify) {
+	int rc = -1, object = mnlxt_rt_cache_message_object(message);
+	const mnlxt_rt_cache_ops_t *ops;
+	mnlxt_rt_cache_entry_t *entry;
+	void *payload;
+
+	if (0 > object || NULL == message->payload) {
+		/* not cached */
+		rc = 0;
+		goto end;
+	}
+	if (MNLXT_RT_CACHE_ROUTE == object) {
+		rc = mnlxt_rt_cache_apply_route(state, message, notify);
+		goto end;
+	}
+	ops = &cache_ops[object];
+	payload = ops->get(message);
+	if (MNLXT_RT_CACHE_LINK == object && AF_BRIDGE == ((mnlxt_rt_link_t *)payload)->family) {
+		/* bridge port events share the index with the link itself */
+		rc = 0;
+		goto end;
+	}
+	entry = mnlxt_rt_cache_find(state, object, payload);
+	if (cache_objects[object].del_type == message->nlmsg_type) {
+		if (entry) {
+			mnlxt_hash_remove(&state->tables[object], &entry->entry);
+			mnlxt_rt_cache_notify(notify, object, message->nlmsg_type, entry->object);
+			ops->free(entry->object);
+			free(entry);
+		}
+		rc = 0;
+		goto end;
+	}
+	if (NULL == (payload = mnlxt_rt_cache_take(message, payload, ops->remove, ops->clone))) {
+		goto end;
+	} else if (entry) {
+		ops->free(entry->object);
+		entry->object = payload;
+		rc = 0;
+	} else if (NULL != (entry = malloc(sizeof(mnlxt_rt_cache_entry_t)))) {
+		entry->object = payload;
+		mnlxt_hash_insert(&state->tables[object], &entry->entry, ops->hash(payload));
+		rc = 0;
+	} else {
+		ops->free(payload);
+	}
+	if (0 == rc) {
+		mnlxt_rt_cache_notify(notify, object, message->nlmsg_type, payload);
+	}
+end:
+	return rc;
+}
+
+static int mnlxt_rt_cache_dump_cb(mnlxt_message_t *message, void *arg) {
+	return (0 == mnlxt_rt_cache_apply((mnlxt_rt_cache_state_t *)arg, message, NULL) ? 0 : 1);
+}
+
+static int mnlxt_rt_cache_event_cb(mnlxt_message_t *message, void *arg) {
+	mnlxt_rt_cache_t *cache = (mnlxt_rt_cache_t *)arg;
+	return (0 == mnlxt_rt_cache_apply(&cache->state, message, cache) ? 0 : 1);
+}
+
+/* gets the family to dump an object with, or -1 if none of its groups is subscribed */
+static int mnlxt_rt_cache_dump_family(const mnlxt_rt_cache_t *cache, int object) {
+	int family = -1;
+	int groups4 = cache->events.groups & cache_objects[object].groups4;
+	int groups6 = cache->events.groups & cache_objects[object].groups6;
+	if (!(cache->objects & MNLXT_FLAG(object))) {
+		/* not cached */
+	} else if (groups4 && groups6) {
+		family = AF_UNSPEC;
+	} else if (groups4) {
+		family = AF_INET;
+	} else if (groups6) {
+		family = AF_INET6;
+	}
+	return family;
+}
+
+static int mnlxt_rt_cache_dump(mnlxt_rt_cache_t *cache, mnlxt_rt_cache_state_t *state) {
+	int rc = -1, object, family;
+	for (object = 0; object < MNLXT_RT_CACHE_MAX; ++object) {
+		mnlxt_data_t data = {};
+		if (0 > (family = mnlxt_rt_cache_dump_family(cache, object))) {
+			continue;
+		}
+		/* dumped objects go straight into the tables */
+		mnlxt_data_set_stream(&data, mnlxt_rt_cache_dump_cb, state);
+		if (0 != mnlxt_rt_handle_data_dump(&cache->request, &data, cache_objects[object].get_type, family)) {
+			cache->error_str = (data.error_str ? data.error_str : "dump failed");
+		} else if (data.stream_stopped) {
+			cache->error_str = "applying dump failed";
+		} else {
+			rc = 0;
+		}
+		mnlxt_data_clean(&data);
+		if (0 != rc) {
+			goto end;
+		}
+		rc = -1;
+	}
+	rc = 0;
+end:
+	return rc;
+}
+
+/* passes the differences between the cached objects and a new dump as changes */
+static void mnlxt_rt_cache_diff(mnlxt_rt_cache_t *cache, const mnlxt_rt_cache_state_t *state) {
+	int object;
+	void *it;
+	mnlxt_rt_route_t *route, *other;
+	mnlxt_hash_entry_t *entry;
+	mnlxt_rt_cache_entry_t *found;
+
+	for (object = 0; object < MNLXT_RT_CACHE_MAX; ++object) {
+		const mnlxt_rt_cache_ops_t *ops = &cache_ops[object];
+		if (0 > mnlxt_rt_cache_dump_family(cache, object)) {
+			continue;
+		}
+		if (MNLXT_RT_CACHE_ROUTE == object) {
+			for (it = NULL; NULL != (route = mnlxt_rt_route_index_iterate(state->routes, &it));) {
+				other = mnlxt_rt_route_index_lookup(cache->state.routes, route);
+				if (NULL == other || 0 != mnlxt_rt_route_compare(other, route, (uint64_t)-1)) {
+					mnlxt_rt_cache_notify(cache, object, RTM_NEWROUTE, route);
+				}
+			}
+			for (it = NULL; NULL != (route = mnlxt_rt_route_index_iterate(cache->state.routes, &it));) {
+				if (NULL == mnlxt_rt_route_index_lookup(state->routes, route)) {
+					mnlxt_rt_cache_notify(cache, object, RTM_DELROUTE, route);
+				}
+			}
+			continue;
+		}
+		for (entry = state->tables[object].first; entry; entry = entry->next) {
+			void *payload = ((mnlxt_rt_cache_entry_t *)entry)->object;
+			found = mnlxt_rt_cache_find(&cache->state, object, payload);
+			if (NULL == found || 0 != ops->differ(found->object, payload)) {
+				mnlxt_rt_cache_notify(cache, object, cache_objects[object].new_type, payload);
+			}
+		}
+		for (entry = cache->state.tables[object].first; entry; entry = entry->next) {
+			void *payload = ((mnlxt_rt_cache_entry_t *)entry)->object;
+			if (NULL == mnlxt_rt_cache_find(state, object, payload)) {
+				mnlxt_rt_cache_notify(cache, object, cache_objects[object].del_type, payload);
+			}
+		}
+	}
+}
+
+/* applies the queued events, returns the number of applied messages */
+static int mnlxt_rt_cache_events(mnlxt_rt_cache_t *cache, int *overrun) {
+	int rc = 0, ret;
+	mnlxt_buffer_t buffer;
+
+	*overrun = 0;
+	while (1) {
+		mnlxt_data_t data = {};
+		memset(&buffer, 0, sizeof(buffer));
+		ret = mnlxt_receive_inplace(&cache->events, &buffer);
+		if (0 == ret) {
+			break;
+		}
+		if (0 > ret) {
+			if (ENOBUFS == errno) {
+				*overrun = 1;
+			} else {
+				cache->error_str = cache->events.error_str;
+				rc = -1;
+			}
+			break;
+		}
+		/* events are not answers to a request */
+		buffer.portid = buffer.seq = 0;
+		mnlxt_data_set_stream(&data, mnlxt_rt_cache_event_cb, cache);
+		ret = mnlxt_data_parse(&data, &buffer);
+		mnlxt_buffer_clean(&buffer);
+		if (0 > ret || data.stream_stopped) {
+			cache->error_str = (data.error_str ? data.error_str : "applying event failed");
+			mnlxt_data_clean(&data);
+			rc = -1;
+			break;
+		}
+		mnlxt_data_clean(&data);
+		++rc;
+	}
+	return rc;
+}
+
+int mnlxt_rt_cache_resync(mnlxt_rt_cache_t *cache) {
+	int rc = -1, overrun = 0, tries = 0;
+	mnlxt_rt_cache_state_t state;
+
+	if (NULL == cache) {
+		errno = EINVAL;
+		return rc;
+	}
+	do {
+		if (0 != mnlxt_rt_cache_state_init(&state)) {
+			cache->error_str = "malloc failed";
+			mnlxt_rt_cache_state_clean(&state);
+			break;
+		}
+		if (0 != mnlxt_rt_cache_dump(cache, &state)) {
+			mnlxt_rt_cache_state_clean(&state);
+			break;
+		}
+		if (cache->change_cb) {
+			mnlxt_rt_cache_diff(cache, &state);
+		}
+		mnlxt_rt_cache_state_clean(&cache->state);
+		cache->state = state;
+		/* the events queued during the dump are newer than or equal to the dumped objects */
+		if (0 <= mnlxt_rt_cache_events(cache, &overrun) && !overrun) {
+			rc = 0;
+		}
+	} while (0 != rc && overrun && ++tries < 3);
+	if (0 != rc && overrun) {
+		cache->error_str = "event overrun during resync";
+		errno = ENOBUFS;
+	}
+	return rc;
+}
+
+mnlxt_rt_cache_t *mnlxt_rt_cache_new(uint64_t objects) {
+	mnlxt_rt_cache_t *cache = NULL;
+	int object, groups = 0;
+	mnlxt_connect_opts_t opts = {};
+
+	if (0 == objects || objects >= MNLXT_FLAG((MNLXT_RT_CACHE_MAX))) {
+		errno = EINVAL;
+		goto failed;
+	}
+	for (object = 0; object < MNLXT_RT_CACHE_MAX; ++object) {
+		if (objects & MNLXT_FLAG(object)) {
+			groups |= cache_objects[object].groups4 | cache_objects[object].groups6;
+		}
+	}
+	if (NULL == (cache = calloc(1, sizeof(mnlxt_rt_cache_t)))) {
+		goto failed;
+	}
+	cache->objects = objects;
+	cache->auto_resync = 1;
+	/* subscribe before dumping, so no change is lost between dump and events */
+	opts.flags =
+		MNLXT_FLAG(MNLXT_CONNECT_NONBLOCK) | MNLXT_FLAG(MNLXT_CONNECT_CLOEXEC) | MNLXT_FLAG(MNLXT_CONNECT_BUF_FORCE);
+	opts.rcvbuf = MNLXT_RT_CACHE_RCVBUF;
+	if (0 != mnlxt_rt_connect_opts(&cache->events, groups, &opts)) {
+		goto failed;
+	}
+	if (0 != mnlxt_rt_connect(&cache->request, 0)) {
+		goto failed;
+	}
+	if (0 != mnlxt_rt_cache_resync(cache)) {
+		goto failed;
+	}
+	return cache;
+failed:
+	mnlxt_rt_cache_free(cache);
+	return NULL;
+}
+
+void mnlxt_rt_cache_free(mnlxt_rt_cache_t *cache) {
+	if (cache) {
+		int errnum = errno;
+		mnlxt_rt_cache_state_clean(&cache->state);
+		mnlxt_disconnect(&cache->events);
+		mnlxt_disconnect(&cache->request);
+		free(cache);
+		errno = errnum;
+	}
+}
+
+int mnlxt_rt_cache_get_fd(const mnlxt_rt_cache_t *cache) {
+	int rc = -1;
+	if (NULL == cache) {
+		errno = EINVAL;
+	} else {
+		rc = mnlxt_handel_get_fd(&cache->events);
+	}
+	return rc;
+}
+
+int mnlxt_rt_cache_process(mnlxt_rt_cache_t *cache) {
+	int rc = -1, overrun;
+	if (NULL == cache) {
+		errno = EINVAL;
+	} else if (0 <= (rc = mnlxt_rt_cache_events(cache, &overrun)) && overrun) {
+		/* changes are lost, only a new dump gets the cache in sync again */
+		if (!cache->auto_resync) {
+			cache->error_str = cache->events.error_str;
+			errno = ENOBUFS;
+			rc = -1;
+		} else if (0 != mnlxt_rt_cache_resync(cache)) {
+			rc = -1;
+		}
+	}
+	return rc;
+}
+
+int mnlxt_rt_cache_set_change_cb(mnlxt_rt_cache_t *cache, mnlxt_rt_cache_change_cb_t cb, void *arg) {
+	int rc = -1;
+	if (NULL == cache) {
+		errno = EINVAL;
+	} else {
+		cache->change_cb = cb;
+		cache->change_arg = arg;
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_rt_cache_set_auto_resync(mnlxt_rt_cache_t *cache, int enable) {
+	int rc = -1;
+	if (NULL == cache) {
+		errno = EINVAL;
+	} else {
+		cache->auto_resync = enable;
+		rc = 0;
+	}
+	return rc;
+}
+
+unsigned long mnlxt_rt_cache_overruns(const mnlxt_rt_cache_t *cache) {
+	unsigned long overruns = 0;
+	if (NULL == cache) {
+		errno = EINVAL;
+	} else {
+		overruns = mnlxt_handle_get_overruns(&cache->events);
+	}
+	return overruns;
+}
+
+const char *mnlxt_rt_cache_error(const mnlxt_rt_cache_t *cache) {
+	return (cache ? cache->error_str : NULL);
+}
+
+size_t mnlxt_rt_cache_count(const mnlxt_rt_cache_t *cache, mnlxt_rt_cache_object_t object) {
+	size_t count = 0;
+	if (NULL == cache || MNLXT_RT_CACHE_MAX <= object) {
+		errno = EINVAL;
+	} else if (MNLXT_RT_CACHE_ROUTE == object) {
+		count = mnlxt_rt_route_index_count(cache->state.routes);
+	} else {
+		count = cache->state.tables[object].count;
+	}
+	return count;
+}
+
+static void *mnlxt_rt_cache_lookup(const mnlxt_rt_cache_t *cache, int object, const void *key) {
+	void *found = NULL;
+	mnlxt_rt_cache_entry_t *entry;
+	if (NULL == cache || NULL == key) {
+		errno = EINVAL;
+	} else if (NULL != (entry = mnlxt_rt_cache_find(&cache->state, object, key))) {
+		found = entry->object;
+	}
+	return found;
+}
+
+static void *mnlxt_rt_cache_iterate(const mnlxt_rt_cache_t *cache, int object, void **iterator) {
+	void *found = NULL;
+	mnlxt_hash_entry_t *entry;
+	if (NULL == cache || NULL == iterator) {
+		errno = EINVAL;
+	} else {
+		/* the iterator refers the next entry; the table marks the end */
+		const mnlxt_hash_t *table = &cache->state.tables[object];
+		entry = (NULL == *iterator ? table->first : (*iterator == table ? NULL : *iterator));
+		if (NULL != entry) {
+			found = ((mnlxt_rt_cache_entry_t *)entry)->object;
+			*iterator = (entry->next ? (void *)entry->next : (void *)table);
+		}
+	}
+	return found;
+}
+
+mnlxt_rt_link_t *mnlxt_rt_cache_link_lookup(const mnlxt_rt_cache_t *cache, uint32_t index) {
+	mnlxt_rt_link_t key = {};
+	key.index = index;
+	MNLXT_SET_PROP_FLAG((&key), MNLXT_RT_LINK_INDEX);
+	return mnlxt_rt_cache_lookup(cache, MNLXT_RT_CACHE_LINK, &key);
+}
+
+mnlxt_rt_link_t *mnlxt_rt_cache_link_iterate(const mnlxt_rt_cache_t *cache, void **iterator) {
+	return mnlxt_rt_cache_iterate(cache, MNLXT_RT_CACHE_LINK, iterator);
+}
+
+mnlxt_rt_addr_t *mnlxt_rt_cache_addr_lookup(const mnlxt_rt_cache_t *cache, const mnlxt_rt_addr_t *key) {
+	return mnlxt_rt_cache_lookup(cache, MNLXT_RT_CACHE_ADDR, key);
+}
+
+mnlxt_rt_addr_t *mnlxt_rt_cache_addr_iterate(const mnlxt_rt_cache_t *cache, void **iterator) {
+	return mnlxt_rt_cache_iterate(cache, MNLXT_RT_CACHE_ADDR, iterator);
+}
+
+mnlxt_rt_route_t *mnlxt_rt_cache_route_lookup(const mnlxt_rt_cache_t *cache, const mnlxt_rt_route_t *key) {
+	mnlxt_rt_route_t *route = NULL;
+	if (NULL == cache) {
+		errno = EINVAL;
+	} else {
+		route = mnlxt_rt_route_index_lookup(cache->state.routes, key);
+	}
+	return route;
+}
+
+mnlxt_rt_route_t *mnlxt_rt_cache_route_iterate(const mnlxt_rt_cache_t *cache, void **iterator) {
+	mnlxt_rt_route_t *route = NULL;
+	if (NULL == cache) {
+		errno = EINVAL;
+	} else {
+		route = mnlxt_rt_route_index_iterate(cache->state.routes, iterator);
+	}
+	return route;
+}
+
+mnlxt_rt_rule_t *mnlxt_rt_cache_rule_lookup(const mnlxt_rt_cache_t *cache, const mnlxt_rt_rule_t *key) {
+	return mnlxt_rt_cache_lookup(cache, MNLXT_RT_CACHE_RULE, key);
+}
+
+mnlxt_rt_rule_t *mnlxt_rt_cache_rule_iterate(const mnlxt_rt_cache_t *cache, void **iterator) {
+	return mnlxt_rt_cache_iterate(cache, MNLXT_RT_CACHE_RULE, iterator);
+}
@@ -13,6 +13,7 @@
 
 #include "config.h"
 #include "libmnlxt/rt.h"
+#include "private/data.h"
 #include "private/internal.h"
 #include "private/link_data_tun.h"
 #include "private/link_data_vlan.h"
@@ -387,9 +388,9 @@ int mnlxt_rt_link_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 		goto end;
 	}
 
-	rt_link = mnlxt_rt_link_new();
+	rt_link = mnlxt_data_alloc(data, sizeof(mnlxt_rt_link_t));
 	if (NULL == rt_link) {
-		data->error_str = "nl_link_new failed";
+		data->error_str = "mnlxt_data_alloc failed";
 		goto end;
 	}
 
@@ -511,9 +512,9 @@ int mnlxt_rt_link_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 		}
 	}
 
-	msg = mnlxt_rt_message_new(nlh->nlmsg_type, 0, rt_link);
+	msg = mnlxt_rt_data_message_new(data, nlh->nlmsg_type, rt_link);
 	if (NULL == msg) {
-		data->error_str = "mnlxt_rt_message_new failed";
+		data->error_str = "mnlxt_rt_data_message_new failed";
 		goto end;
 	}
 
@@ -522,7 +523,7 @@ int mnlxt_rt_link_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 	msg = NULL;
 	rc = MNL_CB_OK;
 end:
-	mnlxt_rt_link_free(rt_link);
+	mnlxt_data_release(data, rt_link, mnlxt_rt_link_FREE);
 	mnlxt_message_free(msg);
 
 	return rc;
@@ -559,10 +560,50 @@ mnlxt_rt_link_t *mnlxt_rt_link_iterate(mnlxt_data_t *data, mnlxt_message_t **ite
 }
 
 int mnlxt_rt_link_dump(mnlxt_data_t *data) {
-	return mnlxt_rt_data_dump(data, RTM_GETLINK, AF_PACKET);
+	return mnlxt_rt_link_handle_dump(NULL, data);
+}
+
+int mnlxt_rt_link_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data) {
+	return mnlxt_rt_handle_data_dump(handle, data, RTM_GETLINK, AF_PACKET);
+}
+
+int mnlxt_rt_link_dump_filter(mnlxt_data_t *data, const mnlxt_rt_link_t *filter) {
+	return mnlxt_rt_link_handle_dump_filter(NULL, data, filter);
+}
+
+int mnlxt_rt_link_handle_dump_filter(mnlxt_handle_t *handle, mnlxt_data_t *data, const mnlxt_rt_link_t *filter) {
+	int rc = -1;
+	const char *kind = NULL;
+	if (NULL == filter || (filter->prop_flags & ~MNLXT_RT_LINK_DUMP_FILTER)) {
+		errno = EINVAL;
+	} else if (MNLXT_GET_PROP_FLAG(filter, MNLXT_RT_LINK_INFO)
+						 && NULL == (kind = mnlxt_rt_link_info_kind_get_string(filter->info.kind))) {
+		errno = EINVAL;
+	} else {
+		char buf[MNL_NLMSG_HDRLEN + MNL_ALIGN(sizeof(struct ifinfomsg)) + 64];
+		struct nlmsghdr *nlh = mnl_nlmsg_put_header(buf);
+		struct ifinfomsg *ifm = mnl_nlmsg_put_extra_header(nlh, sizeof(struct ifinfomsg));
+		nlh->nlmsg_type = RTM_GETLINK;
+		ifm->ifi_family = AF_PACKET;
+		if (MNLXT_GET_PROP_FLAG(filter, MNLXT_RT_LINK_MASTER)) {
+			mnl_attr_put_u32(nlh, IFLA_MASTER, filter->master);
+		}
+		if (kind) {
+			/* the kernel matches the kind only, the kind specific data is not needed */
+			struct nlattr *nest_info = mnl_attr_nest_start(nlh, IFLA_LINKINFO);
+			mnl_attr_put_str(nlh, IFLA_INFO_KIND, kind);
+			mnl_attr_nest_end(nlh, nest_info);
+		}
+		rc = mnlxt_rt_dump_request(handle, data, nlh, 1);
+	}
+	return rc;
 }
 
 int mnlxt_rt_link_request(mnlxt_rt_link_t *rt_link, uint16_t type, uint16_t flags) {
+	return mnlxt_rt_link_handle_request(NULL, rt_link, type, flags);
+}
+
+int mnlxt_rt_link_handle_request(mnlxt_handle_t *handle, mnlxt_rt_link_t *rt_link, uint16_t type, uint16_t flags) {
 	int rc = -1;
 	mnlxt_rt_link_info_kind_t info_kind = -1;
 	if (0 == mnlxt_rt_link_get_info_kind(rt_link, &info_kind) && MNLXT_RT_LINK_INFO_KIND_TUN == info_kind) {
@@ -581,7 +622,7 @@ int mnlxt_rt_link_request(mnlxt_rt_link_t *rt_link, uint16_t type, uint16_t flag
 	}
 	mnlxt_message_t *message = mnlxt_rt_link_message(&rt_link, type, flags);
 	if (NULL != message) {
-		rc = mnlxt_rt_message_request(message);
+		rc = mnlxt_rt_handle_message_request(handle, message);
 		if (0 == rc && RTM_NEWLINK == type) {
 			/* add device index */
 			uint32_t if_index;
@@ -0,0 +1,203 @@
+/*
+ * neigh.c		Libmnlxt Routing Neighbours
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libmnlxt/rt_neigh.h"
+#include "private/internal.h"
+
+#define neigh_ad_init(member) ad_init(mnlxt_rt_neigh_t, member)
+
+static struct access_data neigh_data[MNLXT_RT_NEIGH_MAX] = {
+	[MNLXT_RT_NEIGH_FAMILY] = neigh_ad_init(family),
+	[MNLXT_RT_NEIGH_IFINDEX] = neigh_ad_init(if_index),
+	[MNLXT_RT_NEIGH_STATE] = neigh_ad_init(state),
+	[MNLXT_RT_NEIGH_FLAGS] = neigh_ad_init(flags),
+	[MNLXT_RT_NEIGH_TYPE] = neigh_ad_init(type),
+	[MNLXT_RT_NEIGH_DST] = {}, // special case
+	[MNLXT_RT_NEIGH_LLADDR] = neigh_ad_init(lladdr),
+	[MNLXT_RT_NEIGH_VLAN] = neigh_ad_init(vlan),
+};
+
+mnlxt_rt_neigh_t *mnlxt_rt_neigh_new() {
+	return calloc(1, sizeof(mnlxt_rt_neigh_t));
+}
+
+mnlxt_rt_neigh_t *mnlxt_rt_neigh_clone(const mnlxt_rt_neigh_t *src, uint64_t filter) {
+	mnlxt_rt_neigh_t *dst = NULL;
+	if (NULL == src) {
+		errno = EINVAL;
+	} else if (NULL != (dst = mnlxt_rt_neigh_new()) && filter) {
+		*dst = *src;
+		dst->prop_flags = src->prop_flags & filter;
+	}
+	return dst;
+}
+
+void mnlxt_rt_neigh_free(mnlxt_rt_neigh_t *neigh) {
+	if (NULL != neigh) {
+		free(neigh);
+	}
+}
+
+static int mnlxt_rt_neigh_set_ptr(mnlxt_rt_neigh_t *neigh, mnlxt_rt_neigh_data_t data, const void *ptr, uint8_t size) {
+	int rc = -1;
+	if (NULL == neigh || MNLXT_RT_NEIGH_MAX <= (unsigned)data || neigh_data[data].size != size
+			|| 0 == neigh_data[data].size) {
+		errno = EINVAL;
+	} else {
+		MNLXT_SET_PROP_FLAG(neigh, data);
+		memcpy(((char *)neigh + neigh_data[data].offset), ptr, size);
+		rc = 0;
+	}
+	return rc;
+}
+
+static inline int mnlxt_rt_neigh_set_u32(mnlxt_rt_neigh_t *neigh, mnlxt_rt_neigh_data_t data, uint32_t u32) {
+	return mnlxt_rt_neigh_set_ptr(neigh, data, &u32, sizeof(uint32_t));
+}
+
+static inline int mnlxt_rt_neigh_set_u16(mnlxt_rt_neigh_t *neigh, mnlxt_rt_neigh_data_t data, uint16_t u16) {
+	return mnlxt_rt_neigh_set_ptr(neigh, data, &u16, sizeof(uint16_t));
+}
+
+static inline int mnlxt_rt_neigh_set_u8(mnlxt_rt_neigh_t *neigh, mnlxt_rt_neigh_data_t data, uint8_t u8) {
+	return mnlxt_rt_neigh_set_ptr(neigh, data, &u8, sizeof(uint8_t));
+}
+
+static int mnlxt_rt_neigh_get_ptr(const mnlxt_rt_neigh_t *neigh, mnlxt_rt_neigh_data_t data, void *ptr, uint8_t size) {
+	int rc = -1;
+	if (NULL == neigh || MNLXT_RT_NEIGH_MAX <= (unsigned)data || neigh_data[data].size != size
+			|| 0 == neigh_data[data].size) {
+		errno = EINVAL;
+	} else if (!MNLXT_GET_PROP_FLAG(neigh, data)) {
+		rc = 1;
+	} else {
+		memcpy(ptr, ((char *)neigh + neigh_data[data].offset), size);
+		rc = 0;
+	}
+	return rc;
+}
+
+static inline int mnlxt_rt_neigh_get_u32(const mnlxt_rt_neigh_t *neigh, mnlxt_rt_neigh_data_t data, uint32_t *pu32) {
+	return mnlxt_rt_neigh_get_ptr(neigh, data, pu32, sizeof(uint32_t));
+}
+
+static inline int mnlxt_rt_neigh_get_u16(const mnlxt_rt_neigh_t *neigh, mnlxt_rt_neigh_data_t data, uint16_t *pu16) {
+	return mnlxt_rt_neigh_get_ptr(neigh, data, pu16, sizeof(uint16_t));
+}
+
+static inline int mnlxt_rt_neigh_get_u8(const mnlxt_rt_neigh_t *neigh, mnlxt_rt_neigh_data_t data, uint8_t *pu8) {
+	return mnlxt_rt_neigh_get_ptr(neigh, data, pu8, sizeof(uint8_t));
+}
+
+int mnlxt_rt_neigh_set_family(mnlxt_rt_neigh_t *neigh, uint8_t family) {
+	int rc = -1;
+	if (NULL == neigh) {
+		errno = EINVAL;
+	} else if (AF_INET != family && AF_INET6 != family && AF_BRIDGE != family) {
+		errno = EAFNOSUPPORT;
+	} else if (MNLXT_GET_PROP_FLAG(neigh, MNLXT_RT_NEIGH_FAMILY)) {
+		if (family == neigh->family) {
+			rc = 0;
+		} else {
+			errno = EINVAL;
+		}
+	} else {
+		neigh->family = family;
+		MNLXT_SET_PROP_FLAG(neigh, MNLXT_RT_NEIGH_FAMILY);
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_rt_neigh_get_family(const mnlxt_rt_neigh_t *neigh, uint8_t *family) {
+	return mnlxt_rt_neigh_get_u8(neigh, MNLXT_RT_NEIGH_FAMILY, family);
+}
+
+int mnlxt_rt_neigh_set_ifindex(mnlxt_rt_neigh_t *neigh, uint32_t if_index) {
+	return mnlxt_rt_neigh_set_u32(neigh, MNLXT_RT_NEIGH_IFINDEX, if_index);
+}
+
+int mnlxt_rt_neigh_get_ifindex(const mnlxt_rt_neigh_t *neigh, uint32_t *if_index) {
+	return mnlxt_rt_neigh_get_u32(neigh, MNLXT_RT_NEIGH_IFINDEX, if_index);
+}
+
+int mnlxt_rt_neigh_set_state(mnlxt_rt_neigh_t *neigh, uint16_t state) {
+	return mnlxt_rt_neigh_set_u16(neigh, MNLXT_RT_NEIGH_STATE, state);
+}
+
+int mnlxt_rt_neigh_get_state(const mnlxt_rt_neigh_t *neigh, uint16_t *state) {
+	return mnlxt_rt_neigh_get_u16(neigh, MNLXT_RT_NEIGH_STATE, state);
+}
+
+int mnlxt_rt_neigh_set_flags(mnlxt_rt_neigh_t *neigh, uint8_t flags) {
+	return mnlxt_rt_neigh_set_u8(neigh, MNLXT_RT_NEIGH_FLAGS, flags);
+}
+
+int mnlxt_rt_neigh_get_flags(const mnlxt_rt_neigh_t *neigh, uint8_t *flags) {
+	return mnlxt_rt_neigh_get_u8(neigh, MNLXT_RT_NEIGH_FLAGS, flags);
+}
+
+int mnlxt_rt_neigh_set_type(mnlxt_rt_neigh_t *neigh, uint8_t type) {
+	return mnlxt_rt_neigh_set_u8(neigh, MNLXT_RT_NEIGH_TYPE, type);
+}
+
+int mnlxt_rt_neigh_get_type(const mnlxt_rt_neigh_t *neigh, uint8_t *type) {
+	return mnlxt_rt_neigh_get_u8(neigh, MNLXT_RT_NEIGH_TYPE, type);
+}
+
+int mnlxt_rt_neigh_set_dst(mnlxt_rt_neigh_t *neigh, uint8_t family, const mnlxt_inet_addr_t *buf) {
+	int rc = -1;
+	if (NULL == neigh || NULL == buf || (AF_INET != family && AF_INET6 != family)) {
+		errno = EINVAL;
+	} else {
+		rc = mnlxt_rt_neigh_set_family(neigh, family);
+		if (0 == rc) {
+			neigh->dst = *buf;
+			MNLXT_SET_PROP_FLAG(neigh, MNLXT_RT_NEIGH_DST);
+		}
+	}
+	return rc;
+}
+
+int mnlxt_rt_neigh_get_dst(const mnlxt_rt_neigh_t *neigh, uint8_t *family, const mnlxt_inet_addr_t **buf) {
+	int rc = -1;
+	if (NULL == neigh || NULL == buf) {
+		errno = EINVAL;
+	} else if (!MNLXT_GET_PROP_FLAG(neigh, MNLXT_RT_NEIGH_DST)) {
+		rc = 1;
+	} else {
+		*buf = &neigh->dst;
+		if (NULL != family) {
+			*family = neigh->family;
+		}
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_rt_neigh_set_lladdr(mnlxt_rt_neigh_t *neigh, mnlxt_eth_addr_t lladdr) {
+	return mnlxt_rt_neigh_set_ptr(neigh, MNLXT_RT_NEIGH_LLADDR, lladdr, sizeof(mnlxt_eth_addr_t));
+}
+
+int mnlxt_rt_neigh_get_lladdr(const mnlxt_rt_neigh_t *neigh, mnlxt_eth_addr_t *lladdr) {
+	return mnlxt_rt_neigh_get_ptr(neigh, MNLXT_RT_NEIGH_LLADDR, lladdr, sizeof(mnlxt_eth_addr_t));
+}
+
+int mnlxt_rt_neigh_set_vlan(mnlxt_rt_neigh_t *neigh, uint16_t vlan) {
+	return mnlxt_rt_neigh_set_u16(neigh, MNLXT_RT_NEIGH_VLAN, vlan);
+}
+
+int mnlxt_rt_neigh_get_vlan(const mnlxt_rt_neigh_t *neigh, uint16_t *vlan) {
+	return mnlxt_rt_neigh_get_u16(neigh, MNLXT_RT_NEIGH_VLAN, vlan);
+}
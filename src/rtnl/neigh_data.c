@@ -0,0 +1,417 @@
+/*
+ * neigh_data.c		Libmnlxt Routing Neighbours
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "libmnlxt/rt.h"
+#include "private/data.h"
+#include "private/hash.h"
+#include "private/identity.h"
+#include "private/internal.h"
+#include "private/reconcile.h"
+
+static int mnlxt_rt_neigh_cmp(const mnlxt_rt_neigh_t *neigh1, const mnlxt_rt_neigh_t *neigh2,
+															mnlxt_rt_neigh_data_t data) {
+	int rc = data + 1;
+	size_t family_size;
+	switch (data) {
+	case MNLXT_RT_NEIGH_FAMILY:
+		if (neigh1->family != neigh2->family) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_NEIGH_IFINDEX:
+		if (neigh1->if_index != neigh2->if_index) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_NEIGH_STATE:
+		if (neigh1->state != neigh2->state) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_NEIGH_FLAGS:
+		if (neigh1->flags != neigh2->flags) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_NEIGH_TYPE:
+		if (neigh1->type != neigh2->type) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_NEIGH_DST:
+		family_size = (AF_INET == neigh1->family ? sizeof(neigh1->dst.in) : sizeof(neigh1->dst));
+		if (0 != memcmp(&neigh1->dst, &neigh2->dst, family_size)) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_NEIGH_LLADDR:
+		if (0 != memcmp(neigh1->lladdr, neigh2->lladdr, sizeof(neigh1->lladdr))) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_NEIGH_VLAN:
+		if (neigh1->vlan != neigh2->vlan) {
+			goto failed;
+		}
+		break;
+	}
+	rc = 0;
+failed:
+	return rc;
+}
+
+int mnlxt_rt_neigh_match(const mnlxt_rt_neigh_t *neigh, const mnlxt_rt_neigh_t *match) {
+	int rc = -1;
+	if (NULL == match) {
+		errno = EINVAL;
+	} else {
+		rc = mnlxt_rt_neigh_compare(neigh, match, match->prop_flags);
+	}
+	return rc;
+}
+
+int mnlxt_rt_neigh_compare(const mnlxt_rt_neigh_t *neigh1, const mnlxt_rt_neigh_t *neigh2, uint64_t filter) {
+	int rc = -1, i;
+	if (NULL == neigh1 || NULL == neigh2) {
+		errno = EINVAL;
+	} else {
+		uint64_t flag = 1;
+		for (i = 0; i < MNLXT_RT_NEIGH_MAX; ++i, flag <<= 1) {
+			if (0 == (flag & filter)) {
+				continue;
+			}
+			if (0 == (neigh1->prop_flags & flag)) {
+				if (0 == (neigh2->prop_flags & flag)) {
+					/* both not set */
+					continue;
+				}
+				goto failed;
+			} else if (0 == (neigh2->prop_flags & flag)) {
+				goto failed;
+			} else if (0 != mnlxt_rt_neigh_cmp(neigh1, neigh2, i)) {
+				goto failed;
+			}
+		}
+		return 0;
+	failed:
+		rc = ++i;
+	}
+	return rc;
+}
+
+mnlxt_rt_neigh_t *mnlxt_rt_neigh_get(const mnlxt_message_t *message) {
+	mnlxt_rt_neigh_t *neigh = NULL;
+	if (message && message->payload
+			&& (RTM_NEWNEIGH == message->nlmsg_type || RTM_GETNEIGH == message->nlmsg_type
+					|| RTM_DELNEIGH == message->nlmsg_type)) {
+		neigh = (mnlxt_rt_neigh_t *)message->payload;
+	}
+	return neigh;
+}
+
+mnlxt_rt_neigh_t *mnlxt_rt_neigh_remove(mnlxt_message_t *message) {
+	mnlxt_rt_neigh_t *neigh = mnlxt_rt_neigh_get(message);
+	if (NULL != neigh) {
+		message->payload = NULL;
+	}
+	return neigh;
+}
+
+int mnlxt_rt_neigh_put(struct nlmsghdr *nlh, const mnlxt_rt_neigh_t *neigh) {
+	int rc = -1;
+	if (neigh && nlh) {
+		struct ndmsg *ndm = mnl_nlmsg_put_extra_header(nlh, sizeof(struct ndmsg));
+		uint16_t flag = 1;
+		size_t family_size = (AF_INET == neigh->family ? sizeof(neigh->dst.in) : sizeof(neigh->dst));
+		int i = 0;
+		for (; i < MNLXT_RT_NEIGH_MAX; ++i, flag <<= 1) {
+			if (neigh->prop_flags & flag) {
+				switch (i) {
+				case MNLXT_RT_NEIGH_FAMILY:
+					ndm->ndm_family = neigh->family;
+					break;
+				case MNLXT_RT_NEIGH_IFINDEX:
+					ndm->ndm_ifindex = neigh->if_index;
+					break;
+				case MNLXT_RT_NEIGH_STATE:
+					ndm->ndm_state = neigh->state;
+					break;
+				case MNLXT_RT_NEIGH_FLAGS:
+					ndm->ndm_flags = neigh->flags;
+					break;
+				case MNLXT_RT_NEIGH_TYPE:
+					ndm->ndm_type = neigh->type;
+					break;
+				case MNLXT_RT_NEIGH_DST:
+					mnl_attr_put(nlh, NDA_DST, family_size, &neigh->dst);
+					break;
+				case MNLXT_RT_NEIGH_LLADDR:
+					mnl_attr_put(nlh, NDA_LLADDR, sizeof(neigh->lladdr), neigh->lladdr);
+					break;
+				case MNLXT_RT_NEIGH_VLAN:
+					mnl_attr_put_u16(nlh, NDA_VLAN, neigh->vlan);
+					break;
+				}
+			}
+		}
+		rc = 0;
+	} else {
+		errno = EINVAL;
+	}
+	return rc;
+}
+
+int mnlxt_rt_neigh_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
+	int rc = MNL_CB_ERROR;
+	mnlxt_rt_neigh_t *neigh = NULL;
+	mnlxt_message_t *msg = NULL;
+
+	if (NULL == data) {
+		errno = EINVAL;
+		goto end;
+	}
+
+	if (NULL == nlh) {
+		errno = EINVAL;
+		data->error_str = "invalid arguments";
+		goto end;
+	}
+
+	if (RTM_GETNEIGH != nlh->nlmsg_type && RTM_NEWNEIGH != nlh->nlmsg_type && RTM_DELNEIGH != nlh->nlmsg_type) {
+		errno = EBADMSG;
+		data->error_str = "unsupported message type";
+		goto end;
+	}
+
+	struct ndmsg *ndm = mnl_nlmsg_get_payload(nlh);
+
+	/* IPv6, IPv4 and bridge forwarding database support only */
+	size_t family_size = 0;
+	if (AF_INET == ndm->ndm_family) {
+		family_size = sizeof(struct in_addr);
+	} else if (AF_INET6 == ndm->ndm_family) {
+		family_size = sizeof(struct in6_addr);
+	} else if (AF_BRIDGE != ndm->ndm_family) {
+		rc = MNL_CB_OK;
+		goto end;
+	}
+
+	neigh = mnlxt_data_alloc(data, sizeof(mnlxt_rt_neigh_t));
+	if (NULL == neigh) {
+		data->error_str = "mnlxt_data_alloc failed";
+		goto end;
+	}
+
+	mnlxt_rt_neigh_set_family(neigh, ndm->ndm_family);
+	mnlxt_rt_neigh_set_ifindex(neigh, ndm->ndm_ifindex);
+	mnlxt_rt_neigh_set_state(neigh, ndm->ndm_state);
+	mnlxt_rt_neigh_set_flags(neigh, ndm->ndm_flags);
+	mnlxt_rt_neigh_set_type(neigh, ndm->ndm_type);
+
+	struct nlattr *attr;
+	mnl_attr_for_each(attr, nlh, sizeof(*ndm)) {
+		int type = mnl_attr_get_type(attr);
+		/* skip unsupported attribute in user-space */
+		if (0 > mnl_attr_type_valid(attr, NDA_MAX)) {
+			continue;
+		}
+		switch (type) {
+		case NDA_DST:
+			/* remote addresses of bridge entries (VXLAN) are skipped */
+			if (0 == family_size) {
+				break;
+			}
+			if (0 > mnl_attr_validate2(attr, MNL_TYPE_BINARY, family_size)) {
+				data->error_str = "NDA_DST validation failed";
+				goto end;
+			}
+			if (-1 == mnlxt_rt_neigh_set_dst(neigh, ndm->ndm_family, mnl_attr_get_payload(attr))) {
+				data->error_str = "mnlxt_rt_neigh_set_dst failed";
+				goto end;
+			}
+			break;
+		case NDA_LLADDR:
+			/* link layer addresses of non ethernet devices are skipped */
+			if (sizeof(neigh->lladdr) != mnl_attr_get_payload_len(attr)) {
+				break;
+			}
+			if (-1 == mnlxt_rt_neigh_set_lladdr(neigh, mnl_attr_get_payload(attr))) {
+				data->error_str = "mnlxt_rt_neigh_set_lladdr failed";
+				goto end;
+			}
+			break;
+		case NDA_VLAN:
+			if (0 > mnl_attr_validate(attr, MNL_TYPE_U16)) {
+				data->error_str = "NDA_VLAN validation failed";
+				goto end;
+			}
+			if (-1 == mnlxt_rt_neigh_set_vlan(neigh, mnl_attr_get_u16(attr))) {
+				data->error_str = "mnlxt_rt_neigh_set_vlan failed";
+				goto end;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	msg = mnlxt_rt_data_message_new(data, nlh->nlmsg_type, neigh);
+	if (NULL == msg) {
+		data->error_str = "mnlxt_rt_data_message_new failed";
+		goto end;
+	}
+
+	mnlxt_data_add(data, msg);
+	neigh = NULL;
+	msg = NULL;
+	rc = MNL_CB_OK;
+end:
+	mnlxt_data_release(data, neigh, mnlxt_rt_neigh_FREE);
+	mnlxt_message_free(msg);
+
+	return rc;
+}
+
+mnlxt_rt_neigh_t *mnlxt_rt_neigh_iterate(mnlxt_data_t *data, mnlxt_message_t **iterator) {
+	mnlxt_rt_neigh_t *neigh = NULL;
+	if (iterator) {
+		while ((*iterator = mnlxt_data_iterate(data, *iterator))) {
+			if ((neigh = mnlxt_rt_neigh_get(*iterator))) {
+				break;
+			}
+		}
+	}
+	return neigh;
+}
+
+int mnlxt_rt_neigh_dump(mnlxt_data_t *data, unsigned char family) {
+	return mnlxt_rt_neigh_handle_dump(NULL, data, family);
+}
+
+int mnlxt_rt_neigh_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, unsigned char family) {
+	int rc = -1;
+	if (AF_INET != family && AF_INET6 != family && AF_BRIDGE != family && AF_UNSPEC != family) {
+		errno = EAFNOSUPPORT;
+	} else {
+		rc = mnlxt_rt_handle_data_dump(handle, data, RTM_GETNEIGH, family);
+	}
+	return rc;
+}
+
+int mnlxt_rt_neigh_request(mnlxt_rt_neigh_t *neigh, uint16_t type, uint16_t flags) {
+	return mnlxt_rt_neigh_handle_request(NULL, neigh, type, flags);
+}
+
+int mnlxt_rt_neigh_handle_request(mnlxt_handle_t *handle, mnlxt_rt_neigh_t *neigh, uint16_t type, uint16_t flags) {
+	int rc = -1;
+	mnlxt_message_t *message = mnlxt_rt_neigh_message(&neigh, type, flags);
+	if (NULL != message) {
+		rc = mnlxt_rt_handle_message_request(handle, message);
+		mnlxt_rt_neigh_remove(message);
+		mnlxt_message_free(message);
+	}
+	return rc;
+}
+
+mnlxt_message_t *mnlxt_rt_neigh_message(mnlxt_rt_neigh_t **neigh, uint16_t type, uint16_t flags) {
+	mnlxt_message_t *message = NULL;
+	if (NULL == neigh || NULL == *neigh || !(RTM_NEWNEIGH == type || RTM_DELNEIGH == type)) {
+		errno = EINVAL;
+	} else if (NULL != (message = mnlxt_rt_message_new(type, flags, *neigh))) {
+		*neigh = NULL;
+	}
+	return message;
+}
+
+#define MNLXT_RT_NEIGH_IDENTITY_FILTER                                                                          \
+	(MNLXT_FLAG(MNLXT_RT_NEIGH_FAMILY) | MNLXT_FLAG(MNLXT_RT_NEIGH_IFINDEX) | MNLXT_FLAG(MNLXT_RT_NEIGH_DST))
+/** bridge forwarding entries are identified by the link layer address instead of a destination */
+#define MNLXT_RT_NEIGH_BRIDGE_IDENTITY_FILTER                                                                    \
+	(MNLXT_FLAG(MNLXT_RT_NEIGH_FAMILY) | MNLXT_FLAG(MNLXT_RT_NEIGH_IFINDEX) | MNLXT_FLAG(MNLXT_RT_NEIGH_LLADDR) \
+	 | MNLXT_FLAG(MNLXT_RT_NEIGH_VLAN))
+
+uint32_t mnlxt_rt_neigh_identity_hash(const void *object) {
+	const mnlxt_rt_neigh_t *neigh = object;
+	struct {
+		uint32_t if_index;
+		uint8_t family;
+		uint8_t padding;
+		uint16_t vlan;
+		mnlxt_inet_addr_t dst;
+		mnlxt_eth_addr_t lladdr;
+	} key;
+	memset(&key, 0, sizeof(key));
+	if (MNLXT_GET_PROP_FLAG(neigh, MNLXT_RT_NEIGH_IFINDEX)) {
+		key.if_index = neigh->if_index;
+	}
+	if (MNLXT_GET_PROP_FLAG(neigh, MNLXT_RT_NEIGH_FAMILY)) {
+		key.family = neigh->family;
+	}
+	if (AF_BRIDGE == key.family) {
+		if (MNLXT_GET_PROP_FLAG(neigh, MNLXT_RT_NEIGH_LLADDR)) {
+			memcpy(key.lladdr, neigh->lladdr, sizeof(key.lladdr));
+		}
+		if (MNLXT_GET_PROP_FLAG(neigh, MNLXT_RT_NEIGH_VLAN)) {
+			key.vlan = neigh->vlan;
+		}
+	} else if (MNLXT_GET_PROP_FLAG(neigh, MNLXT_RT_NEIGH_DST)) {
+		key.dst = neigh->dst;
+	}
+	return mnlxt_hash_fnv(&key, sizeof(key));
+}
+
+int mnlxt_rt_neigh_identity_cmp(const void *object1, const void *object2) {
+	const mnlxt_rt_neigh_t *neigh = object1;
+	uint64_t filter = MNLXT_RT_NEIGH_IDENTITY_FILTER;
+	if (MNLXT_GET_PROP_FLAG(neigh, MNLXT_RT_NEIGH_FAMILY) && AF_BRIDGE == neigh->family) {
+		filter = MNLXT_RT_NEIGH_BRIDGE_IDENTITY_FILTER;
+	}
+	return mnlxt_rt_neigh_compare(object1, object2, filter);
+}
+
+static int mnlxt_rt_neigh_reconcile_match(const void *current, const void *desired) {
+	return mnlxt_rt_neigh_match(current, desired);
+}
+
+static void *mnlxt_rt_neigh_reconcile_get(const mnlxt_message_t *message) {
+	return mnlxt_rt_neigh_get(message);
+}
+
+static void *mnlxt_rt_neigh_reconcile_clone(const void *object) {
+	const mnlxt_rt_neigh_t *neigh = object;
+	return mnlxt_rt_neigh_clone(neigh, neigh->prop_flags);
+}
+
+static mnlxt_message_t *mnlxt_rt_neigh_reconcile_message(void *object, uint16_t type, uint16_t flags) {
+	mnlxt_rt_neigh_t *neigh = object;
+	return mnlxt_rt_neigh_message(&neigh, type, flags);
+}
+
+static const mnlxt_reconcile_ops_t neigh_reconcile_ops = {
+	.hash = mnlxt_rt_neigh_identity_hash,
+	.identity = mnlxt_rt_neigh_identity_cmp,
+	.match = mnlxt_rt_neigh_reconcile_match,
+	.get = mnlxt_rt_neigh_reconcile_get,
+	.clone = mnlxt_rt_neigh_reconcile_clone,
+	.free = mnlxt_rt_neigh_FREE,
+	.message = mnlxt_rt_neigh_reconcile_message,
+	.new_type = RTM_NEWNEIGH,
+	.new_flags = NLM_F_CREATE | NLM_F_EXCL,
+	.replace_type = RTM_NEWNEIGH,
+	.replace_flags = NLM_F_CREATE | NLM_F_REPLACE,
+	.del_type = RTM_DELNEIGH,
+};
+
+int mnlxt_rt_neigh_reconcile(mnlxt_data_t *desired, mnlxt_data_t *current, mnlxt_data_t *changes) {
+	return mnlxt_data_reconcile(&neigh_reconcile_ops, desired, current, changes);
+}
@@ -0,0 +1,267 @@
+/*
+ * nexthop.c		Libmnlxt Routing Nexthops
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libmnlxt/rt_nexthop.h"
+#include "private/internal.h"
+
+#define nexthop_ad_init(member) ad_init(mnlxt_rt_nexthop_t, member)
+
+static struct access_data nexthop_data[MNLXT_RT_NEXTHOP_MAX] = {
+	[MNLXT_RT_NEXTHOP_FAMILY] = nexthop_ad_init(family),
+	[MNLXT_RT_NEXTHOP_PROTOCOL] = nexthop_ad_init(protocol),
+	[MNLXT_RT_NEXTHOP_FLAGS] = nexthop_ad_init(flags),
+	[MNLXT_RT_NEXTHOP_ID] = nexthop_ad_init(id),
+	[MNLXT_RT_NEXTHOP_OIFINDEX] = nexthop_ad_init(oif_index),
+	[MNLXT_RT_NEXTHOP_GATEWAY] = {},	 // special case
+	[MNLXT_RT_NEXTHOP_BLACKHOLE] = {}, // special case
+	[MNLXT_RT_NEXTHOP_GROUP] = {},		 // special case
+	[MNLXT_RT_NEXTHOP_GROUP_TYPE] = nexthop_ad_init(group_type),
+};
+
+mnlxt_rt_nexthop_t *mnlxt_rt_nexthop_new() {
+	return calloc(1, sizeof(mnlxt_rt_nexthop_t));
+}
+
+mnlxt_rt_nexthop_t *mnlxt_rt_nexthop_clone(const mnlxt_rt_nexthop_t *src, uint64_t filter) {
+	mnlxt_rt_nexthop_t *dst = NULL;
+	if (NULL == src) {
+		errno = EINVAL;
+	} else if (NULL != (dst = mnlxt_rt_nexthop_new()) && filter) {
+		*dst = *src;
+		dst->prop_flags = src->prop_flags & filter;
+		dst->group = NULL;
+		dst->group_size = 0;
+		if (MNLXT_GET_PROP_FLAG(dst, MNLXT_RT_NEXTHOP_GROUP)) {
+			MNLXT_UNSET_PROP_FLAG(dst, MNLXT_RT_NEXTHOP_GROUP);
+			if (0 != mnlxt_rt_nexthop_set_group(dst, src->group, src->group_size)) {
+				mnlxt_rt_nexthop_free(dst);
+				dst = NULL;
+			}
+		}
+	}
+	return dst;
+}
+
+void mnlxt_rt_nexthop_free(mnlxt_rt_nexthop_t *nexthop) {
+	if (NULL != nexthop) {
+		if (NULL != nexthop->group) {
+			free(nexthop->group);
+		}
+		free(nexthop);
+	}
+}
+
+static int mnlxt_rt_nexthop_set_ptr(mnlxt_rt_nexthop_t *nexthop, mnlxt_rt_nexthop_data_t data, void *ptr,
+																		uint8_t size) {
+	int rc = -1;
+	if (NULL == nexthop || MNLXT_RT_NEXTHOP_MAX <= (unsigned)data || nexthop_data[data].size != size
+			|| 0 == nexthop_data[data].size) {
+		errno = EINVAL;
+	} else {
+		MNLXT_SET_PROP_FLAG(nexthop, data);
+		memcpy(((char *)nexthop + nexthop_data[data].offset), ptr, size);
+		rc = 0;
+	}
+	return rc;
+}
+
+static inline int mnlxt_rt_nexthop_set_u32(mnlxt_rt_nexthop_t *nexthop, mnlxt_rt_nexthop_data_t data, uint32_t u32) {
+	return mnlxt_rt_nexthop_set_ptr(nexthop, data, &u32, sizeof(uint32_t));
+}
+
+static inline int mnlxt_rt_nexthop_set_u16(mnlxt_rt_nexthop_t *nexthop, mnlxt_rt_nexthop_data_t data, uint16_t u16) {
+	return mnlxt_rt_nexthop_set_ptr(nexthop, data, &u16, sizeof(uint16_t));
+}
+
+static inline int mnlxt_rt_nexthop_set_u8(mnlxt_rt_nexthop_t *nexthop, mnlxt_rt_nexthop_data_t data, uint8_t u8) {
+	return mnlxt_rt_nexthop_set_ptr(nexthop, data, &u8, sizeof(uint8_t));
+}
+
+static int mnlxt_rt_nexthop_get_ptr(const mnlxt_rt_nexthop_t *nexthop, mnlxt_rt_nexthop_data_t data, void *ptr,
+																		uint8_t size) {
+	int rc = -1;
+	if (NULL == nexthop || MNLXT_RT_NEXTHOP_MAX <= (unsigned)data || nexthop_data[data].size != size
+			|| 0 == nexthop_data[data].size) {
+		errno = EINVAL;
+	} else if (!MNLXT_GET_PROP_FLAG(nexthop, data)) {
+		rc = 1;
+	} else {
+		memcpy(ptr, ((char *)nexthop + nexthop_data[data].offset), size);
+		rc = 0;
+	}
+	return rc;
+}
+
+static inline int mnlxt_rt_nexthop_get_u32(const mnlxt_rt_nexthop_t *nexthop, mnlxt_rt_nexthop_data_t data,
+																					 uint32_t *pu32) {
+	return mnlxt_rt_nexthop_get_ptr(nexthop, data, pu32, sizeof(uint32_t));
+}
+
+static inline int mnlxt_rt_nexthop_get_u16(const mnlxt_rt_nexthop_t *nexthop, mnlxt_rt_nexthop_data_t data,
+																					 uint16_t *pu16) {
+	return mnlxt_rt_nexthop_get_ptr(nexthop, data, pu16, sizeof(uint16_t));
+}
+
+static inline int mnlxt_rt_nexthop_get_u8(const mnlxt_rt_nexthop_t *nexthop, mnlxt_rt_nexthop_data_t data,
+																					uint8_t *pu8) {
+	return mnlxt_rt_nexthop_get_ptr(nexthop, data, pu8, sizeof(uint8_t));
+}
+
+int mnlxt_rt_nexthop_set_family(mnlxt_rt_nexthop_t *nexthop, uint8_t family) {
+	int rc = -1;
+	if (NULL == nexthop) {
+		errno = EINVAL;
+	} else if (AF_INET != family && AF_INET6 != family && AF_UNSPEC != family) {
+		errno = EAFNOSUPPORT;
+	} else if (MNLXT_GET_PROP_FLAG(nexthop, MNLXT_RT_NEXTHOP_FAMILY)) {
+		if (family == nexthop->family) {
+			rc = 0;
+		} else {
+			errno = EINVAL;
+		}
+	} else {
+		nexthop->family = family;
+		MNLXT_SET_PROP_FLAG(nexthop, MNLXT_RT_NEXTHOP_FAMILY);
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_rt_nexthop_get_family(const mnlxt_rt_nexthop_t *nexthop, uint8_t *family) {
+	return mnlxt_rt_nexthop_get_u8(nexthop, MNLXT_RT_NEXTHOP_FAMILY, family);
+}
+
+int mnlxt_rt_nexthop_set_protocol(mnlxt_rt_nexthop_t *nexthop, uint8_t protocol) {
+	return mnlxt_rt_nexthop_set_u8(nexthop, MNLXT_RT_NEXTHOP_PROTOCOL, protocol);
+}
+
+int mnlxt_rt_nexthop_get_protocol(const mnlxt_rt_nexthop_t *nexthop, uint8_t *protocol) {
+	return mnlxt_rt_nexthop_get_u8(nexthop, MNLXT_RT_NEXTHOP_PROTOCOL, protocol);
+}
+
+int mnlxt_rt_nexthop_set_flags(mnlxt_rt_nexthop_t *nexthop, uint32_t flags) {
+	return mnlxt_rt_nexthop_set_u32(nexthop, MNLXT_RT_NEXTHOP_FLAGS, flags);
+}
+
+int mnlxt_rt_nexthop_get_flags(const mnlxt_rt_nexthop_t *nexthop, uint32_t *flags) {
+	return mnlxt_rt_nexthop_get_u32(nexthop, MNLXT_RT_NEXTHOP_FLAGS, flags);
+}
+
+int mnlxt_rt_nexthop_set_id(mnlxt_rt_nexthop_t *nexthop, uint32_t id) {
+	return mnlxt_rt_nexthop_set_u32(nexthop, MNLXT_RT_NEXTHOP_ID, id);
+}
+
+int mnlxt_rt_nexthop_get_id(const mnlxt_rt_nexthop_t *nexthop, uint32_t *id) {
+	return mnlxt_rt_nexthop_get_u32(nexthop, MNLXT_RT_NEXTHOP_ID, id);
+}
+
+int mnlxt_rt_nexthop_set_oifindex(mnlxt_rt_nexthop_t *nexthop, uint32_t if_index) {
+	return mnlxt_rt_nexthop_set_u32(nexthop, MNLXT_RT_NEXTHOP_OIFINDEX, if_index);
+}
+
+int mnlxt_rt_nexthop_get_oifindex(const mnlxt_rt_nexthop_t *nexthop, uint32_t *if_index) {
+	return mnlxt_rt_nexthop_get_u32(nexthop, MNLXT_RT_NEXTHOP_OIFINDEX, if_index);
+}
+
+int mnlxt_rt_nexthop_set_gateway(mnlxt_rt_nexthop_t *nexthop, uint8_t family, const mnlxt_inet_addr_t *buf) {
+	int rc = -1;
+	if (NULL == nexthop || NULL == buf || AF_UNSPEC == family) {
+		errno = EINVAL;
+	} else {
+		rc = mnlxt_rt_nexthop_set_family(nexthop, family);
+		if (0 == rc) {
+			nexthop->gateway = *buf;
+			MNLXT_SET_PROP_FLAG(nexthop, MNLXT_RT_NEXTHOP_GATEWAY);
+		}
+	}
+	return rc;
+}
+
+int mnlxt_rt_nexthop_get_gateway(const mnlxt_rt_nexthop_t *nexthop, uint8_t *family, const mnlxt_inet_addr_t **buf) {
+	int rc = -1;
+	if (NULL == nexthop || NULL == buf) {
+		errno = EINVAL;
+	} else if (!MNLXT_GET_PROP_FLAG(nexthop, MNLXT_RT_NEXTHOP_GATEWAY)) {
+		rc = 1;
+	} else {
+		*buf = &nexthop->gateway;
+		if (NULL != family) {
+			*family = nexthop->family;
+		}
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_rt_nexthop_set_blackhole(mnlxt_rt_nexthop_t *nexthop) {
+	int rc = -1;
+	if (NULL == nexthop) {
+		errno = EINVAL;
+	} else {
+		MNLXT_SET_PROP_FLAG(nexthop, MNLXT_RT_NEXTHOP_BLACKHOLE);
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_rt_nexthop_get_blackhole(const mnlxt_rt_nexthop_t *nexthop) {
+	int rc = -1;
+	if (NULL == nexthop) {
+		errno = EINVAL;
+	} else {
+		rc = (MNLXT_GET_PROP_FLAG(nexthop, MNLXT_RT_NEXTHOP_BLACKHOLE) ? 0 : 1);
+	}
+	return rc;
+}
+
+int mnlxt_rt_nexthop_set_group(mnlxt_rt_nexthop_t *nexthop, const mnlxt_rt_nexthop_grp_t *group, uint16_t size) {
+	int rc = -1;
+	mnlxt_rt_nexthop_grp_t *copy;
+	if (NULL == nexthop || NULL == group || 0 == size) {
+		errno = EINVAL;
+	} else if (NULL != (copy = malloc(size * sizeof(*copy)))) {
+		memcpy(copy, group, size * sizeof(*copy));
+		if (NULL != nexthop->group) {
+			free(nexthop->group);
+		}
+		nexthop->group = copy;
+		nexthop->group_size = size;
+		MNLXT_SET_PROP_FLAG(nexthop, MNLXT_RT_NEXTHOP_GROUP);
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_rt_nexthop_get_group(const mnlxt_rt_nexthop_t *nexthop, const mnlxt_rt_nexthop_grp_t **group,
+															 uint16_t *size) {
+	int rc = -1;
+	if (NULL == nexthop || NULL == group || NULL == size) {
+		errno = EINVAL;
+	} else if (!MNLXT_GET_PROP_FLAG(nexthop, MNLXT_RT_NEXTHOP_GROUP)) {
+		rc = 1;
+	} else {
+		*group = nexthop->group;
+		*size = nexthop->group_size;
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_rt_nexthop_set_group_type(mnlxt_rt_nexthop_t *nexthop, uint16_t group_type) {
+	return mnlxt_rt_nexthop_set_u16(nexthop, MNLXT_RT_NEXTHOP_GROUP_TYPE, group_type);
+}
+
+int mnlxt_rt_nexthop_get_group_type(const mnlxt_rt_nexthop_t *nexthop, uint16_t *group_type) {
+	return mnlxt_rt_nexthop_get_u16(nexthop, MNLXT_RT_NEXTHOP_GROUP_TYPE, group_type);
+}
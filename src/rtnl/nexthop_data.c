@@ -0,0 +1,403 @@
+/*
+ * nexthop_data.c		Libmnlxt Routing Nexthops
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "libmnlxt/rt.h"
+#include "private/data.h"
+#include "private/internal.h"
+
+static int mnlxt_rt_nexthop_cmp(const mnlxt_rt_nexthop_t *nexthop1, const mnlxt_rt_nexthop_t *nexthop2,
+																mnlxt_rt_nexthop_data_t data) {
+	int rc = data + 1;
+	size_t family_size;
+	uint16_t i;
+	switch (data) {
+	case MNLXT_RT_NEXTHOP_FAMILY:
+		if (nexthop1->family != nexthop2->family) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_NEXTHOP_PROTOCOL:
+		if (nexthop1->protocol != nexthop2->protocol) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_NEXTHOP_FLAGS:
+		if (nexthop1->flags != nexthop2->flags) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_NEXTHOP_ID:
+		if (nexthop1->id != nexthop2->id) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_NEXTHOP_OIFINDEX:
+		if (nexthop1->oif_index != nexthop2->oif_index) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_NEXTHOP_GATEWAY:
+		family_size = (AF_INET == nexthop1->family ? sizeof(nexthop1->gateway.in) : sizeof(nexthop1->gateway));
+		if (0 != memcmp(&nexthop1->gateway, &nexthop2->gateway, family_size)) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_NEXTHOP_BLACKHOLE:
+		/* a flag only, equal if set on both */
+		break;
+	case MNLXT_RT_NEXTHOP_GROUP:
+		if (nexthop1->group_size != nexthop2->group_size) {
+			goto failed;
+		}
+		/* the kernel keeps the members in the order of the request */
+		for (i = 0; i < nexthop1->group_size; ++i) {
+			if (nexthop1->group[i].id != nexthop2->group[i].id
+					|| nexthop1->group[i].weight != nexthop2->group[i].weight) {
+				goto failed;
+			}
+		}
+		break;
+	case MNLXT_RT_NEXTHOP_GROUP_TYPE:
+		if (nexthop1->group_type != nexthop2->group_type) {
+			goto failed;
+		}
+		break;
+	}
+	rc = 0;
+failed:
+	return rc;
+}
+
+int mnlxt_rt_nexthop_match(const mnlxt_rt_nexthop_t *nexthop, const mnlxt_rt_nexthop_t *match) {
+	int rc = -1;
+	if (NULL == match) {
+		errno = EINVAL;
+	} else {
+		rc = mnlxt_rt_nexthop_compare(nexthop, match, match->prop_flags);
+	}
+	return rc;
+}
+
+int mnlxt_rt_nexthop_compare(const mnlxt_rt_nexthop_t *nexthop1, const mnlxt_rt_nexthop_t *nexthop2, uint64_t filter) {
+	int rc = -1, i;
+	if (NULL == nexthop1 || NULL == nexthop2) {
+		errno = EINVAL;
+	} else {
+		uint64_t flag = 1;
+		for (i = 0; i < MNLXT_RT_NEXTHOP_MAX; ++i, flag <<= 1) {
+			if (0 == (flag & filter)) {
+				continue;
+			}
+			if (0 == (nexthop1->prop_flags & flag)) {
+				if (0 == (nexthop2->prop_flags & flag)) {
+					/* both not set */
+					continue;
+				}
+				goto failed;
+			} else if (0 == (nexthop2->prop_flags & flag)) {
+				goto failed;
+			} else if (0 != mnlxt_rt_nexthop_cmp(nexthop1, nexthop2, i)) {
+				goto failed;
+			}
+		}
+		return 0;
+	failed:
+		rc = ++i;
+	}
+	return rc;
+}
+
+mnlxt_rt_nexthop_t *mnlxt_rt_nexthop_get(const mnlxt_message_t *message) {
+	mnlxt_rt_nexthop_t *nexthop = NULL;
+	if (message && message->payload
+			&& (RTM_NEWNEXTHOP == message->nlmsg_type || RTM_GETNEXTHOP == message->nlmsg_type
+					|| RTM_DELNEXTHOP == message->nlmsg_type)) {
+		nexthop = (mnlxt_rt_nexthop_t *)message->payload;
+	}
+	return nexthop;
+}
+
+mnlxt_rt_nexthop_t *mnlxt_rt_nexthop_remove(mnlxt_message_t *message) {
+	mnlxt_rt_nexthop_t *nexthop = mnlxt_rt_nexthop_get(message);
+	if (NULL != nexthop) {
+		message->payload = NULL;
+	}
+	return nexthop;
+}
+
+static int mnlxt_rt_nexthop_put_group(struct nlmsghdr *nlh, const mnlxt_rt_nexthop_t *nexthop) {
+	struct nlattr *attr = mnl_nlmsg_get_payload_tail(nlh);
+	struct nexthop_grp *grp;
+	uint16_t i;
+	if (MNL_SOCKET_BUFFER_SIZE < nlh->nlmsg_len + MNL_ATTR_HDRLEN + nexthop->group_size * sizeof(*grp)) {
+		/* the message is created in a buffer of this size */
+		errno = EMSGSIZE;
+		return -1;
+	}
+	attr->nla_type = NHA_GROUP;
+	attr->nla_len = MNL_ATTR_HDRLEN + nexthop->group_size * sizeof(*grp);
+	grp = mnl_attr_get_payload(attr);
+	memset(grp, 0, nexthop->group_size * sizeof(*grp));
+	for (i = 0; i < nexthop->group_size; ++i) {
+		grp[i].id = nexthop->group[i].id;
+		/* the kernel stores the weight decremented by one */
+		grp[i].weight = (nexthop->group[i].weight ? nexthop->group[i].weight - 1 : 0);
+	}
+	nlh->nlmsg_len += MNL_ALIGN(attr->nla_len);
+	return 0;
+}
+
+int mnlxt_rt_nexthop_put(struct nlmsghdr *nlh, const mnlxt_rt_nexthop_t *nexthop) {
+	int rc = -1;
+	if (nexthop && nlh) {
+		struct nhmsg *nhm = mnl_nlmsg_put_extra_header(nlh, sizeof(struct nhmsg));
+		uint16_t flag = 1;
+		size_t family_size = (AF_INET == nexthop->family ? sizeof(nexthop->gateway.in) : sizeof(nexthop->gateway));
+		int i = 0;
+		for (; i < MNLXT_RT_NEXTHOP_MAX; ++i, flag <<= 1) {
+			if (nexthop->prop_flags & flag) {
+				switch (i) {
+				case MNLXT_RT_NEXTHOP_FAMILY:
+					nhm->nh_family = nexthop->family;
+					break;
+				case MNLXT_RT_NEXTHOP_PROTOCOL:
+					nhm->nh_protocol = nexthop->protocol;
+					break;
+				case MNLXT_RT_NEXTHOP_FLAGS:
+					nhm->nh_flags = nexthop->flags;
+					break;
+				case MNLXT_RT_NEXTHOP_ID:
+					mnl_attr_put_u32(nlh, NHA_ID, nexthop->id);
+					break;
+				case MNLXT_RT_NEXTHOP_OIFINDEX:
+					mnl_attr_put_u32(nlh, NHA_OIF, nexthop->oif_index);
+					break;
+				case MNLXT_RT_NEXTHOP_GATEWAY:
+					mnl_attr_put(nlh, NHA_GATEWAY, family_size, &nexthop->gateway);
+					break;
+				case MNLXT_RT_NEXTHOP_BLACKHOLE:
+					mnl_attr_put(nlh, NHA_BLACKHOLE, 0, NULL);
+					break;
+				case MNLXT_RT_NEXTHOP_GROUP:
+					if (0 != mnlxt_rt_nexthop_put_group(nlh, nexthop)) {
+						return rc;
+					}
+					break;
+				case MNLXT_RT_NEXTHOP_GROUP_TYPE:
+					mnl_attr_put_u16(nlh, NHA_GROUP_TYPE, nexthop->group_type);
+					break;
+				}
+			}
+		}
+		rc = 0;
+	} else {
+		errno = EINVAL;
+	}
+	return rc;
+}
+
+static int mnlxt_rt_nexthop_data_group(mnlxt_rt_nexthop_t *nexthop, const struct nlattr *attr, mnlxt_data_t *data) {
+	int rc = -1;
+	const struct nexthop_grp *grp = mnl_attr_get_payload(attr);
+	uint16_t size = mnl_attr_get_payload_len(attr) / sizeof(*grp), i;
+	if (0 == size || 0 != mnl_attr_get_payload_len(attr) % sizeof(*grp)) {
+		data->error_str = "NHA_GROUP validation failed";
+	} else if (NULL == (nexthop->group = mnlxt_data_alloc(data, size * sizeof(*nexthop->group)))) {
+		data->error_str = "mnlxt_data_alloc failed";
+	} else {
+		for (i = 0; i < size; ++i) {
+			nexthop->group[i].id = grp[i].id;
+			nexthop->group[i].weight = grp[i].weight + 1;
+		}
+		nexthop->group_size = size;
+		MNLXT_SET_PROP_FLAG(nexthop, MNLXT_RT_NEXTHOP_GROUP);
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_rt_nexthop_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
+	int rc = MNL_CB_ERROR;
+	mnlxt_rt_nexthop_t *nexthop = NULL;
+	mnlxt_message_t *msg = NULL;
+
+	if (NULL == data) {
+		errno = EINVAL;
+		goto end;
+	}
+
+	if (NULL == nlh) {
+		errno = EINVAL;
+		data->error_str = "invalid arguments";
+		goto end;
+	}
+
+	if (RTM_GETNEXTHOP != nlh->nlmsg_type && RTM_NEWNEXTHOP != nlh->nlmsg_type
+			&& RTM_DELNEXTHOP != nlh->nlmsg_type) {
+		errno = EBADMSG;
+		data->error_str = "unsupported message type";
+		goto end;
+	}
+
+	struct nhmsg *nhm = mnl_nlmsg_get_payload(nlh);
+
+	/* IPv6 and IPv4 support only, groups and blackholes have no family */
+	size_t family_size = 0;
+	if (AF_INET == nhm->nh_family) {
+		family_size = sizeof(struct in_addr);
+	} else if (AF_INET6 == nhm->nh_family) {
+		family_size = sizeof(struct in6_addr);
+	} else if (AF_UNSPEC != nhm->nh_family) {
+		rc = MNL_CB_OK;
+		goto end;
+	}
+
+	nexthop = mnlxt_data_alloc(data, sizeof(mnlxt_rt_nexthop_t));
+	if (NULL == nexthop) {
+		data->error_str = "mnlxt_data_alloc failed";
+		goto end;
+	}
+
+	mnlxt_rt_nexthop_set_family(nexthop, nhm->nh_family);
+	mnlxt_rt_nexthop_set_protocol(nexthop, nhm->nh_protocol);
+	mnlxt_rt_nexthop_set_flags(nexthop, nhm->nh_flags);
+
+	struct nlattr *attr;
+	mnl_attr_for_each(attr, nlh, sizeof(*nhm)) {
+		int type = mnl_attr_get_type(attr);
+		/* skip unsupported attribute in user-space */
+		if (0 > mnl_attr_type_valid(attr, NHA_MAX)) {
+			continue;
+		}
+		switch (type) {
+		case NHA_ID:
+			if (0 > mnl_attr_validate(attr, MNL_TYPE_U32)) {
+				data->error_str = "NHA_ID validation failed";
+				goto end;
+			}
+			if (-1 == mnlxt_rt_nexthop_set_id(nexthop, mnl_attr_get_u32(attr))) {
+				data->error_str = "mnlxt_rt_nexthop_set_id failed";
+				goto end;
+			}
+			break;
+		case NHA_OIF:
+			if (0 > mnl_attr_validate(attr, MNL_TYPE_U32)) {
+				data->error_str = "NHA_OIF validation failed";
+				goto end;
+			}
+			if (-1 == mnlxt_rt_nexthop_set_oifindex(nexthop, mnl_attr_get_u32(attr))) {
+				data->error_str = "mnlxt_rt_nexthop_set_oifindex failed";
+				goto end;
+			}
+			break;
+		case NHA_GATEWAY:
+			if (0 == family_size || 0 > mnl_attr_validate2(attr, MNL_TYPE_BINARY, family_size)) {
+				data->error_str = "NHA_GATEWAY validation failed";
+				goto end;
+			}
+			if (-1 == mnlxt_rt_nexthop_set_gateway(nexthop, nhm->nh_family, mnl_attr_get_payload(attr))) {
+				data->error_str = "mnlxt_rt_nexthop_set_gateway failed";
+				goto end;
+			}
+			break;
+		case NHA_BLACKHOLE:
+			mnlxt_rt_nexthop_set_blackhole(nexthop);
+			break;
+		case NHA_GROUP:
+			if (NULL == nexthop->group && -1 == mnlxt_rt_nexthop_data_group(nexthop, attr, data)) {
+				goto end;
+			}
+			break;
+		case NHA_GROUP_TYPE:
+			if (0 > mnl_attr_validate(attr, MNL_TYPE_U16)) {
+				data->error_str = "NHA_GROUP_TYPE validation failed";
+				goto end;
+			}
+			if (-1 == mnlxt_rt_nexthop_set_group_type(nexthop, mnl_attr_get_u16(attr))) {
+				data->error_str = "mnlxt_rt_nexthop_set_group_type failed";
+				goto end;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	msg = mnlxt_rt_data_message_new(data, nlh->nlmsg_type, nexthop);
+	if (NULL == msg) {
+		data->error_str = "mnlxt_rt_data_message_new failed";
+		goto end;
+	}
+
+	mnlxt_data_add(data, msg);
+	nexthop = NULL;
+	msg = NULL;
+	rc = MNL_CB_OK;
+end:
+	mnlxt_data_release(data, nexthop, mnlxt_rt_nexthop_FREE);
+	mnlxt_message_free(msg);
+
+	return rc;
+}
+
+mnlxt_rt_nexthop_t *mnlxt_rt_nexthop_iterate(mnlxt_data_t *data, mnlxt_message_t **iterator) {
+	mnlxt_rt_nexthop_t *nexthop = NULL;
+	if (iterator) {
+		while ((*iterator = mnlxt_data_iterate(data, *iterator))) {
+			if ((nexthop = mnlxt_rt_nexthop_get(*iterator))) {
+				break;
+			}
+		}
+	}
+	return nexthop;
+}
+
+int mnlxt_rt_nexthop_dump(mnlxt_data_t *data, unsigned char family) {
+	return mnlxt_rt_nexthop_handle_dump(NULL, data, family);
+}
+
+int mnlxt_rt_nexthop_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, unsigned char family) {
+	int rc = -1;
+	if (AF_INET != family && AF_INET6 != family && AF_UNSPEC != family) {
+		errno = EAFNOSUPPORT;
+	} else {
+		rc = mnlxt_rt_handle_data_dump(handle, data, RTM_GETNEXTHOP, family);
+	}
+	return rc;
+}
+
+int mnlxt_rt_nexthop_request(mnlxt_rt_nexthop_t *nexthop, uint16_t type, uint16_t flags) {
+	return mnlxt_rt_nexthop_handle_request(NULL, nexthop, type, flags);
+}
+
+int mnlxt_rt_nexthop_handle_request(mnlxt_handle_t *handle, mnlxt_rt_nexthop_t *nexthop, uint16_t type,
+																		uint16_t flags) {
+	int rc = -1;
+	mnlxt_message_t *message = mnlxt_rt_nexthop_message(&nexthop, type, flags);
+	if (NULL != message) {
+		rc = mnlxt_rt_handle_message_request(handle, message);
+		mnlxt_rt_nexthop_remove(message);
+		mnlxt_message_free(message);
+	}
+	return rc;
+}
+
+mnlxt_message_t *mnlxt_rt_nexthop_message(mnlxt_rt_nexthop_t **nexthop, uint16_t type, uint16_t flags) {
+	mnlxt_message_t *message = NULL;
+	if (NULL == nexthop || NULL == *nexthop || !(RTM_NEWNEXTHOP == type || RTM_DELNEXTHOP == type)) {
+		errno = EINVAL;
+	} else if (NULL != (message = mnlxt_rt_message_new(type, flags, *nexthop))) {
+		*nexthop = NULL;
+	}
+	return message;
+}
@@ -31,6 +31,8 @@ static struct access_data route_data[MNLXT_RT_ROUTE_MAX] = {
 	[MNLXT_RT_ROUTE_SRC] = {},		 // special case
 	[MNLXT_RT_ROUTE_DST] = {},		 // special case
 	[MNLXT_RT_ROUTE_GATEWAY] = {}, // special case
+	[MNLXT_RT_ROUTE_NH_ID] = route_ad_init(nh_id),
+	[MNLXT_RT_ROUTE_MULTIPATH] = {}, // special case
 };
 
 mnlxt_rt_route_t *mnlxt_rt_route_new() {
@@ -44,12 +46,24 @@ mnlxt_rt_route_t *mnlxt_rt_route_clone(const mnlxt_rt_route_t *src, uint64_t fil
 	} else if (NULL != (dst = mnlxt_rt_route_new()) && filter) {
 		*dst = *src;
 		dst->prop_flags = src->prop_flags & filter;
+		dst->multipath = NULL;
+		dst->multipath_size = 0;
+		if (MNLXT_GET_PROP_FLAG(dst, MNLXT_RT_ROUTE_MULTIPATH)) {
+			MNLXT_UNSET_PROP_FLAG(dst, MNLXT_RT_ROUTE_MULTIPATH);
+			if (0 != mnlxt_rt_route_set_multipath(dst, src->family, src->multipath, src->multipath_size)) {
+				mnlxt_rt_route_free(dst);
+				dst = NULL;
+			}
+		}
 	}
 	return dst;
 }
 
 void mnlxt_rt_route_free(mnlxt_rt_route_t *route) {
 	if (NULL != route) {
+		if (NULL != route->multipath) {
+			free(route->multipath);
+		}
 		free(route);
 	}
 }
@@ -129,12 +143,12 @@ int mnlxt_rt_route_get_protocol(const mnlxt_rt_route_t *route, uint8_t *protocol
 	return mnlxt_rt_route_get_u8(route, MNLXT_RT_ROUTE_PROTOCOL, protocol);
 }
 
-int mnlxt_rt_route_set_table(mnlxt_rt_route_t *route, uint8_t table) {
-	return mnlxt_rt_route_set_u8(route, MNLXT_RT_ROUTE_TABLE, table);
+int mnlxt_rt_route_set_table(mnlxt_rt_route_t *route, uint32_t table) {
+	return mnlxt_rt_route_set_u32(route, MNLXT_RT_ROUTE_TABLE, table);
 }
 
-int mnlxt_rt_route_get_table(const mnlxt_rt_route_t *route, uint8_t *table) {
-	return mnlxt_rt_route_get_u8(route, MNLXT_RT_ROUTE_TABLE, table);
+int mnlxt_rt_route_get_table(const mnlxt_rt_route_t *route, uint32_t *table) {
+	return mnlxt_rt_route_get_u32(route, MNLXT_RT_ROUTE_TABLE, table);
 }
 
 int mnlxt_rt_route_set_scope(mnlxt_rt_route_t *route, uint8_t scope) {
@@ -242,6 +256,7 @@ int mnlxt_rt_route_set_gateway(mnlxt_rt_route_t *route, uint8_t family, const mn
 		if (0 == rc) {
 			route->gateway = *buf;
 			MNLXT_SET_PROP_FLAG(route, MNLXT_RT_ROUTE_GATEWAY);
+			MNLXT_UNSET_PROP_FLAG(route, MNLXT_RT_ROUTE_NH_ID);
 		}
 	}
 	return rc;
@@ -263,6 +278,82 @@ int mnlxt_rt_route_get_gateway(const mnlxt_rt_route_t *route, uint8_t *family, c
 	return rc;
 }
 
+int mnlxt_rt_route_set_nh_id(mnlxt_rt_route_t *route, uint32_t nh_id) {
+	int rc = mnlxt_rt_route_set_u32(route, MNLXT_RT_ROUTE_NH_ID, nh_id);
+	if (0 == rc) {
+		/* the kernel rejects a nexthop id together with a nexthop specification */
+		MNLXT_UNSET_PROP_FLAG(route, MNLXT_RT_ROUTE_GATEWAY);
+		MNLXT_UNSET_PROP_FLAG(route, MNLXT_RT_ROUTE_OIFINDEX);
+		MNLXT_UNSET_PROP_FLAG(route, MNLXT_RT_ROUTE_MULTIPATH);
+		route->multipath_size = 0;
+	}
+	return rc;
+}
+
+int mnlxt_rt_route_get_nh_id(const mnlxt_rt_route_t *route, uint32_t *nh_id) {
+	return mnlxt_rt_route_get_u32(route, MNLXT_RT_ROUTE_NH_ID, nh_id);
+}
+
+int mnlxt_rt_route_set_multipath(mnlxt_rt_route_t *route, uint8_t family, const mnlxt_rt_route_path_t *paths,
+																 uint16_t size) {
+	int rc = -1;
+	mnlxt_rt_route_path_t *copy;
+	if (NULL == route || NULL == paths || 0 == size) {
+		errno = EINVAL;
+	} else if (0 == (rc = mnlxt_rt_route_set_family(route, family))) {
+		if (NULL == (copy = malloc(size * sizeof(*copy)))) {
+			rc = -1;
+		} else {
+			memcpy(copy, paths, size * sizeof(*copy));
+			if (NULL != route->multipath) {
+				free(route->multipath);
+			}
+			route->multipath = copy;
+			route->multipath_size = size;
+			MNLXT_SET_PROP_FLAG(route, MNLXT_RT_ROUTE_MULTIPATH);
+			/* the paths carry gateways and output interfaces */
+			MNLXT_UNSET_PROP_FLAG(route, MNLXT_RT_ROUTE_GATEWAY);
+			MNLXT_UNSET_PROP_FLAG(route, MNLXT_RT_ROUTE_OIFINDEX);
+			MNLXT_UNSET_PROP_FLAG(route, MNLXT_RT_ROUTE_NH_ID);
+		}
+	}
+	return rc;
+}
+
+int mnlxt_rt_route_add_path(mnlxt_rt_route_t *route, uint8_t family, const mnlxt_rt_route_path_t *path) {
+	int rc = -1;
+	mnlxt_rt_route_path_t *paths;
+	if (NULL == route || NULL == path || UINT16_MAX == route->multipath_size) {
+		errno = EINVAL;
+	} else if (0 == (rc = mnlxt_rt_route_set_family(route, family))) {
+		if (NULL == (paths = realloc(route->multipath, (route->multipath_size + 1) * sizeof(*paths)))) {
+			rc = -1;
+		} else {
+			paths[route->multipath_size++] = *path;
+			route->multipath = paths;
+			MNLXT_SET_PROP_FLAG(route, MNLXT_RT_ROUTE_MULTIPATH);
+			MNLXT_UNSET_PROP_FLAG(route, MNLXT_RT_ROUTE_GATEWAY);
+			MNLXT_UNSET_PROP_FLAG(route, MNLXT_RT_ROUTE_OIFINDEX);
+			MNLXT_UNSET_PROP_FLAG(route, MNLXT_RT_ROUTE_NH_ID);
+		}
+	}
+	return rc;
+}
+
+int mnlxt_rt_route_get_multipath(const mnlxt_rt_route_t *route, const mnlxt_rt_route_path_t **paths, uint16_t *size) {
+	int rc = -1;
+	if (NULL == route || NULL == paths || NULL == size) {
+		errno = EINVAL;
+	} else if (!MNLXT_GET_PROP_FLAG(route, MNLXT_RT_ROUTE_MULTIPATH)) {
+		rc = 1;
+	} else {
+		*paths = route->multipath;
+		*size = route->multipath_size;
+		rc = 0;
+	}
+	return rc;
+}
+
 int mnlxt_rt_route_set_priority(mnlxt_rt_route_t *route, uint32_t priority) {
 	return mnlxt_rt_route_set_u32(route, MNLXT_RT_ROUTE_PRIORITY, priority);
 }
@@ -272,7 +363,11 @@ int mnlxt_rt_route_get_priority(const mnlxt_rt_route_t *route, uint32_t *priorit
 }
 
 int mnlxt_rt_route_set_oifindex(mnlxt_rt_route_t *route, uint32_t if_index) {
-	return mnlxt_rt_route_set_u32(route, MNLXT_RT_ROUTE_OIFINDEX, if_index);
+	int rc = mnlxt_rt_route_set_u32(route, MNLXT_RT_ROUTE_OIFINDEX, if_index);
+	if (0 == rc) {
+		MNLXT_UNSET_PROP_FLAG(route, MNLXT_RT_ROUTE_NH_ID);
+	}
+	return rc;
 }
 
 int mnlxt_rt_route_get_oifindex(const mnlxt_rt_route_t *route, uint32_t *if_index) {
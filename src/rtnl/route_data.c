@@ -12,11 +12,21 @@
 #include <string.h>
 
 #include "libmnlxt/rt.h"
+#include "private/data.h"
+#include "private/identity.h"
+#include "private/internal.h"
+#include "private/reconcile.h"
+
+/* gets the address family of the gateway of a path */
+static uint8_t mnlxt_rt_route_path_family(const mnlxt_rt_route_t *route, const mnlxt_rt_route_path_t *path) {
+	return (AF_UNSPEC != path->gateway_family ? path->gateway_family : route->family);
+}
 
 static int mnlxt_rt_route_cmp(const mnlxt_rt_route_t *rt_route1, const mnlxt_rt_route_t *rt_route2,
 															mnlxt_rt_route_data_t data) {
 	int rc = data + 1;
 	size_t family_size;
+	uint16_t i;
 	switch (data) {
 	case MNLXT_RT_ROUTE_FAMILY:
 		if (rt_route1->family != rt_route2->family) {
@@ -86,6 +96,28 @@ static int mnlxt_rt_route_cmp(const mnlxt_rt_route_t *rt_route1, const mnlxt_rt_
 			goto failed;
 		}
 		break;
+	case MNLXT_RT_ROUTE_NH_ID:
+		if (rt_route1->nh_id != rt_route2->nh_id) {
+			goto failed;
+		}
+		break;
+	case MNLXT_RT_ROUTE_MULTIPATH:
+		if (rt_route1->multipath_size != rt_route2->multipath_size) {
+			goto failed;
+		}
+		for (i = 0; i < rt_route1->multipath_size; ++i) {
+			const mnlxt_rt_route_path_t *path1 = &rt_route1->multipath[i], *path2 = &rt_route2->multipath[i];
+			uint8_t family = mnlxt_rt_route_path_family(rt_route1, path1);
+			family_size = (AF_INET == family ? sizeof(path1->gateway.in) : sizeof(path1->gateway));
+			if (path1->oif_index != path2->oif_index || path1->weight != path2->weight || path1->flags != path2->flags
+					|| path1->has_gateway != path2->has_gateway
+					|| (path1->has_gateway
+							&& (family != mnlxt_rt_route_path_family(rt_route2, path2)
+									|| 0 != memcmp(&path1->gateway, &path2->gateway, family_size)))) {
+				goto failed;
+			}
+		}
+		break;
 	}
 	rc = 0;
 failed:
@@ -149,6 +181,46 @@ mnlxt_rt_route_t *mnlxt_rt_route_remove(mnlxt_message_t *message) {
 	return route;
 }
 
+static int mnlxt_rt_route_put_multipath(struct nlmsghdr *nlh, const mnlxt_rt_route_t *route, size_t family_size) {
+	struct nlattr *nest;
+	struct rtnexthop *rtnh;
+	uint16_t i;
+	/* a path has at most an IPv6 gateway via another family */
+	size_t path_size
+		= RTNH_ALIGN(sizeof(*rtnh)) + MNL_ATTR_HDRLEN + MNL_ALIGN(sizeof(struct rtvia) + sizeof(struct in6_addr));
+	if (MNL_SOCKET_BUFFER_SIZE < nlh->nlmsg_len + MNL_ATTR_HDRLEN + route->multipath_size * path_size) {
+		/* the message is created in a buffer of this size */
+		errno = EMSGSIZE;
+		return -1;
+	}
+	nest = mnl_attr_nest_start(nlh, RTA_MULTIPATH);
+	for (i = 0; i < route->multipath_size; ++i) {
+		const mnlxt_rt_route_path_t *path = &route->multipath[i];
+		rtnh = mnl_nlmsg_get_payload_tail(nlh);
+		memset(rtnh, 0, RTNH_ALIGN(sizeof(*rtnh)));
+		nlh->nlmsg_len += RTNH_ALIGN(sizeof(*rtnh));
+		rtnh->rtnh_flags = path->flags;
+		/* the kernel stores the weight decremented by one */
+		rtnh->rtnh_hops = (path->weight ? path->weight - 1 : 0);
+		rtnh->rtnh_ifindex = path->oif_index;
+		if (path->has_gateway) {
+			uint8_t family = mnlxt_rt_route_path_family(route, path);
+			if (family == route->family) {
+				mnl_attr_put(nlh, RTA_GATEWAY, family_size, &path->gateway);
+			} else {
+				size_t addr_size = (AF_INET == family ? sizeof(path->gateway.in) : sizeof(path->gateway));
+				uint16_t via[(sizeof(struct rtvia) + sizeof(struct in6_addr)) / sizeof(uint16_t)];
+				((struct rtvia *)via)->rtvia_family = family;
+				memcpy(((struct rtvia *)via)->rtvia_addr, &path->gateway, addr_size);
+				mnl_attr_put(nlh, RTA_VIA, sizeof(struct rtvia) + addr_size, via);
+			}
+		}
+		rtnh->rtnh_len = (char *)mnl_nlmsg_get_payload_tail(nlh) - (char *)rtnh;
+	}
+	mnl_attr_nest_end(nlh, nest);
+	return 0;
+}
+
 int mnlxt_rt_route_put(struct nlmsghdr *nlh, const mnlxt_rt_route_t *route) {
 	int rc = -1;
 	if (route && nlh) {
@@ -163,7 +235,13 @@ int mnlxt_rt_route_put(struct nlmsghdr *nlh, const mnlxt_rt_route_t *route) {
 					rtm->rtm_family = route->family;
 					break;
 				case MNLXT_RT_ROUTE_TABLE:
-					rtm->rtm_table = route->table;
+					if (256 > route->table) {
+						rtm->rtm_table = route->table;
+					} else {
+						/* the header holds only 8 bits, RTA_TABLE overrides it */
+						rtm->rtm_table = RT_TABLE_UNSPEC;
+						mnl_attr_put_u32(nlh, RTA_TABLE, route->table);
+					}
 					break;
 				case MNLXT_RT_ROUTE_TYPE:
 					rtm->rtm_type = route->type;
@@ -198,6 +276,14 @@ int mnlxt_rt_route_put(struct nlmsghdr *nlh, const mnlxt_rt_route_t *route) {
 				case MNLXT_RT_ROUTE_GATEWAY:
 					mnl_attr_put(nlh, RTA_GATEWAY, family_size, &route->gateway);
 					break;
+				case MNLXT_RT_ROUTE_NH_ID:
+					mnl_attr_put_u32(nlh, RTA_NH_ID, route->nh_id);
+					break;
+				case MNLXT_RT_ROUTE_MULTIPATH:
+					if (0 != mnlxt_rt_route_put_multipath(nlh, route, family_size)) {
+						return rc;
+					}
+					break;
 				}
 			}
 		}
@@ -208,10 +294,74 @@ int mnlxt_rt_route_put(struct nlmsghdr *nlh, const mnlxt_rt_route_t *route) {
 	return rc;
 }
 
+static int mnlxt_rt_route_data_multipath(mnlxt_rt_route_t *route, const struct nlattr *nest, size_t family_size,
+																				 mnlxt_data_t *data) {
+	int rc = -1;
+	const struct rtnexthop *rtnh;
+	struct nlattr *attr;
+	int len;
+	uint16_t size = 0, i;
+
+	/* count and validate the paths first */
+	for (rtnh = mnl_attr_get_payload(nest), len = mnl_attr_get_payload_len(nest);
+			 RTNH_OK(rtnh, len) && UINT16_MAX > size; len -= RTNH_ALIGN(rtnh->rtnh_len), rtnh = RTNH_NEXT(rtnh)) {
+		++size;
+	}
+	if (0 == size) {
+		data->error_str = "RTA_MULTIPATH validation failed";
+		goto end;
+	}
+	if (NULL == (route->multipath = mnlxt_data_alloc(data, size * sizeof(*route->multipath)))) {
+		data->error_str = "mnlxt_data_alloc failed";
+		goto end;
+	}
+	for (rtnh = mnl_attr_get_payload(nest), i = 0; i < size; rtnh = RTNH_NEXT(rtnh), ++i) {
+		mnlxt_rt_route_path_t *path = &route->multipath[i];
+		path->oif_index = rtnh->rtnh_ifindex;
+		path->weight = rtnh->rtnh_hops + 1;
+		path->flags = rtnh->rtnh_flags;
+		mnl_attr_for_each_payload((void *)RTNH_DATA(rtnh), rtnh->rtnh_len - RTNH_LENGTH(0)) {
+			if (RTA_GATEWAY == mnl_attr_get_type(attr)) {
+				if (0 > mnl_attr_validate2(attr, MNL_TYPE_BINARY, family_size)) {
+					data->error_str = "RTA_GATEWAY validation failed";
+					goto end;
+				}
+				memcpy(&path->gateway, mnl_attr_get_payload(attr), family_size);
+				path->has_gateway = 1;
+			} else if (RTA_VIA == mnl_attr_get_type(attr)) {
+				/* gateway of another family than the route */
+				const struct rtvia *rtvia = mnl_attr_get_payload(attr);
+				size_t addr_size = 0;
+				if (sizeof(struct rtvia) <= mnl_attr_get_payload_len(attr)) {
+					if (AF_INET == rtvia->rtvia_family) {
+						addr_size = sizeof(path->gateway.in);
+					} else if (AF_INET6 == rtvia->rtvia_family) {
+						addr_size = sizeof(path->gateway.in6);
+					}
+				}
+				if (0 == addr_size || sizeof(struct rtvia) + addr_size > mnl_attr_get_payload_len(attr)) {
+					data->error_str = "RTA_VIA validation failed";
+					goto end;
+				}
+				memcpy(&path->gateway, rtvia->rtvia_addr, addr_size);
+				path->gateway_family = rtvia->rtvia_family;
+				path->has_gateway = 1;
+			}
+		}
+	}
+	route->multipath_size = size;
+	MNLXT_SET_PROP_FLAG(route, MNLXT_RT_ROUTE_MULTIPATH);
+	rc = 0;
+end:
+	return rc;
+}
+
 int mnlxt_rt_route_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 	int rc = MNL_CB_ERROR;
 	mnlxt_rt_route_t *route = NULL;
 	mnlxt_message_t *msg = NULL;
+	uint32_t nh_id = 0;
+	int has_nh_id = 0;
 
 	if (NULL == data) {
 		errno = EINVAL;
@@ -243,9 +393,9 @@ int mnlxt_rt_route_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 		goto end;
 	}
 
-	route = mnlxt_rt_route_new();
+	route = mnlxt_data_alloc(data, sizeof(mnlxt_rt_route_t));
 	if (!route) {
-		data->error_str = "mnlxt_rt_route_new failed";
+		data->error_str = "mnlxt_data_alloc failed";
 		goto end;
 	}
 
@@ -297,6 +447,17 @@ int mnlxt_rt_route_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 				goto end;
 			}
 			break;
+		case RTA_TABLE:
+			/* the header holds RT_TABLE_COMPAT for tables above 255 */
+			if (0 > mnl_attr_validate(attr, MNL_TYPE_U32)) {
+				data->error_str = "RTA_TABLE validation failed";
+				goto end;
+			}
+			if (-1 == mnlxt_rt_route_set_table(route, mnl_attr_get_u32(attr))) {
+				data->error_str = "mnlxt_rt_route_set_table failed";
+				goto end;
+			}
+			break;
 		case RTA_PRIORITY:
 			if (0 > mnl_attr_validate(attr, MNL_TYPE_U32)) {
 				data->error_str = "RTA_PRIORITY validation failed";
@@ -327,14 +488,32 @@ int mnlxt_rt_route_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 				goto end;
 			}
 			break;
+		case RTA_NH_ID:
+			if (0 > mnl_attr_validate(attr, MNL_TYPE_U32)) {
+				data->error_str = "RTA_NH_ID validation failed";
+				goto end;
+			}
+			/* set after the other attributes, the nexthop compat mode adds gateway and output interface */
+			nh_id = mnl_attr_get_u32(attr);
+			has_nh_id = 1;
+			break;
+		case RTA_MULTIPATH:
+			if (NULL == route->multipath && -1 == mnlxt_rt_route_data_multipath(route, attr, family_size, data)) {
+				goto end;
+			}
+			break;
 		default:
 			break;
 		}
 	}
+	if (has_nh_id && -1 == mnlxt_rt_route_set_nh_id(route, nh_id)) {
+		data->error_str = "mnlxt_rt_route_set_nh_id failed";
+		goto end;
+	}
 
-	msg = mnlxt_rt_message_new(nlh->nlmsg_type, 0, route);
+	msg = mnlxt_rt_data_message_new(data, nlh->nlmsg_type, route);
 	if (NULL == msg) {
-		data->error_str = "mnlxt_rt_message_new failed";
+		data->error_str = "mnlxt_rt_data_message_new failed";
 		goto end;
 	}
 
@@ -343,7 +522,7 @@ int mnlxt_rt_route_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 	msg = NULL;
 	rc = MNL_CB_OK;
 end:
-	mnlxt_rt_route_free(route);
+	mnlxt_data_release(data, route, mnlxt_rt_route_FREE);
 	mnlxt_message_free(msg);
 
 	return rc;
@@ -362,20 +541,51 @@ mnlxt_rt_route_t *mnlxt_rt_route_iterate(mnlxt_data_t *data, mnlxt_message_t **i
 }
 
 int mnlxt_rt_route_dump(mnlxt_data_t *data, unsigned char family) {
+	return mnlxt_rt_route_handle_dump(NULL, data, family);
+}
+
+int mnlxt_rt_route_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, unsigned char family) {
 	int rc = -1;
 	if (AF_INET != family && AF_INET6 != family && AF_UNSPEC != family) {
 		errno = EAFNOSUPPORT;
 	} else {
-		rc = mnlxt_rt_data_dump(data, RTM_GETROUTE, family);
+		rc = mnlxt_rt_handle_data_dump(handle, data, RTM_GETROUTE, family);
+	}
+	return rc;
+}
+
+int mnlxt_rt_route_dump_filter(mnlxt_data_t *data, const mnlxt_rt_route_t *filter) {
+	return mnlxt_rt_route_handle_dump_filter(NULL, data, filter);
+}
+
+int mnlxt_rt_route_handle_dump_filter(mnlxt_handle_t *handle, mnlxt_data_t *data, const mnlxt_rt_route_t *filter) {
+	int rc = -1;
+	if (NULL == filter || (filter->prop_flags & ~MNLXT_RT_ROUTE_DUMP_FILTER)) {
+		errno = EINVAL;
+	} else if (MNLXT_GET_PROP_FLAG(filter, MNLXT_RT_ROUTE_FAMILY) && AF_INET != filter->family
+						 && AF_INET6 != filter->family && AF_UNSPEC != filter->family) {
+		errno = EAFNOSUPPORT;
+	} else {
+		char buf[MNL_NLMSG_HDRLEN + MNL_ALIGN(sizeof(struct rtmsg)) + 64];
+		struct nlmsghdr *nlh = mnl_nlmsg_put_header(buf);
+		nlh->nlmsg_type = RTM_GETROUTE;
+		/* the header members without a filter stay zero, as strict checking requires it */
+		if (0 == mnlxt_rt_route_put(nlh, filter)) {
+			rc = mnlxt_rt_dump_request(handle, data, nlh, 1);
+		}
 	}
 	return rc;
 }
 
 int mnlxt_rt_route_request(mnlxt_rt_route_t *rt_route, uint16_t type, uint16_t flags) {
+	return mnlxt_rt_route_handle_request(NULL, rt_route, type, flags);
+}
+
+int mnlxt_rt_route_handle_request(mnlxt_handle_t *handle, mnlxt_rt_route_t *rt_route, uint16_t type, uint16_t flags) {
 	int rc = -1;
 	mnlxt_message_t *message = mnlxt_rt_route_message(&rt_route, type, flags);
 	if (NULL != message) {
-		rc = mnlxt_rt_message_request(message);
+		rc = mnlxt_rt_handle_message_request(handle, message);
 		mnlxt_rt_route_remove(message);
 		mnlxt_message_free(message);
 	}
@@ -391,3 +601,40 @@ mnlxt_message_t *mnlxt_rt_route_message(mnlxt_rt_route_t **route, uint16_t type,
 	}
 	return message;
 }
+
+static int mnlxt_rt_route_reconcile_match(const void *current, const void *desired) {
+	return mnlxt_rt_route_match(current, desired);
+}
+
+static void *mnlxt_rt_route_reconcile_get(const mnlxt_message_t *message) {
+	return mnlxt_rt_route_get(message);
+}
+
+static void *mnlxt_rt_route_reconcile_clone(const void *object) {
+	const mnlxt_rt_route_t *route = object;
+	return mnlxt_rt_route_clone(route, route->prop_flags);
+}
+
+static mnlxt_message_t *mnlxt_rt_route_reconcile_message(void *object, uint16_t type, uint16_t flags) {
+	mnlxt_rt_route_t *route = object;
+	return mnlxt_rt_route_message(&route, type, flags);
+}
+
+static const mnlxt_reconcile_ops_t route_reconcile_ops = {
+	.hash = mnlxt_rt_route_identity_hash,
+	.identity = mnlxt_rt_route_identity_cmp,
+	.match = mnlxt_rt_route_reconcile_match,
+	.get = mnlxt_rt_route_reconcile_get,
+	.clone = mnlxt_rt_route_reconcile_clone,
+	.free = mnlxt_rt_route_FREE,
+	.message = mnlxt_rt_route_reconcile_message,
+	.new_type = RTM_NEWROUTE,
+	.new_flags = NLM_F_CREATE | NLM_F_EXCL,
+	.replace_type = RTM_NEWROUTE,
+	.replace_flags = NLM_F_CREATE | NLM_F_REPLACE,
+	.del_type = RTM_DELROUTE,
+};
+
+int mnlxt_rt_route_reconcile(mnlxt_data_t *desired, mnlxt_data_t *current, mnlxt_data_t *changes) {
+	return mnlxt_data_reconcile(&route_reconcile_ops, desired, current, changes);
+}
@@ -0,0 +1,261 @@
+/*
+ * route_index.c		Libmnlxt Routing Route Index
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libmnlxt/rt.h"
+#include "private/hash.h"
+#include "private/identity.h"
+#include "private/internal.h"
+
+typedef struct {
+	uint8_t family;
+	uint8_t dst_prefix;
+	uint8_t src_prefix;
+	uint8_t padding;
+	uint32_t table;
+	uint32_t priority;
+	mnlxt_inet_addr_t dst;
+	mnlxt_inet_addr_t src;
+} mnlxt_rt_route_key_t;
+
+typedef struct {
+	/** has to be the first member */
+	mnlxt_hash_entry_t entry;
+	mnlxt_rt_route_key_t key;
+	mnlxt_rt_route_t *route;
+} mnlxt_rt_route_index_entry_t;
+
+struct mnlxt_rt_route_index_s {
+	mnlxt_hash_t hash;
+};
+
+static void mnlxt_rt_route_key_addr(mnlxt_inet_addr_t *dst, const mnlxt_inet_addr_t *src, uint8_t prefix) {
+	size_t bytes = prefix / 8;
+	if (sizeof(*dst) < bytes) {
+		bytes = sizeof(*dst);
+	}
+	memcpy(dst, src, bytes);
+	if (sizeof(*dst) > bytes && (prefix % 8)) {
+		((uint8_t *)dst)[bytes] = ((const uint8_t *)src)[bytes] & (uint8_t)(0xff << (8 - prefix % 8));
+	}
+}
+
+static uint32_t mnlxt_rt_route_key(const mnlxt_rt_route_t *route, mnlxt_rt_route_key_t *key) {
+	memset(key, 0, sizeof(*key));
+	if (MNLXT_GET_PROP_FLAG(route, MNLXT_RT_ROUTE_FAMILY)) {
+		key->family = route->family;
+	}
+	if (MNLXT_GET_PROP_FLAG(route, MNLXT_RT_ROUTE_TABLE)) {
+		key->table = route->table;
+	}
+	if (MNLXT_GET_PROP_FLAG(route, MNLXT_RT_ROUTE_PRIORITY)) {
+		key->priority = route->priority;
+	}
+	if (MNLXT_GET_PROP_FLAG(route, MNLXT_RT_ROUTE_DST_PREFIX)) {
+		key->dst_prefix = route->dst_prefix;
+	}
+	if (MNLXT_GET_PROP_FLAG(route, MNLXT_RT_ROUTE_SRC_PREFIX)) {
+		key->src_prefix = route->src_prefix;
+	}
+	/* only the prefix of an address identifies the route */
+	if (MNLXT_GET_PROP_FLAG(route, MNLXT_RT_ROUTE_DST)) {
+		mnlxt_rt_route_key_addr(&key->dst, &route->dst, key->dst_prefix);
+	}
+	if (MNLXT_GET_PROP_FLAG(route, MNLXT_RT_ROUTE_SRC)) {
+		mnlxt_rt_route_key_addr(&key->src, &route->src, key->src_prefix);
+	}
+	return mnlxt_hash_fnv(key, sizeof(*key));
+}
+
+static int mnlxt_rt_route_key_cmp(const mnlxt_hash_entry_t *entry, const void *key) {
+	return memcmp(&((const mnlxt_rt_route_index_entry_t *)entry)->key, key, sizeof(mnlxt_rt_route_key_t));
+}
+
+uint32_t mnlxt_rt_route_identity_hash(const void *route) {
+	mnlxt_rt_route_key_t key;
+	return mnlxt_rt_route_key(route, &key);
+}
+
+int mnlxt_rt_route_identity_cmp(const void *route1, const void *route2) {
+	mnlxt_rt_route_key_t key1, key2;
+	mnlxt_rt_route_key(route1, &key1);
+	mnlxt_rt_route_key(route2, &key2);
+	return memcmp(&key1, &key2, sizeof(key1));
+}
+
+static mnlxt_rt_route_index_entry_t *mnlxt_rt_route_index_find(const mnlxt_rt_route_index_t *index,
+																															 const mnlxt_rt_route_t *route) {
+	mnlxt_rt_route_key_t key;
+	uint32_t hashval = mnlxt_rt_route_key(route, &key);
+	return (mnlxt_rt_route_index_entry_t *)mnlxt_hash_find(&index->hash, hashval, mnlxt_rt_route_key_cmp, &key);
+}
+
+mnlxt_rt_route_index_t *mnlxt_rt_route_index_new(size_t size) {
+	mnlxt_rt_route_index_t *index = calloc(1, sizeof(mnlxt_rt_route_index_t));
+	if (index && 0 != mnlxt_hash_init(&index->hash, size)) {
+		free(index);
+		index = NULL;
+	}
+	return index;
+}
+
+void mnlxt_rt_route_index_free(mnlxt_rt_route_index_t *index) {
+	if (index) {
+		mnlxt_hash_entry_t *entry = index->hash.first;
+		while (entry) {
+			mnlxt_rt_route_index_entry_t *route_entry = (mnlxt_rt_route_index_entry_t *)entry;
+			entry = entry->next;
+			mnlxt_rt_route_free(route_entry->route);
+			free(route_entry);
+		}
+		mnlxt_hash_clean(&index->hash);
+		free(index);
+	}
+}
+
+size_t mnlxt_rt_route_index_count(const mnlxt_rt_route_index_t *index) {
+	size_t count = 0;
+	if (index) {
+		count = index->hash.count;
+	} else {
+		errno = EINVAL;
+	}
+	return count;
+}
+
+int mnlxt_rt_route_index_add(mnlxt_rt_route_index_t *index, mnlxt_rt_route_t *route) {
+	int rc = -1;
+	mnlxt_rt_route_index_entry_t *entry;
+	mnlxt_rt_route_key_t key;
+	uint32_t hashval;
+
+	if (NULL == index || NULL == route) {
+		errno = EINVAL;
+		goto end;
+	}
+	hashval = mnlxt_rt_route_key(route, &key);
+	entry = (mnlxt_rt_route_index_entry_t *)mnlxt_hash_find(&index->hash, hashval, mnlxt_rt_route_key_cmp, &key);
+	if (NULL != entry) {
+		/* replace in place, the position in insertion order is kept */
+		mnlxt_rt_route_free(entry->route);
+		entry->route = route;
+		rc = 1;
+	} else if (NULL != (entry = malloc(sizeof(mnlxt_rt_route_index_entry_t)))) {
+		entry->key = key;
+		entry->route = route;
+		mnlxt_hash_insert(&index->hash, &entry->entry, hashval);
+		rc = 0;
+	}
+end:
+	return rc;
+}
+
+mnlxt_rt_route_t *mnlxt_rt_route_index_lookup(const mnlxt_rt_route_index_t *index, const mnlxt_rt_route_t *key) {
+	mnlxt_rt_route_t *route = NULL;
+	mnlxt_rt_route_index_entry_t *entry;
+	if (NULL == index || NULL == key) {
+		errno = EINVAL;
+	} else if (NULL != (entry = mnlxt_rt_route_index_find(index, key))) {
+		route = entry->route;
+	}
+	return route;
+}
+
+mnlxt_rt_route_t *mnlxt_rt_route_index_remove(mnlxt_rt_route_index_t *index, const mnlxt_rt_route_t *key) {
+	mnlxt_rt_route_t *route = NULL;
+	mnlxt_rt_route_index_entry_t *entry;
+	if (NULL == index || NULL == key) {
+		errno = EINVAL;
+	} else if (NULL != (entry = mnlxt_rt_route_index_find(index, key))) {
+		route = entry->route;
+		mnlxt_hash_remove(&index->hash, &entry->entry);
+		free(entry);
+	}
+	return route;
+}
+
+int mnlxt_rt_route_index_update(mnlxt_rt_route_index_t *index, const mnlxt_message_t *message) {
+	int rc = -1;
+	mnlxt_rt_route_t *route = mnlxt_rt_route_get(message);
+	if (NULL == index || NULL == route) {
+		errno = EINVAL;
+	} else if (RTM_DELROUTE == message->nlmsg_type) {
+		mnlxt_rt_route_t *removed = mnlxt_rt_route_index_remove(index, route);
+		if (NULL != removed) {
+			mnlxt_rt_route_free(removed);
+			rc = 0;
+		} else {
+			rc = 1;
+		}
+	} else {
+		mnlxt_rt_route_t *copy = mnlxt_rt_route_clone(route, route->prop_flags);
+		if (NULL != copy && 0 <= mnlxt_rt_route_index_add(index, copy)) {
+			rc = 0;
+		} else {
+			mnlxt_rt_route_free(copy);
+		}
+	}
+	return rc;
+}
+
+int mnlxt_rt_route_index_load(mnlxt_rt_route_index_t *index, mnlxt_data_t *data) {
+	int rc = -1;
+	mnlxt_message_t *msg, *next;
+
+	if (NULL == index || NULL == data) {
+		errno = EINVAL;
+		goto end;
+	}
+	for (msg = data->first; NULL != msg; msg = next) {
+		mnlxt_rt_route_t *route;
+		next = msg->next;
+		if (RTM_DELROUTE == msg->nlmsg_type || NULL == mnlxt_rt_route_get(msg)) {
+			continue;
+		}
+		if (msg->arena) {
+			/* payloads of an arena can not be taken over */
+			route = mnlxt_rt_route_get(msg);
+			route = mnlxt_rt_route_clone(route, route->prop_flags);
+		} else {
+			route = mnlxt_rt_route_remove(msg);
+		}
+		if (NULL == route) {
+			goto end;
+		}
+		if (0 > mnlxt_rt_route_index_add(index, route)) {
+			mnlxt_rt_route_free(route);
+			goto end;
+		}
+		mnlxt_data_remove(data, msg);
+		mnlxt_message_free(msg);
+	}
+	rc = 0;
+end:
+	return rc;
+}
+
+mnlxt_rt_route_t *mnlxt_rt_route_index_iterate(const mnlxt_rt_route_index_t *index, void **iterator) {
+	mnlxt_rt_route_t *route = NULL;
+	mnlxt_hash_entry_t *entry;
+	if (NULL == index || NULL == iterator) {
+		errno = EINVAL;
+	} else {
+		/* the iterator refers the next entry, so the current one may be removed; the index marks the end */
+		entry = (NULL == *iterator ? index->hash.first : (*iterator == index ? NULL : *iterator));
+		if (NULL != entry) {
+			route = ((mnlxt_rt_route_index_entry_t *)entry)->route;
+			*iterator = (entry->next ? (void *)entry->next : (void *)index);
+		}
+	}
+	return route;
+}
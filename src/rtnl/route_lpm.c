@@ -0,0 +1,300 @@
+/*
+ * route_lpm.c		Libmnlxt Routing Longest Prefix Match
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libmnlxt/rt.h"
+#include "private/internal.h"
+#include "private/trie.h"
+
+/* routes of one destination prefix, ordered by priority */
+typedef struct mnlxt_rt_route_lpm_entry_s {
+	struct mnlxt_rt_route_lpm_entry_s *next;
+	uint32_t priority;
+	mnlxt_rt_route_t *route;
+} mnlxt_rt_route_lpm_entry_t;
+
+/* tries of AF_INET and AF_INET6 of a table above 255 */
+typedef struct {
+	uint32_t id;
+	mnlxt_trie_t tries[2];
+} mnlxt_rt_route_lpm_table_t;
+
+struct mnlxt_rt_route_lpm_s {
+	/** tries of AF_INET and AF_INET6 per table up to 255 */
+	mnlxt_trie_t tries[2][256];
+	/** tables above 255, e.g. of VRFs */
+	mnlxt_rt_route_lpm_table_t *tables;
+	size_t ntables;
+	size_t count;
+};
+
+/* empty trie of tables without routes */
+static const mnlxt_trie_t mnlxt_rt_route_lpm_empty;
+
+/* gets the trie of a table and family, and the address length in bits; a missing table is created if asked for */
+static mnlxt_trie_t *mnlxt_rt_route_lpm_trie(const mnlxt_rt_route_lpm_t *lpm, uint32_t table, uint8_t family,
+																						 uint8_t *bits, int create) {
+	mnlxt_trie_t *trie = NULL;
+	mnlxt_rt_route_lpm_t *mutable = (mnlxt_rt_route_lpm_t *)lpm;
+	mnlxt_rt_route_lpm_table_t *tables;
+	int index;
+	size_t i;
+	if (AF_INET == family) {
+		index = 0;
+		*bits = 32;
+	} else if (AF_INET6 == family) {
+		index = 1;
+		*bits = 128;
+	} else {
+		errno = EAFNOSUPPORT;
+		goto end;
+	}
+	if (256 > table) {
+		trie = &mutable->tries[index][table];
+		goto end;
+	}
+	for (i = 0; i < lpm->ntables; ++i) {
+		if (table == lpm->tables[i].id) {
+			trie = &lpm->tables[i].tries[index];
+			goto end;
+		}
+	}
+	if (!create) {
+		trie = (mnlxt_trie_t *)&mnlxt_rt_route_lpm_empty;
+	} else if (NULL != (tables = realloc(lpm->tables, (lpm->ntables + 1) * sizeof(*tables)))) {
+		memset(&tables[lpm->ntables], 0, sizeof(*tables));
+		tables[lpm->ntables].id = table;
+		trie = &tables[lpm->ntables].tries[index];
+		mutable->tables = tables;
+		++mutable->ntables;
+	}
+end:
+	return trie;
+}
+
+/* gets trie and destination prefix of a route */
+static mnlxt_trie_t *mnlxt_rt_route_lpm_route_trie(const mnlxt_rt_route_lpm_t *lpm, const mnlxt_rt_route_t *route,
+																									 uint8_t *prefix, uint32_t *priority, int create) {
+	mnlxt_trie_t *trie = NULL;
+	uint8_t bits;
+	if (!MNLXT_GET_PROP_FLAG(route, MNLXT_RT_ROUTE_FAMILY)) {
+		errno = EINVAL;
+	} else if (NULL != (trie = mnlxt_rt_route_lpm_trie(
+													lpm, (MNLXT_GET_PROP_FLAG(route, MNLXT_RT_ROUTE_TABLE) ? route->table : RT_TABLE_MAIN),
+													route->family, &bits, create))) {
+		*prefix = (MNLXT_GET_PROP_FLAG(route, MNLXT_RT_ROUTE_DST_PREFIX) ? route->dst_prefix : 0);
+		*priority = (MNLXT_GET_PROP_FLAG(route, MNLXT_RT_ROUTE_PRIORITY) ? route->priority : 0);
+		if (bits < *prefix || (*prefix && !MNLXT_GET_PROP_FLAG(route, MNLXT_RT_ROUTE_DST))) {
+			errno = EINVAL;
+			trie = NULL;
+		}
+	}
+	return trie;
+}
+
+static void mnlxt_rt_route_lpm_entry_free(void *value) {
+	mnlxt_rt_route_lpm_entry_t *entry = value;
+	while (entry) {
+		mnlxt_rt_route_lpm_entry_t *next = entry->next;
+		mnlxt_rt_route_free(entry->route);
+		free(entry);
+		entry = next;
+	}
+}
+
+mnlxt_rt_route_lpm_t *mnlxt_rt_route_lpm_new() {
+	return calloc(1, sizeof(mnlxt_rt_route_lpm_t));
+}
+
+void mnlxt_rt_route_lpm_free(mnlxt_rt_route_lpm_t *lpm) {
+	if (lpm) {
+		int family, table;
+		size_t i;
+		for (family = 0; family < 2; ++family) {
+			for (table = 0; table < 256; ++table) {
+				mnlxt_trie_clean(&lpm->tries[family][table], mnlxt_rt_route_lpm_entry_free);
+			}
+			for (i = 0; i < lpm->ntables; ++i) {
+				mnlxt_trie_clean(&lpm->tables[i].tries[family], mnlxt_rt_route_lpm_entry_free);
+			}
+		}
+		free(lpm->tables);
+		free(lpm);
+	}
+}
+
+size_t mnlxt_rt_route_lpm_count(const mnlxt_rt_route_lpm_t *lpm) {
+	size_t count = 0;
+	if (lpm) {
+		count = lpm->count;
+	} else {
+		errno = EINVAL;
+	}
+	return count;
+}
+
+int mnlxt_rt_route_lpm_add(mnlxt_rt_route_lpm_t *lpm, mnlxt_rt_route_t *route) {
+	int rc = -1;
+	mnlxt_trie_t *trie;
+	mnlxt_rt_route_lpm_entry_t **link, *entry;
+	uint8_t prefix;
+	uint32_t priority;
+
+	if (NULL == lpm || NULL == route) {
+		errno = EINVAL;
+		goto end;
+	}
+	if (NULL == (trie = mnlxt_rt_route_lpm_route_trie(lpm, route, &prefix, &priority, 1))) {
+		goto end;
+	}
+	if (NULL == (link = (mnlxt_rt_route_lpm_entry_t **)mnlxt_trie_insert(trie, (const uint8_t *)&route->dst, prefix))) {
+		goto end;
+	}
+	while (*link && (*link)->priority < priority) {
+		link = &(*link)->next;
+	}
+	if (*link && (*link)->priority == priority) {
+		mnlxt_rt_route_free((*link)->route);
+		(*link)->route = route;
+		rc = 1;
+	} else if (NULL != (entry = malloc(sizeof(mnlxt_rt_route_lpm_entry_t)))) {
+		entry->next = *link;
+		entry->priority = priority;
+		entry->route = route;
+		*link = entry;
+		++lpm->count;
+		rc = 0;
+	} else if (NULL == *(mnlxt_rt_route_lpm_entry_t **)mnlxt_trie_insert(trie, (const uint8_t *)&route->dst, prefix)) {
+		/* drop the prefix created for the failed entry */
+		mnlxt_trie_remove(trie, (const uint8_t *)&route->dst, prefix);
+	}
+end:
+	return rc;
+}
+
+mnlxt_rt_route_t *mnlxt_rt_route_lpm_remove(mnlxt_rt_route_lpm_t *lpm, const mnlxt_rt_route_t *key) {
+	mnlxt_rt_route_t *route = NULL;
+	mnlxt_trie_t *trie;
+	mnlxt_rt_route_lpm_entry_t **link, *entry;
+	uint8_t prefix;
+	uint32_t priority;
+
+	if (NULL == lpm || NULL == key) {
+		errno = EINVAL;
+	} else if (NULL != (trie = mnlxt_rt_route_lpm_route_trie(lpm, key, &prefix, &priority, 0))
+						 && NULL != (link = (mnlxt_rt_route_lpm_entry_t **)mnlxt_trie_find(trie, (const uint8_t *)&key->dst,
+																																							 prefix))) {
+		mnlxt_rt_route_lpm_entry_t **head = link;
+		while (*link && (*link)->priority < priority) {
+			link = &(*link)->next;
+		}
+		if (NULL != (entry = *link) && entry->priority == priority) {
+			route = entry->route;
+			*link = entry->next;
+			free(entry);
+			--lpm->count;
+			if (NULL == *head) {
+				mnlxt_trie_remove(trie, (const uint8_t *)&key->dst, prefix);
+			}
+		}
+	}
+	return route;
+}
+
+int mnlxt_rt_route_lpm_update(mnlxt_rt_route_lpm_t *lpm, const mnlxt_message_t *message) {
+	int rc = -1;
+	mnlxt_rt_route_t *route = mnlxt_rt_route_get(message);
+	if (NULL == lpm || NULL == route) {
+		errno = EINVAL;
+	} else if (RTM_DELROUTE == message->nlmsg_type) {
+		mnlxt_rt_route_t *removed = mnlxt_rt_route_lpm_remove(lpm, route);
+		if (NULL != removed) {
+			mnlxt_rt_route_free(removed);
+			rc = 0;
+		} else {
+			rc = 1;
+		}
+	} else {
+		mnlxt_rt_route_t *copy = mnlxt_rt_route_clone(route, route->prop_flags);
+		if (NULL != copy && 0 <= mnlxt_rt_route_lpm_add(lpm, copy)) {
+			rc = 0;
+		} else {
+			mnlxt_rt_route_free(copy);
+		}
+	}
+	return rc;
+}
+
+int mnlxt_rt_route_lpm_load(mnlxt_rt_route_lpm_t *lpm, const mnlxt_data_t *data) {
+	int rc = -1;
+	mnlxt_message_t *msg;
+
+	if (NULL == lpm || NULL == data) {
+		errno = EINVAL;
+		goto end;
+	}
+	for (msg = data->first; NULL != msg; msg = msg->next) {
+		mnlxt_rt_route_t *route = mnlxt_rt_route_get(msg);
+		if (RTM_DELROUTE == msg->nlmsg_type || NULL == route
+				|| (AF_INET != route->family && AF_INET6 != route->family)) {
+			continue;
+		}
+		if (0 > mnlxt_rt_route_lpm_update(lpm, msg)) {
+			goto end;
+		}
+	}
+	rc = 0;
+end:
+	return rc;
+}
+
+const mnlxt_rt_route_t *mnlxt_rt_route_lpm_lookup(const mnlxt_rt_route_lpm_t *lpm, uint32_t table, uint8_t family,
+																									const mnlxt_inet_addr_t *addr) {
+	const mnlxt_rt_route_t *route = NULL;
+	if (NULL == addr || 1 != mnlxt_rt_route_lpm_lookup_batch(lpm, table, family, addr, &route, 1)) {
+		route = NULL;
+	}
+	return route;
+}
+
+int mnlxt_rt_route_lpm_lookup_batch(const mnlxt_rt_route_lpm_t *lpm, uint32_t table, uint8_t family,
+																		const mnlxt_inet_addr_t *addrs, const mnlxt_rt_route_t **routes, size_t count) {
+	int rc = -1;
+	const mnlxt_trie_t *trie;
+	size_t i;
+	uint8_t bits;
+
+	if (NULL == lpm || (count && (NULL == addrs || NULL == routes))) {
+		errno = EINVAL;
+		goto end;
+	}
+	/* the trie is resolved once for the whole batch */
+	if (NULL == (trie = mnlxt_rt_route_lpm_trie(lpm, table, family, &bits, 0))) {
+		goto end;
+	}
+	rc = 0;
+	for (i = 0; i < count; ++i) {
+		const mnlxt_rt_route_lpm_entry_t *entry = NULL;
+		if (trie->root) {
+			entry = mnlxt_trie_lookup(trie, (const uint8_t *)&addrs[i], bits);
+		}
+		if (NULL != entry) {
+			routes[i] = entry->route;
+			++rc;
+		} else {
+			routes[i] = NULL;
+		}
+	}
+end:
+	return rc;
+}
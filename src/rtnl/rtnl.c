@@ -11,6 +11,7 @@
 #include <errno.h>
 
 #include "libmnlxt/rt.h"
+#include "private/data.h"
 #include "private/internal.h"
 
 static const mnlxt_data_cb_t data_handlers[] = {
@@ -30,12 +31,27 @@ static const mnlxt_data_cb_t data_handlers[] = {
 	[RTM_NEWRULE] = {"NEWRULE", mnlxt_rt_rule_DATA, mnlxt_rt_rule_PUT, mnlxt_rt_rule_FREE, NLM_F_CREATE},
 	[RTM_DELRULE] = {"DELRULE", mnlxt_rt_rule_DATA, mnlxt_rt_rule_PUT, mnlxt_rt_rule_FREE, 0},
 	[RTM_GETRULE] = {"GETRULE", mnlxt_rt_rule_DATA, mnlxt_rt_rule_PUT, mnlxt_rt_rule_FREE, 0},
+
+	[RTM_NEWNEXTHOP] = {"NEWNEXTHOP", mnlxt_rt_nexthop_DATA, mnlxt_rt_nexthop_PUT, mnlxt_rt_nexthop_FREE, NLM_F_CREATE},
+	[RTM_DELNEXTHOP] = {"DELNEXTHOP", mnlxt_rt_nexthop_DATA, mnlxt_rt_nexthop_PUT, mnlxt_rt_nexthop_FREE, 0},
+	[RTM_GETNEXTHOP] = {"GETNEXTHOP", mnlxt_rt_nexthop_DATA, mnlxt_rt_nexthop_PUT, mnlxt_rt_nexthop_FREE, 0},
+
+	[RTM_NEWNEIGH] = {"NEWNEIGH", mnlxt_rt_neigh_DATA, mnlxt_rt_neigh_PUT, mnlxt_rt_neigh_FREE, NLM_F_CREATE},
+	[RTM_DELNEIGH] = {"DELNEIGH", mnlxt_rt_neigh_DATA, mnlxt_rt_neigh_PUT, mnlxt_rt_neigh_FREE, 0},
+	[RTM_GETNEIGH] = {"GETNEIGH", mnlxt_rt_neigh_DATA, mnlxt_rt_neigh_PUT, mnlxt_rt_neigh_FREE, 0},
+
+	[RTM_NEWSTATS] = {"NEWSTATS", mnlxt_rt_stats_DATA, NULL, mnlxt_rt_stats_FREE, 0},
+	[RTM_GETSTATS] = {"GETSTATS", mnlxt_rt_stats_DATA, NULL, mnlxt_rt_stats_FREE, 0},
 };
 
 static const size_t data_nhandlers = MNL_ARRAY_SIZE(data_handlers);
 
 int mnlxt_rt_connect(mnlxt_handle_t *handle, int group) {
-	int rc = mnlxt_connect(handle, NETLINK_ROUTE, group);
+	return mnlxt_rt_connect_opts(handle, group, NULL);
+}
+
+int mnlxt_rt_connect_opts(mnlxt_handle_t *handle, int group, const mnlxt_connect_opts_t *opts) {
+	int rc = mnlxt_connect_opts(handle, NETLINK_ROUTE, group, opts);
 
 	if (!rc) {
 		handle->data_handlers = data_handlers;
@@ -45,38 +61,110 @@ int mnlxt_rt_connect(mnlxt_handle_t *handle, int group) {
 	return rc;
 }
 
-int mnlxt_rt_data_dump(mnlxt_data_t *data, int type, unsigned char family) {
+static size_t mnlxt_rt_dump_header_size(int type) {
+	size_t size;
+	/* complete headers are accepted by strict checking sockets too, the kernel reads only the family otherwise */
+	switch (type) {
+	case RTM_GETLINK:
+		size = sizeof(struct ifinfomsg);
+		break;
+	case RTM_GETADDR:
+		size = sizeof(struct ifaddrmsg);
+		break;
+	case RTM_GETROUTE:
+		size = sizeof(struct rtmsg);
+		break;
+	case RTM_GETRULE:
+		size = sizeof(struct fib_rule_hdr);
+		break;
+	case RTM_GETNEXTHOP:
+		size = sizeof(struct nhmsg);
+		break;
+	case RTM_GETNEIGH:
+		size = sizeof(struct ndmsg);
+		break;
+	default:
+		size = sizeof(struct rtgenmsg);
+		break;
+	}
+	return size;
+}
+
+int mnlxt_rt_dump_request(mnlxt_handle_t *handle, mnlxt_data_t *data, struct nlmsghdr *nlh, int strict) {
 	int rc = -1;
 
-	if (NULL == data) {
+	if (NULL == data || NULL == nlh) {
 		errno = EINVAL;
 
 	} else {
-		struct nlmsghdr *nlh;
-		struct rtgenmsg *rtg;
-		char buf[sizeof(struct nlmsghdr) + sizeof(struct rtgenmsg) + 64];
+		data->handlers = data_handlers;
+		data->nhandlers = data_nhandlers;
 
-		if (NULL != (nlh = mnl_nlmsg_put_header(buf))) {
-			nlh->nlmsg_type = type;
+		if (NULL == handle) {
+			mnlxt_connect_opts_t opts = {};
+			if (strict) {
+				opts.flags = MNLXT_FLAG(MNLXT_CONNECT_STRICT_CHK);
+			}
+			rc = mnlxt_data_dump_opts(data, NETLINK_ROUTE, nlh, &opts);
+		} else {
+			rc = mnlxt_handle_dump(handle, data, nlh);
 		}
+	}
 
-		if (NULL != (rtg = mnl_nlmsg_put_extra_header(nlh, sizeof(struct rtgenmsg)))) {
-			rtg->rtgen_family = family;
-		}
+	return rc;
+}
 
+int mnlxt_rt_get_request(mnlxt_handle_t *handle, mnlxt_data_t *data, struct nlmsghdr *nlh) {
+	int rc = -1;
+
+	if (NULL == data || NULL == nlh) {
+		errno = EINVAL;
+
+	} else {
 		data->handlers = data_handlers;
 		data->nhandlers = data_nhandlers;
+		rc = mnlxt_data_get(handle, data, NETLINK_ROUTE, nlh);
+	}
+
+	return rc;
+}
 
-		rc = mnlxt_data_dump(data, NETLINK_ROUTE, nlh);
+static int mnlxt_rt_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, int type, unsigned char family) {
+	int rc = -1;
+
+	if (NULL == data) {
+		errno = EINVAL;
+
+	} else {
+		struct nlmsghdr *nlh;
+		struct rtgenmsg *rtg;
+		char buf[MNL_NLMSG_HDRLEN + MNL_ALIGN(sizeof(struct ifinfomsg)) + 64];
+
+		nlh = mnl_nlmsg_put_header(buf);
+		nlh->nlmsg_type = type;
+
+		/* the family is the first member of all headers */
+		rtg = mnl_nlmsg_put_extra_header(nlh, mnlxt_rt_dump_header_size(type));
+		rtg->rtgen_family = family;
+
+		rc = mnlxt_rt_dump_request(handle, data, nlh, 0);
 	}
 
 	return rc;
 }
 
+int mnlxt_rt_data_dump(mnlxt_data_t *data, int type, unsigned char family) {
+	return mnlxt_rt_dump(NULL, data, type, family);
+}
+
+int mnlxt_rt_handle_data_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, int type, unsigned char family) {
+	return mnlxt_rt_dump(handle, data, type, family);
+}
+
 static const mnlxt_data_cb_t *mnlxt_rt_type_handler(uint16_t type) {
 	const mnlxt_data_cb_t *data_cb = NULL;
 
-	if (data_nhandlers < type) {
+	if (data_nhandlers <= type) {
 		errno = EBADMSG;
 	} else {
 		data_cb = &data_handlers[type];
@@ -89,7 +177,7 @@ static const mnlxt_data_cb_t *mnlxt_rt_type_handler(uint16_t type) {
 	return data_cb;
 }
 
-int mnlxt_rt_message_request(mnlxt_message_t *message) {
+int mnlxt_rt_handle_message_request(mnlxt_handle_t *handle, mnlxt_message_t *message) {
 	const mnlxt_data_cb_t *data_cb;
 	int rc = -1;
 
@@ -97,19 +185,27 @@ int mnlxt_rt_message_request(mnlxt_message_t *message) {
 		errno = EINVAL;
 	} else if (NULL != (data_cb = mnlxt_rt_type_handler(message->nlmsg_type))) {
 		message->handler = data_cb;
-		rc = mnlxt_message_request(message, NETLINK_ROUTE);
+		if (NULL == handle) {
+			rc = mnlxt_message_request(message, NETLINK_ROUTE);
+		} else {
+			rc = mnlxt_handle_request(handle, message);
+		}
 	}
 
 	return rc;
 }
 
-mnlxt_message_t *mnlxt_rt_message_new(uint16_t type, uint16_t flags, void *payload) {
+int mnlxt_rt_message_request(mnlxt_message_t *message) {
+	return mnlxt_rt_handle_message_request(NULL, message);
+}
+
+static mnlxt_message_t *mnlxt_rt_message_create(mnlxt_data_t *data, uint16_t type, uint16_t flags, void *payload) {
 	const mnlxt_data_cb_t *data_cb;
 	mnlxt_message_t *msg = NULL;
 
 	if (NULL == (data_cb = mnlxt_rt_type_handler(type))) {
 		errno = EINVAL;
-	} else if (NULL != (msg = mnlxt_message_new())) {
+	} else if (NULL != (msg = mnlxt_data_message_new(data))) {
 		msg->nlmsg_type = type;
 		msg->flags = flags;
 		msg->payload = payload;
@@ -118,3 +214,11 @@ mnlxt_message_t *mnlxt_rt_message_new(uint16_t type, uint16_t flags, void *paylo
 
 	return msg;
 }
+
+mnlxt_message_t *mnlxt_rt_message_new(uint16_t type, uint16_t flags, void *payload) {
+	return mnlxt_rt_message_create(NULL, type, flags, payload);
+}
+
+mnlxt_message_t *mnlxt_rt_data_message_new(mnlxt_data_t *data, uint16_t type, void *payload) {
+	return mnlxt_rt_message_create(data, type, 0, payload);
+}
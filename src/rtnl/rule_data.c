@@ -12,6 +12,11 @@
 #include <string.h>
 
 #include "libmnlxt/rt.h"
+#include "private/data.h"
+#include "private/hash.h"
+#include "private/identity.h"
+#include "private/internal.h"
+#include "private/reconcile.h"
 
 static int mnlxt_rt_rule_cmp(const mnlxt_rt_rule_t *rt_rule1, const mnlxt_rt_rule_t *rt_rule2,
 														 mnlxt_rt_rule_data_t data) {
@@ -242,9 +247,9 @@ int mnlxt_rt_rule_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 		goto end;
 	}
 
-	rule = mnlxt_rt_rule_new();
+	rule = mnlxt_data_alloc(data, sizeof(mnlxt_rt_rule_t));
 	if (NULL == rule) {
-		data->error_str = "mnlxt_rt_rule_new failed";
+		data->error_str = "mnlxt_data_alloc failed";
 		goto end;
 	}
 
@@ -320,29 +325,33 @@ int mnlxt_rt_rule_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 				data->error_str = "FRA_OIFNAME validation failed";
 				goto end;
 			}
-			if (-1 == mnlxt_rt_rule_set_oif_name(rule, mnl_attr_get_str(attr))) {
-				data->error_str = "mnlxt_rt_rule_set_oif_name failed";
+			if (NULL == rule->oif_name
+					&& NULL == (rule->oif_name = mnlxt_data_strndup(data, mnl_attr_get_str(attr), sizeof(mnlxt_if_name_t) - 1))) {
+				data->error_str = "mnlxt_data_strndup failed";
 				goto end;
 			}
+			MNLXT_SET_PROP_FLAG(rule, MNLXT_RT_RULE_OIFNAME);
 			break;
 		case FRA_IIFNAME:
 			if (0 > mnl_attr_validate(attr, MNL_TYPE_STRING)) {
 				data->error_str = "FRA_IIFNAME validation failed";
 				goto end;
 			}
-			if (-1 == mnlxt_rt_rule_set_iif_name(rule, mnl_attr_get_str(attr))) {
-				data->error_str = "mnlxt_rt_rule_set_iif_name failed";
+			if (NULL == rule->iif_name
+					&& NULL == (rule->iif_name = mnlxt_data_strndup(data, mnl_attr_get_str(attr), sizeof(mnlxt_if_name_t) - 1))) {
+				data->error_str = "mnlxt_data_strndup failed";
 				goto end;
 			}
+			MNLXT_SET_PROP_FLAG(rule, MNLXT_RT_RULE_IIFNAME);
 			break;
 		default:
 			break;
 		}
 	}
 
-	msg = mnlxt_rt_message_new(nlh->nlmsg_type, 0, rule);
+	msg = mnlxt_rt_data_message_new(data, nlh->nlmsg_type, rule);
 	if (NULL == msg) {
-		data->error_str = "mnlxt_rt_message_new failed";
+		data->error_str = "mnlxt_rt_data_message_new failed";
 		goto end;
 	}
 
@@ -351,7 +360,7 @@ int mnlxt_rt_rule_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 	msg = NULL;
 	rc = MNL_CB_OK;
 end:
-	mnlxt_rt_rule_free(rule);
+	mnlxt_data_release(data, rule, mnlxt_rt_rule_FREE);
 	mnlxt_message_free(msg);
 
 	return rc;
@@ -370,20 +379,28 @@ mnlxt_rt_rule_t *mnlxt_rt_rule_iterate(mnlxt_data_t *data, mnlxt_message_t **ite
 }
 
 int mnlxt_rt_rule_dump(mnlxt_data_t *data, unsigned char family) {
+	return mnlxt_rt_rule_handle_dump(NULL, data, family);
+}
+
+int mnlxt_rt_rule_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, unsigned char family) {
 	int rc = -1;
 	if (AF_INET != family && AF_INET6 != family && AF_UNSPEC != family) {
 		errno = EAFNOSUPPORT;
 	} else {
-		rc = mnlxt_rt_data_dump(data, RTM_GETRULE, family);
+		rc = mnlxt_rt_handle_data_dump(handle, data, RTM_GETRULE, family);
 	}
 	return rc;
 }
 
 int mnlxt_rt_rule_request(mnlxt_rt_rule_t *rt_rule, uint16_t type, uint16_t flags) {
+	return mnlxt_rt_rule_handle_request(NULL, rt_rule, type, flags);
+}
+
+int mnlxt_rt_rule_handle_request(mnlxt_handle_t *handle, mnlxt_rt_rule_t *rt_rule, uint16_t type, uint16_t flags) {
 	int rc = -1;
 	mnlxt_message_t *message = mnlxt_rt_rule_message(&rt_rule, type, flags);
 	if (NULL != message) {
-		rc = mnlxt_rt_message_request(message);
+		rc = mnlxt_rt_handle_message_request(handle, message);
 		mnlxt_rt_rule_remove(message);
 		mnlxt_message_free(message);
 	}
@@ -399,3 +416,59 @@ mnlxt_message_t *mnlxt_rt_rule_message(mnlxt_rt_rule_t **rule, uint16_t type, ui
 	}
 	return message;
 }
+
+uint32_t mnlxt_rt_rule_identity_hash(const void *object) {
+	const mnlxt_rt_rule_t *rule = object;
+	uint32_t key[3] = {};
+	if (MNLXT_GET_PROP_FLAG(rule, MNLXT_RT_RULE_FAMILY)) {
+		key[0] = rule->family;
+	}
+	if (MNLXT_GET_PROP_FLAG(rule, MNLXT_RT_RULE_TABLE)) {
+		key[1] = rule->table;
+	}
+	if (MNLXT_GET_PROP_FLAG(rule, MNLXT_RT_RULE_PRIORITY)) {
+		key[2] = rule->priority;
+	}
+	return mnlxt_hash_fnv(key, sizeof(key));
+}
+
+int mnlxt_rt_rule_identity_cmp(const void *object1, const void *object2) {
+	return mnlxt_rt_rule_compare(object1, object2, (MNLXT_FLAG((MNLXT_RT_RULE_MAX)) - 1));
+}
+
+static int mnlxt_rt_rule_reconcile_match(const void *current, const void *desired) {
+	/* the kernel reports properties the desired rule may leave unset */
+	return mnlxt_rt_rule_match(current, desired);
+}
+
+static void *mnlxt_rt_rule_reconcile_get(const mnlxt_message_t *message) {
+	return mnlxt_rt_rule_get(message);
+}
+
+static void *mnlxt_rt_rule_reconcile_clone(const void *object) {
+	const mnlxt_rt_rule_t *rule = object;
+	return mnlxt_rt_rule_clone(rule, rule->prop_flags);
+}
+
+static mnlxt_message_t *mnlxt_rt_rule_reconcile_message(void *object, uint16_t type, uint16_t flags) {
+	mnlxt_rt_rule_t *rule = object;
+	return mnlxt_rt_rule_message(&rule, type, flags);
+}
+
+/* a rule of the same identity has the same properties, so there is nothing to replace */
+static const mnlxt_reconcile_ops_t rule_reconcile_ops = {
+	.hash = mnlxt_rt_rule_identity_hash,
+	.identity = mnlxt_rt_rule_reconcile_match,
+	.match = mnlxt_rt_rule_reconcile_match,
+	.get = mnlxt_rt_rule_reconcile_get,
+	.clone = mnlxt_rt_rule_reconcile_clone,
+	.free = mnlxt_rt_rule_FREE,
+	.message = mnlxt_rt_rule_reconcile_message,
+	.new_type = RTM_NEWRULE,
+	.new_flags = NLM_F_CREATE | NLM_F_EXCL,
+	.del_type = RTM_DELRULE,
+};
+
+int mnlxt_rt_rule_reconcile(mnlxt_data_t *desired, mnlxt_data_t *current, mnlxt_data_t *changes) {
+	return mnlxt_data_reconcile(&rule_reconcile_ops, desired, current, changes);
+}
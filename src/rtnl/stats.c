@@ -0,0 +1,218 @@
+/*
+ * stats.c		Libmnlxt Routing Interface Statistics
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libmnlxt/rt.h"
+#include "private/data.h"
+
+/** slab size of a table update, the slab is reused for each streamed message */
+#define MNLXT_RT_STATS_SLAB_SIZE 1024
+/** initial number of entries of a table */
+#define MNLXT_RT_STATS_TABLE_MIN 64
+
+void mnlxt_rt_stats_free(mnlxt_rt_stats_t *stats) {
+	if (NULL != stats) {
+		free(stats);
+	}
+}
+
+int mnlxt_rt_stats_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
+	int rc = MNL_CB_ERROR;
+	mnlxt_rt_stats_t *stats = NULL;
+	mnlxt_message_t *msg = NULL;
+
+	if (NULL == data) {
+		errno = EINVAL;
+		goto end;
+	}
+
+	if (NULL == nlh) {
+		errno = EINVAL;
+		data->error_str = "invalid arguments";
+		goto end;
+	}
+
+	if (RTM_GETSTATS != nlh->nlmsg_type && RTM_NEWSTATS != nlh->nlmsg_type) {
+		errno = EBADMSG;
+		data->error_str = "unsupported message type";
+		goto end;
+	}
+
+	struct if_stats_msg *ifsm = mnl_nlmsg_get_payload(nlh);
+
+	stats = mnlxt_data_alloc(data, sizeof(mnlxt_rt_stats_t));
+	if (NULL == stats) {
+		data->error_str = "mnlxt_data_alloc failed";
+		goto end;
+	}
+
+	stats->if_index = ifsm->ifindex;
+
+	struct nlattr *attr;
+	mnl_attr_for_each(attr, nlh, sizeof(*ifsm)) {
+		if (IFLA_STATS_LINK_64 == mnl_attr_get_type(attr)) {
+			/* the structure grows with the kernel, copy what both sides know */
+			size_t size = mnl_attr_get_payload_len(attr);
+			if (size > sizeof(stats->stats)) {
+				size = sizeof(stats->stats);
+			}
+			memcpy(&stats->stats, mnl_attr_get_payload(attr), size);
+		}
+	}
+
+	msg = mnlxt_rt_data_message_new(data, nlh->nlmsg_type, stats);
+	if (NULL == msg) {
+		data->error_str = "mnlxt_rt_data_message_new failed";
+		goto end;
+	}
+
+	mnlxt_data_add(data, msg);
+	stats = NULL;
+	msg = NULL;
+	rc = MNL_CB_OK;
+end:
+	mnlxt_data_release(data, stats, mnlxt_rt_stats_FREE);
+	mnlxt_message_free(msg);
+
+	return rc;
+}
+
+mnlxt_rt_stats_t *mnlxt_rt_stats_get(const mnlxt_message_t *message) {
+	mnlxt_rt_stats_t *stats = NULL;
+	if (message && message->payload && (RTM_NEWSTATS == message->nlmsg_type || RTM_GETSTATS == message->nlmsg_type)) {
+		stats = (mnlxt_rt_stats_t *)message->payload;
+	}
+	return stats;
+}
+
+mnlxt_rt_stats_t *mnlxt_rt_stats_iterate(mnlxt_data_t *data, mnlxt_message_t **iterator) {
+	mnlxt_rt_stats_t *stats = NULL;
+	if (iterator) {
+		while ((*iterator = mnlxt_data_iterate(data, *iterator))) {
+			if ((stats = mnlxt_rt_stats_get(*iterator))) {
+				break;
+			}
+		}
+	}
+	return stats;
+}
+
+int mnlxt_rt_stats_dump(mnlxt_data_t *data, uint32_t if_index) {
+	return mnlxt_rt_stats_handle_dump(NULL, data, if_index);
+}
+
+int mnlxt_rt_stats_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, uint32_t if_index) {
+	int rc = -1;
+
+	if (NULL == data) {
+		errno = EINVAL;
+
+	} else {
+		struct nlmsghdr *nlh;
+		struct if_stats_msg *ifsm;
+		char buf[MNL_NLMSG_HDRLEN + MNL_ALIGN(sizeof(struct if_stats_msg))];
+
+		nlh = mnl_nlmsg_put_header(buf);
+		nlh->nlmsg_type = RTM_GETSTATS;
+
+		/* only the 64 bit link counters are filled by the kernel */
+		ifsm = mnl_nlmsg_put_extra_header(nlh, sizeof(*ifsm));
+		ifsm->family = AF_UNSPEC;
+		ifsm->ifindex = if_index;
+		ifsm->filter_mask = IFLA_STATS_FILTER_BIT(IFLA_STATS_LINK_64);
+
+		if (0 == if_index) {
+			rc = mnlxt_rt_dump_request(handle, data, nlh, 0);
+		} else {
+			rc = mnlxt_rt_get_request(handle, data, nlh);
+		}
+	}
+
+	return rc;
+}
+
+static int mnlxt_rt_stats_table_add(mnlxt_message_t *message, void *arg) {
+	mnlxt_rt_stats_table_t *table = arg;
+	mnlxt_rt_stats_t *stats = mnlxt_rt_stats_get(message);
+	if (NULL == stats) {
+		return 0;
+	}
+	if (table->size == table->capacity) {
+		size_t capacity = (table->capacity ? 2 * table->capacity : MNLXT_RT_STATS_TABLE_MIN);
+		mnlxt_rt_stats_t *entries = realloc(table->entries, capacity * sizeof(*entries));
+		if (NULL == entries) {
+			/* stops the stream */
+			return -1;
+		}
+		table->entries = entries;
+		table->capacity = capacity;
+	}
+	table->entries[table->size++] = *stats;
+	return 0;
+}
+
+static int mnlxt_rt_stats_cmp(const void *p1, const void *p2) {
+	const mnlxt_rt_stats_t *stats1 = p1, *stats2 = p2;
+	return (stats1->if_index > stats2->if_index) - (stats1->if_index < stats2->if_index);
+}
+
+int mnlxt_rt_stats_table_update(mnlxt_handle_t *handle, mnlxt_rt_stats_table_t *table, uint32_t if_index) {
+	int rc = -1;
+	mnlxt_data_t data = {};
+	size_t i;
+
+	if (NULL == table) {
+		errno = EINVAL;
+		return rc;
+	}
+
+	table->size = 0;
+	if (0 == mnlxt_data_set_stream(&data, mnlxt_rt_stats_table_add, table)
+			&& 0 == mnlxt_data_use_arena(&data, MNLXT_RT_STATS_SLAB_SIZE)
+			&& 0 == mnlxt_rt_stats_handle_dump(handle, &data, if_index)) {
+		if (data.stream_stopped) {
+			errno = ENOMEM;
+		} else {
+			/* older kernels dump the interfaces in the order of their hash buckets */
+			for (i = 1; i < table->size; ++i) {
+				if (table->entries[i - 1].if_index > table->entries[i].if_index) {
+					qsort(table->entries, table->size, sizeof(*table->entries), mnlxt_rt_stats_cmp);
+					break;
+				}
+			}
+			rc = 0;
+		}
+	}
+	mnlxt_data_clean(&data);
+
+	return rc;
+}
+
+const mnlxt_rt_stats_t *mnlxt_rt_stats_table_find(const mnlxt_rt_stats_table_t *table, uint32_t if_index) {
+	const mnlxt_rt_stats_t *stats = NULL;
+	mnlxt_rt_stats_t key = {.if_index = if_index};
+	if (NULL == table) {
+		errno = EINVAL;
+	} else if (0 < table->size) {
+		stats = bsearch(&key, table->entries, table->size, sizeof(*table->entries), mnlxt_rt_stats_cmp);
+	}
+	return stats;
+}
+
+void mnlxt_rt_stats_table_clean(mnlxt_rt_stats_table_t *table) {
+	if (NULL != table) {
+		free(table->entries);
+		table->entries = NULL;
+		table->size = table->capacity = 0;
+	}
+}
@@ -0,0 +1,418 @@
+/*
+ * event.c		Libmnlxt Xfrm/IPsec Events
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libmnlxt/xfrm.h"
+#include "private/data.h"
+#include "private/internal.h"
+#include "private/xfrm.h"
+
+/** slab size of the arena, which the events of one mnlxt_xfrm_event_process call are parsed into */
+#define MNLXT_XFRM_EVENT_SLAB_SIZE 2048
+
+void mnlxt_xfrm_acquire_free(mnlxt_xfrm_acquire_t *acquire) {
+	if (NULL != acquire) {
+		if (NULL != acquire->policy.tmpls) {
+			free(acquire->policy.tmpls);
+		}
+		free(acquire);
+	}
+}
+
+int mnlxt_xfrm_acquire_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
+	int rc = MNL_CB_ERROR;
+	mnlxt_message_t *msg = NULL;
+	mnlxt_xfrm_acquire_t *acquire = NULL;
+	struct xfrm_user_acquire *xacq = NULL;
+
+	if (NULL == data) {
+		errno = EINVAL;
+		goto end;
+	}
+
+	if (NULL == nlh) {
+		errno = EINVAL;
+		data->error_str = "invalid arguments";
+		goto end;
+	}
+
+	if (XFRM_MSG_ACQUIRE != nlh->nlmsg_type) {
+		errno = EBADMSG;
+		data->error_str = "unsupported message type";
+		goto end;
+	}
+
+	if (mnl_nlmsg_get_payload_len(nlh) < sizeof(struct xfrm_user_acquire)) {
+		errno = EBADMSG;
+		data->error_str = "message too short";
+		goto end;
+	}
+
+	acquire = mnlxt_data_alloc(data, sizeof(mnlxt_xfrm_acquire_t));
+	if (NULL == acquire) {
+		data->error_str = "mnlxt_data_alloc failed";
+		goto end;
+	}
+
+	xacq = mnl_nlmsg_get_payload(nlh);
+	acquire->seq = xacq->seq;
+	acquire->id.family = (AF_UNSPEC != xacq->sel.family ? xacq->sel.family : xacq->policy.sel.family);
+	acquire->id.proto = xacq->id.proto;
+	acquire->id.spi = xacq->id.spi;
+	memcpy(&acquire->id.src, &xacq->saddr, sizeof(acquire->id.src));
+	memcpy(&acquire->id.dst, &xacq->id.daddr, sizeof(acquire->id.dst));
+	mnlxt_xfrm_policy_selector_set(&acquire->sel, &xacq->sel);
+	mnlxt_xfrm_policy_info_set(&acquire->policy, &xacq->policy);
+
+	if (0 != mnlxt_xfrm_policy_attrs(data, &acquire->policy, nlh, sizeof(struct xfrm_user_acquire))) {
+		goto end;
+	}
+
+	msg = mnlxt_xfrm_data_message_new(data, nlh->nlmsg_type, acquire);
+	if (NULL == msg) {
+		data->error_str = "mnlxt_xfrm_data_message_new failed";
+		goto end;
+	}
+
+	mnlxt_data_add(data, msg);
+	acquire = NULL;
+	msg = NULL;
+	rc = MNL_CB_OK;
+end:
+	mnlxt_data_release(data, acquire, mnlxt_xfrm_acquire_FREE);
+	mnlxt_message_free(msg);
+
+	return rc;
+}
+
+mnlxt_xfrm_acquire_t *mnlxt_xfrm_acquire_get(const mnlxt_message_t *message) {
+	mnlxt_xfrm_acquire_t *acquire = NULL;
+	if (message && message->payload && XFRM_MSG_ACQUIRE == message->nlmsg_type) {
+		acquire = (mnlxt_xfrm_acquire_t *)message->payload;
+	}
+	return acquire;
+}
+
+void mnlxt_xfrm_expire_free(mnlxt_xfrm_expire_t *expire) {
+	if (NULL != expire) {
+		free(expire);
+	}
+}
+
+int mnlxt_xfrm_expire_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
+	int rc = MNL_CB_ERROR;
+	mnlxt_message_t *msg = NULL;
+	mnlxt_xfrm_expire_t *expire = NULL;
+	struct xfrm_user_expire *xexp = NULL;
+
+	if (NULL == data) {
+		errno = EINVAL;
+		goto end;
+	}
+
+	if (NULL == nlh) {
+		errno = EINVAL;
+		data->error_str = "invalid arguments";
+		goto end;
+	}
+
+	if (XFRM_MSG_EXPIRE != nlh->nlmsg_type) {
+		errno = EBADMSG;
+		data->error_str = "unsupported message type";
+		goto end;
+	}
+
+	if (mnl_nlmsg_get_payload_len(nlh) < sizeof(struct xfrm_user_expire)) {
+		errno = EBADMSG;
+		data->error_str = "message too short";
+		goto end;
+	}
+
+	expire = mnlxt_data_alloc(data, sizeof(mnlxt_xfrm_expire_t));
+	if (NULL == expire) {
+		data->error_str = "mnlxt_data_alloc failed";
+		goto end;
+	}
+
+	xexp = mnl_nlmsg_get_payload(nlh);
+	expire->hard = xexp->hard;
+	mnlxt_xfrm_state_info_set(&expire->state, &xexp->state);
+
+	if (0 != mnlxt_xfrm_state_attrs(data, &expire->state, nlh, sizeof(struct xfrm_user_expire))) {
+		goto end;
+	}
+
+	msg = mnlxt_xfrm_data_message_new(data, nlh->nlmsg_type, expire);
+	if (NULL == msg) {
+		data->error_str = "mnlxt_xfrm_data_message_new failed";
+		goto end;
+	}
+
+	mnlxt_data_add(data, msg);
+	expire = NULL;
+	msg = NULL;
+	rc = MNL_CB_OK;
+end:
+	mnlxt_data_release(data, expire, mnlxt_xfrm_expire_FREE);
+	mnlxt_message_free(msg);
+
+	return rc;
+}
+
+mnlxt_xfrm_expire_t *mnlxt_xfrm_expire_get(const mnlxt_message_t *message) {
+	mnlxt_xfrm_expire_t *expire = NULL;
+	if (message && message->payload && XFRM_MSG_EXPIRE == message->nlmsg_type) {
+		expire = (mnlxt_xfrm_expire_t *)message->payload;
+	}
+	return expire;
+}
+
+void mnlxt_xfrm_polexpire_free(mnlxt_xfrm_polexpire_t *polexpire) {
+	if (NULL != polexpire) {
+		if (NULL != polexpire->policy.tmpls) {
+			free(polexpire->policy.tmpls);
+		}
+		free(polexpire);
+	}
+}
+
+int mnlxt_xfrm_polexpire_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
+	int rc = MNL_CB_ERROR;
+	mnlxt_message_t *msg = NULL;
+	mnlxt_xfrm_polexpire_t *polexpire = NULL;
+	struct xfrm_user_polexpire *xpexp = NULL;
+
+	if (NULL == data) {
+		errno = EINVAL;
+		goto end;
+	}
+
+	if (NULL == nlh) {
+		errno = EINVAL;
+		data->error_str = "invalid arguments";
+		goto end;
+	}
+
+	if (XFRM_MSG_POLEXPIRE != nlh->nlmsg_type) {
+		errno = EBADMSG;
+		data->error_str = "unsupported message type";
+		goto end;
+	}
+
+	if (mnl_nlmsg_get_payload_len(nlh) < sizeof(struct xfrm_user_polexpire)) {
+		errno = EBADMSG;
+		data->error_str = "message too short";
+		goto end;
+	}
+
+	polexpire = mnlxt_data_alloc(data, sizeof(mnlxt_xfrm_polexpire_t));
+	if (NULL == polexpire) {
+		data->error_str = "mnlxt_data_alloc failed";
+		goto end;
+	}
+
+	xpexp = mnl_nlmsg_get_payload(nlh);
+	polexpire->hard = xpexp->hard;
+	mnlxt_xfrm_policy_info_set(&polexpire->policy, &xpexp->pol);
+
+	if (0 != mnlxt_xfrm_policy_attrs(data, &polexpire->policy, nlh, sizeof(struct xfrm_user_polexpire))) {
+		goto end;
+	}
+
+	msg = mnlxt_xfrm_data_message_new(data, nlh->nlmsg_type, polexpire);
+	if (NULL == msg) {
+		data->error_str = "mnlxt_xfrm_data_message_new failed";
+		goto end;
+	}
+
+	mnlxt_data_add(data, msg);
+	polexpire = NULL;
+	msg = NULL;
+	rc = MNL_CB_OK;
+end:
+	mnlxt_data_release(data, polexpire, mnlxt_xfrm_polexpire_FREE);
+	mnlxt_message_free(msg);
+
+	return rc;
+}
+
+mnlxt_xfrm_polexpire_t *mnlxt_xfrm_polexpire_get(const mnlxt_message_t *message) {
+	mnlxt_xfrm_polexpire_t *polexpire = NULL;
+	if (message && message->payload && XFRM_MSG_POLEXPIRE == message->nlmsg_type) {
+		polexpire = (mnlxt_xfrm_polexpire_t *)message->payload;
+	}
+	return polexpire;
+}
+
+void mnlxt_xfrm_mapping_free(mnlxt_xfrm_mapping_t *mapping) {
+	if (NULL != mapping) {
+		free(mapping);
+	}
+}
+
+int mnlxt_xfrm_mapping_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
+	int rc = MNL_CB_ERROR;
+	mnlxt_message_t *msg = NULL;
+	mnlxt_xfrm_mapping_t *mapping = NULL;
+	struct xfrm_user_mapping *xmap = NULL;
+
+	if (NULL == data) {
+		errno = EINVAL;
+		goto end;
+	}
+
+	if (NULL == nlh) {
+		errno = EINVAL;
+		data->error_str = "invalid arguments";
+		goto end;
+	}
+
+	if (XFRM_MSG_MAPPING != nlh->nlmsg_type) {
+		errno = EBADMSG;
+		data->error_str = "unsupported message type";
+		goto end;
+	}
+
+	if (mnl_nlmsg_get_payload_len(nlh) < sizeof(struct xfrm_user_mapping)) {
+		errno = EBADMSG;
+		data->error_str = "message too short";
+		goto end;
+	}
+
+	mapping = mnlxt_data_alloc(data, sizeof(mnlxt_xfrm_mapping_t));
+	if (NULL == mapping) {
+		data->error_str = "mnlxt_data_alloc failed";
+		goto end;
+	}
+
+	xmap = mnl_nlmsg_get_payload(nlh);
+	mapping->family = xmap->id.family;
+	mapping->proto = xmap->id.proto;
+	mapping->spi = ntohl(xmap->id.spi);
+	mapping->reqid = xmap->reqid;
+	memcpy(&mapping->dst, &xmap->id.daddr, sizeof(mapping->dst));
+	memcpy(&mapping->old_src, &xmap->old_saddr, sizeof(mapping->old_src));
+	memcpy(&mapping->new_src, &xmap->new_saddr, sizeof(mapping->new_src));
+	mapping->old_sport = ntohs(xmap->old_sport);
+	mapping->new_sport = ntohs(xmap->new_sport);
+
+	msg = mnlxt_xfrm_data_message_new(data, nlh->nlmsg_type, mapping);
+	if (NULL == msg) {
+		data->error_str = "mnlxt_xfrm_data_message_new failed";
+		goto end;
+	}
+
+	mnlxt_data_add(data, msg);
+	mapping = NULL;
+	msg = NULL;
+	rc = MNL_CB_OK;
+end:
+	mnlxt_data_release(data, mapping, mnlxt_xfrm_mapping_FREE);
+	mnlxt_message_free(msg);
+
+	return rc;
+}
+
+mnlxt_xfrm_mapping_t *mnlxt_xfrm_mapping_get(const mnlxt_message_t *message) {
+	mnlxt_xfrm_mapping_t *mapping = NULL;
+	if (message && message->payload && XFRM_MSG_MAPPING == message->nlmsg_type) {
+		mapping = (mnlxt_xfrm_mapping_t *)message->payload;
+	}
+	return mapping;
+}
+
+typedef struct {
+	const mnlxt_xfrm_event_cbs_t *cbs;
+	void *arg;
+	int count;
+} mnlxt_xfrm_event_dispatch_t;
+
+static int mnlxt_xfrm_event_dispatch(mnlxt_message_t *message, void *arg) {
+	mnlxt_xfrm_event_dispatch_t *dispatch = arg;
+	const mnlxt_xfrm_event_cbs_t *cbs = dispatch->cbs;
+
+	switch (message->nlmsg_type) {
+	case XFRM_MSG_ACQUIRE:
+		if (cbs->acquire) {
+			cbs->acquire(mnlxt_xfrm_acquire_get(message), dispatch->arg);
+		}
+		break;
+	case XFRM_MSG_EXPIRE:
+		if (cbs->expire) {
+			cbs->expire(mnlxt_xfrm_expire_get(message), dispatch->arg);
+		}
+		break;
+	case XFRM_MSG_POLEXPIRE:
+		if (cbs->polexpire) {
+			cbs->polexpire(mnlxt_xfrm_polexpire_get(message), dispatch->arg);
+		}
+		break;
+	case XFRM_MSG_MAPPING:
+		if (cbs->mapping) {
+			cbs->mapping(mnlxt_xfrm_mapping_get(message), dispatch->arg);
+		}
+		break;
+	default:
+		if (cbs->other) {
+			cbs->other(message, dispatch->arg);
+		}
+		break;
+	}
+	++dispatch->count;
+	return 0;
+}
+
+int mnlxt_xfrm_event_process(mnlxt_handle_t *handle, const mnlxt_xfrm_event_cbs_t *cbs, void *arg) {
+	int rc = -1, ret;
+	mnlxt_buffer_t buffer;
+	mnlxt_data_t data = {};
+	mnlxt_xfrm_event_dispatch_t dispatch = {cbs, arg, 0};
+
+	if (NULL == handle || NULL == cbs) {
+		errno = EINVAL;
+		return rc;
+	}
+	/* the events of all buffers are parsed into the slabs of one arena */
+	if (0 != mnlxt_data_use_arena(&data, MNLXT_XFRM_EVENT_SLAB_SIZE)) {
+		handle->error_str = "mnlxt_data_use_arena failed";
+		return rc;
+	}
+	if (0 != mnlxt_data_set_stream(&data, mnlxt_xfrm_event_dispatch, &dispatch)) {
+		handle->error_str = "mnlxt_data_set_stream failed";
+		mnlxt_data_clean(&data);
+		return rc;
+	}
+	while (1) {
+		memset(&buffer, 0, sizeof(buffer));
+		ret = mnlxt_receive_inplace(handle, &buffer);
+		if (0 == ret) {
+			rc = dispatch.count;
+			break;
+		}
+		if (0 > ret) {
+			/* errno ENOBUFS tells about an overrun */
+			break;
+		}
+		/* events are not answers to a request */
+		buffer.portid = buffer.seq = 0;
+		ret = mnlxt_data_parse(&data, &buffer);
+		mnlxt_buffer_clean(&buffer);
+		if (0 > ret) {
+			handle->error_str = (data.error_str ? data.error_str : "parsing event failed");
+			break;
+		}
+	}
+	mnlxt_data_clean(&data);
+	return rc;
+}
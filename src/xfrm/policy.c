@@ -33,6 +33,7 @@ static struct access_data policy_data[MNLXT_XFRM_POLICY_MAX] = {
 	[MNLXT_XFRM_POLICY_DIR] = policy_ad_init(dir),
 	[MNLXT_XFRM_POLICY_MARK] = policy_ad_init(mark),
 	[MNLXT_XFRM_POLICY_TMPLS] = {}, // special case
+	[MNLXT_XFRM_POLICY_IF_ID] = policy_ad_init(if_id),
 };
 
 mnlxt_xfrm_policy_t *mnlxt_xfrm_policy_new() {
@@ -66,6 +67,9 @@ mnlxt_xfrm_policy_t *mnlxt_xfrm_policy_clone(const mnlxt_xfrm_policy_t *src, uin
 		if (prop_flags) {
 			*dst = *src;
 			dst->tmpls = tmpls;
+			if (NULL == tmpls) {
+				dst->tmpl_num = 0;
+			}
 			tmpls = NULL;
 			dst->prop_flags = prop_flags;
 		}
@@ -391,3 +395,43 @@ int mnlxt_xfrm_policy_set_index(mnlxt_xfrm_policy_t *policy, uint32_t index) {
 int mnlxt_xfrm_policy_get_index(const mnlxt_xfrm_policy_t *policy, uint32_t *index) {
 	return mnlxt_xfrm_policy_get_u32(policy, MNLXT_XFRM_POLICY_INDEX, index);
 }
+
+int mnlxt_xfrm_policy_set_if_id(mnlxt_xfrm_policy_t *policy, uint32_t if_id) {
+	return mnlxt_xfrm_policy_set_u32(policy, MNLXT_XFRM_POLICY_IF_ID, if_id);
+}
+
+int mnlxt_xfrm_policy_get_if_id(const mnlxt_xfrm_policy_t *policy, uint32_t *if_id) {
+	return mnlxt_xfrm_policy_get_u32(policy, MNLXT_XFRM_POLICY_IF_ID, if_id);
+}
+
+int mnlxt_xfrm_policy_set_tmpls(mnlxt_xfrm_policy_t *policy, const mnlxt_xfrm_tmpl_t *tmpls, uint16_t num) {
+	int rc = -1;
+	mnlxt_xfrm_tmpl_t *copy;
+	if (NULL == policy || NULL == tmpls || 0 == num || MNLXT_XFRM_POLICY_TMPL_MAX < num) {
+		errno = EINVAL;
+	} else if (NULL != (copy = malloc(num * sizeof(*copy)))) {
+		memcpy(copy, tmpls, num * sizeof(*copy));
+		if (NULL != policy->tmpls) {
+			free(policy->tmpls);
+		}
+		policy->tmpls = copy;
+		policy->tmpl_num = num;
+		MNLXT_SET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_TMPLS);
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_policy_get_tmpls(const mnlxt_xfrm_policy_t *policy, const mnlxt_xfrm_tmpl_t **tmpls, uint16_t *num) {
+	int rc = -1;
+	if (NULL == policy || NULL == tmpls || NULL == num) {
+		errno = EINVAL;
+	} else if (!MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_TMPLS)) {
+		rc = 1;
+	} else {
+		*tmpls = policy->tmpls;
+		*num = policy->tmpl_num;
+		rc = 0;
+	}
+	return rc;
+}
@@ -12,13 +12,30 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "config.h"
 #include "libmnlxt/xfrm.h"
+#include "private/data.h"
+#include "private/hash.h"
 #include "private/internal.h"
+#include "private/reconcile.h"
+#include "private/xfrm.h"
+
+static int mnlxt_xfrm_tmpl_cmp(const mnlxt_xfrm_tmpl_t *tmpl1, const mnlxt_xfrm_tmpl_t *tmpl2) {
+	size_t addr_size = (AF_INET == tmpl1->family ? sizeof(tmpl1->src.in) : sizeof(tmpl1->src));
+	if (tmpl1->family != tmpl2->family || tmpl1->proto != tmpl2->proto || tmpl1->mode != tmpl2->mode
+			|| tmpl1->share != tmpl2->share || tmpl1->optional != tmpl2->optional || tmpl1->reqid != tmpl2->reqid
+			|| tmpl1->spi != tmpl2->spi || 0 != memcmp(&tmpl1->src, &tmpl2->src, addr_size)
+			|| 0 != memcmp(&tmpl1->dst, &tmpl2->dst, addr_size)) {
+		return 1;
+	}
+	return 0;
+}
 
 static int mnlxt_xfrm_policy_cmp(const mnlxt_xfrm_policy_t *policy1, const mnlxt_xfrm_policy_t *policy2,
 																 mnlxt_xfrm_policy_data_t data) {
 	int rc = data + 1;
 	size_t addr_size;
+	uint16_t i;
 	switch (data) {
 	case MNLXT_XFRM_POLICY_FAMILY:
 		if (policy1->family != policy2->family) {
@@ -93,7 +110,20 @@ static int mnlxt_xfrm_policy_cmp(const mnlxt_xfrm_policy_t *policy1, const mnlxt
 		}
 		break;
 	case MNLXT_XFRM_POLICY_TMPLS:
-		/*TODO*/
+		if (policy1->tmpl_num != policy2->tmpl_num) {
+			goto failed;
+		}
+		/* the order matters, the first template is the outer transformation */
+		for (i = 0; i < policy1->tmpl_num; ++i) {
+			if (0 != mnlxt_xfrm_tmpl_cmp(&policy1->tmpls[i], &policy2->tmpls[i])) {
+				goto failed;
+			}
+		}
+		break;
+	case MNLXT_XFRM_POLICY_IF_ID:
+		if (policy1->if_id != policy2->if_id) {
+			goto failed;
+		}
 		break;
 	}
 	rc = 0;
@@ -158,6 +188,26 @@ mnlxt_xfrm_policy_t *mnlxt_xfrm_policy_remove(mnlxt_message_t *message) {
 	return policy;
 }
 
+static void mnlxt_xfrm_policy_put_tmpls(struct xfrm_user_tmpl *tmpl, const mnlxt_xfrm_tmpl_t *conn, uint16_t num) {
+	uint16_t i;
+	memset(tmpl, 0, num * sizeof(*tmpl));
+	for (i = 0; i < num; ++i, ++tmpl, ++conn) {
+		tmpl->family = conn->family;
+		memcpy(&tmpl->saddr, &conn->src, sizeof(conn->src));
+		memcpy(&tmpl->id.daddr, &conn->dst, sizeof(conn->dst));
+		tmpl->mode = conn->mode;
+		tmpl->id.proto = conn->proto;
+		tmpl->id.spi = conn->spi;
+		tmpl->share = conn->share;
+		tmpl->optional = conn->optional;
+		tmpl->reqid = conn->reqid;
+		/* any algorithm is allowed, like by iproute2 */
+		tmpl->aalgos = ~(uint32_t)0;
+		tmpl->ealgos = ~(uint32_t)0;
+		tmpl->calgos = ~(uint32_t)0;
+	}
+}
+
 int mnlxt_xfrm_policy_put(struct nlmsghdr *nlh, const mnlxt_xfrm_policy_t *policy, uint16_t nlmsg_type) {
 	int rc = -1;
 	uint8_t *dir = NULL;
@@ -166,6 +216,7 @@ int mnlxt_xfrm_policy_put(struct nlmsghdr *nlh, const mnlxt_xfrm_policy_t *polic
 	struct xfrm_userpolicy_id *xpid = NULL;
 	struct xfrm_selector *sel = NULL;
 	struct xfrm_mark mark = {0};
+	struct xfrm_user_tmpl tmpls[MNLXT_XFRM_POLICY_TMPL_MAX];
 
 	if (!policy || !nlh) {
 		errno = EINVAL;
@@ -243,7 +294,23 @@ int mnlxt_xfrm_policy_put(struct nlmsghdr *nlh, const mnlxt_xfrm_policy_t *polic
 				mnl_attr_put(nlh, XFRMA_MARK, sizeof(struct xfrm_mark), &mark);
 				break;
 			case MNLXT_XFRM_POLICY_TMPLS:
-				/*TODO:*/
+				/* the kernel finds the policy to delete without its templates */
+				if (xpinfo && policy->tmpl_num) {
+					if (NULL == policy->tmpls || MNLXT_XFRM_POLICY_TMPL_MAX < policy->tmpl_num) {
+						errno = EINVAL;
+						goto failed;
+					}
+					mnlxt_xfrm_policy_put_tmpls(tmpls, policy->tmpls, policy->tmpl_num);
+					mnl_attr_put(nlh, XFRMA_TMPL, policy->tmpl_num * sizeof(struct xfrm_user_tmpl), tmpls);
+				}
+				break;
+			case MNLXT_XFRM_POLICY_IF_ID:
+#ifdef HAVE_XFRMA_IF_ID
+				mnl_attr_put_u32(nlh, XFRMA_IF_ID, policy->if_id);
+#else
+				errno = EOPNOTSUPP;
+				goto failed;
+#endif
 				break;
 			}
 		}
@@ -253,7 +320,7 @@ failed:
 	return rc;
 }
 
-static void mnlxt_xfrm_policy_selector_set(mnlxt_xfrm_policy_t *policy, struct xfrm_selector *sel) {
+void mnlxt_xfrm_policy_selector_set(mnlxt_xfrm_policy_t *policy, const struct xfrm_selector *sel) {
 	if (policy && sel) {
 		uint8_t family = sel->family;
 		if (AF_UNSPEC == family) {
@@ -278,10 +345,11 @@ static void mnlxt_xfrm_policy_selector_set(mnlxt_xfrm_policy_t *policy, struct x
 	}
 }
 
-static int mnlxt_xfrm_policy_tmpl(mnlxt_xfrm_policy_t *policy, uint16_t num, struct xfrm_user_tmpl tmpls[]) {
+static int mnlxt_xfrm_policy_tmpl(mnlxt_data_t *data, mnlxt_xfrm_policy_t *policy, uint16_t num,
+																	struct xfrm_user_tmpl tmpls[]) {
 	int rc = -1;
-	if (0 < num && tmpls && policy) {
-		mnlxt_xfrm_tmpl_t *conns = calloc(num, sizeof(mnlxt_xfrm_tmpl_t));
+	if (0 < num && tmpls && policy && NULL == policy->tmpls) {
+		mnlxt_xfrm_tmpl_t *conns = mnlxt_data_alloc(data, num * sizeof(mnlxt_xfrm_tmpl_t));
 		if (NULL != conns) {
 			int i = 0;
 			struct xfrm_user_tmpl *tmpl = tmpls;
@@ -296,6 +364,7 @@ static int mnlxt_xfrm_policy_tmpl(mnlxt_xfrm_policy_t *policy, uint16_t num, str
 				conn->proto = tmpl->id.proto;
 				conn->spi = tmpl->id.spi;
 				conn->share = tmpl->share;
+				conn->optional = tmpl->optional;
 				conn->reqid = tmpl->reqid;
 			}
 			policy->tmpls = conns;
@@ -307,15 +376,83 @@ static int mnlxt_xfrm_policy_tmpl(mnlxt_xfrm_policy_t *policy, uint16_t num, str
 	return rc;
 }
 
+void mnlxt_xfrm_policy_info_set(mnlxt_xfrm_policy_t *policy, const struct xfrm_userpolicy_info *xpinfo) {
+	mnlxt_xfrm_policy_selector_set(policy, &xpinfo->sel);
+	mnlxt_xfrm_policy_set_index(policy, xpinfo->index);
+	mnlxt_xfrm_policy_set_dir(policy, xpinfo->dir);
+	mnlxt_xfrm_policy_set_action(policy, xpinfo->action);
+	mnlxt_xfrm_policy_set_priority(policy, xpinfo->priority);
+}
+
+int mnlxt_xfrm_policy_attrs(mnlxt_data_t *data, mnlxt_xfrm_policy_t *policy, const struct nlmsghdr *nlh, size_t offset) {
+	uint16_t attr_len = 0;
+	struct xfrm_mark *mark = NULL;
+	struct xfrm_user_tmpl *tmpls = NULL;
+	struct xfrm_userpolicy_type *upt = NULL;
+	struct nlattr *attr;
+
+	mnl_attr_for_each(attr, nlh, offset) {
+		int type = mnl_attr_get_type(attr);
+		/* skip unsupported attribute in user-space */
+		if (0 > mnl_attr_type_valid(attr, XFRMA_MAX)) {
+			continue;
+		}
+		switch (type) {
+		case XFRMA_TMPL:
+			attr_len = mnl_attr_get_payload_len(attr);
+			if (attr_len % sizeof(struct xfrm_user_tmpl)) {
+				data->error_str = "XFRMA_TMPL validation failed";
+				return -1;
+			}
+			tmpls = mnl_attr_get_payload(attr);
+			if (0 != mnlxt_xfrm_policy_tmpl(data, policy, attr_len / sizeof(struct xfrm_user_tmpl), tmpls)) {
+				data->error_str = "mnlxt_xfrm_policy_tmpl failed";
+				return -1;
+			}
+			break;
+		case XFRMA_POLICY_TYPE:
+			if (0 > mnl_attr_validate2(attr, MNL_TYPE_BINARY, sizeof(struct xfrm_userpolicy_type))) {
+				data->error_str = "XFRMA_POLICY_TYPE validation failed";
+				return -1;
+			}
+			upt = mnl_attr_get_payload(attr);
+			if (XFRM_POLICY_TYPE_MAIN != upt->type) {
+				/* we need just main policies, do we ? */
+				return -1;
+			}
+			break;
+		case XFRMA_MARK:
+			if (0 > mnl_attr_validate2(attr, MNL_TYPE_BINARY, sizeof(struct xfrm_mark))) {
+				data->error_str = "XFRMA_MARK validation failed";
+				return -1;
+			}
+			mark = mnl_attr_get_payload(attr);
+			if (0 != mnlxt_xfrm_policy_set_mark(policy, mark->v, mark->m)) {
+				data->error_str = "mnlxt_xfrm_policy_set_mark failed";
+				return -1;
+			}
+			break;
+#ifdef HAVE_XFRMA_IF_ID
+		case XFRMA_IF_ID:
+			if (0 > mnl_attr_validate(attr, MNL_TYPE_U32)) {
+				data->error_str = "XFRMA_IF_ID validation failed";
+				return -1;
+			}
+			mnlxt_xfrm_policy_set_if_id(policy, mnl_attr_get_u32(attr));
+			break;
+#endif
+		default:
+			break;
+		}
+	}
+	return 0;
+}
+
 int mnlxt_xfrm_policy_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 	int rc = MNL_CB_ERROR;
-	uint16_t attr_len = 0;
 	size_t payload_size = 0;
 	mnlxt_message_t *msg = NULL;
 	mnlxt_xfrm_policy_t *policy = NULL;
-	struct xfrm_mark *mark = NULL;
-	struct xfrm_user_tmpl *tmpls = NULL;
-	struct xfrm_userpolicy_type *upt = NULL;
 
 	if (NULL == data) {
 		errno = EINVAL;
@@ -344,74 +481,43 @@ int mnlxt_xfrm_policy_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 		goto end;
 	}
 
-	policy = mnlxt_xfrm_policy_new();
+	policy = mnlxt_data_alloc(data, sizeof(mnlxt_xfrm_policy_t));
 	if (NULL == policy) {
-		data->error_str = "mnlxt_xfrm_policy_new failed";
+		data->error_str = "mnlxt_data_alloc failed";
 		goto end;
 	}
 
+	if (NULL != xpid) {
+		/* a deletion event carries the deleted policy, a deletion request its selector or index only */
+		struct nlattr *attr;
+		mnl_attr_for_each(attr, nlh, payload_size) {
+			if (XFRMA_POLICY == mnl_attr_get_type(attr)) {
+				if (0 > mnl_attr_validate2(attr, MNL_TYPE_BINARY, sizeof(struct xfrm_userpolicy_info))) {
+					data->error_str = "XFRMA_POLICY validation failed";
+					goto end;
+				}
+				xpinfo = mnl_attr_get_payload(attr);
+				break;
+			}
+		}
+	}
 	if (NULL != xpinfo) {
-		mnlxt_xfrm_policy_selector_set(policy, &xpinfo->sel);
-		mnlxt_xfrm_policy_set_index(policy, xpinfo->index);
-		mnlxt_xfrm_policy_set_dir(policy, xpinfo->dir);
-		mnlxt_xfrm_policy_set_action(policy, xpinfo->action);
-		mnlxt_xfrm_policy_set_priority(policy, xpinfo->priority);
+		mnlxt_xfrm_policy_info_set(policy, xpinfo);
 	} else if (NULL != xpid) {
 		mnlxt_xfrm_policy_selector_set(policy, &xpid->sel);
-		mnlxt_xfrm_policy_set_index(policy, xpid->index);
+		if (0 != xpid->index) {
+			mnlxt_xfrm_policy_set_index(policy, xpid->index);
+		}
 		mnlxt_xfrm_policy_set_dir(policy, xpid->dir);
 	}
 
-	struct nlattr *attr;
-	mnl_attr_for_each(attr, nlh, payload_size) {
-		int type = mnl_attr_get_type(attr);
-		/* skip unsupported attribute in user-space */
-		if (0 > mnl_attr_type_valid(attr, XFRMA_MAX)) {
-			continue;
-		}
-		switch (type) {
-		case XFRMA_TMPL:
-			attr_len = mnl_attr_get_len(attr);
-			if (attr_len % sizeof(struct xfrm_user_tmpl)) {
-				data->error_str = "XFRMA_TMPL validation failed";
-				goto end;
-			}
-			tmpls = mnl_attr_get_payload(attr);
-			if (0 != mnlxt_xfrm_policy_tmpl(policy, attr_len / sizeof(struct xfrm_user_tmpl), tmpls)) {
-				data->error_str = "mnlxt_xfrm_policy_tmpl failed";
-				goto end;
-			}
-			break;
-		case XFRMA_POLICY_TYPE:
-			if (0 > mnl_attr_validate2(attr, MNL_TYPE_BINARY, sizeof(struct xfrm_userpolicy_type))) {
-				data->error_str = "XFRMA_POLICY_TYPE validation failed";
-				goto end;
-			}
-			upt = mnl_attr_get_payload(attr);
-			if (XFRM_POLICY_TYPE_MAIN != upt->type) {
-				/* we need just main policies, do we ? */
-				goto end;
-			}
-			break;
-		case XFRMA_MARK:
-			if (0 > mnl_attr_validate2(attr, MNL_TYPE_BINARY, sizeof(struct xfrm_mark))) {
-				data->error_str = "XFRMA_MARK validation failed";
-				goto end;
-			}
-			mark = mnl_attr_get_payload(attr);
-			if (0 != mnlxt_xfrm_policy_set_mark(policy, mark->v, mark->m)) {
-				data->error_str = "mnlxt_xfrm_policy_set_mark failed";
-				goto end;
-			}
-			break;
-		default:
-			break;
-		}
+	if (0 != mnlxt_xfrm_policy_attrs(data, policy, nlh, payload_size)) {
+		goto end;
 	}
 
-	msg = mnlxt_xfrm_message_new(nlh->nlmsg_type, 0, policy);
+	msg = mnlxt_xfrm_data_message_new(data, nlh->nlmsg_type, policy);
 	if (NULL == msg) {
-		data->error_str = "mnlxt_xfrm_message_new failed";
+		data->error_str = "mnlxt_xfrm_data_message_new failed";
 		goto end;
 	}
 
@@ -420,7 +526,7 @@ int mnlxt_xfrm_policy_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
 	msg = NULL;
 	rc = MNL_CB_OK;
 end:
-	mnlxt_xfrm_policy_free(policy);
+	mnlxt_data_release(data, policy, mnlxt_xfrm_policy_FREE);
 	mnlxt_message_free(msg);
 
 	return rc;
@@ -439,14 +545,23 @@ mnlxt_xfrm_policy_t *mnlxt_xfrm_policy_iterate(mnlxt_data_t *data, mnlxt_message
 }
 
 int mnlxt_xfrm_policy_dump(mnlxt_data_t *data) {
-	return mnlxt_xfrm_data_dump(data, XFRM_MSG_GETPOLICY);
+	return mnlxt_xfrm_policy_handle_dump(NULL, data);
+}
+
+int mnlxt_xfrm_policy_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data) {
+	return mnlxt_xfrm_handle_data_dump(handle, data, XFRM_MSG_GETPOLICY);
 }
 
 int mnlxt_xfrm_policy_request(mnlxt_xfrm_policy_t *xfrm_policy, uint16_t type, uint16_t flags) {
+	return mnlxt_xfrm_policy_handle_request(NULL, xfrm_policy, type, flags);
+}
+
+int mnlxt_xfrm_policy_handle_request(mnlxt_handle_t *handle, mnlxt_xfrm_policy_t *xfrm_policy, uint16_t type,
+																		 uint16_t flags) {
 	int rc = -1;
 	mnlxt_message_t *message = mnlxt_xfrm_policy_message(&xfrm_policy, type, flags);
 	if (NULL != message) {
-		rc = mnlxt_xfrm_message_request(message);
+		rc = mnlxt_xfrm_handle_message_request(handle, message);
 		mnlxt_xfrm_policy_remove(message);
 		mnlxt_message_free(message);
 	}
@@ -463,3 +578,219 @@ mnlxt_message_t *mnlxt_xfrm_policy_message(mnlxt_xfrm_policy_t **policy, uint16_
 	}
 	return message;
 }
+
+static uint32_t mnlxt_xfrm_policy_identity_hash(const void *object) {
+	const mnlxt_xfrm_policy_t *policy = object;
+	struct {
+		uint8_t family;
+		uint8_t proto;
+		uint8_t dir;
+		uint8_t padding;
+		uint32_t if_index;
+		uint32_t if_id;
+		mnlxt_xfrm_site_t src;
+		mnlxt_xfrm_site_t dst;
+		mnlxt_xfrm_mark_t mark;
+	} key;
+	size_t addr_size;
+	memset(&key, 0, sizeof(key));
+	if (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_FAMILY)) {
+		key.family = policy->family;
+	}
+	if (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_PROTO)) {
+		key.proto = policy->proto;
+	}
+	if (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_DIR)) {
+		key.dir = policy->dir;
+	}
+	if (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_IFINDEX)) {
+		key.if_index = policy->if_index;
+	}
+	if (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_IF_ID)) {
+		key.if_id = policy->if_id;
+	}
+	if (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_SRC_PREFIXLEN)) {
+		key.src.prefixlen = policy->src.prefixlen;
+	}
+	if (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_DST_PREFIXLEN)) {
+		key.dst.prefixlen = policy->dst.prefixlen;
+	}
+	if (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_SRC_PORT)) {
+		key.src.port = policy->src.port;
+	}
+	if (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_DST_PORT)) {
+		key.dst.port = policy->dst.port;
+	}
+	/* the compare ignores the unused part of IPv4 addresses */
+	addr_size = (AF_INET == key.family ? sizeof(policy->src.addr.in) : sizeof(policy->src.addr));
+	if (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_SRC_ADDR)) {
+		memcpy(&key.src.addr, &policy->src.addr, addr_size);
+	}
+	if (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_DST_ADDR)) {
+		memcpy(&key.dst.addr, &policy->dst.addr, addr_size);
+	}
+	if (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_MARK)) {
+		key.mark = policy->mark;
+	}
+	return mnlxt_hash_fnv(&key, sizeof(key));
+}
+
+static int mnlxt_xfrm_policy_identity_cmp(const void *object1, const void *object2) {
+	return mnlxt_xfrm_policy_compare(object1, object2, MNLXT_XFRM_POLICY_IDENTITY_FILTER);
+}
+
+static int mnlxt_xfrm_policy_reconcile_match(const void *current, const void *desired) {
+	return mnlxt_xfrm_policy_match(current, desired);
+}
+
+static void *mnlxt_xfrm_policy_reconcile_get(const mnlxt_message_t *message) {
+	return mnlxt_xfrm_policy_get(message);
+}
+
+static void *mnlxt_xfrm_policy_reconcile_clone(const void *object) {
+	const mnlxt_xfrm_policy_t *policy = object;
+	return mnlxt_xfrm_policy_clone(policy, policy->prop_flags);
+}
+
+static mnlxt_message_t *mnlxt_xfrm_policy_reconcile_message(void *object, uint16_t type, uint16_t flags) {
+	mnlxt_xfrm_policy_t *policy = object;
+	return mnlxt_xfrm_policy_message(&policy, type, flags);
+}
+
+static const mnlxt_reconcile_ops_t policy_reconcile_ops = {
+	.hash = mnlxt_xfrm_policy_identity_hash,
+	.identity = mnlxt_xfrm_policy_identity_cmp,
+	.match = mnlxt_xfrm_policy_reconcile_match,
+	.get = mnlxt_xfrm_policy_reconcile_get,
+	.clone = mnlxt_xfrm_policy_reconcile_clone,
+	.free = mnlxt_xfrm_policy_FREE,
+	.message = mnlxt_xfrm_policy_reconcile_message,
+	.new_type = XFRM_MSG_NEWPOLICY,
+	.replace_type = XFRM_MSG_UPDPOLICY,
+	.del_type = XFRM_MSG_DELPOLICY,
+};
+
+int mnlxt_xfrm_policy_reconcile(mnlxt_data_t *desired, mnlxt_data_t *current, mnlxt_data_t *changes) {
+	return mnlxt_data_reconcile(&policy_reconcile_ops, desired, current, changes);
+}
+
+int mnlxt_xfrm_policy_flush(mnlxt_handle_t *handle, uint8_t type) {
+	int rc = -1;
+	mnlxt_data_t data = {};
+	struct nlmsghdr *nlh;
+	char buf[MNL_NLMSG_HDRLEN + MNL_ATTR_HDRLEN + MNL_ALIGN(sizeof(struct xfrm_userpolicy_type))];
+
+	if (XFRM_POLICY_TYPE_MAIN != type && XFRM_POLICY_TYPE_SUB != type) {
+		errno = EINVAL;
+		return rc;
+	}
+
+	nlh = mnl_nlmsg_put_header(buf);
+	nlh->nlmsg_type = XFRM_MSG_FLUSHPOLICY;
+	if (XFRM_POLICY_TYPE_MAIN != type) {
+		/* without the attribute the kernel flushes the main policies */
+		struct xfrm_userpolicy_type upt = {.type = type};
+		mnl_attr_put(nlh, XFRMA_POLICY_TYPE, sizeof(upt), &upt);
+	}
+	/* the kernel answers with the acknowledge only */
+	rc = mnlxt_xfrm_get_request(handle, &data, nlh);
+	mnlxt_data_clean(&data);
+
+	return rc;
+}
+
+/* checks if the selector prefix of site lies within the prefix */
+static int mnlxt_xfrm_site_within(const mnlxt_xfrm_site_t *site, const mnlxt_xfrm_site_t *prefix) {
+	const uint8_t *addr = (const uint8_t *)&site->addr, *net = (const uint8_t *)&prefix->addr;
+	uint8_t bytes = prefix->prefixlen / 8, bits = prefix->prefixlen % 8;
+
+	if (site->prefixlen < prefix->prefixlen || 0 != memcmp(addr, net, bytes)) {
+		return 0;
+	}
+	return 0 == bits || 0 == ((addr[bytes] ^ net[bytes]) & (uint8_t)(0xff << (8 - bits)));
+}
+
+static int mnlxt_xfrm_policy_flush_matches(const mnlxt_xfrm_policy_t *policy, const mnlxt_xfrm_policy_t *match) {
+	const uint64_t src_prefix = MNLXT_FLAG(MNLXT_XFRM_POLICY_SRC_ADDR) | MNLXT_FLAG(MNLXT_XFRM_POLICY_SRC_PREFIXLEN);
+	const uint64_t dst_prefix = MNLXT_FLAG(MNLXT_XFRM_POLICY_DST_ADDR) | MNLXT_FLAG(MNLXT_XFRM_POLICY_DST_PREFIXLEN);
+	uint64_t filter = match->prop_flags;
+
+	if (src_prefix == (filter & src_prefix)) {
+		if (src_prefix != (policy->prop_flags & src_prefix) || !mnlxt_xfrm_site_within(&policy->src, &match->src)) {
+			return 0;
+		}
+		filter &= ~src_prefix;
+	}
+	if (dst_prefix == (filter & dst_prefix)) {
+		if (dst_prefix != (policy->prop_flags & dst_prefix) || !mnlxt_xfrm_site_within(&policy->dst, &match->dst)) {
+			return 0;
+		}
+		filter &= ~dst_prefix;
+	}
+	return 0 == mnlxt_xfrm_policy_compare(policy, match, filter);
+}
+
+int mnlxt_xfrm_policy_flush_match(mnlxt_handle_t *handle, const mnlxt_xfrm_policy_t *match) {
+	int rc = -1, error = 0;
+	mnlxt_handle_t temp_handle = {};
+	mnlxt_data_t current = {}, changes = {};
+	mnlxt_message_t *it = NULL, *message;
+	mnlxt_xfrm_policy_t *policy, *del;
+
+	if (NULL == match) {
+		errno = EINVAL;
+		return rc;
+	}
+
+	if (NULL == handle) {
+		if (0 != mnlxt_xfrm_connect(&temp_handle, 0)) {
+			return rc;
+		}
+		handle = &temp_handle;
+	}
+
+	if (0 != mnlxt_xfrm_policy_handle_dump(handle, &current)) {
+		goto end;
+	}
+
+	while ((policy = mnlxt_xfrm_policy_iterate(&current, &it))) {
+		if (!mnlxt_xfrm_policy_flush_matches(policy, match)) {
+			continue;
+		}
+		/* the templates do not identify a policy */
+		del = mnlxt_xfrm_policy_clone(policy, policy->prop_flags & ~MNLXT_FLAG(MNLXT_XFRM_POLICY_TMPLS));
+		if (NULL == del) {
+			goto end;
+		}
+		message = mnlxt_xfrm_policy_message(&del, XFRM_MSG_DELPOLICY, 0);
+		if (NULL == message) {
+			mnlxt_xfrm_policy_free(del);
+			goto end;
+		}
+		mnlxt_data_add(&changes, message);
+	}
+
+	if (0 > mnlxt_handle_batch_request(handle, &changes)) {
+		goto end;
+	}
+
+	rc = 0;
+	for (message = changes.first; NULL != message; message = message->next) {
+		if (0 == message->error) {
+			++rc;
+		} else if (-ENOENT != message->error && 0 == error) {
+			/* policies deleted meanwhile are gone anyway */
+			error = -message->error;
+		}
+	}
+	if (error) {
+		errno = error;
+		rc = -1;
+	}
+end:
+	mnlxt_data_clean(&changes);
+	mnlxt_data_clean(&current);
+	mnlxt_disconnect(&temp_handle);
+
+	return rc;
+}
@@ -0,0 +1,342 @@
+/*
+ * spd.c		Libmnlxt Xfrm/IPsec Security Policy Database Classifier
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+
+#include "libmnlxt/xfrm.h"
+#include "private/internal.h"
+#include "private/xfrm.h"
+#include "private/trie.h"
+
+/* policies of one source and destination prefix, ordered by priority and index */
+typedef struct mnlxt_xfrm_spd_entry_s {
+	struct mnlxt_xfrm_spd_entry_s *next;
+	uint32_t priority;
+	uint32_t index;
+	mnlxt_xfrm_policy_t *policy;
+} mnlxt_xfrm_spd_entry_t;
+
+struct mnlxt_xfrm_spd_s {
+	/** destination tries of AF_INET and AF_INET6 per direction, their values are source tries */
+	mnlxt_trie_t tries[XFRM_POLICY_MAX][2];
+	size_t count;
+};
+
+/* gets the destination trie of a direction and family, and the address length in bits */
+static mnlxt_trie_t *mnlxt_xfrm_spd_trie(const mnlxt_xfrm_spd_t *spd, uint8_t dir, uint8_t family, uint8_t *bits) {
+	mnlxt_trie_t *trie = NULL;
+	if (XFRM_POLICY_MAX <= dir) {
+		errno = EINVAL;
+	} else if (AF_INET == family) {
+		trie = (mnlxt_trie_t *)&spd->tries[dir][0];
+		*bits = 32;
+	} else if (AF_INET6 == family) {
+		trie = (mnlxt_trie_t *)&spd->tries[dir][1];
+		*bits = 128;
+	} else {
+		errno = EAFNOSUPPORT;
+	}
+	return trie;
+}
+
+/* gets destination trie and selector prefixes of a policy */
+static mnlxt_trie_t *mnlxt_xfrm_spd_policy_trie(const mnlxt_xfrm_spd_t *spd, const mnlxt_xfrm_policy_t *policy,
+																								uint8_t *src_prefix, uint8_t *dst_prefix) {
+	mnlxt_trie_t *trie = NULL;
+	uint8_t bits;
+	if (!MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_FAMILY) || !MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_DIR)) {
+		errno = EINVAL;
+	} else if (NULL != (trie = mnlxt_xfrm_spd_trie(spd, policy->dir, policy->family, &bits))) {
+		*src_prefix = (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_SRC_PREFIXLEN) ? policy->src.prefixlen : 0);
+		*dst_prefix = (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_DST_PREFIXLEN) ? policy->dst.prefixlen : 0);
+		if (bits < *src_prefix || bits < *dst_prefix
+				|| (*src_prefix && !MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_SRC_ADDR))
+				|| (*dst_prefix && !MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_DST_ADDR))) {
+			errno = EINVAL;
+			trie = NULL;
+		}
+	}
+	return trie;
+}
+
+static uint32_t mnlxt_xfrm_spd_policy_index(const mnlxt_xfrm_policy_t *policy) {
+	return (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_INDEX) ? policy->index : 0);
+}
+
+/* checks if entry holds the policy of key, which is identified by its index or else by its selector */
+static int mnlxt_xfrm_spd_entry_is(const mnlxt_xfrm_spd_entry_t *entry, const mnlxt_xfrm_policy_t *key) {
+	if (MNLXT_GET_PROP_FLAG(key, MNLXT_XFRM_POLICY_INDEX)) {
+		return MNLXT_GET_PROP_FLAG(entry->policy, MNLXT_XFRM_POLICY_INDEX) && entry->index == key->index;
+	}
+	return !MNLXT_GET_PROP_FLAG(entry->policy, MNLXT_XFRM_POLICY_INDEX)
+				 && 0 == mnlxt_xfrm_policy_compare(entry->policy, key, MNLXT_XFRM_POLICY_IDENTITY_FILTER);
+}
+
+/* checks if entry takes precedence over other */
+static int mnlxt_xfrm_spd_entry_before(const mnlxt_xfrm_spd_entry_t *entry, const mnlxt_xfrm_spd_entry_t *other) {
+	return entry->priority < other->priority || (entry->priority == other->priority && entry->index < other->index);
+}
+
+/* checks the selector properties not covered by the tries */
+static int mnlxt_xfrm_spd_entry_matches(const mnlxt_xfrm_spd_entry_t *entry, const mnlxt_xfrm_flow_t *flow) {
+	const mnlxt_xfrm_policy_t *policy = entry->policy;
+	return (!MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_PROTO) || policy->proto == flow->proto)
+				 && (!MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_SRC_PORT) || policy->src.port == flow->src_port)
+				 && (!MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_DST_PORT) || policy->dst.port == flow->dst_port)
+				 && (!MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_IFINDEX) || policy->if_index == flow->if_index)
+				 && (!MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_MARK)
+						 || (flow->mark & policy->mark.mask) == policy->mark.value);
+}
+
+static void mnlxt_xfrm_spd_entry_free(void *value) {
+	mnlxt_xfrm_spd_entry_t *entry = value;
+	while (entry) {
+		mnlxt_xfrm_spd_entry_t *next = entry->next;
+		mnlxt_xfrm_policy_free(entry->policy);
+		free(entry);
+		entry = next;
+	}
+}
+
+static void mnlxt_xfrm_spd_src_free(void *value) {
+	mnlxt_trie_clean((mnlxt_trie_t *)value, mnlxt_xfrm_spd_entry_free);
+	free(value);
+}
+
+mnlxt_xfrm_spd_t *mnlxt_xfrm_spd_new() {
+	return calloc(1, sizeof(mnlxt_xfrm_spd_t));
+}
+
+void mnlxt_xfrm_spd_free(mnlxt_xfrm_spd_t *spd) {
+	if (spd) {
+		int dir, family;
+		for (dir = 0; dir < XFRM_POLICY_MAX; ++dir) {
+			for (family = 0; family < 2; ++family) {
+				mnlxt_trie_clean(&spd->tries[dir][family], mnlxt_xfrm_spd_src_free);
+			}
+		}
+		free(spd);
+	}
+}
+
+size_t mnlxt_xfrm_spd_count(const mnlxt_xfrm_spd_t *spd) {
+	size_t count = 0;
+	if (spd) {
+		count = spd->count;
+	} else {
+		errno = EINVAL;
+	}
+	return count;
+}
+
+/* drops the source prefix and the source trie of a key if they are left without policies */
+static void mnlxt_xfrm_spd_prune(mnlxt_trie_t *trie, const mnlxt_xfrm_policy_t *key, uint8_t src_prefix,
+																 uint8_t dst_prefix) {
+	mnlxt_trie_t **src_trie = (mnlxt_trie_t **)mnlxt_trie_find(trie, (const uint8_t *)&key->dst.addr, dst_prefix);
+	if (NULL == src_trie) {
+		/* a prefix without value left by a failed insert */
+		mnlxt_trie_remove(trie, (const uint8_t *)&key->dst.addr, dst_prefix);
+		return;
+	}
+	if (NULL == mnlxt_trie_find(*src_trie, (const uint8_t *)&key->src.addr, src_prefix)) {
+		mnlxt_trie_remove(*src_trie, (const uint8_t *)&key->src.addr, src_prefix);
+	}
+	if (NULL == (*src_trie)->root) {
+		free(mnlxt_trie_remove(trie, (const uint8_t *)&key->dst.addr, dst_prefix));
+	}
+}
+
+/* inserts an entry into the list of its prefixes by priority and index */
+static void mnlxt_xfrm_spd_entry_insert(mnlxt_xfrm_spd_entry_t **link, mnlxt_xfrm_spd_entry_t *entry) {
+	while (*link && mnlxt_xfrm_spd_entry_before(*link, entry)) {
+		link = &(*link)->next;
+	}
+	entry->next = *link;
+	*link = entry;
+}
+
+int mnlxt_xfrm_spd_add(mnlxt_xfrm_spd_t *spd, mnlxt_xfrm_policy_t *policy) {
+	int rc = -1;
+	mnlxt_trie_t *trie, **src_trie;
+	mnlxt_xfrm_spd_entry_t **head = NULL, **link, *entry;
+	uint8_t src_prefix, dst_prefix;
+
+	if (NULL == spd || NULL == policy) {
+		errno = EINVAL;
+		goto end;
+	}
+	if (NULL == (trie = mnlxt_xfrm_spd_policy_trie(spd, policy, &src_prefix, &dst_prefix))) {
+		goto end;
+	}
+	if (NULL == (src_trie = (mnlxt_trie_t **)mnlxt_trie_insert(trie, (const uint8_t *)&policy->dst.addr, dst_prefix))
+			|| (NULL == *src_trie && NULL == (*src_trie = calloc(1, sizeof(mnlxt_trie_t))))
+			|| NULL == (head = (mnlxt_xfrm_spd_entry_t **)mnlxt_trie_insert(*src_trie, (const uint8_t *)&policy->src.addr,
+																																			src_prefix))) {
+		goto failed;
+	}
+	/* an updated policy keeps its index, but may change its priority */
+	link = head;
+	while (*link && !mnlxt_xfrm_spd_entry_is(*link, policy)) {
+		link = &(*link)->next;
+	}
+	if (NULL != (entry = *link)) {
+		*link = entry->next;
+		mnlxt_xfrm_policy_free(entry->policy);
+		rc = 1;
+	} else if (NULL != (entry = malloc(sizeof(mnlxt_xfrm_spd_entry_t)))) {
+		++spd->count;
+		rc = 0;
+	} else {
+		goto failed;
+	}
+	entry->priority = (MNLXT_GET_PROP_FLAG(policy, MNLXT_XFRM_POLICY_PRIO) ? policy->priority : 0);
+	entry->index = mnlxt_xfrm_spd_policy_index(policy);
+	entry->policy = policy;
+	mnlxt_xfrm_spd_entry_insert(head, entry);
+	goto end;
+failed:
+	mnlxt_xfrm_spd_prune(trie, policy, src_prefix, dst_prefix);
+end:
+	return rc;
+}
+
+mnlxt_xfrm_policy_t *mnlxt_xfrm_spd_remove(mnlxt_xfrm_spd_t *spd, const mnlxt_xfrm_policy_t *key) {
+	mnlxt_xfrm_policy_t *policy = NULL;
+	mnlxt_trie_t *trie, **src_trie;
+	mnlxt_xfrm_spd_entry_t **link, *entry;
+	uint8_t src_prefix, dst_prefix;
+
+	if (NULL == spd || NULL == key) {
+		errno = EINVAL;
+	} else if (NULL != (trie = mnlxt_xfrm_spd_policy_trie(spd, key, &src_prefix, &dst_prefix))
+						 && NULL != (src_trie = (mnlxt_trie_t **)mnlxt_trie_find(trie, (const uint8_t *)&key->dst.addr,
+																																			 dst_prefix))
+						 && NULL != (link = (mnlxt_xfrm_spd_entry_t **)mnlxt_trie_find(*src_trie, (const uint8_t *)&key->src.addr,
+																																					 src_prefix))) {
+		/* the priority of a deleted policy may be unknown */
+		while (*link && !mnlxt_xfrm_spd_entry_is(*link, key)) {
+			link = &(*link)->next;
+		}
+		if (NULL != (entry = *link)) {
+			policy = entry->policy;
+			*link = entry->next;
+			free(entry);
+			--spd->count;
+			mnlxt_xfrm_spd_prune(trie, key, src_prefix, dst_prefix);
+		}
+	}
+	return policy;
+}
+
+int mnlxt_xfrm_spd_update(mnlxt_xfrm_spd_t *spd, const mnlxt_message_t *message) {
+	int rc = -1;
+	mnlxt_xfrm_policy_t *policy = mnlxt_xfrm_policy_get(message), *removed;
+	mnlxt_xfrm_polexpire_t *polexpire = mnlxt_xfrm_polexpire_get(message);
+
+	if (NULL == spd || (NULL == policy && NULL == polexpire)) {
+		errno = EINVAL;
+	} else if (NULL != polexpire && !polexpire->hard) {
+		/* the policy stays until its hard lifetime expires */
+		rc = 0;
+	} else if (NULL != polexpire || XFRM_MSG_DELPOLICY == message->nlmsg_type) {
+		if (NULL != (removed = mnlxt_xfrm_spd_remove(spd, (polexpire ? &polexpire->policy : policy)))) {
+			mnlxt_xfrm_policy_free(removed);
+			rc = 0;
+		} else {
+			rc = 1;
+		}
+	} else {
+		mnlxt_xfrm_policy_t *copy = mnlxt_xfrm_policy_clone(policy, policy->prop_flags);
+		if (NULL != copy && 0 <= mnlxt_xfrm_spd_add(spd, copy)) {
+			rc = 0;
+		} else {
+			mnlxt_xfrm_policy_free(copy);
+		}
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_spd_load(mnlxt_xfrm_spd_t *spd, const mnlxt_data_t *data) {
+	int rc = -1;
+	mnlxt_message_t *msg;
+
+	if (NULL == spd || NULL == data) {
+		errno = EINVAL;
+		goto end;
+	}
+	for (msg = data->first; NULL != msg; msg = msg->next) {
+		mnlxt_xfrm_policy_t *policy = mnlxt_xfrm_policy_get(msg);
+		if (XFRM_MSG_DELPOLICY == msg->nlmsg_type || NULL == policy) {
+			continue;
+		}
+		if (0 > mnlxt_xfrm_spd_update(spd, msg)) {
+			goto end;
+		}
+	}
+	rc = 0;
+end:
+	return rc;
+}
+
+const mnlxt_xfrm_policy_t *mnlxt_xfrm_spd_lookup(const mnlxt_xfrm_spd_t *spd, uint8_t dir, uint8_t family,
+																								 const mnlxt_xfrm_flow_t *flow) {
+	const mnlxt_xfrm_policy_t *policy = NULL;
+	if (NULL == flow || 1 != mnlxt_xfrm_spd_lookup_batch(spd, dir, family, flow, &policy, 1)) {
+		policy = NULL;
+	}
+	return policy;
+}
+
+int mnlxt_xfrm_spd_lookup_batch(const mnlxt_xfrm_spd_t *spd, uint8_t dir, uint8_t family,
+																const mnlxt_xfrm_flow_t *flows, const mnlxt_xfrm_policy_t **policies, size_t count) {
+	int rc = -1;
+	const mnlxt_trie_t *trie;
+	/* values of all prefixes along a path, at most one per prefix length */
+	void *src_tries[129], *entries[129];
+	size_t i, d, s, ndst, nsrc;
+	uint8_t bits;
+
+	if (NULL == spd || (count && (NULL == flows || NULL == policies))) {
+		errno = EINVAL;
+		goto end;
+	}
+	/* the trie is resolved once for the whole batch */
+	if (NULL == (trie = mnlxt_xfrm_spd_trie(spd, dir, family, &bits))) {
+		goto end;
+	}
+	rc = 0;
+	for (i = 0; i < count; ++i) {
+		const mnlxt_xfrm_spd_entry_t *best = NULL, *entry;
+		ndst = mnlxt_trie_prefixes(trie, (const uint8_t *)&flows[i].dst, bits, src_tries, MNL_ARRAY_SIZE(src_tries));
+		for (d = 0; d < ndst; ++d) {
+			nsrc = mnlxt_trie_prefixes(src_tries[d], (const uint8_t *)&flows[i].src, bits, entries,
+																 MNL_ARRAY_SIZE(entries));
+			for (s = 0; s < nsrc; ++s) {
+				/* only policies taking precedence over the best one so far are compared */
+				for (entry = entries[s]; entry && (NULL == best || mnlxt_xfrm_spd_entry_before(entry, best));
+						 entry = entry->next) {
+					if (mnlxt_xfrm_spd_entry_matches(entry, &flows[i])) {
+						best = entry;
+						break;
+					}
+				}
+			}
+		}
+		if (NULL != best) {
+			policies[i] = best->policy;
+			++rc;
+		} else {
+			policies[i] = NULL;
+		}
+	}
+end:
+	return rc;
+}
@@ -0,0 +1,298 @@
+/*
+ * spdinfo.c		Libmnlxt Xfrm/IPsec Security Policy Database Information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libmnlxt/xfrm.h"
+#include "private/data.h"
+#include "private/internal.h"
+
+mnlxt_xfrm_spdinfo_t *mnlxt_xfrm_spdinfo_new() {
+	return calloc(1, sizeof(mnlxt_xfrm_spdinfo_t));
+}
+
+void mnlxt_xfrm_spdinfo_free(mnlxt_xfrm_spdinfo_t *info) {
+	if (NULL != info) {
+		free(info);
+	}
+}
+
+int mnlxt_xfrm_spdinfo_set_hthresh(mnlxt_xfrm_spdinfo_t *info, uint8_t family, uint8_t lbits, uint8_t rbits) {
+	int rc = -1;
+	if (NULL == info) {
+		errno = EINVAL;
+	} else if (AF_INET == family) {
+		if (32 < lbits || 32 < rbits) {
+			errno = EINVAL;
+		} else {
+			info->ipv4_hthresh.lbits = lbits;
+			info->ipv4_hthresh.rbits = rbits;
+			MNLXT_SET_PROP_FLAG(info, MNLXT_XFRM_SPDINFO_IPV4_HTHRESH);
+			rc = 0;
+		}
+	} else if (AF_INET6 == family) {
+		if (128 < lbits || 128 < rbits) {
+			errno = EINVAL;
+		} else {
+			info->ipv6_hthresh.lbits = lbits;
+			info->ipv6_hthresh.rbits = rbits;
+			MNLXT_SET_PROP_FLAG(info, MNLXT_XFRM_SPDINFO_IPV6_HTHRESH);
+			rc = 0;
+		}
+	} else {
+		errno = EAFNOSUPPORT;
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_spdinfo_get_hthresh(const mnlxt_xfrm_spdinfo_t *info, uint8_t family, uint8_t *lbits, uint8_t *rbits) {
+	int rc = -1;
+	const struct xfrmu_spdhthresh *hthresh;
+	mnlxt_xfrm_spdinfo_data_t prop;
+	if (NULL == info || NULL == lbits || NULL == rbits) {
+		errno = EINVAL;
+		return rc;
+	} else if (AF_INET == family) {
+		hthresh = &info->ipv4_hthresh;
+		prop = MNLXT_XFRM_SPDINFO_IPV4_HTHRESH;
+	} else if (AF_INET6 == family) {
+		hthresh = &info->ipv6_hthresh;
+		prop = MNLXT_XFRM_SPDINFO_IPV6_HTHRESH;
+	} else {
+		errno = EAFNOSUPPORT;
+		return rc;
+	}
+	if (!MNLXT_GET_PROP_FLAG(info, prop)) {
+		rc = 1;
+	} else {
+		*lbits = hthresh->lbits;
+		*rbits = hthresh->rbits;
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_spdinfo_get_counts(const mnlxt_xfrm_spdinfo_t *info, const struct xfrmu_spdinfo **counts) {
+	int rc = -1;
+	if (NULL == info || NULL == counts) {
+		errno = EINVAL;
+	} else if (!MNLXT_GET_PROP_FLAG(info, MNLXT_XFRM_SPDINFO_COUNTS)) {
+		rc = 1;
+	} else {
+		*counts = &info->counts;
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_spdinfo_get_hash(const mnlxt_xfrm_spdinfo_t *info, const struct xfrmu_spdhinfo **hash) {
+	int rc = -1;
+	if (NULL == info || NULL == hash) {
+		errno = EINVAL;
+	} else if (!MNLXT_GET_PROP_FLAG(info, MNLXT_XFRM_SPDINFO_HASH)) {
+		rc = 1;
+	} else {
+		*hash = &info->hash;
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_spdinfo_put(struct nlmsghdr *nlh, const mnlxt_xfrm_spdinfo_t *info, uint16_t nlmsg_type) {
+	int rc = -1;
+
+	if (!info || !nlh || (XFRM_MSG_NEWSPDINFO != nlmsg_type && XFRM_MSG_GETSPDINFO != nlmsg_type)) {
+		errno = EINVAL;
+		goto failed;
+	}
+	/* the kernel expects a flags word in front of the attributes, no flags are defined yet */
+	uint32_t *flags = mnl_nlmsg_put_extra_header(nlh, sizeof(uint32_t));
+	*flags = 0;
+	if (XFRM_MSG_NEWSPDINFO == nlmsg_type) {
+		if (MNLXT_GET_PROP_FLAG(info, MNLXT_XFRM_SPDINFO_IPV4_HTHRESH)) {
+			mnl_attr_put(nlh, XFRMA_SPD_IPV4_HTHRESH, sizeof(info->ipv4_hthresh), &info->ipv4_hthresh);
+		}
+		if (MNLXT_GET_PROP_FLAG(info, MNLXT_XFRM_SPDINFO_IPV6_HTHRESH)) {
+			mnl_attr_put(nlh, XFRMA_SPD_IPV6_HTHRESH, sizeof(info->ipv6_hthresh), &info->ipv6_hthresh);
+		}
+	}
+	rc = 0;
+failed:
+	return rc;
+}
+
+int mnlxt_xfrm_spdinfo_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
+	int rc = MNL_CB_ERROR;
+	mnlxt_xfrm_spdinfo_t *info = NULL;
+	mnlxt_message_t *msg = NULL;
+
+	if (NULL == data) {
+		errno = EINVAL;
+		goto end;
+	}
+
+	if (NULL == nlh) {
+		errno = EINVAL;
+		data->error_str = "invalid arguments";
+		goto end;
+	}
+
+	if (XFRM_MSG_NEWSPDINFO != nlh->nlmsg_type && XFRM_MSG_GETSPDINFO != nlh->nlmsg_type) {
+		errno = EBADMSG;
+		data->error_str = "unsupported message type";
+		goto end;
+	}
+
+	if (mnl_nlmsg_get_payload_len(nlh) < sizeof(uint32_t)) {
+		errno = EBADMSG;
+		data->error_str = "message too short";
+		goto end;
+	}
+
+	info = mnlxt_data_alloc(data, sizeof(mnlxt_xfrm_spdinfo_t));
+	if (NULL == info) {
+		data->error_str = "mnlxt_data_alloc failed";
+		goto end;
+	}
+
+	struct nlattr *attr;
+	mnl_attr_for_each(attr, nlh, sizeof(uint32_t)) {
+		switch (mnl_attr_get_type(attr)) {
+		case XFRMA_SPD_INFO:
+			if (mnl_attr_validate2(attr, MNL_TYPE_UNSPEC, sizeof(info->counts)) < 0) {
+				data->error_str = "XFRMA_SPD_INFO validation failed";
+				goto end;
+			}
+			memcpy(&info->counts, mnl_attr_get_payload(attr), sizeof(info->counts));
+			MNLXT_SET_PROP_FLAG(info, MNLXT_XFRM_SPDINFO_COUNTS);
+			break;
+		case XFRMA_SPD_HINFO:
+			if (mnl_attr_validate2(attr, MNL_TYPE_UNSPEC, sizeof(info->hash)) < 0) {
+				data->error_str = "XFRMA_SPD_HINFO validation failed";
+				goto end;
+			}
+			memcpy(&info->hash, mnl_attr_get_payload(attr), sizeof(info->hash));
+			MNLXT_SET_PROP_FLAG(info, MNLXT_XFRM_SPDINFO_HASH);
+			break;
+		case XFRMA_SPD_IPV4_HTHRESH:
+			if (mnl_attr_validate2(attr, MNL_TYPE_UNSPEC, sizeof(info->ipv4_hthresh)) < 0) {
+				data->error_str = "XFRMA_SPD_IPV4_HTHRESH validation failed";
+				goto end;
+			}
+			memcpy(&info->ipv4_hthresh, mnl_attr_get_payload(attr), sizeof(info->ipv4_hthresh));
+			MNLXT_SET_PROP_FLAG(info, MNLXT_XFRM_SPDINFO_IPV4_HTHRESH);
+			break;
+		case XFRMA_SPD_IPV6_HTHRESH:
+			if (mnl_attr_validate2(attr, MNL_TYPE_UNSPEC, sizeof(info->ipv6_hthresh)) < 0) {
+				data->error_str = "XFRMA_SPD_IPV6_HTHRESH validation failed";
+				goto end;
+			}
+			memcpy(&info->ipv6_hthresh, mnl_attr_get_payload(attr), sizeof(info->ipv6_hthresh));
+			MNLXT_SET_PROP_FLAG(info, MNLXT_XFRM_SPDINFO_IPV6_HTHRESH);
+			break;
+		}
+	}
+
+	msg = mnlxt_xfrm_data_message_new(data, nlh->nlmsg_type, info);
+	if (NULL == msg) {
+		data->error_str = "mnlxt_xfrm_data_message_new failed";
+		goto end;
+	}
+
+	mnlxt_data_add(data, msg);
+	info = NULL;
+	msg = NULL;
+	rc = MNL_CB_OK;
+end:
+	mnlxt_data_release(data, info, mnlxt_xfrm_spdinfo_FREE);
+	mnlxt_message_free(msg);
+
+	return rc;
+}
+
+mnlxt_xfrm_spdinfo_t *mnlxt_xfrm_spdinfo_get(const mnlxt_message_t *message) {
+	mnlxt_xfrm_spdinfo_t *info = NULL;
+	if (message && message->payload
+			&& (XFRM_MSG_NEWSPDINFO == message->nlmsg_type || XFRM_MSG_GETSPDINFO == message->nlmsg_type)) {
+		info = (mnlxt_xfrm_spdinfo_t *)message->payload;
+	}
+	return info;
+}
+
+mnlxt_xfrm_spdinfo_t *mnlxt_xfrm_spdinfo_remove(mnlxt_message_t *message) {
+	mnlxt_xfrm_spdinfo_t *info = mnlxt_xfrm_spdinfo_get(message);
+	if (NULL != info) {
+		message->payload = NULL;
+	}
+	return info;
+}
+
+mnlxt_xfrm_spdinfo_t *mnlxt_xfrm_spdinfo_iterate(mnlxt_data_t *data, mnlxt_message_t **iterator) {
+	mnlxt_xfrm_spdinfo_t *info = NULL;
+	if (iterator) {
+		while ((*iterator = mnlxt_data_iterate(data, *iterator))) {
+			if ((info = mnlxt_xfrm_spdinfo_get(*iterator))) {
+				break;
+			}
+		}
+	}
+	return info;
+}
+
+int mnlxt_xfrm_spdinfo_dump(mnlxt_data_t *data) {
+	return mnlxt_xfrm_spdinfo_handle_dump(NULL, data);
+}
+
+int mnlxt_xfrm_spdinfo_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data) {
+	int rc = -1;
+
+	if (NULL == data) {
+		errno = EINVAL;
+
+	} else {
+		struct nlmsghdr *nlh;
+		char buf[MNL_NLMSG_HDRLEN + MNL_ALIGN(sizeof(uint32_t))];
+
+		nlh = mnl_nlmsg_put_header(buf);
+		nlh->nlmsg_type = XFRM_MSG_GETSPDINFO;
+		*(uint32_t *)mnl_nlmsg_put_extra_header(nlh, sizeof(uint32_t)) = 0;
+
+		/* the kernel answers a single XFRM_MSG_NEWSPDINFO, not a dump */
+		rc = mnlxt_xfrm_get_request(handle, data, nlh);
+	}
+
+	return rc;
+}
+
+int mnlxt_xfrm_spdinfo_request(const mnlxt_xfrm_spdinfo_t *info) {
+	return mnlxt_xfrm_spdinfo_handle_request(NULL, info);
+}
+
+int mnlxt_xfrm_spdinfo_handle_request(mnlxt_handle_t *handle, const mnlxt_xfrm_spdinfo_t *info) {
+	int rc = -1;
+	mnlxt_message_t *message = NULL;
+
+	if (NULL == info) {
+		errno = EINVAL;
+	} else if (!MNLXT_GET_PROP_FLAG(info, MNLXT_XFRM_SPDINFO_IPV4_HTHRESH)
+						 && !MNLXT_GET_PROP_FLAG(info, MNLXT_XFRM_SPDINFO_IPV6_HTHRESH)) {
+		/* nothing to set */
+		errno = EINVAL;
+	} else if (NULL != (message = mnlxt_xfrm_message_new(XFRM_MSG_NEWSPDINFO, 0, (void *)info))) {
+		rc = mnlxt_xfrm_handle_message_request(handle, message);
+		/* the information is owned by the caller */
+		message->payload = NULL;
+		mnlxt_message_free(message);
+	}
+
+	return rc;
+}
@@ -0,0 +1,353 @@
+/*
+ * state.c		Libmnlxt Xfrm/IPsec Security Association
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libmnlxt/xfrm_state.h"
+#include "private/internal.h"
+
+#define state_ad_init(member) ad_init(mnlxt_xfrm_state_t, member)
+#define state_offset(member) offsetof(mnlxt_xfrm_state_t, member)
+
+static struct access_data state_data[MNLXT_XFRM_STATE_MAX] = {
+	[MNLXT_XFRM_STATE_FAMILY] = state_ad_init(family),
+	[MNLXT_XFRM_STATE_PROTO] = state_ad_init(proto),
+	[MNLXT_XFRM_STATE_SPI] = state_ad_init(spi),
+	[MNLXT_XFRM_STATE_SRC_ADDR] = {}, // special case
+	[MNLXT_XFRM_STATE_DST_ADDR] = {}, // special case
+	[MNLXT_XFRM_STATE_MODE] = state_ad_init(mode),
+	[MNLXT_XFRM_STATE_REQID] = state_ad_init(reqid),
+	[MNLXT_XFRM_STATE_REPLAY_WINDOW] = state_ad_init(replay_window),
+	[MNLXT_XFRM_STATE_FLAGS] = state_ad_init(flags),
+	[MNLXT_XFRM_STATE_MARK] = state_ad_init(mark),
+	[MNLXT_XFRM_STATE_IF_ID] = state_ad_init(if_id),
+	[MNLXT_XFRM_STATE_ENCAP] = state_ad_init(encap),
+	[MNLXT_XFRM_STATE_LIFETIME] = state_ad_init(lifetime),
+	[MNLXT_XFRM_STATE_AUTH] = {},	// special case
+	[MNLXT_XFRM_STATE_CRYPT] = {}, // special case
+	[MNLXT_XFRM_STATE_AEAD] = {},	// special case
+};
+
+mnlxt_xfrm_state_t *mnlxt_xfrm_state_new() {
+	return calloc(1, sizeof(mnlxt_xfrm_state_t));
+}
+
+mnlxt_xfrm_state_t *mnlxt_xfrm_state_clone(const mnlxt_xfrm_state_t *src, uint64_t filter) {
+	mnlxt_xfrm_state_t *dst = NULL;
+	if (NULL == src) {
+		errno = EINVAL;
+	} else if (NULL != (dst = mnlxt_xfrm_state_new()) && filter) {
+		*dst = *src;
+		dst->prop_flags = src->prop_flags & filter;
+		/* keys of filtered algorithms are not copied */
+		if (!MNLXT_GET_PROP_FLAG(dst, MNLXT_XFRM_STATE_AUTH)) {
+			memset(&dst->auth, 0, sizeof(dst->auth));
+		}
+		if (!MNLXT_GET_PROP_FLAG(dst, MNLXT_XFRM_STATE_CRYPT)) {
+			memset(&dst->crypt, 0, sizeof(dst->crypt));
+		}
+		if (!MNLXT_GET_PROP_FLAG(dst, MNLXT_XFRM_STATE_AEAD)) {
+			memset(&dst->aead, 0, sizeof(dst->aead));
+		}
+	}
+	return dst;
+}
+
+void mnlxt_xfrm_state_free(mnlxt_xfrm_state_t *state) {
+	if (NULL != state) {
+		/* do not leave keys in freed memory */
+		memset(state, 0, sizeof(*state));
+		free(state);
+	}
+}
+
+static int mnlxt_xfrm_state_set_ptr(mnlxt_xfrm_state_t *state, mnlxt_xfrm_state_data_t data, const void *ptr,
+																		uint8_t size) {
+	int rc = -1;
+	if (NULL == state || NULL == ptr || MNLXT_XFRM_STATE_MAX <= (unsigned)data || state_data[data].size != size
+			|| 0 == state_data[data].size) {
+		errno = EINVAL;
+	} else {
+		MNLXT_SET_PROP_FLAG(state, data);
+		memcpy(((char *)state + state_data[data].offset), ptr, size);
+		rc = 0;
+	}
+	return rc;
+}
+
+static inline int mnlxt_xfrm_state_set_u32(mnlxt_xfrm_state_t *state, mnlxt_xfrm_state_data_t data, uint32_t u32) {
+	return mnlxt_xfrm_state_set_ptr(state, data, &u32, sizeof(uint32_t));
+}
+
+static inline int mnlxt_xfrm_state_set_u8(mnlxt_xfrm_state_t *state, mnlxt_xfrm_state_data_t data, uint8_t u8) {
+	return mnlxt_xfrm_state_set_ptr(state, data, &u8, sizeof(uint8_t));
+}
+
+static int mnlxt_xfrm_state_get_ptr(const mnlxt_xfrm_state_t *state, mnlxt_xfrm_state_data_t data, void *ptr,
+																		uint8_t size) {
+	int rc = -1;
+	if (NULL == state || NULL == ptr || MNLXT_XFRM_STATE_MAX <= (unsigned)data || state_data[data].size != size
+			|| 0 == state_data[data].size) {
+		errno = EINVAL;
+	} else if (!MNLXT_GET_PROP_FLAG(state, data)) {
+		rc = 1;
+	} else {
+		memcpy(ptr, ((char *)state + state_data[data].offset), size);
+		rc = 0;
+	}
+	return rc;
+}
+
+static inline int mnlxt_xfrm_state_get_u32(const mnlxt_xfrm_state_t *state, mnlxt_xfrm_state_data_t data,
+																					 uint32_t *pu32) {
+	return mnlxt_xfrm_state_get_ptr(state, data, pu32, sizeof(uint32_t));
+}
+
+static inline int mnlxt_xfrm_state_get_u8(const mnlxt_xfrm_state_t *state, mnlxt_xfrm_state_data_t data,
+																					uint8_t *pu8) {
+	return mnlxt_xfrm_state_get_ptr(state, data, pu8, sizeof(uint8_t));
+}
+
+/* returns a pointer to the property within the state, which is set */
+static int mnlxt_xfrm_state_get_ref(const mnlxt_xfrm_state_t *state, mnlxt_xfrm_state_data_t data, size_t offset,
+																		const void **ref) {
+	int rc = -1;
+	if (NULL == state || NULL == ref) {
+		errno = EINVAL;
+	} else if (!MNLXT_GET_PROP_FLAG(state, data)) {
+		rc = 1;
+	} else {
+		*ref = (const char *)state + offset;
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_state_set_family(mnlxt_xfrm_state_t *state, uint8_t family) {
+	int rc = -1;
+	if (NULL == state) {
+		errno = EINVAL;
+	} else if (AF_INET != family && AF_INET6 != family) {
+		errno = EAFNOSUPPORT;
+	} else if (MNLXT_GET_PROP_FLAG(state, MNLXT_XFRM_STATE_FAMILY)) {
+		if (family == state->family) {
+			rc = 0;
+		} else {
+			errno = EINVAL;
+		}
+	} else {
+		state->family = family;
+		MNLXT_SET_PROP_FLAG(state, MNLXT_XFRM_STATE_FAMILY);
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_state_get_family(const mnlxt_xfrm_state_t *state, uint8_t *family) {
+	return mnlxt_xfrm_state_get_u8(state, MNLXT_XFRM_STATE_FAMILY, family);
+}
+
+int mnlxt_xfrm_state_set_proto(mnlxt_xfrm_state_t *state, uint8_t proto) {
+	int rc = -1;
+	if (IPPROTO_ESP != proto && IPPROTO_AH != proto && IPPROTO_COMP != proto) {
+		errno = EPROTONOSUPPORT;
+	} else {
+		rc = mnlxt_xfrm_state_set_u8(state, MNLXT_XFRM_STATE_PROTO, proto);
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_state_get_proto(const mnlxt_xfrm_state_t *state, uint8_t *proto) {
+	return mnlxt_xfrm_state_get_u8(state, MNLXT_XFRM_STATE_PROTO, proto);
+}
+
+int mnlxt_xfrm_state_set_spi(mnlxt_xfrm_state_t *state, uint32_t spi) {
+	return mnlxt_xfrm_state_set_u32(state, MNLXT_XFRM_STATE_SPI, spi);
+}
+
+int mnlxt_xfrm_state_get_spi(const mnlxt_xfrm_state_t *state, uint32_t *spi) {
+	return mnlxt_xfrm_state_get_u32(state, MNLXT_XFRM_STATE_SPI, spi);
+}
+
+int mnlxt_xfrm_state_set_src_addr(mnlxt_xfrm_state_t *state, uint8_t family, const mnlxt_inet_addr_t *buf) {
+	int rc = -1;
+	if (NULL == state || NULL == buf) {
+		errno = EINVAL;
+	} else {
+		rc = mnlxt_xfrm_state_set_family(state, family);
+		if (0 == rc) {
+			state->src = *buf;
+			MNLXT_SET_PROP_FLAG(state, MNLXT_XFRM_STATE_SRC_ADDR);
+		}
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_state_get_src_addr(const mnlxt_xfrm_state_t *state, uint8_t *family, const mnlxt_inet_addr_t **buf) {
+	int rc = mnlxt_xfrm_state_get_ref(state, MNLXT_XFRM_STATE_SRC_ADDR, state_offset(src), (const void **)buf);
+	if (0 == rc && NULL != family) {
+		*family = state->family;
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_state_set_dst_addr(mnlxt_xfrm_state_t *state, uint8_t family, const mnlxt_inet_addr_t *buf) {
+	int rc = -1;
+	if (NULL == state || NULL == buf) {
+		errno = EINVAL;
+	} else {
+		rc = mnlxt_xfrm_state_set_family(state, family);
+		if (0 == rc) {
+			state->dst = *buf;
+			MNLXT_SET_PROP_FLAG(state, MNLXT_XFRM_STATE_DST_ADDR);
+		}
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_state_get_dst_addr(const mnlxt_xfrm_state_t *state, uint8_t *family, const mnlxt_inet_addr_t **buf) {
+	int rc = mnlxt_xfrm_state_get_ref(state, MNLXT_XFRM_STATE_DST_ADDR, state_offset(dst), (const void **)buf);
+	if (0 == rc && NULL != family) {
+		*family = state->family;
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_state_set_mode(mnlxt_xfrm_state_t *state, uint8_t mode) {
+	int rc = -1;
+	if (XFRM_MODE_MAX <= mode) {
+		errno = EINVAL;
+	} else {
+		rc = mnlxt_xfrm_state_set_u8(state, MNLXT_XFRM_STATE_MODE, mode);
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_state_get_mode(const mnlxt_xfrm_state_t *state, uint8_t *mode) {
+	return mnlxt_xfrm_state_get_u8(state, MNLXT_XFRM_STATE_MODE, mode);
+}
+
+int mnlxt_xfrm_state_set_reqid(mnlxt_xfrm_state_t *state, uint32_t reqid) {
+	return mnlxt_xfrm_state_set_u32(state, MNLXT_XFRM_STATE_REQID, reqid);
+}
+
+int mnlxt_xfrm_state_get_reqid(const mnlxt_xfrm_state_t *state, uint32_t *reqid) {
+	return mnlxt_xfrm_state_get_u32(state, MNLXT_XFRM_STATE_REQID, reqid);
+}
+
+int mnlxt_xfrm_state_set_replay_window(mnlxt_xfrm_state_t *state, uint8_t replay_window) {
+	return mnlxt_xfrm_state_set_u8(state, MNLXT_XFRM_STATE_REPLAY_WINDOW, replay_window);
+}
+
+int mnlxt_xfrm_state_get_replay_window(const mnlxt_xfrm_state_t *state, uint8_t *replay_window) {
+	return mnlxt_xfrm_state_get_u8(state, MNLXT_XFRM_STATE_REPLAY_WINDOW, replay_window);
+}
+
+int mnlxt_xfrm_state_set_flags(mnlxt_xfrm_state_t *state, uint8_t flags) {
+	return mnlxt_xfrm_state_set_u8(state, MNLXT_XFRM_STATE_FLAGS, flags);
+}
+
+int mnlxt_xfrm_state_get_flags(const mnlxt_xfrm_state_t *state, uint8_t *flags) {
+	return mnlxt_xfrm_state_get_u8(state, MNLXT_XFRM_STATE_FLAGS, flags);
+}
+
+int mnlxt_xfrm_state_set_mark(mnlxt_xfrm_state_t *state, uint32_t mark, uint32_t mask) {
+	mnlxt_xfrm_mark_t m = {mark, mask ? mask : (uint32_t)-1};
+	return mnlxt_xfrm_state_set_ptr(state, MNLXT_XFRM_STATE_MARK, &m, sizeof(m));
+}
+
+int mnlxt_xfrm_state_get_mark(const mnlxt_xfrm_state_t *state, uint32_t *mark, uint32_t *mask) {
+	mnlxt_xfrm_mark_t m;
+	int rc = mnlxt_xfrm_state_get_ptr(state, MNLXT_XFRM_STATE_MARK, &m, sizeof(m));
+	if (0 == rc) {
+		if (NULL != mark) {
+			*mark = m.value;
+		}
+		if (NULL != mask) {
+			*mask = m.mask;
+		}
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_state_set_if_id(mnlxt_xfrm_state_t *state, uint32_t if_id) {
+	return mnlxt_xfrm_state_set_u32(state, MNLXT_XFRM_STATE_IF_ID, if_id);
+}
+
+int mnlxt_xfrm_state_get_if_id(const mnlxt_xfrm_state_t *state, uint32_t *if_id) {
+	return mnlxt_xfrm_state_get_u32(state, MNLXT_XFRM_STATE_IF_ID, if_id);
+}
+
+int mnlxt_xfrm_state_set_encap(mnlxt_xfrm_state_t *state, const mnlxt_xfrm_encap_t *encap) {
+	return mnlxt_xfrm_state_set_ptr(state, MNLXT_XFRM_STATE_ENCAP, encap, sizeof(mnlxt_xfrm_encap_t));
+}
+
+int mnlxt_xfrm_state_get_encap(const mnlxt_xfrm_state_t *state, const mnlxt_xfrm_encap_t **encap) {
+	return mnlxt_xfrm_state_get_ref(state, MNLXT_XFRM_STATE_ENCAP, state_offset(encap), (const void **)encap);
+}
+
+int mnlxt_xfrm_state_set_lifetime(mnlxt_xfrm_state_t *state, const struct xfrm_lifetime_cfg *lifetime) {
+	return mnlxt_xfrm_state_set_ptr(state, MNLXT_XFRM_STATE_LIFETIME, lifetime, sizeof(struct xfrm_lifetime_cfg));
+}
+
+int mnlxt_xfrm_state_get_lifetime(const mnlxt_xfrm_state_t *state, const struct xfrm_lifetime_cfg **lifetime) {
+	return mnlxt_xfrm_state_get_ref(state, MNLXT_XFRM_STATE_LIFETIME, state_offset(lifetime), (const void **)lifetime);
+}
+
+static int mnlxt_xfrm_state_set_alg(mnlxt_xfrm_state_t *state, mnlxt_xfrm_state_data_t data, mnlxt_xfrm_alg_t *alg,
+																		const char *name, const uint8_t *key, uint16_t key_len, uint16_t icv_len) {
+	int rc = -1;
+	size_t name_len = (NULL == name ? 0 : strlen(name));
+	if (NULL == state || 0 == name_len || sizeof(alg->name) <= name_len || (key_len && NULL == key)
+			|| 8 * MNLXT_XFRM_ALG_KEY_MAX < key_len) {
+		errno = EINVAL;
+	} else {
+		memset(alg, 0, sizeof(*alg));
+		memcpy(alg->name, name, name_len);
+		alg->key_len = key_len;
+		alg->icv_len = icv_len;
+		if (key_len) {
+			memcpy(alg->key, key, (key_len + 7) / 8);
+		}
+		MNLXT_SET_PROP_FLAG(state, data);
+		rc = 0;
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_state_set_auth(mnlxt_xfrm_state_t *state, const char *name, const uint8_t *key, uint16_t key_len,
+															uint16_t trunc_len) {
+	return mnlxt_xfrm_state_set_alg(state, MNLXT_XFRM_STATE_AUTH, state ? &state->auth : NULL, name, key, key_len,
+																	trunc_len);
+}
+
+int mnlxt_xfrm_state_get_auth(const mnlxt_xfrm_state_t *state, const mnlxt_xfrm_alg_t **alg) {
+	return mnlxt_xfrm_state_get_ref(state, MNLXT_XFRM_STATE_AUTH, state_offset(auth), (const void **)alg);
+}
+
+int mnlxt_xfrm_state_set_crypt(mnlxt_xfrm_state_t *state, const char *name, const uint8_t *key, uint16_t key_len) {
+	return mnlxt_xfrm_state_set_alg(state, MNLXT_XFRM_STATE_CRYPT, state ? &state->crypt : NULL, name, key, key_len, 0);
+}
+
+int mnlxt_xfrm_state_get_crypt(const mnlxt_xfrm_state_t *state, const mnlxt_xfrm_alg_t **alg) {
+	return mnlxt_xfrm_state_get_ref(state, MNLXT_XFRM_STATE_CRYPT, state_offset(crypt), (const void **)alg);
+}
+
+int mnlxt_xfrm_state_set_aead(mnlxt_xfrm_state_t *state, const char *name, const uint8_t *key, uint16_t key_len,
+															uint16_t icv_len) {
+	return mnlxt_xfrm_state_set_alg(state, MNLXT_XFRM_STATE_AEAD, state ? &state->aead : NULL, name, key, key_len,
+																	icv_len);
+}
+
+int mnlxt_xfrm_state_get_aead(const mnlxt_xfrm_state_t *state, const mnlxt_xfrm_alg_t **alg) {
+	return mnlxt_xfrm_state_get_ref(state, MNLXT_XFRM_STATE_AEAD, state_offset(aead), (const void **)alg);
+}
@@ -0,0 +1,619 @@
+/*
+ * state_data.c		Libmnlxt Xfrm/IPsec Security Association
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "libmnlxt/xfrm.h"
+#include "private/data.h"
+#include "private/internal.h"
+#include "private/xfrm.h"
+
+static int mnlxt_xfrm_alg_cmp(const mnlxt_xfrm_alg_t *alg1, const mnlxt_xfrm_alg_t *alg2) {
+	return (0 != strncmp(alg1->name, alg2->name, sizeof(alg1->name)) || alg1->key_len != alg2->key_len
+					|| alg1->icv_len != alg2->icv_len || 0 != memcmp(alg1->key, alg2->key, (alg1->key_len + 7) / 8));
+}
+
+static int mnlxt_xfrm_state_cmp(const mnlxt_xfrm_state_t *state1, const mnlxt_xfrm_state_t *state2,
+																mnlxt_xfrm_state_data_t data) {
+	int rc = data + 1;
+	size_t addr_size = (AF_INET == state1->family ? sizeof(state1->src.in) : sizeof(state1->src));
+	switch (data) {
+	case MNLXT_XFRM_STATE_FAMILY:
+		if (state1->family != state2->family) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_PROTO:
+		if (state1->proto != state2->proto) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_SPI:
+		if (state1->spi != state2->spi) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_SRC_ADDR:
+		if (0 != memcmp(&state1->src, &state2->src, addr_size)) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_DST_ADDR:
+		if (0 != memcmp(&state1->dst, &state2->dst, addr_size)) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_MODE:
+		if (state1->mode != state2->mode) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_REQID:
+		if (state1->reqid != state2->reqid) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_REPLAY_WINDOW:
+		if (state1->replay_window != state2->replay_window) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_FLAGS:
+		if (state1->flags != state2->flags) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_MARK:
+		if (0 != memcmp(&state1->mark, &state2->mark, sizeof(state1->mark))) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_IF_ID:
+		if (state1->if_id != state2->if_id) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_ENCAP:
+		if (state1->encap.type != state2->encap.type || state1->encap.sport != state2->encap.sport
+				|| state1->encap.dport != state2->encap.dport
+				|| 0 != memcmp(&state1->encap.oa, &state2->encap.oa, addr_size)) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_LIFETIME:
+		if (0 != memcmp(&state1->lifetime, &state2->lifetime, sizeof(state1->lifetime))) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_AUTH:
+		if (0 != mnlxt_xfrm_alg_cmp(&state1->auth, &state2->auth)) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_CRYPT:
+		if (0 != mnlxt_xfrm_alg_cmp(&state1->crypt, &state2->crypt)) {
+			goto failed;
+		}
+		break;
+	case MNLXT_XFRM_STATE_AEAD:
+		if (0 != mnlxt_xfrm_alg_cmp(&state1->aead, &state2->aead)) {
+			goto failed;
+		}
+		break;
+	}
+	rc = 0;
+failed:
+	return rc;
+}
+
+int mnlxt_xfrm_state_match(const mnlxt_xfrm_state_t *state, const mnlxt_xfrm_state_t *match) {
+	int rc = -1;
+	if (NULL == match) {
+		errno = EINVAL;
+	} else {
+		rc = mnlxt_xfrm_state_compare(state, match, match->prop_flags);
+	}
+	return rc;
+}
+
+int mnlxt_xfrm_state_compare(const mnlxt_xfrm_state_t *state1, const mnlxt_xfrm_state_t *state2, uint64_t filter) {
+	int rc = -1, i;
+	if (NULL == state1 || NULL == state2) {
+		errno = EINVAL;
+	} else {
+		uint64_t flag = 1;
+		for (i = 0; i < MNLXT_XFRM_STATE_MAX; ++i, flag <<= 1) {
+			if (0 == (flag & filter)) {
+				continue;
+			}
+			if (0 == (state1->prop_flags & flag)) {
+				if (0 == (state2->prop_flags & flag)) {
+					/* both not set */
+					continue;
+				}
+				goto failed;
+			} else if (0 == (state2->prop_flags & flag)) {
+				goto failed;
+			} else if (0 != mnlxt_xfrm_state_cmp(state1, state2, i)) {
+				goto failed;
+			}
+		}
+		return 0;
+	failed:
+		rc = ++i;
+	}
+	return rc;
+}
+
+mnlxt_xfrm_state_t *mnlxt_xfrm_state_get(const mnlxt_message_t *message) {
+	mnlxt_xfrm_state_t *state = NULL;
+	if (message && message->payload
+			&& (XFRM_MSG_NEWSA == message->nlmsg_type || XFRM_MSG_UPDSA == message->nlmsg_type
+					|| XFRM_MSG_GETSA == message->nlmsg_type || XFRM_MSG_DELSA == message->nlmsg_type)) {
+		state = (mnlxt_xfrm_state_t *)message->payload;
+	}
+	return state;
+}
+
+mnlxt_xfrm_state_t *mnlxt_xfrm_state_remove(mnlxt_message_t *message) {
+	mnlxt_xfrm_state_t *state = mnlxt_xfrm_state_get(message);
+	if (NULL != state) {
+		message->payload = NULL;
+	}
+	return state;
+}
+
+static void mnlxt_xfrm_state_put_alg(struct nlmsghdr *nlh, uint16_t type, const mnlxt_xfrm_alg_t *alg) {
+	union {
+		struct xfrm_algo crypt;
+		struct xfrm_algo_auth auth;
+		struct xfrm_algo_aead aead;
+		char buf[sizeof(struct xfrm_algo_aead) + MNLXT_XFRM_ALG_KEY_MAX];
+	} algo;
+	size_t key_size = (alg->key_len + 7) / 8;
+	char *key;
+	size_t size;
+
+	memset(&algo, 0, sizeof(algo));
+	switch (type) {
+	case XFRMA_ALG_AUTH_TRUNC:
+		memcpy(algo.auth.alg_name, alg->name, sizeof(algo.auth.alg_name));
+		algo.auth.alg_key_len = alg->key_len;
+		algo.auth.alg_trunc_len = alg->icv_len;
+		key = algo.auth.alg_key;
+		size = sizeof(algo.auth);
+		break;
+	case XFRMA_ALG_AEAD:
+		memcpy(algo.aead.alg_name, alg->name, sizeof(algo.aead.alg_name));
+		algo.aead.alg_key_len = alg->key_len;
+		algo.aead.alg_icv_len = alg->icv_len;
+		key = algo.aead.alg_key;
+		size = sizeof(algo.aead);
+		break;
+	default:
+		memcpy(algo.crypt.alg_name, alg->name, sizeof(algo.crypt.alg_name));
+		algo.crypt.alg_key_len = alg->key_len;
+		key = algo.crypt.alg_key;
+		size = sizeof(algo.crypt);
+		break;
+	}
+	memcpy(key, alg->key, key_size);
+	mnl_attr_put(nlh, type, size + key_size, &algo);
+}
+
+int mnlxt_xfrm_state_put(struct nlmsghdr *nlh, const mnlxt_xfrm_state_t *state, uint16_t nlmsg_type) {
+	int rc = -1;
+	struct xfrm_usersa_info *xsinfo = NULL;
+	struct xfrm_usersa_id *xsid = NULL;
+	xfrm_address_t *daddr;
+	struct xfrm_encap_tmpl encap = {};
+	struct xfrm_mark mark = {};
+
+	if (!state || !nlh) {
+		errno = EINVAL;
+		goto failed;
+	}
+	size_t addr_size = (AF_INET == state->family ? sizeof(state->src.in) : sizeof(state->src));
+	if (XFRM_MSG_NEWSA == nlh->nlmsg_type || XFRM_MSG_UPDSA == nlh->nlmsg_type) {
+		xsinfo = mnl_nlmsg_put_extra_header(nlh, sizeof(struct xfrm_usersa_info));
+		daddr = &xsinfo->id.daddr;
+		xsinfo->family = state->family;
+		xsinfo->id.proto = state->proto;
+		xsinfo->id.spi = htonl(state->spi);
+		/* no limits without a lifetime */
+		xsinfo->lft.soft_byte_limit = XFRM_INF;
+		xsinfo->lft.hard_byte_limit = XFRM_INF;
+		xsinfo->lft.soft_packet_limit = XFRM_INF;
+		xsinfo->lft.hard_packet_limit = XFRM_INF;
+	} else if (XFRM_MSG_DELSA == nlh->nlmsg_type || XFRM_MSG_GETSA == nlh->nlmsg_type) {
+		xsid = mnl_nlmsg_put_extra_header(nlh, sizeof(struct xfrm_usersa_id));
+		daddr = &xsid->daddr;
+		xsid->family = state->family;
+		xsid->proto = state->proto;
+		xsid->spi = htonl(state->spi);
+	} else {
+		errno = EINVAL;
+		goto failed;
+	}
+	int i;
+	uint32_t flag = 1;
+	for (i = 0; i < MNLXT_XFRM_STATE_MAX; ++i, flag <<= 1) {
+		if (0 == (state->prop_flags & flag)) {
+			continue;
+		}
+		switch (i) {
+		case MNLXT_XFRM_STATE_SRC_ADDR:
+			if (xsinfo) {
+				memcpy(&xsinfo->saddr, &state->src, addr_size);
+			} else {
+				/* identifies the state together with the mark */
+				xfrm_address_t saddr = {};
+				memcpy(&saddr, &state->src, addr_size);
+				mnl_attr_put(nlh, XFRMA_SRCADDR, sizeof(saddr), &saddr);
+			}
+			break;
+		case MNLXT_XFRM_STATE_DST_ADDR:
+			memcpy(daddr, &state->dst, addr_size);
+			break;
+		case MNLXT_XFRM_STATE_MARK:
+			mark.m = state->mark.mask;
+			mark.v = state->mark.value;
+			mnl_attr_put(nlh, XFRMA_MARK, sizeof(mark), &mark);
+			break;
+		}
+		if (NULL == xsinfo) {
+			/* only the identity of a state is put into delete and get requests */
+			continue;
+		}
+		switch (i) {
+		case MNLXT_XFRM_STATE_MODE:
+			xsinfo->mode = state->mode;
+			break;
+		case MNLXT_XFRM_STATE_REQID:
+			xsinfo->reqid = state->reqid;
+			break;
+		case MNLXT_XFRM_STATE_REPLAY_WINDOW:
+			xsinfo->replay_window = state->replay_window;
+			break;
+		case MNLXT_XFRM_STATE_FLAGS:
+			xsinfo->flags = state->flags;
+			break;
+		case MNLXT_XFRM_STATE_IF_ID:
+#ifdef HAVE_XFRMA_IF_ID
+			mnl_attr_put_u32(nlh, XFRMA_IF_ID, state->if_id);
+#else
+			errno = EOPNOTSUPP;
+			goto failed;
+#endif
+			break;
+		case MNLXT_XFRM_STATE_ENCAP:
+			encap.encap_type = state->encap.type;
+			encap.encap_sport = htons(state->encap.sport);
+			encap.encap_dport = htons(state->encap.dport);
+			memcpy(&encap.encap_oa, &state->encap.oa, addr_size);
+			mnl_attr_put(nlh, XFRMA_ENCAP, sizeof(encap), &encap);
+			break;
+		case MNLXT_XFRM_STATE_LIFETIME:
+			xsinfo->lft = state->lifetime;
+			break;
+		case MNLXT_XFRM_STATE_AUTH:
+			mnlxt_xfrm_state_put_alg(nlh, XFRMA_ALG_AUTH_TRUNC, &state->auth);
+			break;
+		case MNLXT_XFRM_STATE_CRYPT:
+			mnlxt_xfrm_state_put_alg(nlh, XFRMA_ALG_CRYPT, &state->crypt);
+			break;
+		case MNLXT_XFRM_STATE_AEAD:
+			mnlxt_xfrm_state_put_alg(nlh, XFRMA_ALG_AEAD, &state->aead);
+			break;
+		}
+	}
+	rc = 0;
+failed:
+	return rc;
+}
+
+void mnlxt_xfrm_state_info_set(mnlxt_xfrm_state_t *state, const struct xfrm_usersa_info *xsinfo) {
+	state->family = xsinfo->family;
+	state->proto = xsinfo->id.proto;
+	state->spi = ntohl(xsinfo->id.spi);
+	memcpy(&state->src, &xsinfo->saddr, sizeof(state->src));
+	memcpy(&state->dst, &xsinfo->id.daddr, sizeof(state->dst));
+	state->mode = xsinfo->mode;
+	state->reqid = xsinfo->reqid;
+	state->replay_window = xsinfo->replay_window;
+	state->flags = xsinfo->flags;
+	state->lifetime = xsinfo->lft;
+	state->prop_flags |= MNLXT_FLAG(MNLXT_XFRM_STATE_FAMILY) | MNLXT_FLAG(MNLXT_XFRM_STATE_PROTO)
+											 | MNLXT_FLAG(MNLXT_XFRM_STATE_SPI) | MNLXT_FLAG(MNLXT_XFRM_STATE_SRC_ADDR)
+											 | MNLXT_FLAG(MNLXT_XFRM_STATE_DST_ADDR) | MNLXT_FLAG(MNLXT_XFRM_STATE_MODE)
+											 | MNLXT_FLAG(MNLXT_XFRM_STATE_REQID) | MNLXT_FLAG(MNLXT_XFRM_STATE_REPLAY_WINDOW)
+											 | MNLXT_FLAG(MNLXT_XFRM_STATE_FLAGS) | MNLXT_FLAG(MNLXT_XFRM_STATE_LIFETIME);
+}
+
+/* parses the algorithm of an XFRMA_ALG_* attribute */
+static int mnlxt_xfrm_state_alg(mnlxt_xfrm_alg_t *alg, const struct nlattr *attr) {
+	int rc = -1;
+	const void *payload = mnl_attr_get_payload(attr);
+	const char *key;
+	size_t size, attr_len = mnl_attr_get_payload_len(attr);
+	uint16_t type = mnl_attr_get_type(attr);
+
+	if (XFRMA_ALG_AUTH_TRUNC == type) {
+		size = sizeof(struct xfrm_algo_auth);
+	} else if (XFRMA_ALG_AEAD == type) {
+		size = sizeof(struct xfrm_algo_aead);
+	} else {
+		size = sizeof(struct xfrm_algo);
+	}
+	if (attr_len < size) {
+		goto failed;
+	}
+	memset(alg, 0, sizeof(*alg));
+	if (XFRMA_ALG_AUTH_TRUNC == type) {
+		const struct xfrm_algo_auth *auth = payload;
+		memcpy(alg->name, auth->alg_name, strnlen(auth->alg_name, sizeof(alg->name) - 1));
+		alg->key_len = auth->alg_key_len;
+		alg->icv_len = auth->alg_trunc_len;
+		key = auth->alg_key;
+	} else if (XFRMA_ALG_AEAD == type) {
+		const struct xfrm_algo_aead *aead = payload;
+		memcpy(alg->name, aead->alg_name, strnlen(aead->alg_name, sizeof(alg->name) - 1));
+		alg->key_len = aead->alg_key_len;
+		alg->icv_len = aead->alg_icv_len;
+		key = aead->alg_key;
+	} else {
+		const struct xfrm_algo *crypt = payload;
+		memcpy(alg->name, crypt->alg_name, strnlen(crypt->alg_name, sizeof(alg->name) - 1));
+		alg->key_len = crypt->alg_key_len;
+		key = crypt->alg_key;
+	}
+	if (8 * MNLXT_XFRM_ALG_KEY_MAX < alg->key_len || attr_len < size + (alg->key_len + 7) / 8) {
+		goto failed;
+	}
+	memcpy(alg->key, key, (alg->key_len + 7) / 8);
+	rc = 0;
+failed:
+	return rc;
+}
+
+int mnlxt_xfrm_state_attrs(mnlxt_data_t *data, mnlxt_xfrm_state_t *state, const struct nlmsghdr *nlh, size_t offset) {
+	struct xfrm_encap_tmpl *encap;
+	struct xfrm_mark *mark;
+	struct nlattr *attr;
+
+	mnl_attr_for_each(attr, nlh, offset) {
+		int type = mnl_attr_get_type(attr);
+		/* skip unsupported attribute in user-space */
+		if (0 > mnl_attr_type_valid(attr, XFRMA_MAX)) {
+			continue;
+		}
+		switch (type) {
+		case XFRMA_SA:
+			/* deleted states are reported with all their information */
+			if (0 > mnl_attr_validate2(attr, MNL_TYPE_BINARY, sizeof(struct xfrm_usersa_info))) {
+				data->error_str = "XFRMA_SA validation failed";
+				return -1;
+			}
+			mnlxt_xfrm_state_info_set(state, mnl_attr_get_payload(attr));
+			break;
+		case XFRMA_SRCADDR:
+			if (0 > mnl_attr_validate2(attr, MNL_TYPE_BINARY, sizeof(xfrm_address_t))) {
+				data->error_str = "XFRMA_SRCADDR validation failed";
+				return -1;
+			}
+			memcpy(&state->src, mnl_attr_get_payload(attr), sizeof(state->src));
+			MNLXT_SET_PROP_FLAG(state, MNLXT_XFRM_STATE_SRC_ADDR);
+			break;
+		case XFRMA_ALG_AUTH:
+			/* the truncated variant is reported too and preferred */
+			if (MNLXT_GET_PROP_FLAG(state, MNLXT_XFRM_STATE_AUTH)) {
+				break;
+			}
+			if (0 != mnlxt_xfrm_state_alg(&state->auth, attr)) {
+				data->error_str = "XFRMA_ALG_AUTH validation failed";
+				return -1;
+			}
+			MNLXT_SET_PROP_FLAG(state, MNLXT_XFRM_STATE_AUTH);
+			break;
+		case XFRMA_ALG_AUTH_TRUNC:
+			if (0 != mnlxt_xfrm_state_alg(&state->auth, attr)) {
+				data->error_str = "XFRMA_ALG_AUTH_TRUNC validation failed";
+				return -1;
+			}
+			MNLXT_SET_PROP_FLAG(state, MNLXT_XFRM_STATE_AUTH);
+			break;
+		case XFRMA_ALG_CRYPT:
+			if (0 != mnlxt_xfrm_state_alg(&state->crypt, attr)) {
+				data->error_str = "XFRMA_ALG_CRYPT validation failed";
+				return -1;
+			}
+			MNLXT_SET_PROP_FLAG(state, MNLXT_XFRM_STATE_CRYPT);
+			break;
+		case XFRMA_ALG_AEAD:
+			if (0 != mnlxt_xfrm_state_alg(&state->aead, attr)) {
+				data->error_str = "XFRMA_ALG_AEAD validation failed";
+				return -1;
+			}
+			MNLXT_SET_PROP_FLAG(state, MNLXT_XFRM_STATE_AEAD);
+			break;
+		case XFRMA_ENCAP:
+			if (0 > mnl_attr_validate2(attr, MNL_TYPE_BINARY, sizeof(struct xfrm_encap_tmpl))) {
+				data->error_str = "XFRMA_ENCAP validation failed";
+				return -1;
+			}
+			encap = mnl_attr_get_payload(attr);
+			state->encap.type = encap->encap_type;
+			state->encap.sport = ntohs(encap->encap_sport);
+			state->encap.dport = ntohs(encap->encap_dport);
+			memcpy(&state->encap.oa, &encap->encap_oa, sizeof(state->encap.oa));
+			MNLXT_SET_PROP_FLAG(state, MNLXT_XFRM_STATE_ENCAP);
+			break;
+		case XFRMA_MARK:
+			if (0 > mnl_attr_validate2(attr, MNL_TYPE_BINARY, sizeof(struct xfrm_mark))) {
+				data->error_str = "XFRMA_MARK validation failed";
+				return -1;
+			}
+			mark = mnl_attr_get_payload(attr);
+			mnlxt_xfrm_state_set_mark(state, mark->v, mark->m);
+			break;
+#ifdef HAVE_XFRMA_IF_ID
+		case XFRMA_IF_ID:
+			if (0 > mnl_attr_validate(attr, MNL_TYPE_U32)) {
+				data->error_str = "XFRMA_IF_ID validation failed";
+				return -1;
+			}
+			mnlxt_xfrm_state_set_if_id(state, mnl_attr_get_u32(attr));
+			break;
+#endif
+		default:
+			break;
+		}
+	}
+	return 0;
+}
+
+int mnlxt_xfrm_state_data(const struct nlmsghdr *nlh, mnlxt_data_t *data) {
+	int rc = MNL_CB_ERROR;
+	size_t payload_size = 0;
+	mnlxt_message_t *msg = NULL;
+	mnlxt_xfrm_state_t *state = NULL;
+	struct xfrm_usersa_info *xsinfo = NULL;
+	struct xfrm_usersa_id *xsid = NULL;
+
+	if (NULL == data) {
+		errno = EINVAL;
+		goto end;
+	}
+
+	if (NULL == nlh) {
+		errno = EINVAL;
+		data->error_str = "invalid arguments";
+		goto end;
+	}
+
+	if (XFRM_MSG_NEWSA == nlh->nlmsg_type || XFRM_MSG_UPDSA == nlh->nlmsg_type || XFRM_MSG_GETSA == nlh->nlmsg_type) {
+		xsinfo = mnl_nlmsg_get_payload(nlh);
+		payload_size = sizeof(struct xfrm_usersa_info);
+	} else if (XFRM_MSG_DELSA == nlh->nlmsg_type) {
+		xsid = mnl_nlmsg_get_payload(nlh);
+		payload_size = sizeof(struct xfrm_usersa_id);
+	} else {
+		errno = EBADMSG;
+		data->error_str = "unsupported message type";
+		goto end;
+	}
+
+	state = mnlxt_data_alloc(data, sizeof(mnlxt_xfrm_state_t));
+	if (NULL == state) {
+		data->error_str = "mnlxt_data_alloc failed";
+		goto end;
+	}
+
+	if (NULL != xsinfo) {
+		mnlxt_xfrm_state_info_set(state, xsinfo);
+	} else {
+		state->family = xsid->family;
+		state->proto = xsid->proto;
+		state->spi = ntohl(xsid->spi);
+		memcpy(&state->dst, &xsid->daddr, sizeof(state->dst));
+		state->prop_flags |= MNLXT_FLAG(MNLXT_XFRM_STATE_FAMILY) | MNLXT_FLAG(MNLXT_XFRM_STATE_PROTO)
+												 | MNLXT_FLAG(MNLXT_XFRM_STATE_SPI) | MNLXT_FLAG(MNLXT_XFRM_STATE_DST_ADDR);
+	}
+
+	if (0 != mnlxt_xfrm_state_attrs(data, state, nlh, payload_size)) {
+		goto end;
+	}
+
+	msg = mnlxt_xfrm_data_message_new(data, nlh->nlmsg_type, state);
+	if (NULL == msg) {
+		data->error_str = "mnlxt_xfrm_data_message_new failed";
+		goto end;
+	}
+
+	mnlxt_data_add(data, msg);
+	state = NULL;
+	msg = NULL;
+	rc = MNL_CB_OK;
+end:
+	mnlxt_data_release(data, state, mnlxt_xfrm_state_FREE);
+	mnlxt_message_free(msg);
+
+	return rc;
+}
+
+mnlxt_xfrm_state_t *mnlxt_xfrm_state_iterate(mnlxt_data_t *data, mnlxt_message_t **iterator) {
+	mnlxt_xfrm_state_t *state = NULL;
+	if (iterator) {
+		while ((*iterator = mnlxt_data_iterate(data, *iterator))) {
+			if ((state = mnlxt_xfrm_state_get(*iterator))) {
+				break;
+			}
+		}
+	}
+	return state;
+}
+
+int mnlxt_xfrm_state_dump(mnlxt_data_t *data) {
+	return mnlxt_xfrm_state_handle_dump(NULL, data);
+}
+
+int mnlxt_xfrm_state_handle_dump(mnlxt_handle_t *handle, mnlxt_data_t *data) {
+	return mnlxt_xfrm_handle_data_dump(handle, data, XFRM_MSG_GETSA);
+}
+
+int mnlxt_xfrm_state_request(mnlxt_xfrm_state_t *state, uint16_t type, uint16_t flags) {
+	return mnlxt_xfrm_state_handle_request(NULL, state, type, flags);
+}
+
+int mnlxt_xfrm_state_handle_request(mnlxt_handle_t *handle, mnlxt_xfrm_state_t *state, uint16_t type,
+																		uint16_t flags) {
+	int rc = -1;
+	mnlxt_message_t *message = mnlxt_xfrm_state_message(&state, type, flags);
+	if (NULL != message) {
+		rc = mnlxt_xfrm_handle_message_request(handle, message);
+		mnlxt_xfrm_state_remove(message);
+		mnlxt_message_free(message);
+	}
+	return rc;
+}
+
+mnlxt_message_t *mnlxt_xfrm_state_message(mnlxt_xfrm_state_t **state, uint16_t type, uint16_t flags) {
+	mnlxt_message_t *message = NULL;
+	if (NULL == state || NULL == *state
+			|| !(XFRM_MSG_NEWSA == type || XFRM_MSG_UPDSA == type || XFRM_MSG_DELSA == type)) {
+		errno = EINVAL;
+	} else if (NULL != (message = mnlxt_xfrm_message_new(type, flags, *state))) {
+		*state = NULL;
+	}
+	return message;
+}
+
+int mnlxt_xfrm_state_flush(mnlxt_handle_t *handle, uint8_t proto) {
+	int rc;
+	mnlxt_data_t data = {};
+	struct nlmsghdr *nlh;
+	struct xfrm_usersa_flush *xsf;
+	char buf[MNL_NLMSG_HDRLEN + MNL_ALIGN(sizeof(struct xfrm_usersa_flush))];
+
+	nlh = mnl_nlmsg_put_header(buf);
+	nlh->nlmsg_type = XFRM_MSG_FLUSHSA;
+	xsf = mnl_nlmsg_put_extra_header(nlh, sizeof(*xsf));
+	xsf->proto = proto;
+
+	/* the kernel answers with the acknowledge only */
+	rc = mnlxt_xfrm_get_request(handle, &data, nlh);
+	mnlxt_data_clean(&data);
+
+	return rc;
+}
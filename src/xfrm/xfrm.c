@@ -11,21 +11,39 @@
 #include <errno.h>
 
 #include "libmnlxt/xfrm.h"
+#include "private/data.h"
 #include "private/internal.h"
 
 static const mnlxt_data_cb_t data_handlers[] = {
+	[XFRM_MSG_NEWSA] = {"NEWSA", mnlxt_xfrm_state_DATA, mnlxt_xfrm_state_PUT, mnlxt_xfrm_state_FREE, NLM_F_CREATE},
+	[XFRM_MSG_DELSA] = {"DELSA", mnlxt_xfrm_state_DATA, mnlxt_xfrm_state_PUT, mnlxt_xfrm_state_FREE, 0},
+	[XFRM_MSG_GETSA] = {"GETSA", mnlxt_xfrm_state_DATA, mnlxt_xfrm_state_PUT, mnlxt_xfrm_state_FREE, 0},
 	[XFRM_MSG_NEWPOLICY]
 	= {"NEWPOLICY", mnlxt_xfrm_policy_DATA, mnlxt_xfrm_policy_PUT, mnlxt_xfrm_policy_FREE, NLM_F_CREATE},
 	[XFRM_MSG_DELPOLICY] = {"DELPOLICY", mnlxt_xfrm_policy_DATA, mnlxt_xfrm_policy_PUT, mnlxt_xfrm_policy_FREE, 0},
 	[XFRM_MSG_GETPOLICY] = {"GETPOLICY", mnlxt_xfrm_policy_DATA, mnlxt_xfrm_policy_PUT, mnlxt_xfrm_policy_FREE, 0},
 	[XFRM_MSG_UPDPOLICY]
 	= {"UPDPOLICY", mnlxt_xfrm_policy_DATA, mnlxt_xfrm_policy_PUT, mnlxt_xfrm_policy_FREE, NLM_F_CREATE | NLM_F_REPLACE},
+	[XFRM_MSG_UPDSA]
+	= {"UPDSA", mnlxt_xfrm_state_DATA, mnlxt_xfrm_state_PUT, mnlxt_xfrm_state_FREE, NLM_F_CREATE | NLM_F_REPLACE},
+	[XFRM_MSG_NEWSPDINFO]
+	= {"NEWSPDINFO", mnlxt_xfrm_spdinfo_DATA, mnlxt_xfrm_spdinfo_PUT, mnlxt_xfrm_spdinfo_FREE, 0},
+	[XFRM_MSG_GETSPDINFO]
+	= {"GETSPDINFO", mnlxt_xfrm_spdinfo_DATA, mnlxt_xfrm_spdinfo_PUT, mnlxt_xfrm_spdinfo_FREE, 0},
+	[XFRM_MSG_ACQUIRE] = {"ACQUIRE", mnlxt_xfrm_acquire_DATA, NULL, mnlxt_xfrm_acquire_FREE, 0},
+	[XFRM_MSG_EXPIRE] = {"EXPIRE", mnlxt_xfrm_expire_DATA, NULL, mnlxt_xfrm_expire_FREE, 0},
+	[XFRM_MSG_POLEXPIRE] = {"POLEXPIRE", mnlxt_xfrm_polexpire_DATA, NULL, mnlxt_xfrm_polexpire_FREE, 0},
+	[XFRM_MSG_MAPPING] = {"MAPPING", mnlxt_xfrm_mapping_DATA, NULL, mnlxt_xfrm_mapping_FREE, 0},
 };
 
 static const size_t data_nhandlers = MNL_ARRAY_SIZE(data_handlers);
 
 int mnlxt_xfrm_connect(mnlxt_handle_t *handle, int group) {
-	int rc = mnlxt_connect(handle, NETLINK_XFRM, group);
+	return mnlxt_xfrm_connect_opts(handle, group, NULL);
+}
+
+int mnlxt_xfrm_connect_opts(mnlxt_handle_t *handle, int group, const mnlxt_connect_opts_t *opts) {
+	int rc = mnlxt_connect_opts(handle, NETLINK_XFRM, group, opts);
 
 	if (!rc) {
 		handle->data_handlers = data_handlers;
@@ -35,7 +53,22 @@ int mnlxt_xfrm_connect(mnlxt_handle_t *handle, int group) {
 	return rc;
 }
 
-int mnlxt_xfrm_data_dump(mnlxt_data_t *data, int type) {
+int mnlxt_xfrm_get_request(mnlxt_handle_t *handle, mnlxt_data_t *data, struct nlmsghdr *nlh) {
+	int rc = -1;
+
+	if (NULL == data || NULL == nlh) {
+		errno = EINVAL;
+
+	} else {
+		data->handlers = data_handlers;
+		data->nhandlers = data_nhandlers;
+		rc = mnlxt_data_get(handle, data, NETLINK_XFRM, nlh);
+	}
+
+	return rc;
+}
+
+static int mnlxt_xfrm_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, int type) {
 	int rc = -1;
 
 	if (NULL == data) {
@@ -50,12 +83,24 @@ int mnlxt_xfrm_data_dump(mnlxt_data_t *data, int type) {
 		data->handlers = data_handlers;
 		data->nhandlers = data_nhandlers;
 
-		rc = mnlxt_data_dump(data, NETLINK_XFRM, nlh);
+		if (NULL == handle) {
+			rc = mnlxt_data_dump(data, NETLINK_XFRM, nlh);
+		} else {
+			rc = mnlxt_handle_dump(handle, data, nlh);
+		}
 	}
 
 	return rc;
 }
 
+int mnlxt_xfrm_data_dump(mnlxt_data_t *data, int type) {
+	return mnlxt_xfrm_dump(NULL, data, type);
+}
+
+int mnlxt_xfrm_handle_data_dump(mnlxt_handle_t *handle, mnlxt_data_t *data, int type) {
+	return mnlxt_xfrm_dump(handle, data, type);
+}
+
 static const mnlxt_data_cb_t *mnlxt_xfrm_type_handler(uint16_t type) {
 	const mnlxt_data_cb_t *data_cb = NULL;
 
@@ -72,7 +117,7 @@ static const mnlxt_data_cb_t *mnlxt_xfrm_type_handler(uint16_t type) {
 	return data_cb;
 }
 
-int mnlxt_xfrm_message_request(mnlxt_message_t *message) {
+int mnlxt_xfrm_handle_message_request(mnlxt_handle_t *handle, mnlxt_message_t *message) {
 	const mnlxt_data_cb_t *data_cb;
 	int rc = -1;
 
@@ -81,19 +126,27 @@ int mnlxt_xfrm_message_request(mnlxt_message_t *message) {
 
 	} else if (NULL != (data_cb = mnlxt_xfrm_type_handler(message->nlmsg_type))) {
 		message->handler = data_cb;
-		rc = mnlxt_message_request(message, NETLINK_XFRM);
+		if (NULL == handle) {
+			rc = mnlxt_message_request(message, NETLINK_XFRM);
+		} else {
+			rc = mnlxt_handle_request(handle, message);
+		}
 	}
 
 	return rc;
 }
 
-mnlxt_message_t *mnlxt_xfrm_message_new(uint16_t type, uint16_t flags, void *payload) {
+int mnlxt_xfrm_message_request(mnlxt_message_t *message) {
+	return mnlxt_xfrm_handle_message_request(NULL, message);
+}
+
+static mnlxt_message_t *mnlxt_xfrm_message_create(mnlxt_data_t *data, uint16_t type, uint16_t flags, void *payload) {
 	const mnlxt_data_cb_t *data_cb;
 	mnlxt_message_t *msg = NULL;
 
 	if (NULL == (data_cb = mnlxt_xfrm_type_handler(type))) {
 		errno = EINVAL;
-	} else if (NULL != (msg = mnlxt_message_new())) {
+	} else if (NULL != (msg = mnlxt_data_message_new(data))) {
 		msg->nlmsg_type = type;
 		msg->flags = flags;
 		msg->payload = payload;
@@ -102,3 +155,11 @@ mnlxt_message_t *mnlxt_xfrm_message_new(uint16_t type, uint16_t flags, void *pay
 
 	return msg;
 }
+
+mnlxt_message_t *mnlxt_xfrm_message_new(uint16_t type, uint16_t flags, void *payload) {
+	return mnlxt_xfrm_message_create(NULL, type, flags, payload);
+}
+
+mnlxt_message_t *mnlxt_xfrm_data_message_new(mnlxt_data_t *data, uint16_t type, void *payload) {
+	return mnlxt_xfrm_message_create(data, type, 0, payload);
+}
@@ -0,0 +1,97 @@
+/*
+ * rtnl_async_link.c		Libmnlxt Routing Test - Getting links with pipelined asynchronous requests
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <errno.h>
+#include <net/if.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <libmnlxt/mnlxt.h>
+
+#include "rtnl_common.h"
+
+static void link_cb(mnlxt_handle_t *handle, uint32_t seq, int error, mnlxt_data_t *data, void *arg) {
+	int *failed = (int *)arg;
+	mnlxt_message_t *it = NULL;
+	mnlxt_rt_link_t *link = NULL;
+	if (0 != error) {
+		printf("request %u failed: %s\n", seq, strerror(-error));
+		++*failed;
+	}
+	while ((link = mnlxt_rt_link_iterate(data, &it))) {
+		mnlxt_rt_link_print(link);
+	}
+}
+
+int main(int argc, char **argv) {
+	int rc = EXIT_FAILURE;
+	int failed = 0;
+	int epfd = -1;
+	mnlxt_handle_t handle = {};
+	struct epoll_event ev = {.events = EPOLLIN};
+	int i;
+
+	if (2 > argc) {
+		printf("usage: %s <ifname>...\n", argv[0]);
+		goto err;
+	}
+
+	if (-1 == mnlxt_rt_connect(&handle, 0) || -1 == mnlxt_async_init(&handle, argc - 1)) {
+		fprintf(stderr, "connect failed, %s\n", handle.error_str ? handle.error_str : strerror(errno));
+		goto err;
+	}
+
+	/* all requests are in flight before the first reply is read */
+	for (i = 1; i < argc; ++i) {
+		char buf[MNL_SOCKET_BUFFER_SIZE];
+		struct nlmsghdr *nlh = mnl_nlmsg_put_header(buf);
+		struct ifinfomsg *ifm = mnl_nlmsg_put_extra_header(nlh, sizeof(struct ifinfomsg));
+		nlh->nlmsg_type = RTM_GETLINK;
+		ifm->ifi_family = AF_UNSPEC;
+		mnl_attr_put_strz(nlh, IFLA_IFNAME, argv[i]);
+		if (-1 == mnlxt_async_send(&handle, nlh, link_cb, &failed)) {
+			fprintf(stderr, "mnlxt_async_send failed, %s\n", handle.error_str ? handle.error_str : strerror(errno));
+			goto err;
+		}
+	}
+	printf("%u requests in flight\n", mnlxt_async_pending(&handle));
+
+	if (-1 == (epfd = epoll_create1(0)) || -1 == epoll_ctl(epfd, EPOLL_CTL_ADD, mnlxt_handel_get_fd(&handle), &ev)) {
+		perror("epoll");
+		goto err;
+	}
+	while (0 != mnlxt_async_pending(&handle)) {
+		if (-1 == epoll_wait(epfd, &ev, 1, -1)) {
+			if (EINTR == errno) {
+				continue;
+			}
+			perror("epoll_wait");
+			goto err;
+		}
+		if (-1 == mnlxt_async_process(&handle)) {
+			fprintf(stderr, "mnlxt_async_process failed, %s\n", handle.error_str ? handle.error_str : strerror(errno));
+			goto err;
+		}
+	}
+
+	if (0 == failed) {
+		rc = EXIT_SUCCESS;
+	}
+
+err:
+	if (-1 != epfd) {
+		close(epfd);
+	}
+	mnlxt_disconnect(&handle);
+	return rc;
+}
@@ -0,0 +1,103 @@
+/*
+ * rtnl_cache.c		Libmnlxt Routing Test - keep links, addresses, routes and rules cached
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libmnlxt/mnlxt.h>
+
+#include "rtnl_common.h"
+
+static int running = 1;
+
+static void sigfunc(int sig) {
+	running = 0;
+}
+
+static void change_cb(uint16_t type, mnlxt_rt_cache_object_t object, const void *payload, void *arg) {
+	printf("====> change: %hu\n", type);
+	switch (object) {
+	case MNLXT_RT_CACHE_LINK:
+		mnlxt_rt_link_print((mnlxt_rt_link_t *)payload);
+		break;
+	case MNLXT_RT_CACHE_ADDR:
+		mnlxt_rt_addr_print((mnlxt_rt_addr_t *)payload);
+		break;
+	case MNLXT_RT_CACHE_ROUTE:
+		mnlxt_rt_route_print((mnlxt_rt_route_t *)payload);
+		break;
+	case MNLXT_RT_CACHE_RULE:
+		mnlxt_rt_rule_print((mnlxt_rt_rule_t *)payload);
+		break;
+	}
+}
+
+static void print_counts(const mnlxt_rt_cache_t *cache) {
+	printf("links: %zu, addresses: %zu, routes: %zu, rules: %zu\n", mnlxt_rt_cache_count(cache, MNLXT_RT_CACHE_LINK),
+				 mnlxt_rt_cache_count(cache, MNLXT_RT_CACHE_ADDR), mnlxt_rt_cache_count(cache, MNLXT_RT_CACHE_ROUTE),
+				 mnlxt_rt_cache_count(cache, MNLXT_RT_CACHE_RULE));
+}
+
+int main(int argc, char **argv) {
+	int rc = EXIT_FAILURE;
+	mnlxt_rt_cache_t *cache;
+	mnlxt_rt_link_t *link;
+	void *it = NULL;
+	struct pollfd pfd;
+	int r;
+
+	signal(SIGINT, sigfunc);
+
+	cache = mnlxt_rt_cache_new(MNLXT_FLAG(MNLXT_RT_CACHE_LINK) | MNLXT_FLAG(MNLXT_RT_CACHE_ADDR)
+														 | MNLXT_FLAG(MNLXT_RT_CACHE_ROUTE) | MNLXT_FLAG(MNLXT_RT_CACHE_RULE));
+	if (NULL == cache) {
+		perror("mnlxt_rt_cache_new");
+		return rc;
+	}
+
+	while ((link = mnlxt_rt_cache_link_iterate(cache, &it))) {
+		mnlxt_rt_link_print(link);
+	}
+	print_counts(cache);
+	mnlxt_rt_cache_set_change_cb(cache, change_cb, NULL);
+
+	pfd.fd = mnlxt_rt_cache_get_fd(cache);
+	pfd.events = POLLIN;
+
+	while (running) {
+		r = poll(&pfd, 1, 1000);
+
+		if (0 == r)
+			continue;
+
+		if (1 != r || !(pfd.revents & POLLIN))
+			break;
+
+		r = mnlxt_rt_cache_process(cache);
+		if (0 > r) {
+			printf("mnlxt_rt_cache_process failed: %s, %m\n", mnlxt_rt_cache_error(cache));
+			break;
+		}
+		if (0 < r) {
+			printf("overruns: %lu, ", mnlxt_rt_cache_overruns(cache));
+			print_counts(cache);
+		}
+	}
+
+	if (!running) {
+		rc = EXIT_SUCCESS;
+	}
+
+	mnlxt_rt_cache_free(cache);
+
+	return rc;
+}
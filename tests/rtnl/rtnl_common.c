@@ -298,6 +298,8 @@ void mnlxt_rt_addr_print(mnlxt_rt_addr_t *addr) {
 }
 
 void mnlxt_rt_route_print(mnlxt_rt_route_t *route) {
+	const mnlxt_rt_route_path_t *paths;
+	uint16_t npaths, i;
 	uint32_t u32;
 	uint8_t u8;
 	int ret;
@@ -307,10 +309,17 @@ void mnlxt_rt_route_print(mnlxt_rt_route_t *route) {
 
 	printf("%s\n", "-- Route");
 
+	ret = mnlxt_rt_route_get_nh_id(route, &u32);
+	if (0 == ret) {
+		printf("nh_id: %u\n", u32);
+	} else if (-1 == ret) {
+		printf("error getting nh_id, %m\n");
+	}
+
 	ret = mnlxt_rt_route_get_oifindex(route, &u32);
 	if (0 == ret) {
 		printf("oif_index: %d\n", u32);
-	} else {
+	} else if (0 != mnlxt_rt_route_get_multipath(route, &paths, &npaths)) {
 		printf("missing if_index, %m\n");
 		return;
 	}
@@ -350,9 +359,9 @@ void mnlxt_rt_route_print(mnlxt_rt_route_t *route) {
 		printf("no priority \n");
 	}
 
-	ret = mnlxt_rt_route_get_table(route, &u8);
+	ret = mnlxt_rt_route_get_table(route, &u32);
 	if (0 == ret) {
-		printf("table: %d\n", u8);
+		printf("table: %u\n", u32);
 	} else if (-1 == ret) {
 		printf("error getting table, %m\n");
 	} else {
@@ -420,6 +429,21 @@ void mnlxt_rt_route_print(mnlxt_rt_route_t *route) {
 	} else {
 		printf("no gateway \n");
 	}
+
+	ret = mnlxt_rt_route_get_multipath(route, &paths, &npaths);
+	if (0 == ret) {
+		for (i = 0; i < npaths; ++i) {
+			printf("nexthop: oif_index %u weight %u flags 0x%x", paths[i].oif_index, paths[i].weight, paths[i].flags);
+			if (paths[i].has_gateway) {
+				inet_ntop((paths[i].gateway_family ? paths[i].gateway_family : family), &paths[i].gateway, addr_str,
+									sizeof(addr_str));
+				printf(" gateway %s", addr_str);
+			}
+			printf("\n");
+		}
+	} else if (-1 == ret) {
+		printf("error getting multipath, %m\n");
+	}
 }
 
 void mnlxt_rt_rule_print(mnlxt_rt_rule_t *rule) {
@@ -611,6 +635,122 @@ end:
 	return rc;
 }
 
+void mnlxt_rt_nexthop_print(mnlxt_rt_nexthop_t *nexthop) {
+	const mnlxt_rt_nexthop_grp_t *group;
+	const mnlxt_inet_addr_t *buf;
+	char addr_str[INET6_ADDRSTRLEN];
+	uint32_t u32;
+	uint16_t u16, i;
+	uint8_t u8;
+	int ret;
+
+	if (NULL == nexthop)
+		return;
+
+	printf("%s\n", "-- Nexthop");
+
+	ret = mnlxt_rt_nexthop_get_id(nexthop, &u32);
+	if (0 == ret) {
+		printf("id: %u\n", u32);
+	} else {
+		printf("missing id\n");
+		return;
+	}
+
+	ret = mnlxt_rt_nexthop_get_family(nexthop, &u8);
+	if (0 == ret) {
+		printf("af_family: %d\n", u8);
+	}
+	int family = u8;
+
+	ret = mnlxt_rt_nexthop_get_protocol(nexthop, &u8);
+	if (0 == ret) {
+		printf("protocol: %d\n", u8);
+	}
+
+	ret = mnlxt_rt_nexthop_get_oifindex(nexthop, &u32);
+	if (0 == ret) {
+		printf("oif_index: %u\n", u32);
+	}
+
+	ret = mnlxt_rt_nexthop_get_gateway(nexthop, NULL, &buf);
+	if (0 == ret) {
+		inet_ntop(family, buf, addr_str, sizeof(addr_str));
+		printf("gateway: %s\n", addr_str);
+	}
+
+	if (0 == mnlxt_rt_nexthop_get_blackhole(nexthop)) {
+		printf("blackhole\n");
+	}
+
+	ret = mnlxt_rt_nexthop_get_group(nexthop, &group, &u16);
+	if (0 == ret) {
+		printf("group:");
+		for (i = 0; i < u16; ++i) {
+			printf(" %u/%u", group[i].id, group[i].weight);
+		}
+		printf("\n");
+	} else if (-1 == ret) {
+		printf("error getting group, %m\n");
+	}
+}
+
+void mnlxt_rt_neigh_print(mnlxt_rt_neigh_t *neigh) {
+	const mnlxt_inet_addr_t *buf;
+	char addr_str[INET6_ADDRSTRLEN];
+	mnlxt_eth_addr_t lladdr;
+	uint32_t u32;
+	uint16_t u16;
+	uint8_t u8;
+	int ret;
+
+	if (NULL == neigh)
+		return;
+
+	printf("%s\n", "-- Neighbour");
+
+	ret = mnlxt_rt_neigh_get_ifindex(neigh, &u32);
+	if (0 == ret) {
+		printf("if_index: %u\n", u32);
+	} else {
+		printf("missing if_index\n");
+		return;
+	}
+
+	ret = mnlxt_rt_neigh_get_family(neigh, &u8);
+	if (0 == ret) {
+		printf("af_family: %d\n", u8);
+	}
+	int family = u8;
+
+	ret = mnlxt_rt_neigh_get_dst(neigh, NULL, &buf);
+	if (0 == ret) {
+		inet_ntop(family, buf, addr_str, sizeof(addr_str));
+		printf("dst: %s\n", addr_str);
+	}
+
+	ret = mnlxt_rt_neigh_get_lladdr(neigh, &lladdr);
+	if (0 == ret) {
+		printf("lladdr: %02x:%02x:%02x:%02x:%02x:%02x\n", lladdr[0], lladdr[1], lladdr[2], lladdr[3], lladdr[4],
+					 lladdr[5]);
+	}
+
+	ret = mnlxt_rt_neigh_get_state(neigh, &u16);
+	if (0 == ret) {
+		printf("state: 0x%x\n", u16);
+	}
+
+	ret = mnlxt_rt_neigh_get_flags(neigh, &u8);
+	if (0 == ret) {
+		printf("flags: 0x%x\n", u8);
+	}
+
+	ret = mnlxt_rt_neigh_get_vlan(neigh, &u16);
+	if (0 == ret) {
+		printf("vlan: %u\n", u16);
+	}
+}
+
 int validate_ip(mnlxt_inet_addr_t *ipaddr, int *prefix, int *family, const char *ipstr) {
 	int rc = -1;
 	if (ipstr) {
@@ -15,6 +15,8 @@ void mnlxt_rt_link_print(mnlxt_rt_link_t *link);
 void mnlxt_rt_addr_print(mnlxt_rt_addr_t *addr);
 void mnlxt_rt_route_print(mnlxt_rt_route_t *route);
 void mnlxt_rt_rule_print(mnlxt_rt_rule_t *rule);
+void mnlxt_rt_nexthop_print(mnlxt_rt_nexthop_t *nexthop);
+void mnlxt_rt_neigh_print(mnlxt_rt_neigh_t *neigh);
 
 int validate_ip(mnlxt_inet_addr_t *ipaddr, int *prefix, int *family, const char *ipstr);
 
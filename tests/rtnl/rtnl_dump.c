@@ -27,7 +27,7 @@ static int test_addr_dump() {
 	} else {
 		mnlxt_message_t *it = NULL;
 		mnlxt_rt_addr_t *addr = NULL;
-		// printf("number of datasets: %d\n",);
+		printf("number of datasets: %zu\n", mnlxt_data_count(&data));
 		while ((addr = mnlxt_rt_addr_iterate(&data, &it))) {
 			mnlxt_rt_addr_print(addr);
 		}
@@ -53,7 +53,7 @@ static int test_route_dump() {
 	} else {
 		mnlxt_message_t *it = NULL;
 		mnlxt_rt_route_t *route = NULL;
-		// printf("number of datasets: %d\n", ?);
+		printf("number of datasets: %zu\n", mnlxt_data_count(&data));
 		while ((route = mnlxt_rt_route_iterate(&data, &it))) {
 			mnlxt_rt_route_print(route);
 		}
@@ -79,7 +79,7 @@ static int test_rule_dump() {
 	} else {
 		mnlxt_message_t *it = NULL;
 		mnlxt_rt_rule_t *rule = NULL;
-		// printf("number of datasets: %d\n", ?);
+		printf("number of datasets: %zu\n", mnlxt_data_count(&data));
 		while ((rule = mnlxt_rt_rule_iterate(&data, &it))) {
 			mnlxt_rt_rule_print(rule);
 		}
@@ -105,7 +105,7 @@ static int test_link_dump() {
 	} else {
 		mnlxt_message_t *it = NULL;
 		mnlxt_rt_link_t *link = NULL;
-		// printf("number of datasets: %d\n", ?);
+		printf("number of datasets: %zu\n", mnlxt_data_count(&data));
 		while ((link = mnlxt_rt_link_iterate(&data, &it))) {
 			mnlxt_rt_link_print(link);
 		}
@@ -119,11 +119,249 @@ static int test_link_dump() {
 	return rc;
 }
 
+static int route_stream_cb(mnlxt_message_t *message, void *arg) {
+	size_t *count = (size_t *)arg;
+	mnlxt_rt_route_print(mnlxt_rt_route_get(message));
+	++*count;
+	return 0;
+}
+
+static int test_route_stream() {
+	printf("\nmnlxt_rt_route_dump streaming test\n");
+	int rc = -1;
+	size_t count = 0;
+	mnlxt_data_t data = {};
+	mnlxt_data_set_stream(&data, route_stream_cb, &count);
+	if (0 != mnlxt_rt_route_dump(&data, AF_UNSPEC)) {
+		printf("mnlxt_rt_route_dump failed, %m\n");
+	} else if (NULL != mnlxt_data_iterate(&data, NULL)) {
+		printf("streamed routes are stored\n");
+	} else {
+		printf("number of streamed routes: %zu\n", count);
+		rc = 0;
+	}
+	if (data.error_str) {
+		printf("error: %s\n", data.error_str);
+		rc = -1;
+	}
+	mnlxt_data_clean(&data);
+	return rc;
+}
+
+static int test_route_index() {
+	printf("\nmnlxt_rt_route_index test\n");
+	int rc = -1;
+	mnlxt_data_t data = {};
+	mnlxt_rt_route_index_t *index = NULL;
+	if (0 != mnlxt_rt_route_dump(&data, AF_UNSPEC)) {
+		printf("mnlxt_rt_route_dump failed, %m\n");
+	} else if (NULL == (index = mnlxt_rt_route_index_new(mnlxt_data_count(&data)))) {
+		printf("mnlxt_rt_route_index_new failed, %m\n");
+	} else if (0 != mnlxt_rt_route_index_load(index, &data)) {
+		printf("mnlxt_rt_route_index_load failed, %m\n");
+	} else {
+		void *it = NULL;
+		mnlxt_rt_route_t *route = NULL;
+		printf("number of indexed routes: %zu\n", mnlxt_rt_route_index_count(index));
+		rc = 0;
+		while ((route = mnlxt_rt_route_index_iterate(index, &it))) {
+			if (route != mnlxt_rt_route_index_lookup(index, route)) {
+				printf("lookup failed for route:\n");
+				mnlxt_rt_route_print(route);
+				rc = -1;
+			}
+		}
+	}
+	mnlxt_rt_route_index_free(index);
+	mnlxt_data_clean(&data);
+	return rc;
+}
+
+static int test_route_reconcile() {
+	printf("\nmnlxt_rt_route_reconcile test\n");
+	int rc = -1;
+	mnlxt_data_t data = {}, empty = {}, changes = {};
+	if (0 != mnlxt_rt_route_dump(&data, AF_UNSPEC)) {
+		printf("mnlxt_rt_route_dump failed, %m\n");
+	} else if (0 != mnlxt_rt_route_reconcile(&data, &data, &changes)) {
+		printf("mnlxt_rt_route_reconcile failed, %m\n");
+	} else if (0 != mnlxt_data_count(&changes)) {
+		printf("unchanged routes produced %zu changes\n", mnlxt_data_count(&changes));
+	} else if (0 != mnlxt_rt_route_reconcile(&empty, &data, &changes)) {
+		printf("mnlxt_rt_route_reconcile failed, %m\n");
+	} else if (mnlxt_data_count(&data) != mnlxt_data_count(&changes)) {
+		printf("%zu routes produced %zu deletions\n", mnlxt_data_count(&data), mnlxt_data_count(&changes));
+	} else {
+		/* the deletions are not sent */
+		printf("number of deletions of all routes: %zu\n", mnlxt_data_count(&changes));
+		rc = 0;
+	}
+	mnlxt_data_clean(&changes);
+	mnlxt_data_clean(&data);
+	return rc;
+}
+
+static int test_route_lpm() {
+	printf("\nmnlxt_rt_route_lpm test\n");
+	int rc = -1;
+	mnlxt_data_t data = {};
+	mnlxt_rt_route_lpm_t *lpm = NULL;
+	if (0 != mnlxt_rt_route_dump(&data, AF_UNSPEC)) {
+		printf("mnlxt_rt_route_dump failed, %m\n");
+	} else if (NULL == (lpm = mnlxt_rt_route_lpm_new())) {
+		printf("mnlxt_rt_route_lpm_new failed, %m\n");
+	} else if (0 != mnlxt_rt_route_lpm_load(lpm, &data)) {
+		printf("mnlxt_rt_route_lpm_load failed, %m\n");
+	} else {
+		mnlxt_message_t *msg;
+		printf("number of routes for longest prefix match: %zu\n", mnlxt_rt_route_lpm_count(lpm));
+		rc = 0;
+		for (msg = data.first; msg; msg = msg->next) {
+			mnlxt_rt_route_t *route = mnlxt_rt_route_get(msg);
+			const mnlxt_rt_route_t *match;
+			if (NULL == route || (AF_INET != route->family && AF_INET6 != route->family)) {
+				continue;
+			}
+			/* the destination of a route is at least matched by the route itself */
+			match = mnlxt_rt_route_lpm_lookup(lpm, route->table, route->family, &route->dst);
+			if (NULL == match || match->dst_prefix < route->dst_prefix) {
+				printf("longest prefix match failed for route:\n");
+				mnlxt_rt_route_print(route);
+				rc = -1;
+			}
+		}
+	}
+	mnlxt_rt_route_lpm_free(lpm);
+	mnlxt_data_clean(&data);
+	return rc;
+}
+
+static int test_nexthop_dump() {
+	printf("\nmnlxt_rt_nexthop_dump test\n");
+	int rc = -1;
+	mnlxt_data_t data = {};
+	if (0 != mnlxt_rt_nexthop_dump(&data, AF_UNSPEC)) {
+		/* kernels before 5.3 have no nexthop objects */
+		printf("mnlxt_rt_nexthop_dump failed, %m\n");
+		if (data.error_str) {
+			printf("error: %s\n", data.error_str);
+		}
+	} else {
+		mnlxt_message_t *it = NULL;
+		mnlxt_rt_nexthop_t *nexthop = NULL;
+		printf("number of datasets: %zu\n", mnlxt_data_count(&data));
+		while ((nexthop = mnlxt_rt_nexthop_iterate(&data, &it))) {
+			mnlxt_rt_nexthop_print(nexthop);
+		}
+		if (data.error_str) {
+			printf("error: %s\n", data.error_str);
+		} else {
+			rc = 0;
+		}
+		mnlxt_data_clean(&data);
+	}
+	return rc;
+}
+
+static int test_neigh_dump() {
+	printf("\nmnlxt_rt_neigh_dump test\n");
+	int rc = -1;
+	mnlxt_data_t data = {};
+	if (0 != mnlxt_rt_neigh_dump(&data, AF_UNSPEC)) {
+		printf("mnlxt_rt_neigh_dump failed, %m\n");
+		if (data.error_str) {
+			printf("error: %s\n", data.error_str);
+		}
+	} else {
+		mnlxt_message_t *it = NULL;
+		mnlxt_rt_neigh_t *neigh = NULL;
+		printf("number of datasets: %zu\n", mnlxt_data_count(&data));
+		while ((neigh = mnlxt_rt_neigh_iterate(&data, &it))) {
+			mnlxt_rt_neigh_print(neigh);
+		}
+		if (data.error_str) {
+			printf("error: %s\n", data.error_str);
+		} else {
+			rc = 0;
+		}
+		mnlxt_data_clean(&data);
+	}
+	return rc;
+}
+
+static int test_stats_table() {
+	printf("\nmnlxt_rt_stats_table_update test\n");
+	int rc = -1;
+	mnlxt_rt_stats_table_t table = {};
+	if (0 != mnlxt_rt_stats_table_update(NULL, &table, 0)) {
+		/* kernels before 4.7 have no RTM_GETSTATS */
+		printf("mnlxt_rt_stats_table_update failed, %m\n");
+	} else {
+		const mnlxt_rt_stats_t *stats;
+		size_t i;
+		printf("number of interfaces: %zu\n", table.size);
+		for (i = 0; i < table.size; ++i) {
+			stats = &table.entries[i];
+			printf("if_index: %u rx_bytes: %llu tx_bytes: %llu\n", stats->if_index,
+						 (unsigned long long)stats->stats.rx_bytes, (unsigned long long)stats->stats.tx_bytes);
+		}
+		if (0 < table.size && NULL == mnlxt_rt_stats_table_find(&table, table.entries[0].if_index)) {
+			printf("mnlxt_rt_stats_table_find failed\n");
+		} else {
+			rc = 0;
+		}
+	}
+	mnlxt_rt_stats_table_clean(&table);
+	return rc;
+}
+
+static int test_route_dump_filter() {
+	printf("\nmnlxt_rt_route_dump_filter test\n");
+	int rc = -1;
+	mnlxt_data_t data = {};
+	mnlxt_rt_route_t *filter = mnlxt_rt_route_new();
+	if (NULL == filter) {
+		printf("mnlxt_rt_route_new failed, %m\n");
+		return rc;
+	}
+	mnlxt_rt_route_set_family(filter, AF_INET);
+	mnlxt_rt_route_set_table(filter, RT_TABLE_MAIN);
+	if (0 != mnlxt_rt_route_dump_filter(&data, filter)) {
+		printf("mnlxt_rt_route_dump_filter failed, %m\n");
+		if (data.error_str) {
+			printf("error: %s\n", data.error_str);
+		}
+	} else {
+		mnlxt_message_t *it = NULL;
+		mnlxt_rt_route_t *route = NULL;
+		printf("number of datasets: %zu\n", mnlxt_data_count(&data));
+		rc = 0;
+		while ((route = mnlxt_rt_route_iterate(&data, &it))) {
+			/* kernels without strict checking ignore the filter */
+			if (0 != mnlxt_rt_route_match(route, filter)) {
+				continue;
+			}
+			mnlxt_rt_route_print(route);
+		}
+		mnlxt_data_clean(&data);
+	}
+	mnlxt_rt_route_free(filter);
+	return rc;
+}
+
 int main(int argc, char **argv) {
 	int rc = 1, ret = 0;
 	ret |= test_addr_dump();
 	ret |= test_route_dump();
+	ret |= test_route_dump_filter();
+	ret |= test_route_stream();
+	ret |= test_route_index();
+	ret |= test_route_lpm();
+	ret |= test_route_reconcile();
 	ret |= test_rule_dump();
+	ret |= test_nexthop_dump();
+	ret |= test_neigh_dump();
+	ret |= test_stats_table();
 	ret |= test_link_dump();
 	if (0 == ret) {
 		rc = 0;
@@ -8,6 +8,7 @@
  *
  */
 
+#include <errno.h>
 #include <poll.h>
 #include <signal.h>
 #include <stdio.h>
@@ -39,7 +40,7 @@ int main(int argc, char **argv) {
 
 		groups |= RTMGRP_LINK;
 		// groups |= RTMGRP_NOTIFY;
-		// groups |= RTMGRP_NEIGH;
+		groups |= RTMGRP_NEIGH;
 		// groups |= RTMGRP_TC;
 
 		groups |= RTMGRP_IPV4_IFADDR;
@@ -59,6 +60,11 @@ int main(int argc, char **argv) {
 			break;
 		}
 
+		if (-1 == mnlxt_handle_add_group(&handle, RTNLGRP_NEXTHOP)) {
+			perror("mnlxt_handle_add_group");
+			break;
+		}
+
 		pfd.fd = mnlxt_handel_get_fd(&handle);
 		pfd.events = POLLIN;
 
@@ -73,7 +79,7 @@ int main(int argc, char **argv) {
 
 			memset(&buffer, 0, sizeof(buffer));
 
-			r = mnlxt_receive(&handle, &buffer);
+			r = mnlxt_receive_inplace(&handle, &buffer);
 
 			if (0 < r) {
 				memset(&data, 0, sizeof(data));
@@ -92,6 +98,8 @@ int main(int argc, char **argv) {
 						mnlxt_rt_addr_print(mnlxt_rt_addr_get(msg));
 						mnlxt_rt_route_print(mnlxt_rt_route_get(msg));
 						mnlxt_rt_rule_print(mnlxt_rt_rule_get(msg));
+						mnlxt_rt_nexthop_print(mnlxt_rt_nexthop_get(msg));
+						mnlxt_rt_neigh_print(mnlxt_rt_neigh_get(msg));
 					}
 
 					mnlxt_data_clean(&data);
@@ -105,8 +113,12 @@ int main(int argc, char **argv) {
 			} else if (0 == r) {
 				/* empy read, continue */
 
+			} else if (ENOBUFS == errno) {
+				/* events were dropped, a real listener would dump again */
+				printf("====> overrun (%lu)\n", mnlxt_handle_get_overruns(&handle));
+
 			} else {
-				perror("mnlxt_receive");
+				perror("mnlxt_receive_inplace");
 				break;
 			}
 		}
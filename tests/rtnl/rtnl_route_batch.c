@@ -0,0 +1,129 @@
+/*
+ * rtnl_route_batch.c		Libmnlxt Routing Test - Setting/Deleting many routes in batched requests
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <net/if.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libmnlxt/mnlxt.h>
+
+#include "rtnl_common.h"
+
+static void usage(const char *progname) {
+	printf("usage: %s add|del <dst> <count> dev <ifname>\n"
+				 "\t dst		IP address of the first host route\n"
+				 "\t count		number of host routes to create/delete\n"
+				 "\t ifname		interface name\n",
+				 progname);
+}
+
+static void inet_addr_inc(mnlxt_inet_addr_t *addr, int family) {
+	uint32_t *u32 = (AF_INET == family ? &addr->in.s_addr : &addr->in6.s6_addr32[3]);
+	*u32 = htonl(ntohl(*u32) + 1);
+}
+
+int main(int argc, char **argv) {
+	int rc = EXIT_FAILURE;
+	int action = 0;
+	const char *progname = argv[0];
+	mnlxt_handle_t handle = {};
+	mnlxt_connect_opts_t opts = {};
+	mnlxt_data_t data = {};
+	mnlxt_inet_addr_t addr_buf = {};
+	mnlxt_rt_route_t *rt_route = NULL;
+	mnlxt_message_t *msg = NULL;
+	int prefix = 0, family = AF_INET, ifindex = 0;
+	long count, i;
+
+	if (6 != argc || strcmp("dev", argv[4])) {
+		usage(progname);
+		goto err;
+	}
+
+	if (!strcmp("add", argv[1])) {
+		action = RTM_NEWROUTE;
+	} else if (!strcmp("del", argv[1])) {
+		action = RTM_DELROUTE;
+	} else {
+		fprintf(stderr, "Invalid argument: %s\n", argv[1]);
+		usage(progname);
+		goto err;
+	}
+
+	if (0 != validate_ip(&addr_buf, &prefix, &family, argv[2])) {
+		fprintf(stderr, "Invalid route destination: %s\n", argv[2]);
+		goto err;
+	}
+
+	if (0 >= (count = strtol(argv[3], NULL, 10))) {
+		fprintf(stderr, "Invalid route count: %s\n", argv[3]);
+		goto err;
+	}
+
+	if (0 == (ifindex = if_nametoindex(argv[5]))) {
+		fprintf(stderr, "Invalid interface name: %s\n", argv[5]);
+		goto err;
+	}
+
+	for (i = 0; i < count; ++i, inet_addr_inc(&addr_buf, family)) {
+		if (NULL == (rt_route = mnlxt_rt_route_new())) {
+			fprintf(stderr, "mnlxt_rt_route_new failed\n");
+			goto err;
+		}
+		mnlxt_rt_route_set_table(rt_route, RT_TABLE_MAIN);
+		mnlxt_rt_route_set_type(rt_route, RTN_UNICAST);
+		mnlxt_rt_route_set_scope(rt_route, RT_SCOPE_LINK);
+		mnlxt_rt_route_set_protocol(rt_route, RTPROT_BOOT);
+		mnlxt_rt_route_set_dst(rt_route, (uint8_t)family, &addr_buf);
+		mnlxt_rt_route_set_dst_prefix(rt_route, (AF_INET == family ? 32 : 128));
+		mnlxt_rt_route_set_oifindex(rt_route, ifindex);
+		if (NULL == (msg = mnlxt_rt_route_message(&rt_route, action, 0))) {
+			fprintf(stderr, "mnlxt_rt_route_message failed\n");
+			goto err;
+		}
+		mnlxt_data_add(&data, msg);
+	}
+
+	/* acknowledges of large batches do not need to echo the requests */
+	opts.flags = MNLXT_FLAG(MNLXT_CONNECT_CAP_ACK) | MNLXT_FLAG(MNLXT_CONNECT_EXT_ACK);
+	opts.sndbuf = 1 << 20;
+	if (-1 == mnlxt_rt_connect_opts(&handle, 0, &opts)) {
+		perror("mnlxt_rt_connect_opts");
+		goto err;
+	}
+
+	int failed = mnlxt_handle_batch_request(&handle, &data);
+	if (0 > failed) {
+		fprintf(stderr, "mnlxt_handle_batch_request failed, %s\n", handle.error_str ? handle.error_str : strerror(errno));
+		goto err;
+	}
+
+	msg = NULL;
+	while (NULL != (msg = mnlxt_data_iterate(&data, msg))) {
+		if (0 != msg->error) {
+			mnlxt_rt_route_print(mnlxt_rt_route_get(msg));
+			printf("failed: %s\n", strerror(-msg->error));
+		}
+	}
+	printf("%ld requests sent, %d failed\n", count, failed);
+
+	if (0 == failed) {
+		rc = EXIT_SUCCESS;
+	}
+
+err:
+	mnlxt_rt_route_free(rt_route);
+	mnlxt_data_clean(&data);
+	mnlxt_disconnect(&handle);
+	return rc;
+}
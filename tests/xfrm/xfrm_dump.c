@@ -92,7 +92,83 @@ static int test_policy_dump() {
 			if (0 == ret) {
 				printf("priority %d ", u32);
 			}
-			/* TODO: templates */
+			const mnlxt_xfrm_tmpl_t *tmpls = NULL;
+			ret = mnlxt_xfrm_policy_get_tmpls(policy, &tmpls, &u16);
+			if (0 == ret) {
+				for (int i = 0; i < u16; ++i) {
+					printf("\n\ttmpl src ");
+					inet_ntop(tmpls[i].family, &tmpls[i].src, str, sizeof(str));
+					printf("%s dst ", str);
+					inet_ntop(tmpls[i].family, &tmpls[i].dst, str, sizeof(str));
+					printf("%s proto %d reqid %u mode %d%s", str, tmpls[i].proto, tmpls[i].reqid, tmpls[i].mode,
+								 tmpls[i].optional ? " level use" : "");
+				}
+			}
+			printf("\n");
+		}
+	}
+	if (data.error_str) {
+		printf("error: %s\n", data.error_str);
+	} else {
+		rc = 0;
+	}
+	mnlxt_data_clean(&data);
+	return rc;
+}
+
+static int test_state_dump() {
+	printf("\nmnlxt_xfrm_state_dump test\n");
+	int rc = -1;
+	mnlxt_data_t data = {};
+	if (0 != mnlxt_xfrm_state_dump(&data)) {
+		printf("mnlxt_xfrm_state_dump failed, %m\n");
+	} else {
+		mnlxt_message_t *it = NULL;
+		mnlxt_xfrm_state_t *state = NULL;
+		while ((state = mnlxt_xfrm_state_iterate(&data, &it))) {
+			uint8_t u8;
+			uint32_t u32;
+			const mnlxt_inet_addr_t *buf = NULL;
+			const mnlxt_xfrm_alg_t *alg = NULL;
+			const mnlxt_xfrm_encap_t *encap = NULL;
+			char str[INET6_ADDRSTRLEN] = {};
+			printf("\n");
+			if (0 == mnlxt_xfrm_state_get_src_addr(state, &u8, &buf)) {
+				inet_ntop(u8, buf, str, sizeof(str));
+				printf("src %s ", str);
+			}
+			if (0 == mnlxt_xfrm_state_get_dst_addr(state, &u8, &buf)) {
+				inet_ntop(u8, buf, str, sizeof(str));
+				printf("dst %s ", str);
+			}
+			if (0 == mnlxt_xfrm_state_get_proto(state, &u8)) {
+				printf("proto %d ", u8);
+			}
+			if (0 == mnlxt_xfrm_state_get_spi(state, &u32)) {
+				printf("spi 0x%08x ", u32);
+			}
+			if (0 == mnlxt_xfrm_state_get_reqid(state, &u32)) {
+				printf("reqid %u ", u32);
+			}
+			if (0 == mnlxt_xfrm_state_get_mode(state, &u8)) {
+				printf("mode %d ", u8);
+			}
+			if (0 == mnlxt_xfrm_state_get_if_id(state, &u32)) {
+				printf("if_id %u ", u32);
+			}
+			/* keys are not printed */
+			if (0 == mnlxt_xfrm_state_get_auth(state, &alg)) {
+				printf("auth %s %d ", alg->name, alg->icv_len);
+			}
+			if (0 == mnlxt_xfrm_state_get_crypt(state, &alg)) {
+				printf("enc %s ", alg->name);
+			}
+			if (0 == mnlxt_xfrm_state_get_aead(state, &alg)) {
+				printf("aead %s %d ", alg->name, alg->icv_len);
+			}
+			if (0 == mnlxt_xfrm_state_get_encap(state, &encap)) {
+				printf("encap %d %d %d ", encap->type, encap->sport, encap->dport);
+			}
 			printf("\n");
 		}
 	}
@@ -105,9 +181,168 @@ static int test_policy_dump() {
 	return rc;
 }
 
+static int test_spdinfo_dump() {
+	printf("\nmnlxt_xfrm_spdinfo_dump test\n");
+	int rc = -1;
+	mnlxt_data_t data = {};
+	if (0 != mnlxt_xfrm_spdinfo_dump(&data)) {
+		printf("mnlxt_xfrm_spdinfo_dump failed, %m\n");
+	} else {
+		mnlxt_message_t *it = NULL;
+		mnlxt_xfrm_spdinfo_t *info = NULL;
+		while ((info = mnlxt_xfrm_spdinfo_iterate(&data, &it))) {
+			const struct xfrmu_spdinfo *counts = NULL;
+			const struct xfrmu_spdhinfo *hash = NULL;
+			uint8_t lbits, rbits;
+			if (0 == mnlxt_xfrm_spdinfo_get_counts(info, &counts)) {
+				printf("policies in %u out %u fwd %u, socket in %u out %u fwd %u\n", counts->incnt, counts->outcnt,
+							 counts->fwdcnt, counts->inscnt, counts->outscnt, counts->fwdscnt);
+			}
+			if (0 == mnlxt_xfrm_spdinfo_get_hash(info, &hash)) {
+				printf("hash buckets %u max %u\n", hash->spdhcnt, hash->spdhmcnt);
+			}
+			if (0 == mnlxt_xfrm_spdinfo_get_hthresh(info, AF_INET, &lbits, &rbits)) {
+				printf("hthresh4 %d %d\n", lbits, rbits);
+			}
+			if (0 == mnlxt_xfrm_spdinfo_get_hthresh(info, AF_INET6, &lbits, &rbits)) {
+				printf("hthresh6 %d %d\n", lbits, rbits);
+			}
+		}
+	}
+	if (data.error_str) {
+		printf("error: %s\n", data.error_str);
+	} else {
+		rc = 0;
+	}
+	mnlxt_data_clean(&data);
+	return rc;
+}
+
+static int test_spd() {
+	printf("\nmnlxt_xfrm_spd test\n");
+	int rc = -1;
+	mnlxt_data_t data = {};
+	mnlxt_xfrm_spd_t *spd = NULL;
+	if (0 != mnlxt_xfrm_policy_dump(&data)) {
+		printf("mnlxt_xfrm_policy_dump failed, %m\n");
+	} else if (NULL == (spd = mnlxt_xfrm_spd_new())) {
+		printf("mnlxt_xfrm_spd_new failed, %m\n");
+	} else if (0 != mnlxt_xfrm_spd_load(spd, &data)) {
+		printf("mnlxt_xfrm_spd_load failed, %m\n");
+	} else {
+		mnlxt_message_t *it = NULL;
+		mnlxt_xfrm_policy_t *policy = NULL;
+		uint64_t selector = MNLXT_FLAG(MNLXT_XFRM_POLICY_DIR) | MNLXT_FLAG(MNLXT_XFRM_POLICY_FAMILY)
+												| MNLXT_FLAG(MNLXT_XFRM_POLICY_PROTO) | MNLXT_FLAG(MNLXT_XFRM_POLICY_SRC_PREFIXLEN)
+												| MNLXT_FLAG(MNLXT_XFRM_POLICY_DST_PREFIXLEN) | MNLXT_FLAG(MNLXT_XFRM_POLICY_SRC_ADDR)
+												| MNLXT_FLAG(MNLXT_XFRM_POLICY_DST_ADDR) | MNLXT_FLAG(MNLXT_XFRM_POLICY_SRC_PORT)
+												| MNLXT_FLAG(MNLXT_XFRM_POLICY_DST_PORT) | MNLXT_FLAG(MNLXT_XFRM_POLICY_MARK);
+		printf("number of policies to classify: %zu\n", mnlxt_xfrm_spd_count(spd));
+		rc = 0;
+		while ((policy = mnlxt_xfrm_policy_iterate(&data, &it))) {
+			mnlxt_xfrm_flow_t flow = {};
+			const mnlxt_xfrm_policy_t *match;
+			/* a flow built from the selector of a policy is at least matched by the policy itself */
+			flow.proto = policy->proto;
+			flow.src_port = policy->src.port;
+			flow.dst_port = policy->dst.port;
+			flow.if_index = policy->if_index;
+			flow.mark = policy->mark.value & policy->mark.mask;
+			flow.src = policy->src.addr;
+			flow.dst = policy->dst.addr;
+			match = mnlxt_xfrm_spd_lookup(spd, policy->dir, policy->family, &flow);
+			/* another policy is only returned if it takes precedence */
+			if (NULL == match
+					|| (match->index == policy->index
+									? 0 != mnlxt_xfrm_policy_compare(match, policy, selector)
+									: (match->priority > policy->priority
+										 || (match->priority == policy->priority && match->index > policy->index)))) {
+				printf("classification failed for policy %u\n", policy->index);
+				rc = -1;
+			}
+		}
+	}
+	mnlxt_xfrm_spd_free(spd);
+	mnlxt_data_clean(&data);
+	return rc;
+}
+
+/* applies a policy message to a classifier, built like the kernel notifies it */
+static int spd_apply(mnlxt_xfrm_spd_t *spd, const mnlxt_xfrm_policy_t *policy, uint16_t type, int by_index) {
+	int rc = -1;
+	char info_buf[MNL_SOCKET_BUFFER_SIZE], del_buf[MNL_SOCKET_BUFFER_SIZE];
+	mnlxt_data_t data = {};
+	struct nlmsghdr *nlh = mnl_nlmsg_put_header(info_buf);
+	nlh->nlmsg_type = XFRM_MSG_NEWPOLICY;
+	if (0 != mnlxt_xfrm_policy_put(nlh, policy, XFRM_MSG_NEWPOLICY)) {
+		printf("mnlxt_xfrm_policy_put failed, %m\n");
+		return rc;
+	}
+	if (XFRM_MSG_DELPOLICY == type) {
+		/* the deletion carries the identification of the request and the deleted policy */
+		struct xfrm_userpolicy_info *xpinfo = mnl_nlmsg_get_payload(nlh);
+		struct xfrm_userpolicy_id *xpid;
+		nlh = mnl_nlmsg_put_header(del_buf);
+		nlh->nlmsg_type = XFRM_MSG_DELPOLICY;
+		xpid = mnl_nlmsg_put_extra_header(nlh, sizeof(*xpid));
+		xpid->dir = xpinfo->dir;
+		if (by_index) {
+			xpid->index = xpinfo->index;
+		} else {
+			xpid->sel = xpinfo->sel;
+		}
+		mnl_attr_put(nlh, XFRMA_POLICY, sizeof(*xpinfo), xpinfo);
+	}
+	if (MNL_CB_OK != mnlxt_xfrm_policy_data(nlh, &data)) {
+		printf("mnlxt_xfrm_policy_data failed, %s\n", data.error_str ? data.error_str : "");
+	} else {
+		rc = mnlxt_xfrm_spd_update(spd, data.first);
+	}
+	mnlxt_data_clean(&data);
+	return rc;
+}
+
+static int test_spd_update() {
+	printf("\nmnlxt_xfrm_spd_update test\n");
+	int rc = -1;
+	mnlxt_xfrm_spd_t *spd = mnlxt_xfrm_spd_new();
+	mnlxt_xfrm_policy_t *policy = mnlxt_xfrm_policy_new();
+	mnlxt_inet_addr_t src = {}, dst = {};
+	inet_pton(AF_INET, "10.0.0.0", &src.in);
+	inet_pton(AF_INET, "10.1.0.0", &dst.in);
+	if (NULL == spd || NULL == policy) {
+		printf("allocation failed, %m\n");
+	} else if (0 != mnlxt_xfrm_policy_set_family(policy, AF_INET)
+						 || 0 != mnlxt_xfrm_policy_set_dir(policy, XFRM_POLICY_OUT)
+						 || 0 != mnlxt_xfrm_policy_set_src_addr(policy, AF_INET, &src)
+						 || 0 != mnlxt_xfrm_policy_set_src_prefixlen(policy, 24)
+						 || 0 != mnlxt_xfrm_policy_set_dst_addr(policy, AF_INET, &dst)
+						 || 0 != mnlxt_xfrm_policy_set_dst_prefixlen(policy, 24) || 0 != mnlxt_xfrm_policy_set_index(policy, 8)
+						 || 0 != mnlxt_xfrm_policy_set_priority(policy, 100)
+						 || 0 != mnlxt_xfrm_policy_set_action(policy, XFRM_POLICY_ALLOW)) {
+		printf("setting policy failed, %m\n");
+	} else if (0 != spd_apply(spd, policy, XFRM_MSG_NEWPOLICY, 0) || 1 != mnlxt_xfrm_spd_count(spd)) {
+		printf("adding policy failed\n");
+	} else if (0 != spd_apply(spd, policy, XFRM_MSG_DELPOLICY, 0) || 0 != mnlxt_xfrm_spd_count(spd)) {
+		printf("deleting policy by selector failed\n");
+	} else if (0 != spd_apply(spd, policy, XFRM_MSG_NEWPOLICY, 0) || 0 != spd_apply(spd, policy, XFRM_MSG_DELPOLICY, 1)
+						 || 0 != mnlxt_xfrm_spd_count(spd)) {
+		printf("deleting policy by index failed\n");
+	} else {
+		rc = 0;
+	}
+	mnlxt_xfrm_policy_free(policy);
+	mnlxt_xfrm_spd_free(spd);
+	return rc;
+}
+
 int main(int argc, char **argv) {
 	int rc = 1, ret = 0;
 	ret |= test_policy_dump();
+	ret |= test_state_dump();
+	ret |= test_spdinfo_dump();
+	ret |= test_spd();
+	ret |= test_spd_update();
 	if (0 == ret) {
 		rc = 0;
 	}
@@ -0,0 +1,120 @@
+/*
+ * xfrm_monitor.c		Libmnlxt Xfrm/IPsec Test - print acquire, expire and mapping events
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libmnlxt/mnlxt.h>
+
+static int running = 1;
+
+static void sigfunc(int sig) {
+	running = 0;
+}
+
+static void acquire_cb(const mnlxt_xfrm_acquire_t *acquire, void *arg) {
+	char src[INET6_ADDRSTRLEN] = {}, dst[INET6_ADDRSTRLEN] = {};
+	uint32_t index = 0;
+	uint16_t num = 0;
+	const mnlxt_xfrm_tmpl_t *tmpls = NULL;
+
+	inet_ntop(acquire->id.family, &acquire->id.src, src, sizeof(src));
+	inet_ntop(acquire->id.family, &acquire->id.dst, dst, sizeof(dst));
+	mnlxt_xfrm_policy_get_index(&acquire->policy, &index);
+	mnlxt_xfrm_policy_get_tmpls(&acquire->policy, &tmpls, &num);
+	printf("====> acquire: seq %u proto %hhu src %s dst %s policy %u templates %hu\n", acquire->seq,
+				 acquire->id.proto, src, dst, index, num);
+}
+
+static void expire_cb(const mnlxt_xfrm_expire_t *expire, void *arg) {
+	char dst[INET6_ADDRSTRLEN] = {};
+
+	inet_ntop(expire->state.family, &expire->state.dst, dst, sizeof(dst));
+	printf("====> expire %s: proto %hhu spi 0x%08x dst %s\n", (expire->hard ? "hard" : "soft"), expire->state.proto,
+				 expire->state.spi, dst);
+}
+
+static void polexpire_cb(const mnlxt_xfrm_polexpire_t *polexpire, void *arg) {
+	uint32_t index = 0;
+
+	mnlxt_xfrm_policy_get_index(&polexpire->policy, &index);
+	printf("====> policy expire %s: index %u\n", (polexpire->hard ? "hard" : "soft"), index);
+}
+
+static void mapping_cb(const mnlxt_xfrm_mapping_t *mapping, void *arg) {
+	char old_src[INET6_ADDRSTRLEN] = {}, new_src[INET6_ADDRSTRLEN] = {};
+
+	inet_ntop(mapping->family, &mapping->old_src, old_src, sizeof(old_src));
+	inet_ntop(mapping->family, &mapping->new_src, new_src, sizeof(new_src));
+	printf("====> mapping: spi 0x%08x %s:%hu -> %s:%hu\n", mapping->spi, old_src, mapping->old_sport, new_src,
+				 mapping->new_sport);
+}
+
+static void other_cb(const mnlxt_message_t *message, void *arg) {
+	printf("====> other: %hu\n", message->nlmsg_type);
+}
+
+int main(int argc, char **argv) {
+	int rc = EXIT_FAILURE;
+	mnlxt_handle_t handle = {};
+	mnlxt_connect_opts_t opts = {.flags = MNLXT_FLAG(MNLXT_CONNECT_NONBLOCK)};
+	mnlxt_xfrm_event_cbs_t cbs = {acquire_cb, expire_cb, polexpire_cb, mapping_cb, other_cb};
+	struct pollfd pfd;
+	int r;
+
+	signal(SIGINT, sigfunc);
+
+	if (-1 == mnlxt_xfrm_connect_opts(&handle, 0, &opts)) {
+		perror("mnlxt_xfrm_connect_opts");
+		return rc;
+	}
+	if (-1 == mnlxt_handle_add_group(&handle, XFRMNLGRP_ACQUIRE)
+			|| -1 == mnlxt_handle_add_group(&handle, XFRMNLGRP_EXPIRE)
+			|| -1 == mnlxt_handle_add_group(&handle, XFRMNLGRP_MAPPING)) {
+		perror("mnlxt_handle_add_group");
+		goto end;
+	}
+
+	pfd.fd = mnlxt_handel_get_fd(&handle);
+	pfd.events = POLLIN;
+
+	while (running) {
+		r = poll(&pfd, 1, 1000);
+
+		if (0 == r)
+			continue;
+
+		if (1 != r || !(pfd.revents & POLLIN))
+			break;
+
+		r = mnlxt_xfrm_event_process(&handle, &cbs, NULL);
+		if (0 > r) {
+			if (ENOBUFS == errno) {
+				printf("====> overrun\n");
+				continue;
+			}
+			printf("mnlxt_xfrm_event_process failed: %s, %m\n", handle.error_str);
+			break;
+		}
+	}
+
+	if (!running) {
+		rc = EXIT_SUCCESS;
+	}
+
+end:
+	mnlxt_disconnect(&handle);
+
+	return rc;
+}
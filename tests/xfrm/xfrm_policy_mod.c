@@ -16,7 +16,7 @@
 #include <libmnlxt/mnlxt.h>
 
 static void usage(const char *progname) {
-	printf("usage: %s add|del\n", progname);
+	printf("usage: %s add|del|flush\n", progname);
 }
 
 int main(int argc, char **argv) {
@@ -36,14 +36,32 @@ int main(int argc, char **argv) {
 		job = XFRM_MSG_NEWPOLICY;
 	} else if (!strcmp("del", argv[1])) {
 		job = XFRM_MSG_DELPOLICY;
+	} else if (!strcmp("flush", argv[1])) {
+		job = XFRM_MSG_FLUSHPOLICY;
 	} else {
 		fprintf(stderr, "Invalid argument: %s\n", argv[1]);
 		usage(argv[0]);
 		goto err;
 	}
 
-	/*ip xfrm policy add dir fwd src 192.168.100.1/32 dst 192.168.200.1/32 proto tcp sport 1234 action bypass priority
-	 * 10*/
+	if (XFRM_MSG_FLUSHPOLICY == job) {
+		/* deletes all policies to peers of 192.168.200.0/24 */
+		mnlxt_xfrm_policy_t match = {};
+		inet_pton(family, "192.168.200.0", &addr_buf);
+		mnlxt_xfrm_policy_set_dst_addr(&match, (uint8_t)family, &addr_buf);
+		mnlxt_xfrm_policy_set_dst_prefixlen(&match, 24);
+		ret = mnlxt_xfrm_policy_flush_match(NULL, &match);
+		if (-1 == ret) {
+			perror("mnlxt_xfrm_policy_flush_match");
+			goto err;
+		}
+		printf("%d policies deleted\n", ret);
+		rc = EXIT_SUCCESS;
+		goto err;
+	}
+
+	/*ip xfrm policy add dir fwd src 192.168.100.1/32 dst 192.168.200.1/32 proto tcp sport 1234 action allow priority
+	 * 10 tmpl src 10.0.0.1 dst 10.0.0.2 proto esp reqid 1 mode tunnel*/
 
 	policy = mnlxt_xfrm_policy_new();
 	if (!policy) {
@@ -69,6 +87,12 @@ int main(int argc, char **argv) {
 
 	mnlxt_xfrm_policy_set_dir(policy, XFRM_POLICY_FWD);
 
+	/* the template is installed by the same request */
+	mnlxt_xfrm_tmpl_t tmpl = {.family = AF_INET, .proto = IPPROTO_ESP, .mode = XFRM_MODE_TUNNEL, .reqid = 1};
+	inet_pton(AF_INET, "10.0.0.1", &tmpl.src);
+	inet_pton(AF_INET, "10.0.0.2", &tmpl.dst);
+	mnlxt_xfrm_policy_set_tmpls(policy, &tmpl, 1);
+
 	message = mnlxt_xfrm_policy_message(&policy, (uint16_t)job, 0);
 	if (!message) {
 		perror("mnlxt_xfrm_policy_message");
@@ -0,0 +1,134 @@
+/*
+ * xfrm_state_batch.c		Libmnlxt Xfrm/IPsec Test - Adding/Deleting many SAs in batched requests
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libmnlxt/mnlxt.h>
+
+static void usage(const char *progname) {
+	printf("usage: %s add|del <src> <dst> <count>\n"
+				 "       %s flush\n"
+				 "\t src		IPv4 address of the local peer\n"
+				 "\t dst		IPv4 address of the first remote peer\n"
+				 "\t count		number of ESP tunnel SAs to create/delete, one per remote peer\n",
+				 progname, progname);
+}
+
+int main(int argc, char **argv) {
+	int rc = EXIT_FAILURE;
+	int action = 0;
+	const char *progname = argv[0];
+	mnlxt_handle_t handle = {};
+	mnlxt_connect_opts_t opts = {};
+	mnlxt_data_t data = {};
+	mnlxt_inet_addr_t src = {}, dst = {};
+	mnlxt_xfrm_state_t *state = NULL;
+	mnlxt_message_t *msg = NULL;
+	uint8_t key[36] = {};
+	long count, i;
+
+	if (2 == argc && !strcmp("flush", argv[1])) {
+		/* ip xfrm state flush proto esp */
+		if (0 != mnlxt_xfrm_state_flush(NULL, IPPROTO_ESP)) {
+			perror("mnlxt_xfrm_state_flush");
+			goto err;
+		}
+		rc = EXIT_SUCCESS;
+		goto err;
+	}
+
+	if (5 != argc) {
+		usage(progname);
+		goto err;
+	}
+
+	if (!strcmp("add", argv[1])) {
+		action = XFRM_MSG_NEWSA;
+	} else if (!strcmp("del", argv[1])) {
+		action = XFRM_MSG_DELSA;
+	} else {
+		fprintf(stderr, "Invalid argument: %s\n", argv[1]);
+		usage(progname);
+		goto err;
+	}
+
+	if (1 != inet_pton(AF_INET, argv[2], &src) || 1 != inet_pton(AF_INET, argv[3], &dst)) {
+		fprintf(stderr, "Invalid peer address\n");
+		goto err;
+	}
+
+	if (0 >= (count = strtol(argv[4], NULL, 10))) {
+		fprintf(stderr, "Invalid SA count: %s\n", argv[4]);
+		goto err;
+	}
+
+	/* ip xfrm state add src <src> dst <dst+i> proto esp spi 0x1000+i reqid 1000+i mode tunnel
+	 * aead 'rfc4106(gcm(aes))' 0x... 128 */
+	for (i = 0; i < count; ++i, dst.in.s_addr = htonl(ntohl(dst.in.s_addr) + 1)) {
+		if (NULL == (state = mnlxt_xfrm_state_new())) {
+			fprintf(stderr, "mnlxt_xfrm_state_new failed\n");
+			goto err;
+		}
+		mnlxt_xfrm_state_set_src_addr(state, AF_INET, &src);
+		mnlxt_xfrm_state_set_dst_addr(state, AF_INET, &dst);
+		mnlxt_xfrm_state_set_proto(state, IPPROTO_ESP);
+		mnlxt_xfrm_state_set_spi(state, 0x1000 + i);
+		if (XFRM_MSG_NEWSA == action) {
+			mnlxt_xfrm_state_set_mode(state, XFRM_MODE_TUNNEL);
+			mnlxt_xfrm_state_set_reqid(state, 1000 + i);
+			mnlxt_xfrm_state_set_replay_window(state, 32);
+			memcpy(key, &i, sizeof(i));
+			mnlxt_xfrm_state_set_aead(state, "rfc4106(gcm(aes))", key, 8 * sizeof(key), 128);
+		}
+		if (NULL == (msg = mnlxt_xfrm_state_message(&state, action, 0))) {
+			fprintf(stderr, "mnlxt_xfrm_state_message failed\n");
+			goto err;
+		}
+		mnlxt_data_add(&data, msg);
+	}
+
+	/* acknowledges of large batches do not need to echo the requests */
+	opts.flags = MNLXT_FLAG(MNLXT_CONNECT_CAP_ACK) | MNLXT_FLAG(MNLXT_CONNECT_EXT_ACK);
+	opts.sndbuf = 1 << 20;
+	if (-1 == mnlxt_xfrm_connect_opts(&handle, 0, &opts)) {
+		perror("mnlxt_xfrm_connect_opts");
+		goto err;
+	}
+
+	int failed = mnlxt_handle_batch_request(&handle, &data);
+	if (0 > failed) {
+		fprintf(stderr, "mnlxt_handle_batch_request failed, %s\n", handle.error_str ? handle.error_str : strerror(errno));
+		goto err;
+	}
+
+	msg = NULL;
+	while (NULL != (msg = mnlxt_data_iterate(&data, msg))) {
+		if (0 != msg->error) {
+			uint32_t spi = 0;
+			mnlxt_xfrm_state_get_spi(mnlxt_xfrm_state_get(msg), &spi);
+			printf("spi 0x%x failed: %s\n", spi, strerror(-msg->error));
+		}
+	}
+	printf("%ld requests sent, %d failed\n", count, failed);
+
+	if (0 == failed) {
+		rc = EXIT_SUCCESS;
+	}
+
+err:
+	mnlxt_xfrm_state_free(state);
+	mnlxt_data_clean(&data);
+	mnlxt_disconnect(&handle);
+	return rc;
+}